@@ -0,0 +1,97 @@
+#ifndef BENCHMARKGRAPH_H
+#define BENCHMARKGRAPH_H
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <utility>
+#include <vector>
+#include "route/RouteGraph.h"
+
+namespace benchmarks {
+
+/// @brief This generates a road like graph to benchmark against. The locations are laid out on a square grid, each connected both ways
+///        to its grid neighbours, with a sprinkling of longer one way links (the motorways). Location costs are small integers just
+///        like the ones in config/locations.dat
+/// @param location_count The (approximate) number of locations to generate
+/// @param seed The random seed, so runs are repeatable
+/// @return The generated graph
+inline route::RouteGraph GenerateRoadGraph(size_t location_count, unsigned int seed = 1) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<unsigned int> location_cost(1, 9);
+    const size_t width = static_cast<size_t>(std::sqrt(static_cast<double>(location_count)));
+    const size_t count = width * width;
+    std::uniform_int_distribution<size_t> any_location(0, count - 1);
+
+    std::vector<unsigned int> costs(count);
+    for (auto& cost : costs) {
+        cost = location_cost(rng);
+    }
+
+    std::vector<std::pair<size_t, size_t>> routes;
+    auto add_route = [&routes](size_t from, size_t to) {
+        routes.push_back(std::make_pair(from, to));
+    };
+
+    for (size_t y = 0; y < width; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            size_t i = y * width + x;
+            if (x + 1 < width) {
+                add_route(i, i + 1);
+                add_route(i + 1, i);
+            }
+            if (y + 1 < width) {
+                add_route(i, i + width);
+                add_route(i + width, i);
+            }
+        }
+    }
+    for (size_t i = 0; i < count / 50; ++i) {
+        add_route(any_location(rng), any_location(rng));
+    }
+    return route::RouteGraph(costs, routes);
+}
+
+/// @brief This generates a list of (start, end) queries. Local queries stay within a few grid steps of the start, the rest are
+///        uniformly random and so typically cross most of the graph
+/// @param graph The graph the queries are for
+/// @param query_count The number of queries to generate
+/// @param local True for local queries, False for random ones
+/// @param seed The random seed, so runs are repeatable
+/// @return The list of queries
+inline std::vector<std::pair<size_t, size_t>> GenerateQueries(const route::RouteGraph& graph, size_t query_count, bool local, unsigned int seed = 2) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<size_t> any_location(0, graph.LocationCount() - 1);
+    const size_t width = static_cast<size_t>(std::sqrt(static_cast<double>(graph.LocationCount())));
+    std::uniform_int_distribution<int> offset(-5, 5);
+
+    std::vector<std::pair<size_t, size_t>> queries;
+    for (size_t i = 0; i < query_count; ++i) {
+        size_t start = any_location(rng);
+        size_t end = any_location(rng);
+        if (local) {
+            long x = static_cast<long>(start % width) + offset(rng);
+            long y = static_cast<long>(start / width) + offset(rng);
+            x = std::min<long>(std::max<long>(x, 0), width - 1);
+            y = std::min<long>(std::max<long>(y, 0), width - 1);
+            end = static_cast<size_t>(y) * width + static_cast<size_t>(x);
+        }
+        queries.push_back(std::make_pair(start, end));
+    }
+    return queries;
+}
+
+/// @brief This times how long a function takes to run
+/// @param function The function to time
+/// @return The time taken in micro seconds
+template <typename FunctionType>
+double TimeMicroseconds(FunctionType function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+#include <boost/algorithm/string.hpp>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BenchmarkGraph.h"
+#include "route/CsvReader.h"
+#include "route/FileContents.h"
+#include "route/FileRouteDatabase.h"
+
+using namespace route;
+
+/// @brief This writes a routes file of around the given size, each row a start location and a handful of destinations
+/// @param file_name The file to write
+/// @param bytes The approximate size of the file
+static void WriteRoutesFile(const std::string& file_name, size_t bytes) {
+    std::ofstream file(file_name, std::ios::trunc);
+    std::mt19937 random(1);
+    std::uniform_int_distribution<unsigned int> location(0, 999999);
+    std::uniform_int_distribution<unsigned int> destination_count(1, 8);
+    size_t written = 0;
+    std::string row;
+    while (written < bytes) {
+        row = "Location " + std::to_string(location(random));
+        for (unsigned int destination_i = destination_count(random); destination_i > 0; --destination_i) {
+            row += ", Location " + std::to_string(location(random));
+        }
+        row += "\n";
+        file << row;
+        written += row.size();
+    }
+}
+
+/// @brief This compares reading a routes file line by line with std::getline, std::stringstream and boost::trim_copy (the way the
+///        file databases used to) against scanning the memory mapped file with CsvReader, reporting the throughput of each next to
+///        the throughput of just reading the file, then parsing the routes on one worker thread against all of them, and the time for
+///        a FileRouteDatabase::Load() of it
+int main(int argc, char* argv[])
+{
+    const size_t megabytes = argc > 1 ? std::stoul(argv[1]) : 256;
+    const std::string file_name("bench_csv_load.csv");
+    WriteRoutesFile(file_name, megabytes * 1024 * 1024);
+
+    size_t read_bytes = 0;
+    const double read_time = benchmarks::TimeMicroseconds([&]() {
+        std::ifstream file(file_name, std::ios::binary);
+        std::vector<char> buffer(1 << 20);
+        while (file.read(buffer.data(), buffer.size()) || file.gcount()) {
+            read_bytes += file.gcount();
+        }
+    });
+
+    size_t getline_fields = 0;
+    const double getline_time = benchmarks::TimeMicroseconds([&]() {
+        std::ifstream file(file_name);
+        std::string line;
+        while (std::getline(file, line)) {
+            std::stringstream ss(boost::trim_copy(line));
+            std::string value;
+            std::vector<std::string> route_data;
+            while (std::getline(ss, value, ',')) {
+                route_data.push_back(boost::trim_copy(value));
+            }
+            getline_fields += route_data.size();
+        }
+    });
+
+    size_t scan_fields = 0;
+    const double scan_time = benchmarks::TimeMicroseconds([&]() {
+        const FileContents file(file_name);
+        CsvReader reader(file.Contents());
+        std::vector<std::string_view> fields;
+        while (reader.NextRow(fields)) {
+            scan_fields += fields.size();
+        }
+    });
+
+    // The route parse on one worker against all of them, the routes must come out the same
+    size_t serial_routes = 0;
+    size_t parallel_routes = 0;
+    bool same_routes = false;
+    const double serial_parse_time = benchmarks::TimeMicroseconds([&]() {
+        const FileContents file(file_name);
+        serial_routes = FileRouteDatabase::ParseRoutes(file.Contents(), ROUTE_PARSE_CHUNK_SIZE, 1).size();
+    });
+    const double parallel_parse_time = benchmarks::TimeMicroseconds([&]() {
+        const FileContents file(file_name);
+        parallel_routes = FileRouteDatabase::ParseRoutes(file.Contents()).size();
+    });
+    {
+        const FileContents file(file_name);
+        same_routes = FileRouteDatabase::ParseRoutes(file.Contents(), ROUTE_PARSE_CHUNK_SIZE, 1) == FileRouteDatabase::ParseRoutes(file.Contents());
+    }
+
+    FileRouteDatabase route_db(file_name);
+    const double load_time = benchmarks::TimeMicroseconds([&]() {
+        route_db.Load();
+    });
+    std::remove(file_name.c_str());
+
+    auto throughput = [read_bytes](double time) -> double {
+        return read_bytes / time;
+    };
+    std::printf("%-28s %12s %12s\n", "", "time(ms)", "MB/s");
+    std::printf("%-28s %12.1f %12.1f\n", "read", read_time / 1000, throughput(read_time));
+    std::printf("%-28s %12.1f %12.1f\n", "getline", getline_time / 1000, throughput(getline_time));
+    std::printf("%-28s %12.1f %12.1f%s\n", "scan", scan_time / 1000, throughput(scan_time), scan_fields == getline_fields ? "" : "  MISMATCH");
+    std::printf("%-28s %12.1f %12.1f\n", "ParseRoutes() 1 worker", serial_parse_time / 1000, throughput(serial_parse_time));
+    std::printf("%-28s %12.1f %12.1f%s\n", ("ParseRoutes() " + std::to_string(WorkerCount()) + " worker(s)").c_str(), parallel_parse_time / 1000,
+        throughput(parallel_parse_time), serial_routes == parallel_routes && same_routes ? "" : "  MISMATCH");
+    std::printf("%-28s %12.1f %12.1f\n", "FileRouteDatabase::Load()", load_time / 1000, throughput(load_time));
+    return 0;
+}
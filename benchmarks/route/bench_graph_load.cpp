@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "BenchmarkGraph.h"
+#include "route/FileLocationDatabase.h"
+#include "route/FileRouteDatabase.h"
+#include "route/GraphFile.h"
+#include "route/GraphFileDatabase.h"
+#include "route/RoutePlanner.h"
+
+using namespace route;
+
+/// @brief This writes a graph out as a location file and a route file, the way config/locations.dat and config/routes.dat are laid out
+/// @param graph The graph to write
+/// @param location_file The location file to write
+/// @param route_file The route file to write
+static void WriteDatabaseFiles(const RouteGraph& graph, const std::string& location_file, const std::string& route_file) {
+    std::ofstream locations(location_file, std::ios::trunc);
+    std::ofstream routes(route_file, std::ios::trunc);
+    for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+        locations << "Location " << location_id << ", " << graph.LocationCost(location_id) << "\n";
+        if (graph.RoutesBegin(location_id) != graph.RoutesEnd(location_id)) {
+            routes << "Location " << location_id;
+            for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+                routes << ", Location " << graph.Destination(route_i);
+            }
+            routes << "\n";
+        }
+    }
+}
+
+/// @brief This compares starting the route planner from a location file and a route file against starting it from the graph file
+///        compiled from them, over a generated road graph. Start up is timed from nothing loaded to the first route snapshot being
+///        ready, with the default Dijkstra engine so the engine build doesn't hide the load
+int main(int argc, char* argv[])
+{
+    const size_t location_count = argc > 1 ? std::stoul(argv[1]) : 250000;
+    const std::string location_file("bench_graph_load_locations.dat");
+    const std::string route_file("bench_graph_load_routes.dat");
+    const std::string graph_file("bench_graph_load.graph");
+    WriteDatabaseFiles(benchmarks::GenerateRoadGraph(location_count), location_file, route_file);
+
+    const double convert_time = benchmarks::TimeMicroseconds([&]() {
+        GraphFile::Convert(location_file, route_file, graph_file);
+    });
+
+    size_t file_locations = 0;
+    const double file_start_time = benchmarks::TimeMicroseconds([&]() {
+        RoutePlanner route_planner(std::make_shared<FileLocationDatabase>(location_file), std::make_shared<FileRouteDatabase>(route_file));
+        file_locations = route_planner.GetLocationCount();
+    });
+
+    std::shared_ptr<const GraphFile> loaded;
+    const double graph_load_time = benchmarks::TimeMicroseconds([&]() {
+        loaded = GraphFile::Load(graph_file);
+    });
+
+    size_t graph_locations = 0;
+    const double graph_start_time = benchmarks::TimeMicroseconds([&]() {
+        auto graph_db = std::make_shared<GraphFileDatabase>(graph_file);
+        RoutePlanner route_planner(graph_db, graph_db);
+        graph_locations = route_planner.GetLocationCount();
+    });
+
+    std::remove(location_file.c_str());
+    std::remove(route_file.c_str());
+    std::remove(graph_file.c_str());
+
+    std::printf("locations=%zu routes=%zu\n", loaded->Graph()->LocationCount(), loaded->Graph()->RouteCount());
+    std::printf("%-36s %12s\n", "", "time(ms)");
+    std::printf("%-36s %12.1f\n", "convert", convert_time / 1000);
+    std::printf("%-36s %12.1f\n", "start up from the location/route files", file_start_time / 1000);
+    std::printf("%-36s %12.1f\n", "GraphFile::Load()", graph_load_time / 1000);
+    std::printf("%-36s %12.1f%s\n", "start up from the graph file", graph_start_time / 1000, file_locations == graph_locations ? "" : "  MISMATCH");
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#include "BenchmarkGraph.h"
+#include "route/DijkstraSearch.h"
+#include "route/LocationOrder.h"
+
+using namespace route;
+
+/// @brief This counts the hardware cache misses of this thread with perf_event_open. Where the kernel doesn't allow it (or it isn't
+///        Linux) the counter is unavailable and the benchmark only reports the times
+class CacheMissCounter {
+    int m_fd;
+public:
+    CacheMissCounter() :
+    m_fd(-1) {
+#ifdef __linux__
+        perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+    }
+
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (m_fd >= 0) {
+            close(m_fd);
+        }
+#endif
+    }
+
+    bool Available() const {
+        return m_fd >= 0;
+    }
+
+    void Start() {
+#ifdef __linux__
+        ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    long long Stop() {
+        long long count = 0;
+#ifdef __linux__
+        ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+            count = 0;
+        }
+#endif
+        return count;
+    }
+};
+
+/// @brief This is the result of running a set of queries over one ordering of a graph
+struct OrderResult {
+    double time;            /// The average time per query in micro seconds
+    double cache_misses;    /// The average number of cache misses per query, negative if they couldn't be counted
+    unsigned long checksum; /// The sum of the route costs, to check the orderings agree
+};
+
+/// @brief This runs a set of queries through a Dijkstra search over one ordering of a graph
+/// @param graph The graph
+/// @param queries The queries, in the graph's ids
+/// @return The result
+OrderResult BenchmarkOrder(const RouteGraph& graph, const std::vector<std::pair<size_t, size_t>>& queries) {
+    DijkstraSearch<BinaryHeapQueue> search;
+    CacheMissCounter cache_misses;
+    OrderResult result = {0, -1, 0};
+
+    // One query first so the workspace is allocated before anything is measured
+    search.RouteCost(graph, queries.front().first, queries.front().second);
+    if (cache_misses.Available()) {
+        cache_misses.Start();
+    }
+    double total = benchmarks::TimeMicroseconds([&]() {
+        for (const auto& query : queries) {
+            result.checksum += search.RouteCost(graph, query.first, query.second);
+        }
+    });
+    if (cache_misses.Available()) {
+        result.cache_misses = static_cast<double>(cache_misses.Stop()) / queries.size();
+    }
+    result.time = total / queries.size();
+    return result;
+}
+
+/// @brief This compares the route search over a graph with its locations in file order, modelled as a random order, with the same
+///        graph in reverse Cuthill-McKee order (see route/LocationOrder.h), reporting the average route span, the query time and the
+///        cache misses per query
+int main(int argc, char* argv[])
+{
+    const std::vector<size_t> sizes = {16000, 64000, 256000, 1000000};
+    const size_t query_count = argc > 1 ? std::stoul(argv[1]) : 200;
+
+    std::printf("%-10s %-8s %12s %12s %14s %14s %14s %14s\n", "locations", "queries", "file span", "rcm span", "file(us)", "rcm(us)",
+        "file misses", "rcm misses");
+    for (size_t size : sizes) {
+        const RouteGraph road_graph = benchmarks::GenerateRoadGraph(size);
+        std::vector<LocationId> file_ids(road_graph.LocationCount());
+        std::iota(file_ids.begin(), file_ids.end(), 0);
+        std::shuffle(file_ids.begin(), file_ids.end(), std::mt19937(3));
+        const LocationOrder file_order(std::move(file_ids));
+        const RouteGraph file_graph = file_order.Apply(road_graph);
+        const LocationOrder rcm_order = LocationOrder::ReverseCuthillMcKee(file_graph);
+        const RouteGraph rcm_graph = rcm_order.Apply(file_graph);
+
+        for (bool local : {true, false}) {
+            std::vector<std::pair<size_t, size_t>> file_queries;
+            std::vector<std::pair<size_t, size_t>> rcm_queries;
+            for (const auto& query : benchmarks::GenerateQueries(road_graph, query_count, local)) {
+                const LocationId start_id = file_order.InternalId(static_cast<LocationId>(query.first));
+                const LocationId end_id = file_order.InternalId(static_cast<LocationId>(query.second));
+                file_queries.push_back(std::make_pair(start_id, end_id));
+                rcm_queries.push_back(std::make_pair(rcm_order.InternalId(start_id), rcm_order.InternalId(end_id)));
+            }
+
+            OrderResult file = BenchmarkOrder(file_graph, file_queries);
+            OrderResult rcm = BenchmarkOrder(rcm_graph, rcm_queries);
+            auto misses = [](double cache_misses) -> std::string {
+                return cache_misses < 0 ? "n/a" : std::to_string(static_cast<long long>(cache_misses));
+            };
+
+            std::printf("%-10zu %-8s %12.0f %12.0f %14.1f %14.1f %14s %14s%s\n", road_graph.LocationCount(), local ? "local" : "random",
+                LocationOrder::AverageRouteSpan(file_graph), LocationOrder::AverageRouteSpan(rcm_graph), file.time, rcm.time,
+                misses(file.cache_misses).c_str(), misses(rcm.cache_misses).c_str(), file.checksum == rcm.checksum ? "" : "  MISMATCH");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "BenchmarkGraph.h"
+#include "route/PerfectNameIndex.h"
+
+using namespace route;
+
+/// @brief This is an allocator that counts the bytes it hands out, to measure the memory of a node based map
+template <typename T>
+struct CountingAllocator {
+    typedef T value_type;
+    size_t* bytes;
+
+    CountingAllocator(size_t* bytes) :
+    bytes(bytes) {
+    }
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) :
+    bytes(other.bytes) {
+    }
+
+    T* allocate(size_t count) {
+        *bytes += count * sizeof(T);
+        return std::allocator<T>().allocate(count);
+    }
+
+    void deallocate(T* pointer, size_t count) {
+        *bytes -= count * sizeof(T);
+        std::allocator<T>().deallocate(pointer, count);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const {
+        return bytes == other.bytes;
+    }
+
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>& other) const {
+        return bytes != other.bytes;
+    }
+};
+
+typedef std::unordered_map<std::string, LocationId, std::hash<std::string>, std::equal_to<std::string>,
+    CountingAllocator<std::pair<const std::string, LocationId>>> NameMap;
+
+/// @brief This compares looking up location names in a std::unordered_map against the perfect name index, over a range of name
+///        counts, reporting the build time, the lookup time (a mix of known and unknown names) and the memory used by each
+int main(int argc, char* argv[])
+{
+    const std::vector<size_t> sizes = {1000, 16000, 256000, 1000000};
+    const size_t lookup_count = argc > 1 ? std::stoul(argv[1]) : 1000000;
+
+    std::printf("%-10s %12s %12s %12s %12s %14s %14s\n", "names", "map(ms)", "index(ms)", "map(ns)", "index(ns)", "map(bytes)", "index(bytes)");
+    for (size_t size : sizes) {
+        std::vector<std::string> names;
+        for (size_t i = 0; i < size; ++i) {
+            names.push_back("Location " + std::to_string(i * 7919 % 1000003));
+        }
+        std::mt19937 random(1);
+        std::uniform_int_distribution<size_t> name(0, size - 1);
+        std::vector<std::string> lookups;
+        for (size_t i = 0; i < lookup_count; ++i) {
+            lookups.push_back(i % 8 == 0 ? "Unknown " + std::to_string(i) : names[name(random)]);
+        }
+
+        size_t map_bytes = 0;
+        NameMap map(0, std::hash<std::string>(), std::equal_to<std::string>(), CountingAllocator<std::pair<const std::string, LocationId>>(&map_bytes));
+        const double map_build = benchmarks::TimeMicroseconds([&]() {
+            for (LocationId id = 0; id < names.size(); ++id) {
+                map.emplace(names[id], id);
+            }
+        });
+        std::unique_ptr<PerfectNameIndex> index;
+        const double index_build = benchmarks::TimeMicroseconds([&]() {
+            index = std::make_unique<PerfectNameIndex>(std::vector<std::string_view>(names.begin(), names.end()));
+        });
+
+        unsigned long map_checksum = 0;
+        const double map_lookup = benchmarks::TimeMicroseconds([&]() {
+            for (const std::string& lookup : lookups) {
+                auto id = map.find(lookup);
+                map_checksum += id != map.end() ? id->second : INVALID_LOCATION_ID;
+            }
+        });
+        unsigned long index_checksum = 0;
+        const double index_lookup = benchmarks::TimeMicroseconds([&]() {
+            for (const std::string& lookup : lookups) {
+                index_checksum += index->Find(lookup);
+            }
+        });
+
+        // Names past the small string buffer would add a heap allocation each to the map, the benchmark names all fit in it
+        std::printf("%-10zu %12.1f %12.1f %12.1f %12.1f %14zu %14zu%s\n", size, map_build / 1000, index_build / 1000,
+            map_lookup * 1000 / lookup_count, index_lookup * 1000 / lookup_count, map_bytes, index->MemoryBytes(),
+            map_checksum == index_checksum ? "" : "  MISMATCH");
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "BenchmarkGraph.h"
+#include "route/DijkstraSearch.h"
+#include "route/PagedGraph.h"
+#include "route/PagedRouteEngine.h"
+
+using namespace route;
+
+/// @brief This asks the operating system to drop a file from its page cache, so the pages are read from the disk again
+/// @param path The path of the file
+static void DropFromPageCache(const std::string& path) {
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file >= 0) {
+        fdatasync(file);
+        posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+        close(file);
+    }
+}
+
+/// @brief This compares route queries over a paged graph kept on disk, with the buffer pool at a range of fractions of the size of the
+///        graph, against plain Dijkstra over the graph held in memory. Each run starts with the file dropped from the page cache, and
+///        reports the query time, the buffer pool hit rate and the I/O done
+int main(int argc, char* argv[])
+{
+    const size_t location_count = argc > 1 ? std::stoul(argv[1]) : 250000;
+    const size_t query_count = 200;
+    const std::string paged_file("bench_paged_graph.paged");
+    const RouteGraph graph = benchmarks::GenerateRoadGraph(location_count);
+    std::vector<std::string> names;
+    std::vector<std::string_view> name_views;
+    for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+        names.push_back("Location " + std::to_string(location_id));
+    }
+    for (const std::string& name : names) {
+        name_views.push_back(name);
+    }
+    PagedGraph::Save(paged_file, PerfectNameIndex(name_views), graph, LocationOrder::ReverseCuthillMcKee(graph));
+
+    // The paged graph numbers the locations its own way, the queries are mapped to it by name
+    std::shared_ptr<const PagedGraph> whole = PagedGraph::Open(paged_file);
+    const size_t page_count = whole->PageCount();
+    const size_t pages_size = page_count * whole->PageSize();
+    std::vector<LocationId> paged_ids(graph.LocationCount());
+    for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+        paged_ids[location_id] = whole->Names()->Find(names[location_id]);
+    }
+    whole.reset();
+    std::printf("locations=%zu routes=%zu pages=%zu pages_mb=%.1f\n", graph.LocationCount(), graph.RouteCount(), page_count, pages_size / 1048576.0);
+
+    for (bool local : {true, false}) {
+        const std::vector<std::pair<size_t, size_t>> queries = benchmarks::GenerateQueries(graph, local ? query_count : query_count / 10, local);
+        std::printf("\n%s queries=%zu\n", local ? "local" : "random", queries.size());
+        std::printf("%-24s %12s %10s %12s %12s %12s %10s\n", "", "time(us)", "hit_rate", "read(MB)", "evictions", "prefetches", "checksum");
+
+        DijkstraSearch<BinaryHeapQueue> search;
+        unsigned long memory_checksum = 0;
+        const double memory_time = benchmarks::TimeMicroseconds([&]() {
+            for (const auto& query : queries) {
+                memory_checksum += search.RouteCost(graph, query.first, query.second);
+            }
+        });
+        std::printf("%-24s %12.1f %10s %12s %12s %12s %10lu\n", "in memory", memory_time / queries.size(), "", "", "", "", memory_checksum);
+
+        for (double pool_fraction : {1.0, 0.25, 0.1, 0.02}) {
+            DropFromPageCache(paged_file);
+            std::shared_ptr<const PagedGraph> paged_graph = PagedGraph::Open(paged_file, static_cast<size_t>(pages_size * pool_fraction));
+            const PagedRouteEngine engine(paged_graph);
+            unsigned long paged_checksum = 0;
+            const double paged_time = benchmarks::TimeMicroseconds([&]() {
+                for (const auto& query : queries) {
+                    paged_checksum += engine.GetRouteCost(paged_ids[query.first], paged_ids[query.second]);
+                }
+            });
+            const BufferPoolCounters counters = paged_graph->Counters();
+            const std::string label = "paged, pool " + std::to_string(static_cast<int>(pool_fraction * 100)) + "%";
+            std::printf("%-24s %12.1f %10.3f %12.1f %12lu %12lu %10lu%s\n", label.c_str(), paged_time / queries.size(), counters.HitRate(),
+                counters.bytes_read / 1048576.0, static_cast<unsigned long>(counters.evictions), static_cast<unsigned long>(counters.prefetches),
+                paged_checksum, paged_checksum == memory_checksum ? "" : "  MISMATCH");
+        }
+    }
+
+    std::remove(paged_file.c_str());
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "BenchmarkGraph.h"
+#include "route/DijkstraSearch.h"
+#include "route/PriorityQueue.h"
+
+using namespace route;
+
+/// @brief This runs a set of queries through the search using a given priority queue policy
+/// @return The average time per query in micro seconds
+template <typename QueueType>
+double BenchmarkQueue(const RouteGraph& graph, const std::vector<std::pair<size_t, size_t>>& queries, unsigned long& checksum) {
+    DijkstraSearch<QueueType> search;
+    double total = benchmarks::TimeMicroseconds([&]() {
+        for (const auto& query : queries) {
+            checksum += search.RouteCost(graph, query.first, query.second);
+        }
+    });
+    return total / queries.size();
+}
+
+/// @brief This benchmarks each priority queue policy over a range of graph sizes, for both short local routes and long random routes,
+///        so the crossover point between the policies can be read off the table
+int main(int argc, char* argv[])
+{
+    const std::vector<size_t> sizes = {1000, 4000, 16000, 64000, 256000};
+    const size_t query_count = argc > 1 ? std::stoul(argv[1]) : 200;
+
+    std::printf("%-10s %-8s %12s %12s %12s %12s\n", "locations", "queries", "binary(us)", "4-ary(us)", "pairing(us)", "radix(us)");
+    for (size_t size : sizes) {
+        const RouteGraph graph = benchmarks::GenerateRoadGraph(size);
+        for (bool local : {true, false}) {
+            const auto queries = benchmarks::GenerateQueries(graph, query_count, local);
+            unsigned long checksums[4] = {0, 0, 0, 0};
+
+            double binary = BenchmarkQueue<BinaryHeapQueue>(graph, queries, checksums[0]);
+            double quaternary = BenchmarkQueue<QuaternaryHeapQueue>(graph, queries, checksums[1]);
+            double pairing = BenchmarkQueue<PairingHeapQueue>(graph, queries, checksums[2]);
+            double radix = BenchmarkQueue<RadixHeapQueue>(graph, queries, checksums[3]);
+
+            std::printf("%-10zu %-8s %12.1f %12.1f %12.1f %12.1f%s\n", graph.LocationCount(), local ? "local" : "random",
+                binary, quaternary, pairing, radix,
+                (checksums[0] == checksums[1] && checksums[0] == checksums[2] && checksums[0] == checksums[3]) ? "" : "  MISMATCH");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BenchmarkGraph.h"
+#include "route/AllPairsEngine.h"
+#include "route/AltEngine.h"
+#include "route/ContractionHierarchyEngine.h"
+#include "route/DeltaSteppingEngine.h"
+#include "route/HubLabelEngine.h"
+#include "route/OverlayEngine.h"
+#include "route/SearchEngine.h"
+
+using namespace route;
+
+/// @brief This is a route engine to benchmark
+struct EngineEntry {
+    const char* name;
+    RouteEngineFactory factory;
+    size_t max_locations;   /// Engines with heavy preprocessing are skipped past this graph size
+};
+
+/// @brief This times building each route engine and then running the same set of queries through it, over a range of graph sizes,
+///        for both short local routes and long random routes
+int main(int argc, char* argv[])
+{
+    const std::vector<size_t> sizes = {1000, 4000, 16000, 64000, 256000};
+    const size_t query_count = argc > 1 ? std::stoul(argv[1]) : 200;
+    const std::vector<EngineEntry> engines = {
+        {"dijkstra", DijkstraEngine::Factory(), SIZE_MAX},
+        {"bidirectional", BidirectionalDijkstraEngine::Factory(), SIZE_MAX},
+        {"ch", ContractionHierarchyEngine::Factory(), 64000},
+        {"alt", AltEngine::Factory(), SIZE_MAX},
+        {"table", AllPairsEngine::Factory(), DEFAULT_ALL_PAIRS_MAX_LOCATIONS},
+        {"delta", DeltaSteppingEngine::Factory(0), SIZE_MAX},
+        {"hub", HubLabelEngine::Factory(), 16000},
+        {"overlay", OverlayEngine::Factory(), SIZE_MAX},
+    };
+
+    std::printf("%-10s %-14s %12s %16s %16s %16s %16s\n", "locations", "engine", "build(ms)", "local(us)", "random(us)", "burst(us)", "matrix16(us)");
+    for (size_t size : sizes) {
+        auto graph = std::make_shared<const RouteGraph>(benchmarks::GenerateRoadGraph(size));
+        const auto local_queries = benchmarks::GenerateQueries(*graph, query_count, true);
+        const auto random_queries = benchmarks::GenerateQueries(*graph, query_count, false);
+        // Bursts of 16 queries from the same start location to random end locations
+        std::vector<std::pair<size_t, size_t>> burst_queries;
+        for (size_t i = 0; i < random_queries.size(); ++i) {
+            burst_queries.push_back(std::make_pair(random_queries[i - i % 16].first, random_queries[i].second));
+        }
+        std::vector<LocationId> matrix_starts;
+        std::vector<LocationId> matrix_ends;
+        for (size_t i = 0; i < 16; ++i) {
+            matrix_starts.push_back(static_cast<LocationId>(random_queries[i % random_queries.size()].first));
+            matrix_ends.push_back(static_cast<LocationId>(random_queries[i % random_queries.size()].second));
+        }
+
+        unsigned long reference_checksum = 0;
+        for (size_t engine_i = 0; engine_i < engines.size(); ++engine_i) {
+            if (graph->LocationCount() > engines[engine_i].max_locations) {
+                continue;
+            }
+
+            RouteEnginePtr engine;
+            double build = benchmarks::TimeMicroseconds([&]() {
+                engine = engines[engine_i].factory(graph);
+            });
+
+            unsigned long checksum = 0;
+            auto run = [&engine, &checksum](const std::vector<std::pair<size_t, size_t>>& queries) -> double {
+                double total = benchmarks::TimeMicroseconds([&]() {
+                    for (const auto& query : queries) {
+                        checksum += engine->GetRouteCost(query.first, query.second);
+                    }
+                });
+                return total / queries.size();
+            };
+            double local = run(local_queries);
+            double random = run(random_queries);
+            double burst = run(burst_queries);
+            double matrix = benchmarks::TimeMicroseconds([&]() {
+                const std::vector<unsigned int> route_costs = engine->GetRouteCosts(matrix_starts, matrix_ends);
+                for (unsigned int route_cost : route_costs) {
+                    checksum += route_cost;
+                }
+            });
+            if (engine_i == 0) {
+                reference_checksum = checksum;
+            }
+
+            std::printf("%-10zu %-14s %12.1f %16.1f %16.1f %16.1f %16.1f%s\n", graph->LocationCount(), engines[engine_i].name, build / 1000.0, local, random, burst, matrix,
+                checksum == reference_checksum ? "" : "  MISMATCH");
+        }
+    }
+    return 0;
+}
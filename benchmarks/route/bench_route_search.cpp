@@ -0,0 +1,71 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "BenchmarkGraph.h"
+#include "route/AltEngine.h"
+#include "route/BidirectionalDijkstraSearch.h"
+#include "route/DijkstraSearch.h"
+
+using namespace route;
+
+/// @brief This is the result of running a set of queries through one search
+struct SearchResult {
+    double time;            /// The average time per query in micro seconds
+    double settled;         /// The average number of locations settled per query
+    unsigned long checksum; /// The sum of the route costs, to check the searches agree
+};
+
+/// @brief This runs a set of queries through a search
+/// @param search The search to run
+/// @param route_cost This runs one query through the search
+/// @return The search result
+template <typename SearchType, typename RouteCostFunction>
+SearchResult BenchmarkSearch(SearchType& search, RouteCostFunction route_cost, const std::vector<std::pair<size_t, size_t>>& queries) {
+    SearchResult result = {0, 0, 0};
+    unsigned long settled = 0;
+    double total = benchmarks::TimeMicroseconds([&]() {
+        for (const auto& query : queries) {
+            result.checksum += route_cost(query.first, query.second);
+            settled += search.SettledCount();
+        }
+    });
+    result.time = total / queries.size();
+    result.settled = static_cast<double>(settled) / queries.size();
+    return result;
+}
+
+/// @brief This compares the one directional Dijkstra, bidirectional Dijkstra and ALT searches over a range of graph sizes, reporting
+///        both the query time and how many locations each search settles
+int main(int argc, char* argv[])
+{
+    const std::vector<size_t> sizes = {1000, 4000, 16000, 64000, 256000};
+    const size_t query_count = argc > 1 ? std::stoul(argv[1]) : 200;
+
+    std::printf("%-10s %-8s %14s %10s %14s %10s %14s %10s\n", "locations", "queries", "dijkstra(us)", "settled", "bidir(us)", "settled", "alt(us)", "settled");
+    for (size_t size : sizes) {
+        const RouteGraph graph = benchmarks::GenerateRoadGraph(size);
+        const Landmarks landmarks(graph, DEFAULT_LANDMARK_COUNT);
+        DijkstraSearch<BinaryHeapQueue> dijkstra_search;
+        BidirectionalDijkstraSearch<BinaryHeapQueue> bidirectional_search;
+        AltSearch<BinaryHeapQueue> alt_search;
+
+        for (bool local : {true, false}) {
+            const auto queries = benchmarks::GenerateQueries(graph, query_count, local);
+
+            SearchResult dijkstra = BenchmarkSearch(dijkstra_search, [&](size_t start, size_t end) {
+                return dijkstra_search.RouteCost(graph, start, end);
+            }, queries);
+            SearchResult bidirectional = BenchmarkSearch(bidirectional_search, [&](size_t start, size_t end) {
+                return bidirectional_search.RouteCost(graph, start, end);
+            }, queries);
+            SearchResult alt = BenchmarkSearch(alt_search, [&](size_t start, size_t end) {
+                return alt_search.RouteCost(graph, landmarks, start, end);
+            }, queries);
+
+            std::printf("%-10zu %-8s %14.1f %10.0f %14.1f %10.0f %14.1f %10.0f%s\n", graph.LocationCount(), local ? "local" : "random",
+                dijkstra.time, dijkstra.settled, bidirectional.time, bidirectional.settled, alt.time, alt.settled,
+                (dijkstra.checksum == bidirectional.checksum && dijkstra.checksum == alt.checksum) ? "" : "  MISMATCH");
+        }
+    }
+    return 0;
+}
@@ -5,6 +5,7 @@
 #include "messages/MsgHeader.h"
 #include "messages/MsgLocations.h"
 #include "messages/MsgRoute.h"
+#include "messages/MsgRouteMatrix.h"
 #include "messages/MsgStatus.h"
 
 namespace messages {
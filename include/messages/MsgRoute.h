@@ -1,12 +1,14 @@
 #ifndef MSGROUTE_H_
 #define MSGROUTE_H_
 
+#include <cstdint>
 #include "messages/MsgHeader.h"
 
 namespace messages {
 
 const unsigned int MSG_ROUTE_REQUEST_ID = 105;
 const unsigned int MSG_ROUTE_RESPONSE_ID = 106;
+const size_t MSG_ROUTE_NO_ROUTE = SIZE_MAX;     /// This is the route cost sent when there is no route between the locations
 
 /// @brief This is the Route request data, to request a route calculation between a start and end location
 struct MsgRouteRequestData {
@@ -75,7 +77,7 @@ public:
 
 
     /// @brief This will set the route calculation cost in the data msg
-    /// @param index This is route calculation cost
+    /// @param index This is route calculation cost, MSG_ROUTE_NO_ROUTE if there is no route
     void SetCost(size_t cost) {
         m_msg.cost = cost;
     }
@@ -0,0 +1,134 @@
+#ifndef MSGROUTEMATRIX_H_
+#define MSGROUTEMATRIX_H_
+
+#include <climits>
+#include <cstring>
+#include "messages/MsgHeader.h"
+#include "messages/MsgRoute.h"
+
+namespace messages {
+
+const unsigned int MSG_ROUTE_MATRIX_REQUEST_ID = 107;
+const unsigned int MSG_ROUTE_MATRIX_RESPONSE_ID = 108;
+const size_t MSG_ROUTE_MATRIX_MAX_LOCATIONS = 16;   /// This is the most start (and end) locations a single route matrix request can hold
+
+/// @brief This is the Route Matrix request data, to request the route costs from each of a set of start locations to each of a set
+///        of end locations in one go
+struct MsgRouteMatrixRequestData {
+    size_t start_count;                                     /// This is the number of start locations set
+    size_t end_count;                                       /// This is the number of end locations set
+    size_t start_locations[MSG_ROUTE_MATRIX_MAX_LOCATIONS]; /// This is the index of each start location within the locations list
+    size_t end_locations[MSG_ROUTE_MATRIX_MAX_LOCATIONS];   /// This is the index of each end location within the locations list
+
+    MsgRouteMatrixRequestData() :
+    start_count(0),
+    end_count(0) {
+        memset(start_locations, 0, sizeof(start_locations));
+        memset(end_locations, 0, sizeof(end_locations));
+    }
+};
+
+/// @brief This is the Route Matrix request Msg
+class MsgRouteMatrixRequest : public MsgHeader {
+    MsgRouteMatrixRequestData m_msg;
+
+public: 
+    typedef std::shared_ptr<MsgRouteMatrixRequest> MsgPointer;      ///typedef for a derived message pointer
+
+    MsgRouteMatrixRequest() : 
+    MsgHeader(MSG_ROUTE_MATRIX_REQUEST_ID, sizeof(MsgRouteMatrixRequestData), 
+    (char* const)&m_msg), 
+    m_msg() {
+    }
+
+    /// @brief This will add a start location index to the data msg
+    /// @param index This is start location index
+    /// @return True if the location was added, False if the message is full
+    bool AddStartLocation(size_t index) {
+        if (m_msg.start_count < MSG_ROUTE_MATRIX_MAX_LOCATIONS) {
+            m_msg.start_locations[m_msg.start_count++] = index;
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief This will add an end location index to the data msg
+    /// @param index This is end location index
+    /// @return True if the location was added, False if the message is full
+    bool AddEndLocation(size_t index) {
+        if (m_msg.end_count < MSG_ROUTE_MATRIX_MAX_LOCATIONS) {
+            m_msg.end_locations[m_msg.end_count++] = index;
+            return true;
+        }
+        return false;
+    }
+
+    /// @brief This will get a pointer to the underlying data structure
+    /// @return Data structure pointer
+    const MsgRouteMatrixRequestData* const GetData() {
+        return &m_msg;
+    }
+};
+
+/// @brief This is the Route Matrix response data
+struct MsgRouteMatrixResponseData {
+    size_t start_count;     /// This is the number of start locations (rows) in the matrix
+    size_t end_count;       /// This is the number of end locations (columns) in the matrix
+    size_t costs[MSG_ROUTE_MATRIX_MAX_LOCATIONS * MSG_ROUTE_MATRIX_MAX_LOCATIONS];  /// This is the route costs, row by row
+
+    MsgRouteMatrixResponseData() :
+    start_count(0),
+    end_count(0) {
+        memset(costs, 0, sizeof(costs));
+    }
+};
+
+/// @brief This is the Route Matrix response Msg
+class MsgRouteMatrixResponse : public MsgHeader {
+    MsgRouteMatrixResponseData m_msg;
+
+public: 
+    typedef std::shared_ptr<MsgRouteMatrixResponse> MsgPointer;     ///typedef for a derived message pointer
+
+    MsgRouteMatrixResponse() : 
+    MsgHeader(MSG_ROUTE_MATRIX_RESPONSE_ID, sizeof(MsgRouteMatrixResponseData), 
+    (char* const)&m_msg), 
+    m_msg() {
+    }
+
+    /// @brief This will set the route costs in the data msg
+    /// @param start_count This is the number of start locations (rows)
+    /// @param end_count This is the number of end locations (columns)
+    /// @param costs This is the route costs, row by row
+    /// @param no_route_cost The route cost in costs that means there is no route, it is sent as MSG_ROUTE_NO_ROUTE
+    /// @return True if the costs were set, False if the matrix is too big for the message
+    bool SetCosts(size_t start_count, size_t end_count, const std::vector<unsigned int>& costs, unsigned int no_route_cost = UINT_MAX) {
+        if (start_count > MSG_ROUTE_MATRIX_MAX_LOCATIONS || end_count > MSG_ROUTE_MATRIX_MAX_LOCATIONS || costs.size() != start_count * end_count) {
+            return false;
+        }
+        m_msg.start_count = start_count;
+        m_msg.end_count = end_count;
+        std::transform(costs.begin(), costs.end(), m_msg.costs, [no_route_cost](unsigned int cost) -> size_t {
+            return cost == no_route_cost ? MSG_ROUTE_NO_ROUTE : cost;
+        });
+        return true;
+    }
+
+    /// @brief This will get a route cost from the data msg
+    /// @param start_i This is the position of the start location in the request
+    /// @param end_i This is the position of the end location in the request
+    /// @return The route cost, MSG_ROUTE_NO_ROUTE if there is no route
+    size_t GetCost(size_t start_i, size_t end_i) const {
+        return m_msg.costs[start_i * m_msg.end_count + end_i];
+    }
+
+    /// @brief This will get a pointer to the underlying data structure
+    /// @return Data structure pointer
+    const MsgRouteMatrixResponseData* const GetData() {
+        return &m_msg;
+    }
+};
+
+}
+
+#endif
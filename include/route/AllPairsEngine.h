@@ -0,0 +1,77 @@
+#ifndef ALLPAIRSENGINE_H
+#define ALLPAIRSENGINE_H
+
+#include <log4cxx/logger.h>
+#include <memory>
+#include <vector>
+#include "route/IRouteEngine.h"
+#include "route/ThreadPool.h"
+
+namespace route {
+
+const size_t DEFAULT_ALL_PAIRS_MAX_LOCATIONS = 4096;   /// This is the largest graph the all pairs engine will build a table for unless told otherwise (64MB)
+
+/// @brief This is a route engine that works out the route cost between every pair of locations when it is built, so each query is
+///        a lookup. The table is built with one Dijkstra search per start location, spread across the cores. The table grows with
+///        the square of the number of locations, so it is only meant for small graphs, and its factory refuses anything bigger
+///        than a set size
+class AllPairsEngine : public IRouteEngine {
+    static log4cxx::LoggerPtr m_logger;
+    std::shared_ptr<const RouteGraph> m_graph;
+    size_t m_location_count;
+    std::vector<unsigned int> m_route_costs;    /// The route cost between each pair of locations, indexed [start * count + end]
+    ThreadPool& m_thread_pool;                  /// The pool the rows of the table are worked out on
+
+    /// @brief class constructor, for a table that has already been worked out
+    /// @param graph The route graph snapshot the table is for
+    /// @param route_costs The table
+    /// @param thread_pool The thread pool to work out rows of the table on
+    AllPairsEngine(std::shared_ptr<const RouteGraph> graph, std::vector<unsigned int>&& route_costs, ThreadPool& thread_pool);
+
+    /// @brief This works out some rows of the table again from scratch, spread across the cores on the thread pool
+    /// @param start_ids The start location of each row
+    void FillRows(const std::vector<LocationId>& start_ids);
+
+public:
+    /// @brief class constructor, this builds the table
+    /// @param graph The route graph snapshot to build the table for
+    /// @param thread_pool The thread pool to build the table on, and to repair it on for a change, it must outlive the engine
+    AllPairsEngine(std::shared_ptr<const RouteGraph> graph, ThreadPool& thread_pool = ThreadPool::Shared());
+
+    unsigned int GetRouteCost(LocationId start_id, LocationId end_id) const override {
+        return m_route_costs[start_id * m_location_count + end_id];
+    }
+
+    std::vector<unsigned int> GetRouteCosts(const std::vector<LocationId>& start_ids, const std::vector<LocationId>& end_ids) const override {
+        std::vector<unsigned int> route_costs;
+        route_costs.reserve(start_ids.size() * end_ids.size());
+        for (LocationId start_id : start_ids) {
+            const unsigned int* row = &m_route_costs[start_id * m_location_count];
+            for (LocationId end_id : end_ids) {
+                route_costs.push_back(row[end_id]);
+            }
+        }
+        return route_costs;
+    }
+
+    /// @brief This repairs a copy of the table for the change rather than building it again. A cheaper location or a new route can
+    ///        only make routes cheaper, so each entry is checked against the route through the change. A dearer location or a
+    ///        removed route can only make routes dearer, and only for the start locations with a cheapest route through the change,
+    ///        so only those rows are worked out again
+    RouteEnginePtr ApplyChange(std::shared_ptr<const RouteGraph> graph, const RouteChange& change) const override;
+
+    /// @brief Getter for the memory used by the table
+    /// @return The size of the table in bytes
+    size_t MemoryBytes() const {
+        return m_route_costs.size() * sizeof(unsigned int);
+    }
+
+    /// @brief Getter for a factory that builds this engine
+    /// @param max_locations The factory refuses (returns null for) graphs with more locations than this
+    /// @return The engine factory
+    static RouteEngineFactory Factory(size_t max_locations = DEFAULT_ALL_PAIRS_MAX_LOCATIONS);
+};
+
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef ALTENGINE_H
+#define ALTENGINE_H
+
+#include <memory>
+#include "route/AltSearch.h"
+#include "route/IRouteEngine.h"
+#include "route/Landmarks.h"
+
+namespace route {
+
+const size_t DEFAULT_LANDMARK_COUNT = 8;   /// This is the number of landmarks the ALT engine picks unless told otherwise
+
+/// @brief This is an ALT route engine, it picks the landmarks when it is built and answers each query with an ALT search (see
+///        route/AltSearch.h). The preprocessing is one forward and one backward search per landmark, and the memory is two route costs
+///        per landmark per location, which makes it a good fit for graphs too big to contract but where plain Dijkstra is too slow
+class AltEngine : public IRouteEngine {
+    std::shared_ptr<const RouteGraph> m_graph;
+    Landmarks m_landmarks;
+
+public:
+    /// @brief class constructor
+    /// @param graph The route graph snapshot to search over
+    /// @param landmark_count The number of landmarks to pick
+    AltEngine(std::shared_ptr<const RouteGraph> graph, size_t landmark_count = DEFAULT_LANDMARK_COUNT);
+
+    unsigned int GetRouteCost(LocationId start_id, LocationId end_id) const override;
+
+    /// @brief Getter for the landmarks picked for the route graph
+    /// @return The landmarks
+    const Landmarks& GetLandmarks() const {
+        return m_landmarks;
+    }
+
+    /// @brief Getter for a factory that builds this engine
+    /// @param landmark_count The number of landmarks to pick
+    /// @return The engine factory
+    static RouteEngineFactory Factory(size_t landmark_count = DEFAULT_LANDMARK_COUNT);
+};
+
+}
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef ALTSEARCH_H
+#define ALTSEARCH_H
+
+#include <vector>
+#include "route/Landmarks.h"
+#include "route/PriorityQueue.h"
+#include "route/RouteGraph.h"
+#include "route/SearchWorkspace.h"
+
+namespace route {
+
+/// @brief This is an ALT (A*, landmarks, triangle inequality) shortest route search. It is Dijkstra with each location queued at its
+///        route cost plus a lower bound on the rest of the route to the end, taken from the landmarks, so the search heads towards
+///        the end rather than spreading out evenly. The landmark bound never drops by more than a route's cost along the route, so
+///        each location is still settled at its lowest route cost and is settled once
+/// @tparam QueueType The priority queue policy to use
+template <typename QueueType = BinaryHeapQueue>
+class AltSearch {
+    QueueType m_queue;
+    SearchWorkspace m_workspace;                /// The current route costs from the start to each location, and which are settled
+    std::vector<unsigned int> m_lower_bounds;   /// The lower bound from each location to the end, worked out when it is first reached.
+                                                /// This is only read for locations reached by the current search so it is never reset
+    size_t m_settled_count;                     /// The number of locations settled by the last search
+
+public:
+    AltSearch() :
+    m_settled_count(0) {
+    }
+
+    /// @brief Getter for the number of locations the last search settled, this is a measure of how much of the graph it explored
+    /// @return The number of settled locations
+    size_t SettledCount() const {
+        return m_settled_count;
+    }
+
+    /// @brief This will find the lowest route cost between two locations. The cost of a route is the sum of the costs of each location
+    ///        entered after the start, the search stops as soon as the end location is settled
+    /// @param graph The route graph to search over
+    /// @param landmarks The landmarks for the route graph
+    /// @param start_id The id of the start location
+    /// @param end_id The id of the end location
+    /// @return The route cost, or ROUTE_COST_UNREACHABLE if there is no route
+    unsigned int RouteCost(const RouteGraph& graph, const Landmarks& landmarks, LocationId start_id, LocationId end_id) {
+        m_workspace.Reset(graph.LocationCount());
+        if (m_lower_bounds.size() < graph.LocationCount()) {
+            m_lower_bounds.resize(graph.LocationCount());
+        }
+        m_queue.Reset(graph.LocationCount());
+        m_settled_count = 0;
+
+        m_lower_bounds[start_id] = landmarks.LowerBound(start_id, end_id);
+        if (m_lower_bounds[start_id] == ROUTE_COST_UNREACHABLE) {
+            return ROUTE_COST_UNREACHABLE;
+        }
+        m_workspace.SetRouteCost(start_id, 0);
+        m_queue.Push(start_id, m_lower_bounds[start_id]);
+
+        while (!m_queue.Empty()) {
+            QueueEntry min_cost = m_queue.Pop();
+
+            // Heaps without decrease-key can hold older, more expensive, entries for a location that has already been settled
+            if (m_workspace.Settled(min_cost.index)) {
+                continue;
+            }
+            m_workspace.Settle(min_cost.index);
+            ++m_settled_count;
+
+            if (min_cost.index == end_id) {
+                break;
+            }
+
+            const unsigned int base_cost = m_workspace.RouteCost(min_cost.index);
+            const uint32_t routes_end = graph.RoutesEnd(min_cost.index);
+            for (uint32_t route_i = graph.RoutesBegin(min_cost.index); route_i < routes_end; ++route_i) {
+                const LocationId adjacent = graph.Destination(route_i);
+                const unsigned int adjacent_cost = base_cost + graph.RouteCost(route_i);
+                const unsigned int route_cost = m_workspace.RouteCost(adjacent);
+                if (adjacent_cost >= route_cost || m_workspace.Settled(adjacent)) {
+                    continue;
+                }
+                if (route_cost == ROUTE_COST_UNREACHABLE) {
+                    m_lower_bounds[adjacent] = landmarks.LowerBound(adjacent, end_id);
+                }
+                // Locations the landmarks show can't reach the end are never queued
+                if (m_lower_bounds[adjacent] != ROUTE_COST_UNREACHABLE) {
+                    m_workspace.SetRouteCost(adjacent, adjacent_cost);
+                    m_queue.Push(adjacent, adjacent_cost + m_lower_bounds[adjacent]);
+                }
+            }
+        }
+
+        return m_workspace.RouteCost(end_id);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+
+#include <log4cxx/logger.h>
+#include <functional>
+#include <ostream>
+#include <string>
+
+namespace route {
+
+/// @brief This saves a binary file so a reader never sees half of it. The file is written to the side and renamed over the file once
+///        it is all written, and the file written to the side is removed again if any part of that fails
+class AtomicFile {
+    static log4cxx::LoggerPtr m_logger;
+public:
+    /// @brief This saves a file
+    /// @param path The path of the file
+    /// @param description What the file is, for the log
+    /// @param write_function This is called with the stream to write the contents to, the stream can be seeked to go back over them
+    /// @return True on success, False if the file couldn't be written
+    static bool Save(const std::string& path, const std::string& description, const std::function<void(std::ostream&)>& write_function);
+};
+
+}
+
+#endif
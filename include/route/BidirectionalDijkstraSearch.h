@@ -0,0 +1,114 @@
+#ifndef BIDIRECTIONALDIJKSTRASEARCH_H
+#define BIDIRECTIONALDIJKSTRASEARCH_H
+
+#include <vector>
+#include "route/PriorityQueue.h"
+#include "route/RouteGraph.h"
+#include "route/SearchWorkspace.h"
+
+namespace route {
+
+/// @brief This is a bidirectional Dijkstra shortest route search. A forward search runs from the start location over the routes, and a
+///        backward search runs from the end location over the reverse routes, taking turns until the two meet.
+///        Route costs are charged on entering a location, so a route is the same as an edge weighted by its destination's cost. The
+///        backward search uses those same edge weights (see RouteGraph::ReverseRouteCost()), which keeps the usual stopping rule exact:
+///        once the last settled forward cost plus the last settled backward cost reaches the best meeting cost found, no route through
+///        an unsettled location can be cheaper
+/// @tparam QueueType The priority queue policy to use
+template <typename QueueType = BinaryHeapQueue>
+class BidirectionalDijkstraSearch {
+    /// @brief This is the state of one of the two searches
+    struct Side {
+        QueueType queue;
+        SearchWorkspace workspace;              /// The current route costs from this side's root to each location, and which are settled
+        unsigned int radius;                    /// The cost of the last location this side settled
+
+        void Reset(size_t location_count, LocationId root) {
+            workspace.Reset(location_count);
+            queue.Reset(location_count);
+            radius = 0;
+            workspace.SetRouteCost(root, 0);
+            queue.Push(root, 0);
+        }
+    };
+
+    Side m_forward;
+    Side m_backward;
+    size_t m_settled_count; /// The number of locations settled (by either side) by the last search
+
+    /// @brief This settles the next location on one side and relaxes its routes, updating the best meeting cost
+    /// @return False if the side has nothing left to settle
+    template <bool Forward>
+    bool Step(const RouteGraph& graph, Side& side, const Side& other, unsigned int& best_cost) {
+        while (!side.queue.Empty()) {
+            QueueEntry min_cost = side.queue.Pop();
+            if (side.workspace.Settled(min_cost.index)) {
+                continue;
+            }
+            side.workspace.Settle(min_cost.index);
+            side.radius = min_cost.cost;
+            ++m_settled_count;
+
+            const unsigned int base_cost = side.workspace.RouteCost(min_cost.index);
+            const uint32_t routes_end = Forward ? graph.RoutesEnd(min_cost.index) : graph.ReverseRoutesEnd(min_cost.index);
+            for (uint32_t route_i = Forward ? graph.RoutesBegin(min_cost.index) : graph.ReverseRoutesBegin(min_cost.index); route_i < routes_end; ++route_i) {
+                const LocationId adjacent = Forward ? graph.Destination(route_i) : graph.Origin(route_i);
+                const unsigned int adjacent_cost = base_cost + (Forward ? graph.RouteCost(route_i) : graph.ReverseRouteCost(route_i));
+                if (side.workspace.Relax(adjacent, adjacent_cost)) {
+                    side.queue.Push(adjacent, adjacent_cost);
+                }
+                // Any route the other side has already reached is a candidate meeting point
+                const unsigned int other_cost = other.workspace.RouteCost(adjacent);
+                if (other_cost != ROUTE_COST_UNREACHABLE && adjacent_cost + other_cost < best_cost) {
+                    best_cost = adjacent_cost + other_cost;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+public:
+    BidirectionalDijkstraSearch() :
+    m_settled_count(0) {
+    }
+
+    /// @brief Getter for the number of locations the last search settled, this is a measure of how much of the graph it explored
+    /// @return The number of settled locations, counting those settled by both sides twice
+    size_t SettledCount() const {
+        return m_settled_count;
+    }
+
+    /// @brief This will find the lowest route cost between two locations. The cost of a route is the sum of the costs of each location
+    ///        entered after the start
+    /// @param graph The route graph to search over
+    /// @param start_id The id of the start location
+    /// @param end_id The id of the end location
+    /// @return The route cost, or ROUTE_COST_UNREACHABLE if there is no route
+    unsigned int RouteCost(const RouteGraph& graph, LocationId start_id, LocationId end_id) {
+        m_settled_count = 0;
+        if (start_id == end_id) {
+            return 0;
+        }
+
+        m_forward.Reset(graph.LocationCount(), start_id);
+        m_backward.Reset(graph.LocationCount(), end_id);
+
+        unsigned int best_cost = ROUTE_COST_UNREACHABLE;
+        bool forward_turn = true;
+        while (static_cast<unsigned long long>(m_forward.radius) + m_backward.radius < best_cost) {
+            // Once either side runs out every location it can reach is settled, so the best meeting cost can't improve
+            bool stepped = forward_turn ? Step<true>(graph, m_forward, m_backward, best_cost) : Step<false>(graph, m_backward, m_forward, best_cost);
+            if (!stepped) {
+                break;
+            }
+            forward_turn = !forward_turn;
+        }
+
+        return best_cost;
+    }
+};
+
+}
+
+#endif
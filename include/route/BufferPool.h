@@ -0,0 +1,172 @@
+#ifndef BUFFERPOOL_H
+#define BUFFERPOOL_H
+
+#include <log4cxx/logger.h>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace route {
+
+/// @brief These are the counters of a buffer pool, since it was opened
+struct BufferPoolCounters {
+    uint64_t hits;              /// Fetches of a page already in the pool
+    uint64_t misses;            /// Fetches that had to read the page from the file
+    uint64_t evictions;         /// Pages dropped from the pool to make room for another
+    uint64_t prefetches;        /// Pages the operating system was asked to read ahead
+    uint64_t bytes_read;        /// Bytes read from the file
+    uint64_t read_errors;       /// Pages that couldn't be read or failed their check, they aren't kept in the pool
+
+    /// @brief Getter for the share of fetches answered from the pool
+    /// @return The hit rate, 0 if there have been no fetches
+    double HitRate() const {
+        return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0;
+    }
+};
+
+/// @brief This is a bounded cache of the fixed size pages of a file, for files too big to keep in memory. The pages are read into a
+///        fixed number of frames with pread(). When all the frames are in use a frame is chosen to be reused with the clock algorithm:
+///        a hand sweeps round the frames, a frame fetched since the hand last passed gets a second chance and is passed over, the
+///        first one that hasn't been is reused. A fetched page is pinned until its handle is dropped, a pinned frame is never reused.
+///        Fetches are safe to make from many threads at once, a page is only read once however many threads want it
+class BufferPool {
+    static log4cxx::LoggerPtr m_logger;
+    static constexpr uint32_t NO_FRAME = UINT32_MAX;
+
+    /// @brief This is one frame of the pool
+    struct Frame {
+        uint32_t page_id;       /// The page in the frame, NO_FRAME if it is empty
+        uint32_t pin_count;     /// The number of handles to the page
+        bool referenced;        /// Set when the page is fetched, cleared as the clock hand passes
+        bool loading;           /// Set while the page is being read
+    };
+
+public:
+    /// @brief This checks a page as it is read, a page that fails isn't kept in the pool
+    typedef std::function<bool(uint32_t page_id, const uint32_t* words)> PageCheck;
+
+    /// @brief This is a pinned page, the page stays in its frame until the handle is dropped
+    class PageHandle {
+        BufferPool* m_pool;
+        uint32_t m_frame_i;
+        const uint32_t* m_words;
+
+        friend class BufferPool;
+
+        PageHandle(BufferPool* pool, uint32_t frame_i, const uint32_t* words) :
+        m_pool(pool),
+        m_frame_i(frame_i),
+        m_words(words) {
+        }
+
+        PageHandle(const PageHandle& other); //copying of the page handle is dissalowed
+    public:
+        PageHandle(PageHandle&& other) :
+        m_pool(other.m_pool),
+        m_frame_i(other.m_frame_i),
+        m_words(other.m_words) {
+            other.m_pool = nullptr;
+        }
+
+        ~PageHandle() {
+            if (m_pool) {
+                m_pool->Unpin(m_frame_i);
+            }
+        }
+
+        /// @brief Getter for the contents of the page, as 32 bit words
+        /// @return The words of the page, or nullptr if it couldn't be read
+        const uint32_t* Words() const {
+            return m_words;
+        }
+    };
+
+private:
+    const std::string m_path;
+    int m_file;                             /// The file the pages are read from, -1 if it couldn't be opened
+    const uint64_t m_first_page_offset;     /// The offset of the first page in the file
+    const size_t m_page_size;
+    const PageCheck m_page_check;
+    std::vector<uint32_t> m_frame_words;    /// The contents of every frame, one after the other
+    std::vector<Frame> m_frames;
+    std::vector<uint32_t> m_page_frames;    /// The frame each page is in, NO_FRAME if it isn't in the pool
+    size_t m_clock_hand;                    /// The next frame the clock looks at
+    BufferPoolCounters m_counters;
+    mutable std::mutex m_mutex;             /// This guards everything but the contents of the frames, a pinned frame's contents don't change
+    std::condition_variable m_frame_changed;    /// Signalled when a page has been read or a frame unpinned
+
+    BufferPool(const BufferPool& other); //copying of the buffer pool is dissalowed
+
+    /// @brief This finds a frame to read a page into, an empty frame or else one chosen by the clock. This must be called with
+    ///        m_mutex held
+    /// @return The frame, or NO_FRAME if every frame is pinned
+    uint32_t ChooseFrame();
+
+    /// @brief This reads a page into a frame
+    /// @param page_id The page to read
+    /// @param words The frame to read it into
+    /// @return True if the page was read, False if it couldn't be read or failed the page check
+    bool ReadPage(uint32_t page_id, uint32_t* words);
+
+    /// @brief This drops a pin on a frame
+    /// @param frame_i The frame
+    void Unpin(uint32_t frame_i);
+public:
+    /// @brief class constructor, this opens the file
+    /// @param path The path of the file
+    /// @param first_page_offset The offset of the first page in the file
+    /// @param page_size The size of a page, a multiple of 4 bytes
+    /// @param page_count The number of pages in the file
+    /// @param frame_count The number of pages the pool holds at once, at least one
+    /// @param page_check This checks each page as it is read
+    BufferPool(const std::string& path, uint64_t first_page_offset, size_t page_size, uint32_t page_count, size_t frame_count, PageCheck page_check);
+
+    /// @brief class destructor, this closes the file
+    ~BufferPool();
+
+    /// @brief Getter for whether the file could be opened
+    /// @return True if it was opened, False if not
+    bool IsOpen() const {
+        return m_file >= 0;
+    }
+
+    /// @brief This gets a page, reading it from the file if it isn't already in the pool. If every frame is pinned this waits for
+    ///        one to be unpinned, so a thread must not hold more handles than there are frames
+    /// @param page_id The page, it must be in the file
+    /// @return The pinned page. If the page couldn't be read or failed its check its words are nullptr, and its frame is left
+    ///         empty so the page is read again the next time it is fetched
+    PageHandle Fetch(uint32_t page_id);
+
+    /// @brief This asks the operating system to start reading a page ahead of it being fetched, unless it is already in the pool. It
+    ///        doesn't wait for the read or take a frame
+    /// @param page_id The page, it must be in the file
+    void Prefetch(uint32_t page_id);
+
+    /// @brief Check if a page is in the pool
+    /// @param page_id The page
+    /// @return True if it is, False if not
+    bool Resident(uint32_t page_id) const;
+
+    /// @brief Getter for the counters of the pool
+    /// @return The counters
+    BufferPoolCounters Counters() const;
+
+    /// @brief Getter for the number of frames
+    /// @return The frame count
+    size_t FrameCount() const {
+        return m_frames.size();
+    }
+
+    /// @brief Getter for the page size
+    /// @return The page size in bytes
+    size_t PageSize() const {
+        return m_page_size;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef CONTRACTIONHIERARCHYENGINE_H
+#define CONTRACTIONHIERARCHYENGINE_H
+
+#include <log4cxx/logger.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "route/IRouteEngine.h"
+#include "route/PriorityQueue.h"
+#include "route/RouteGraph.h"
+
+namespace route {
+
+/// @brief This is a Contraction Hierarchies route engine. When it is built every location is given a rank, and locations are contracted
+///        (removed) in rank order, adding a shortcut route between a pair of neighbours whenever the only cheapest route between them
+///        ran through the contracted location. A query is then a bidirectional search that only ever moves up the ranks, which touches a
+///        tiny part of the graph.
+///        Preprocessing works on the route graph's edge weights, the cost of a route being the cost of the location it enters, so a
+///        shortcut's cost is the sum of the location costs along the routes it replaces and the location cost model is kept exactly
+class ContractionHierarchyEngine : public IRouteEngine {
+    static log4cxx::LoggerPtr m_logger;
+
+    /// @brief This is the search graph for one direction of the query, in compressed sparse row form. Each location only holds the
+    ///        routes (and shortcuts) going to higher ranked locations
+    struct UpwardGraph {
+        std::vector<uint32_t> offsets;          /// This is the offset of the first route of each location, with one extra at the end
+        std::vector<LocationId> targets;        /// This is the location at the other end of each route
+        std::vector<unsigned int> costs;        /// This is the cost of each route
+    };
+
+    std::shared_ptr<const RouteGraph> m_graph;
+    std::vector<uint32_t> m_ranks;  /// This is the contraction rank of each location
+    UpwardGraph m_forward;          /// The upward routes leaving each location, searched from the start
+    UpwardGraph m_backward;         /// The upward routes entering each location, searched backwards from the end
+    size_t m_shortcut_count;        /// The number of shortcuts added by the contraction
+
+    void Build();
+
+    /// @brief This is the state of one side of a query. The arrays are sized to the graph, but only the locations in touched are reset
+    ///        between queries as the search space is a tiny part of the graph
+    struct SearchSide {
+        BinaryHeapQueue queue;
+        std::vector<unsigned int> route_costs;
+        std::vector<bool> settled;
+        std::vector<LocationId> touched;
+
+        void Reset(size_t location_count);
+        void SetRouteCost(LocationId location_id, unsigned int route_cost);
+    };
+
+    /// @brief This is the state of both sides of a query, they are pooled so concurrent queries each get their own
+    struct Workspace {
+        SearchSide forward;
+        SearchSide backward;
+    };
+
+    mutable std::mutex m_workspaces_mutex;
+    mutable std::vector<std::unique_ptr<Workspace>> m_workspaces;   /// The workspaces not in use by a query
+
+    /// @brief This settles the next location on one side of the query, moving up the hierarchy, and updates the best meeting cost
+    /// @param graph The upward graph for this side
+    /// @param stall_graph The upward graph for the other side, used to spot locations reached more cheaply from above
+    /// @param side The state of this side
+    /// @param other The state of the other side
+    /// @param best_cost The best route cost found so far
+    /// @return False once this side is finished
+    bool Step(const UpwardGraph& graph, const UpwardGraph& stall_graph, SearchSide& side, const SearchSide& other, unsigned int& best_cost) const;
+public:
+    /// @brief class constructor, this runs the contraction so can take a while on a large graph
+    /// @param graph The route graph snapshot to build the hierarchy for
+    ContractionHierarchyEngine(std::shared_ptr<const RouteGraph> graph);
+
+    unsigned int GetRouteCost(LocationId start_id, LocationId end_id) const override;
+
+    /// @brief Getter for the number of shortcuts the contraction added
+    /// @return The shortcut count
+    size_t ShortcutCount() const {
+        return m_shortcut_count;
+    }
+
+    /// @brief Getter for the contraction rank of a location, higher ranked locations were contracted later
+    /// @param location_id The id of the location
+    /// @return The rank
+    uint32_t Rank(LocationId location_id) const {
+        return m_ranks[location_id];
+    }
+
+    /// @brief Getter for a factory that builds this engine
+    /// @return The engine factory
+    static RouteEngineFactory Factory();
+};
+
+}
+
+#endif
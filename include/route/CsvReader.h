@@ -0,0 +1,139 @@
+#ifndef CSVREADER_H
+#define CSVREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "route/MappedFile.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace route {
+
+const size_t CSV_SCAN_BLOCK_SIZE = 64;  /// This is the number of characters scanned for delimiters in one go, one bit each in a 64 bit mask
+
+/// @brief This splits comma separated rows held in memory into their fields, as trimmed string views into the memory rather than
+///        copies. The delimiters (commas and newlines) are found CSV_SCAN_BLOCK_SIZE characters at a time: each block is compared
+///        against both delimiters with SSE2 where it is available, giving a mask with a bit set for each delimiter in the block,
+///        and the fields are then cut at each set bit in turn. A row is split in the same way as trimming it and reading it with
+///        std::getline(stream, field, ','), so a comma at the end of a row doesn't add an empty field and blank rows are skipped
+class CsvReader {
+    const char* m_end;          /// The end of the contents
+    const char* m_position;     /// The start of the next row
+    const char* m_block;        /// The start of the block m_mask is for
+    uint64_t m_mask;            /// The delimiters in the block not yet used, one bit per character
+    std::string_view m_row;     /// The last row read
+
+    /// @brief This builds the delimiter mask for the block at m_block
+    void ScanBlock() {
+        m_mask = 0;
+        const char* const block_end = m_end - m_block < static_cast<std::ptrdiff_t>(CSV_SCAN_BLOCK_SIZE) ? m_end : m_block + CSV_SCAN_BLOCK_SIZE;
+        size_t character_i = 0;
+#ifdef __SSE2__
+        if (block_end == m_block + CSV_SCAN_BLOCK_SIZE) {
+            const __m128i commas = _mm_set1_epi8(',');
+            const __m128i newlines = _mm_set1_epi8('\n');
+            for (; character_i < CSV_SCAN_BLOCK_SIZE; character_i += sizeof(__m128i)) {
+                const __m128i characters = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_block + character_i));
+                const __m128i delimiters = _mm_or_si128(_mm_cmpeq_epi8(characters, commas), _mm_cmpeq_epi8(characters, newlines));
+                m_mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(delimiters))) << character_i;
+            }
+        }
+#endif
+        for (; m_block + character_i < block_end; ++character_i) {
+            const char character = m_block[character_i];
+            if (character == ',' || character == '\n') {
+                m_mask |= uint64_t(1) << character_i;
+            }
+        }
+    }
+
+    /// @brief This finds the next delimiter
+    /// @return The delimiter, or m_end if there are none left
+    const char* NextDelimiter() {
+        while (!m_mask) {
+            if (m_end - m_block <= static_cast<std::ptrdiff_t>(CSV_SCAN_BLOCK_SIZE)) {
+                m_block = m_end;
+                return m_end;
+            }
+            m_block += CSV_SCAN_BLOCK_SIZE;
+            ScanBlock();
+        }
+        const char* const delimiter = m_block + __builtin_ctzll(m_mask);
+        m_mask &= m_mask - 1;
+        return delimiter;
+    }
+public:
+    /// @brief class constructor
+    /// @param contents The rows, these must outlive the reader and the fields it reads
+    CsvReader(std::string_view contents);
+
+    /// @brief This reads the next row that isn't blank
+    /// @param fields This is set to the fields of the row, trimmed of white space
+    /// @return True if a row was read, False at the end of the contents
+    bool NextRow(std::vector<std::string_view>& fields) {
+        while (m_position < m_end) {
+            const char* const row_begin = m_position;
+            const char* field_begin = m_position;
+            fields.clear();
+            for (;;) {
+                const char* const delimiter = NextDelimiter();
+                fields.push_back(Trim(std::string_view(field_begin, delimiter - field_begin)));
+                if (delimiter == m_end || *delimiter == '\n') {
+                    m_position = delimiter == m_end ? m_end : delimiter + 1;
+                    m_row = Trim(std::string_view(row_begin, delimiter - row_begin));
+                    break;
+                }
+                field_begin = delimiter + 1;
+            }
+            if (fields.size() > 1 && fields.back().empty()) {
+                fields.pop_back();
+            }
+            if (!m_row.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Getter for the last row read, trimmed of white space, useful for reporting a row that couldn't be parsed
+    /// @return The row
+    std::string_view Row() const {
+        return m_row;
+    }
+
+    /// @brief This trims white space from both ends of a field
+    /// @param field The field
+    /// @return The trimmed field
+    static std::string_view Trim(std::string_view field) {
+        auto is_space = [](char character) -> bool {
+            return character == ' ' || character == '\t' || character == '\r' || character == '\n' || character == '\v' || character == '\f';
+        };
+        while (!field.empty() && is_space(field.front())) {
+            field.remove_prefix(1);
+        }
+        while (!field.empty() && is_space(field.back())) {
+            field.remove_suffix(1);
+        }
+        return field;
+    }
+
+    /// @brief This splits rows into chunks of around the given size, so they can be read by more than one reader at once. Each chunk
+    ///        but the last ends just after a newline, so no row is split between two chunks
+    /// @param contents The rows
+    /// @param chunk_size The size to aim for, a chunk runs on to the end of the row it would end in
+    /// @return The chunks in order, together they are the whole of the contents
+    static std::vector<std::string_view> SplitRows(std::string_view contents, size_t chunk_size);
+
+    /// @brief This parses a field as an unsigned number, the whole field must be the number
+    /// @param field The field
+    /// @param value This is set to the number on success
+    /// @return True on success, False if the field isn't a number
+    static bool ParseUnsigned(std::string_view field, unsigned int& value);
+};
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef DELTASTEPPINGENGINE_H
+#define DELTASTEPPINGENGINE_H
+
+#include <atomic>
+#include <log4cxx/logger.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "route/IRouteEngine.h"
+#include "route/RouteGraph.h"
+#include "route/ThreadPool.h"
+
+namespace route {
+
+const size_t DEFAULT_DELTA_STEPPING_MIN_LOCATIONS = 1000000;   /// Graphs smaller than this are searched with plain Dijkstra instead
+
+/// @brief This is a delta-stepping route engine, a shortest route search that relaxes many locations at once on a pool of threads.
+///        Locations are kept in buckets of route costs delta wide instead of a priority queue, and every location in the lowest
+///        bucket is relaxed in parallel. Routes no more expensive than delta (light routes) can put a location back into the bucket
+///        being worked on, so those are relaxed over and over until it empties, and the rest (heavy routes) are relaxed once after.
+///        Only a handful of buckets can hold anything at once, as no route costs more than the most expensive route, so the buckets
+///        are a small ring that is reused as the search moves up.
+///        The search stops once the end locations can't get any cheaper. A query spreads its relaxing across the thread pool, it's
+///        meant for graphs so big that a single query wants every core. Concurrent queries each search with a workspace of their own,
+///        and one that finds the pool busy relaxes on its own thread
+class DeltaSteppingEngine : public IRouteEngine {
+    static log4cxx::LoggerPtr m_logger;
+
+    /// @brief This is the state of a search, kept between queries. Only the locations a search touched are reset after it
+    struct Workspace {
+        std::vector<std::atomic<unsigned int>> route_costs;     /// The current route cost from the start to each location
+        std::vector<uint32_t> buckets_of;                       /// The bucket each location is queued in, NO_BUCKET if it isn't queued
+        std::vector<std::vector<LocationId>> buckets;           /// The ring of buckets, bucket b is at [b % buckets.size()]
+        std::vector<LocationId> frontier;                       /// The locations being relaxed from the current bucket
+        std::vector<LocationId> settled;                        /// Every location taken from the current bucket, for the heavy routes
+        std::vector<std::vector<LocationId>> updated;           /// The locations each worker lowered the route cost of
+        std::vector<std::vector<LocationId>> touched;           /// The locations each worker reached for the first time
+    };
+
+    std::shared_ptr<const RouteGraph> m_graph;
+    unsigned int m_delta;                       /// The width of each bucket in route cost
+    size_t m_bucket_count;                      /// The number of buckets in the ring of each workspace
+    ThreadPool& m_thread_pool;                  /// The pool the routes are relaxed on
+    mutable std::mutex m_mutex;
+    mutable std::vector<std::unique_ptr<Workspace>> m_workspaces;   /// The workspaces not in use by a query
+
+    /// @brief This takes a workspace for a query, one left by an earlier query or a new one if they are all in use
+    /// @return The workspace, to be handed back with ReleaseWorkspace
+    std::unique_ptr<Workspace> AcquireWorkspace() const;
+
+    /// @brief This hands a workspace back once the query is done with it, it must have been reset
+    /// @param workspace The workspace
+    void ReleaseWorkspace(std::unique_ptr<Workspace> workspace) const;
+
+    /// @brief This runs the search from a start location until every one of the end locations has its lowest route cost
+    /// @param workspace The workspace of the query
+    /// @param start_id The id of the start location
+    /// @param end_ids The ids of the end locations
+    void Search(Workspace& workspace, LocationId start_id, const std::vector<LocationId>& end_ids) const;
+
+    /// @brief This relaxes the light or heavy routes leaving a set of locations, spread across the thread pool
+    /// @param workspace The workspace of the query
+    /// @param locations The locations to relax the routes of
+    /// @param light True to relax the routes no more expensive than delta, False for the rest
+    void Relax(Workspace& workspace, const std::vector<LocationId>& locations, bool light) const;
+
+    /// @brief This puts every location whose route cost was lowered by Relax into the bucket for its new route cost
+    /// @param workspace The workspace of the query
+    /// @return The number of locations added to a bucket
+    size_t Enqueue(Workspace& workspace) const;
+
+    /// @brief This resets the locations the last search touched
+    /// @param workspace The workspace of the query
+    void Reset(Workspace& workspace) const;
+public:
+    /// @brief class constructor
+    /// @param graph The route graph snapshot to search over
+    /// @param delta The bucket width, 0 picks the average route cost
+    /// @param thread_pool The pool to relax routes on
+    DeltaSteppingEngine(std::shared_ptr<const RouteGraph> graph, unsigned int delta = 0, ThreadPool& thread_pool = ThreadPool::Shared());
+
+    unsigned int GetRouteCost(LocationId start_id, LocationId end_id) const override;
+
+    std::vector<unsigned int> GetRouteCosts(const std::vector<LocationId>& start_ids, const std::vector<LocationId>& end_ids) const override;
+
+    /// @brief Getter for the bucket width
+    /// @return The bucket width in route cost
+    unsigned int Delta() const {
+        return m_delta;
+    }
+
+    /// @brief Getter for a factory that builds this engine for big graphs, and plain Dijkstra for the rest, as the cost of handing
+    ///        work between threads outweighs the gain until the graph is big
+    /// @param min_locations The smallest graph to use delta-stepping for
+    /// @param delta The bucket width, 0 picks the average route cost
+    /// @param thread_pool The pool the engines relax routes on, it must outlive them
+    /// @return The engine factory
+    static RouteEngineFactory Factory(size_t min_locations = DEFAULT_DELTA_STEPPING_MIN_LOCATIONS, unsigned int delta = 0, ThreadPool& thread_pool = ThreadPool::Shared());
+};
+
+}
+
+#endif
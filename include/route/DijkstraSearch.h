@@ -0,0 +1,277 @@
+#ifndef DIJKSTRASEARCH_H
+#define DIJKSTRASEARCH_H
+
+#include <vector>
+#include "route/PriorityQueue.h"
+#include "route/RouteGraph.h"
+#include "route/SearchWorkspace.h"
+
+namespace route {
+
+/// @brief This is a Dijkstra shortest route search, the priority queue it uses is a policy so different queues can be swapped in
+///        (see route/PriorityQueue.h). The search keeps its buffers between runs, and resets them by generation (see
+///        route/SearchWorkspace.h), so a repeated search only costs the locations it touches.
+///        A forward search also keeps its shortest path tree, so a later query from the same start location can read a location that
+///        is already settled, or carry on from where the search stopped (see ResumeRouteCost)
+/// @tparam QueueType The priority queue policy to use
+template <typename QueueType = BinaryHeapQueue>
+class DijkstraSearch {
+    QueueType m_queue;
+    SearchWorkspace m_workspace;                /// The current route costs between the search root and each location, and which are settled
+    std::vector<unsigned int> m_route_costs;    /// The route costs to every location, filled in by the full graph searches
+    std::vector<bool> m_end_set;                /// The end locations of a one to many search
+    std::vector<LocationId> m_settled_order;    /// The locations the shortest path tree held has settled, in the order it settled them
+    size_t m_settled_count;                     /// The number of locations settled by the last search
+    LocationId m_root_id;                       /// The start location of the shortest path tree held, INVALID_LOCATION_ID if there isn't one
+
+public:
+    DijkstraSearch() :
+    m_settled_count(0),
+    m_root_id(INVALID_LOCATION_ID) {
+    }
+
+    /// @brief Getter for the start location of the shortest path tree this search holds
+    /// @return The location id, or INVALID_LOCATION_ID if the last search was not a forward search
+    LocationId Root() const {
+        return m_root_id;
+    }
+
+    /// @brief Getter for the number of locations the last search settled, this is a measure of how much of the graph it explored
+    /// @return The number of settled locations
+    size_t SettledCount() const {
+        return m_settled_count;
+    }
+
+    /// @brief Check if the shortest path tree held has reached a location, that is, a route to it has been found
+    /// @param location_id The id of the location
+    /// @return True if reached, False if not or there is no tree
+    bool Reached(LocationId location_id) const {
+        return m_root_id != INVALID_LOCATION_ID && m_workspace.RouteCost(location_id) != ROUTE_COST_UNREACHABLE;
+    }
+
+    /// @brief Check if the shortest path tree held has settled a location, that is, its lowest route cost is known and its routes have
+    ///        been relaxed
+    /// @param location_id The id of the location
+    /// @return True if settled, False if not or there is no tree
+    bool Settled(LocationId location_id) const {
+        return m_root_id != INVALID_LOCATION_ID && m_workspace.Settled(location_id);
+    }
+
+    /// @brief This will find the lowest route cost between two locations. The cost of a route is the sum of the costs of each location
+    ///        entered after the start, the search stops as soon as the end location is settled
+    /// @param graph The route graph to search over
+    /// @param start_id The id of the start location
+    /// @param end_id The id of the end location
+    /// @return The route cost, or ROUTE_COST_UNREACHABLE if there is no route
+    unsigned int RouteCost(const RouteGraph& graph, LocationId start_id, LocationId end_id) {
+        Search<true>(graph, start_id, [end_id](LocationId location_id) -> bool {
+            return location_id == end_id;
+        });
+        return m_workspace.RouteCost(end_id);
+    }
+
+    /// @brief This will find the lowest route cost between two locations, like RouteCost, but reusing the shortest path tree held from
+    ///        the last search when it was from the same start location. If the end location is already settled this is an array read,
+    ///        if not the search carries on from where it stopped. The graph must be the one the tree was built over
+    /// @param graph The route graph to search over
+    /// @param start_id The id of the start location
+    /// @param end_id The id of the end location
+    /// @return The route cost, or ROUTE_COST_UNREACHABLE if there is no route
+    unsigned int ResumeRouteCost(const RouteGraph& graph, LocationId start_id, LocationId end_id) {
+        if (m_root_id != start_id) {
+            Start<true>(graph, start_id);
+        }
+        m_settled_count = 0;
+        if (!m_workspace.Settled(end_id)) {
+            Run<true>(graph, [end_id](LocationId location_id) -> bool {
+                return location_id == end_id;
+            });
+        }
+        return m_workspace.RouteCost(end_id);
+    }
+
+    /// @brief This repairs the shortest path tree held after a change to the route graph, so it can carry on over the changed graph.
+    ///        A location only affects the rest of the tree once it is settled and its routes relaxed, and any route through the change
+    ///        costs at least the route cost to where the change is. So the locations settled below that cost are kept as they are, the
+    ///        rest are dropped and the queue is built again from the routes leaving the kept locations
+    /// @param old_graph The route graph the tree was grown over
+    /// @param graph The route graph after the change
+    /// @param change The change
+    void Repair(const RouteGraph& old_graph, const RouteGraph& graph, const RouteChange& change) {
+        unsigned int keep_below = ROUTE_COST_UNREACHABLE;
+        if (change.type == RouteChange::LOCATION_COST) {
+            // A route back into the start location is never the cheapest way anywhere, so its cost doesn't matter to the tree
+            if (!Reached(change.start_id) || change.start_id == m_root_id) {
+                return;
+            }
+            // The route cost to the location moves with its cost. If it goes down, the location may now come before locations
+            // already settled, if it goes up only the locations settled through it are wrong
+            const unsigned int old_cost = old_graph.LocationCost(change.start_id);
+            const unsigned int cost_drop = old_cost > change.cost ? old_cost - change.cost : 0;
+            if (Settled(change.start_id) || cost_drop > 0) {
+                keep_below = m_workspace.RouteCost(change.start_id) - cost_drop;
+            }
+        }
+        else {
+            // A route leaving a location the tree hasn't settled has never been relaxed
+            if (!Settled(change.start_id)) {
+                return;
+            }
+            keep_below = m_workspace.RouteCost(change.start_id) + graph.LocationCost(change.end_id);
+        }
+
+        // The locations are settled in route cost order, so the ones to keep are the front of the settled order
+        size_t keep_count = 0;
+        while (keep_count < m_settled_order.size() && m_workspace.RouteCost(m_settled_order[keep_count]) < keep_below) {
+            ++keep_count;
+        }
+        std::vector<LocationId> kept_ids(m_settled_order.begin(), m_settled_order.begin() + keep_count);
+        std::vector<unsigned int> kept_costs(keep_count);
+        for (size_t kept_i = 0; kept_i < keep_count; ++kept_i) {
+            kept_costs[kept_i] = m_workspace.RouteCost(kept_ids[kept_i]);
+        }
+
+        Start<true>(graph, m_root_id);
+        for (size_t kept_i = 0; kept_i < keep_count; ++kept_i) {
+            m_workspace.SetRouteCost(kept_ids[kept_i], kept_costs[kept_i]);
+            m_workspace.Settle(kept_ids[kept_i]);
+            m_settled_order.push_back(kept_ids[kept_i]);
+        }
+        for (size_t kept_i = 0; kept_i < keep_count; ++kept_i) {
+            for (uint32_t route_i = graph.RoutesBegin(kept_ids[kept_i]); route_i < graph.RoutesEnd(kept_ids[kept_i]); ++route_i) {
+                const unsigned int adjacent_cost = kept_costs[kept_i] + graph.RouteCost(route_i);
+                if (m_workspace.Relax(graph.Destination(route_i), adjacent_cost)) {
+                    m_queue.Push(graph.Destination(route_i), adjacent_cost);
+                }
+            }
+        }
+    }
+
+    /// @brief This will find the lowest route cost from one location to each of a set of locations, with one search that stops as
+    ///        soon as all of them are settled
+    /// @param graph The route graph to search over
+    /// @param start_id The id of the start location
+    /// @param end_ids The ids of the end locations
+    /// @param route_costs This is set to the route cost to each end location, in the same order, ROUTE_COST_UNREACHABLE for those with
+    ///                    no route
+    void RouteCosts(const RouteGraph& graph, LocationId start_id, const std::vector<LocationId>& end_ids, unsigned int* route_costs) {
+        if (end_ids.empty()) {
+            return;
+        }
+        m_end_set.assign(graph.LocationCount(), false);
+        size_t remaining = 0;
+        for (LocationId end_id : end_ids) {
+            if (!m_end_set[end_id]) {
+                m_end_set[end_id] = true;
+                ++remaining;
+            }
+        }
+        Search<true>(graph, start_id, [this, &remaining](LocationId location_id) -> bool {
+            return m_end_set[location_id] && --remaining == 0;
+        });
+        for (size_t end_i = 0; end_i < end_ids.size(); ++end_i) {
+            route_costs[end_i] = m_workspace.RouteCost(end_ids[end_i]);
+        }
+    }
+
+    /// @brief This will find the lowest route cost from one location to every other location
+    /// @param graph The route graph to search over
+    /// @param start_id The id of the start location
+    /// @return The route cost to each location indexed by id, ROUTE_COST_UNREACHABLE for those with no route. This stays valid until
+    ///         the next search
+    const std::vector<unsigned int>& RouteCostsFrom(const RouteGraph& graph, LocationId start_id) {
+        Search<true>(graph, start_id, [](LocationId) -> bool {
+            return false;
+        });
+        return FillRouteCosts(graph);
+    }
+
+    /// @brief This will find the lowest route cost from every location to one location, searching backwards over the reverse routes
+    /// @param graph The route graph to search over
+    /// @param end_id The id of the end location
+    /// @return The route cost from each location indexed by id, ROUTE_COST_UNREACHABLE for those with no route. This stays valid until
+    ///         the next search
+    const std::vector<unsigned int>& RouteCostsTo(const RouteGraph& graph, LocationId end_id) {
+        Search<false>(graph, end_id, [](LocationId) -> bool {
+            return false;
+        });
+        return FillRouteCosts(graph);
+    }
+
+private:
+    /// @brief This copies the route cost to every location out of the workspace, after a search over the whole graph
+    /// @param graph The route graph that was searched
+    /// @return The route cost to each location indexed by id
+    const std::vector<unsigned int>& FillRouteCosts(const RouteGraph& graph) {
+        m_route_costs.resize(graph.LocationCount());
+        for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+            m_route_costs[location_id] = m_workspace.RouteCost(location_id);
+        }
+        return m_route_costs;
+    }
+
+    /// @brief This runs the search out from a root location, forwards over the routes or backwards over the reverse routes
+    /// @param graph The route graph to search over
+    /// @param root_id The id of the location to search from
+    /// @param stop This is called as each location is settled, the search stops once it returns true
+    template <bool Forward, typename StopFunction>
+    void Search(const RouteGraph& graph, LocationId root_id, StopFunction stop) {
+        Start<Forward>(graph, root_id);
+        Run<Forward>(graph, stop);
+    }
+
+    /// @brief This sets up a new search from a root location
+    /// @param graph The route graph to search over
+    /// @param root_id The id of the location to search from
+    template <bool Forward>
+    void Start(const RouteGraph& graph, LocationId root_id) {
+        m_workspace.Reset(graph.LocationCount());
+        m_queue.Reset(graph.LocationCount());
+        m_settled_count = 0;
+        m_settled_order.clear();
+        m_root_id = Forward ? root_id : INVALID_LOCATION_ID;
+
+        // Distance of source vertex from itself is always 0
+        m_workspace.SetRouteCost(root_id, 0);
+        m_queue.Push(root_id, 0);
+    }
+
+    /// @brief This settles locations until the stop function says so or the queue runs dry. Each settled location's routes are
+    ///        relaxed before the stop check, so the queue is always left in a state the search can carry on from
+    /// @param graph The route graph to search over
+    /// @param stop This is called as each location is settled, the search stops once it returns true
+    template <bool Forward, typename StopFunction>
+    void Run(const RouteGraph& graph, StopFunction stop) {
+        while (!m_queue.Empty()) {
+            QueueEntry min_cost = m_queue.Pop();
+
+            // Heaps without decrease-key can hold older, more expensive, entries for a location that has already been settled
+            if (m_workspace.Settled(min_cost.index)) {
+                continue;
+            }
+            m_workspace.Settle(min_cost.index);
+            ++m_settled_count;
+            if (Forward) {
+                m_settled_order.push_back(min_cost.index);
+            }
+
+            const unsigned int base_cost = m_workspace.RouteCost(min_cost.index);
+            const uint32_t routes_end = Forward ? graph.RoutesEnd(min_cost.index) : graph.ReverseRoutesEnd(min_cost.index);
+            for (uint32_t route_i = Forward ? graph.RoutesBegin(min_cost.index) : graph.ReverseRoutesBegin(min_cost.index); route_i < routes_end; ++route_i) {
+                const LocationId adjacent = Forward ? graph.Destination(route_i) : graph.Origin(route_i);
+                const unsigned int adjacent_cost = base_cost + (Forward ? graph.RouteCost(route_i) : graph.ReverseRouteCost(route_i));
+                if (m_workspace.Relax(adjacent, adjacent_cost)) {
+                    m_queue.Push(adjacent, adjacent_cost);
+                }
+            }
+
+            if (stop(min_cost.index)) {
+                break;
+            }
+        }
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef FILECONTENTS_H
+#define FILECONTENTS_H
+
+#include <string>
+#include <string_view>
+
+namespace route {
+
+/// @brief This is the whole of a file read into a buffer the object owns. It is for files that can be rewritten in place while they
+///        are parsed, which would fault a memory map of them (see route/MappedFile.h), here a file that shrinks gives short contents
+class FileContents {
+    std::string m_contents;
+    bool m_open;
+
+    FileContents(const FileContents& other); //copying of the file contents is dissalowed
+public:
+    /// @brief class constructor, this reads the file
+    /// @param path The path of the file to read
+    FileContents(const std::string& path);
+
+    /// @brief Getter for whether the file could be read, an empty file is open but has no contents
+    /// @return True if the file was read, False if not
+    bool IsOpen() const {
+        return m_open;
+    }
+
+    /// @brief Getter for the contents of the file, this stays valid as long as the file contents
+    /// @return The contents
+    std::string_view Contents() const {
+        return m_contents;
+    }
+};
+
+}
+
+#endif
@@ -2,10 +2,15 @@
 #define LOCATIONDATABASE_H
 
 #include <log4cxx/logger.h>
+#include <memory>
 #include <string>
-#include <unordered_map>
+#include <vector>
+#include "route/FileWatcher.h"
 #include "route/Location.h"
+#include "route/LocationArena.h"
 #include "route/ILocationDatabase.h"
+#include "route/FileContents.h"
+#include "route/PerfectNameIndex.h"
 
 namespace route {
 
@@ -13,19 +18,26 @@ namespace route {
 class FileLocationDatabase : public ILocationDatabase {
     static log4cxx::LoggerPtr m_logger;
     const std::string m_database_file;
-    std::unordered_map<std::string, Location*> m_location_map;  
+    PerfectNameIndex m_location_names;      /// The location names, the id of each name is the index of its location in m_location_list
     std::vector<Location*> m_location_list;  
+    std::unique_ptr<LocationArena> m_location_arena;    /// The arena the locations in m_location_list are allocated from
+    std::unique_ptr<LocationArena> m_disk_arena;        /// The arena the locations read by GetLocationsOnDisk() are allocated from, until Load() takes them on
+    mutable FileWatcher m_file_watcher;                 /// This says when the database file may have changed, so it isn't read again until then
+    uint64_t m_contents_checksum;                       /// The checksum of the database file the current locations were read from
     
     FileLocationDatabase(const FileLocationDatabase& other); //copying of the Location database is dissalowed
 
 protected:
-    /// @brief This will delete all the locations in a given location list 
-    /// @param locations The list to iterate over and free up the memory
-    virtual void DeleteLocations(std::vector<Location*>& locations);
+    /// @brief This will delete all the locations in a given location list, by freeing the arena they were allocated from in one go
+    /// @param locations The list of locations, either the current locations or the ones read by GetLocationsOnDisk()
+    /// @param arena The arena the locations were allocated from, m_location_arena or m_disk_arena to go with them
+    virtual void DeleteLocations(std::vector<Location*>& locations, std::unique_ptr<LocationArena>& arena);
 
-    /// @brief This will read the locations currently on disk
+    /// @brief This will read the locations from the database file, as read by Load(), each location is given an id matching its
+    ///        position in the file. The locations are allocated from a new arena, which Load() takes on along with them
+    /// @param file The database file, the same contents Load() checksummed
     /// @return The list of locations on disk 
-    virtual std::vector<Location*> GetLocationsOnDisk();
+    virtual std::vector<Location*> GetLocationsOnDisk(const FileContents& file);
 
     /// @brief This should add a location to the location database
     /// @param location The new location to add
@@ -38,18 +50,29 @@ public:
     /// @brief This is the class destructor.
     virtual ~FileLocationDatabase();
 
-    /// @brief This should load the location database, repeated calls should refresh the database. 
-    /// @return True if the database was updated successfully, False if not
+    /// @brief This should load the location database, repeated calls should refresh the database. The file is only read again once
+    ///        it may have changed (see HasChanged()), and the locations are only replaced if its contents have changed. The file is
+    ///        read once, and the contents checksummed are the ones parsed
+    /// @return True if the database was updated successfully, False if not or if the file is unchanged
     bool Load();
 
+    /// @brief This checks whether the database file may have changed since it was last loaded, without reading it
+    /// @return True if the file may have changed, False if it hasn't
+    bool HasChanged() const;
+
     /// @brief This returns the current list of locations in the location database
     /// @return List of locations
-    const std::vector<Location*> GetLocations() const;
+    const std::vector<Location*>& GetLocations() const;
+
+    /// @brief This returns a particular location based on its id
+    /// @param location_id The id of the location to get
+    /// @return A location pointer, or nullptr if there is no location with that id
+    Location* const GetLocation(LocationId location_id) const;  
 
-    /// @brief This returns a particular location based on its name
-    /// @param location_name The name of the location to get
-    /// @return A location pointer
-    Location* const GetLocation(std::string location_name) const;  
+    /// @brief This resolves a location name into its id
+    /// @param location_name The name of the location
+    /// @return The location id, or INVALID_LOCATION_ID if there is no location with that name
+    LocationId GetLocationId(const std::string& location_name) const;
 };
 
 }
@@ -3,32 +3,60 @@
 
 #include <log4cxx/logger.h>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
+#include "route/FileWatcher.h"
 #include "route/IRouteDatabase.h"
+#include "route/FileContents.h"
+#include "route/ParallelFor.h"
 
 namespace route {
 
+const size_t ROUTE_PARSE_CHUNK_SIZE = 4 * 1024 * 1024;    /// Route files are parsed in chunks of around this many bytes spread across the worker threads, a smaller file is parsed on the calling thread
+
 /// @brief This class manages the database of routes. It knows how to load and sync them from a datafile
 class FileRouteDatabase : public IRouteDatabase {
     static log4cxx::LoggerPtr m_logger;
     const std::string m_route_file;
     std::unordered_map<std::string, std::vector<std::string>> m_routes; ///A string map of start -> end locations (where end is a list avaliable locations)
+    const std::vector<std::string> m_no_routes;                         ///The empty list returned for a start location without any routes
+    mutable FileWatcher m_file_watcher;                                 ///This says when the route file may have changed, so it isn't read again until then
+    uint64_t m_contents_checksum;                                       ///The checksum of the route file the current routes were read from
+
+    FileRouteDatabase(const FileRouteDatabase& other); //copying of the route database is dissalowed
 protected:
     
-    /// @brief This will read the routes currently on disk
+    /// @brief This will read the routes from the route file, as read by Load()
+    /// @param file The route file, the same contents Load() checksummed
     /// @return The list of routes on disk 
-    virtual std::unordered_map<std::string, std::vector<std::string>> GetRoutesOnDisk() const;
+    virtual std::unordered_map<std::string, std::vector<std::string>> GetRoutesOnDisk(const FileContents& file) const;
 public:
     FileRouteDatabase(const std::string route_file);    
 
-    /// @brief This will load the routes
-    /// @return True on success, False if not
+    /// @brief This parses the rows of a route file into routes. The rows are split into chunks (see CsvReader::SplitRows()) that are
+    ///        parsed in parallel, each into routes of its own, which are then merged in chunk order. A start location on more than
+    ///        one row has all of its destinations, in the order they are in the file, just as if the rows were parsed in one go
+    /// @param contents The rows
+    /// @param chunk_size The size of chunk to parse at a time
+    /// @param worker_count The number of worker threads to parse the chunks on, the calling thread is one of them
+    /// @return The routes
+    static std::unordered_map<std::string, std::vector<std::string>> ParseRoutes(std::string_view contents, size_t chunk_size = ROUTE_PARSE_CHUNK_SIZE,
+        size_t worker_count = WorkerCount());
+
+    /// @brief This will load the routes. The file is only read again once it may have changed (see HasChanged()), and the routes
+    ///        are only replaced if its contents have changed. The file is read once, and the contents checksummed are the ones parsed
+    /// @return True on success, False if not or if the file is unchanged
     bool Load();
 
+    /// @brief This checks whether the route file may have changed since it was last loaded, without reading it
+    /// @return True if the file may have changed, False if it hasn't
+    bool HasChanged() const;
+
     /// @brief This will return a list of routes from a given start location
     /// @param start_location_name This is the name of the start location to get the valid routes for 
     /// @return The list of routes from that start location
-    std::vector<std::string> GetRoutes(const std::string start_location_name) const;
+    const std::vector<std::string>& GetRoutes(const std::string& start_location_name) const;
 };
 
 }
@@ -0,0 +1,72 @@
+#ifndef FILEWATCHER_H
+#define FILEWATCHER_H
+
+#include <log4cxx/logger.h>
+#include <cstdint>
+#include <string>
+
+namespace route {
+
+/// @brief This watches one file for changes, so a database only reads its file again when something may have changed. It uses inotify
+///        on the directory of the file, which also sees the file being replaced by a rename or deleted and made again. Where inotify
+///        can't be used (no inotify, no directory yet, or the watch is lost) it falls back to comparing the size, modification time
+///        and inode of the file. Either way a change only says the file may be different, a file that is rewritten with the same
+///        contents is still reported, the database checks the contents for itself (see MappedFile::Checksum())
+class FileWatcher {
+    static log4cxx::LoggerPtr m_logger;
+
+    /// @brief This is what stat() says about the file, the file is taken to be unchanged while it is the same
+    struct FileStamp {
+        int64_t size;
+        int64_t modified_ns;
+        uint64_t inode;
+
+        bool operator==(const FileStamp& other) const {
+            return size == other.size && modified_ns == other.modified_ns && inode == other.inode;
+        }
+    };
+
+    const std::string m_path;
+    std::string m_file_name;        /// The name of the file within its directory, the inotify events name it this way
+    int m_inotify_fd;               /// The inotify instance watching the directory, -1 when the stamp of the file is compared instead
+    bool m_changed;                 /// This is set by an inotify event for the file and cleared by Reset()
+    FileStamp m_stamp;              /// The stamp of the file at the last Reset(), used when there is no inotify
+
+    FileWatcher(const FileWatcher& other); //copying of the file watcher is dissalowed
+
+    /// @brief This gets the stamp of the file
+    /// @return The stamp, all -1 if there is no file
+    FileStamp Stamp() const;
+
+    /// @brief This reads the pending inotify events without waiting, setting m_changed if any of them are for the file
+    void ReadEvents();
+
+    /// @brief This stops using inotify, the stamp of the file is compared from then on
+    void StopInotify();
+public:
+    /// @brief class constructor, the file counts as changed until the first Reset() so it is always loaded once
+    /// @param path The path of the file to watch, the file doesn't have to exist yet
+    /// @param use_inotify False to only compare the stamp of the file, True to use inotify where it can be
+    FileWatcher(const std::string& path, bool use_inotify = true);
+
+    /// @brief class destructor
+    ~FileWatcher();
+
+    /// @brief This checks whether the file may have changed since the last Reset(), it doesn't read the file and doesn't wait
+    /// @return True if the file may have changed, False if it hasn't
+    bool Changed();
+
+    /// @brief This marks the file as unchanged, it should be called just before the file is read so a change made while it is being
+    ///        read is seen by the next Changed()
+    void Reset();
+
+    /// @brief Getter for whether the file is watched with inotify
+    /// @return True if inotify is used, False if the stamp of the file is compared
+    bool UsesInotify() const {
+        return m_inotify_fd >= 0;
+    }
+};
+
+}
+
+#endif
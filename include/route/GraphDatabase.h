@@ -0,0 +1,171 @@
+#ifndef GRAPHDATABASE_H
+#define GRAPHDATABASE_H
+
+#include <log4cxx/logger.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "route/FileWatcher.h"
+#include "route/ILocationDatabase.h"
+#include "route/IRouteDatabase.h"
+#include "route/LocationArena.h"
+#include "route/RouteGraph.h"
+
+namespace route {
+
+/// @brief This is both the location database and the route database, over a binary graph file that holds the locations and the routes
+///        together (see GraphFileDatabase and PagedGraphDatabase). The file is only read again once it may have changed, and the graph
+///        is only replaced if its checksum has. The locations and the routes by name are only made if they are asked for through the
+///        older interfaces
+/// @tparam GraphType The graph loaded from the file, this needs Checksum(), Names(), LocationCount(), LocationCost(location_id) and
+///                   ForEachRoute(location_id, route_function) methods, which give ROUTE_COST_ERROR and False where the graph couldn't
+///                   be read (see route/GraphFile.h)
+template <typename GraphType>
+class GraphDatabase : public ILocationDatabase, public IRouteDatabase {
+    static log4cxx::LoggerPtr m_logger;
+    mutable FileWatcher m_file_watcher;                                             /// This says when the file may have changed, so it isn't read again until then
+    mutable std::unique_ptr<LocationArena> m_location_arena;                        /// The arena the locations in m_location_list are allocated from
+    mutable std::vector<Location*> m_location_list;                                 /// The locations, made the first time they are asked for
+    mutable std::unordered_map<LocationId, std::vector<std::string>> m_routes;      /// The routes by start location, made as they are asked for
+    const std::vector<std::string> m_no_routes;                                     /// The empty list returned for a start location without any routes
+
+    GraphDatabase(const GraphDatabase& other); //copying of the database is dissalowed
+
+    /// @brief This makes the locations from the graph, if they haven't been made since it was loaded. If a location cost can't be
+    ///        read there are no locations, and they are made again the next time they are asked for
+    void MakeLocations() const {
+        if (!m_graph || m_location_arena) {
+            return;
+        }
+        const PerfectNameIndex& names = *m_graph->Names();
+        m_location_arena = std::make_unique<LocationArena>();
+        m_location_list.reserve(m_graph->LocationCount());
+        for (LocationId location_id = 0; location_id < m_graph->LocationCount(); ++location_id) {
+            const unsigned int cost = m_graph->LocationCost(location_id);
+            if (cost == ROUTE_COST_ERROR) {
+                LOG4CXX_ERROR(m_logger, "Could not read the location cost from the graph file. file=" << m_graph_file << " location_id=" << location_id);
+                m_location_list.clear();
+                m_location_arena.reset();
+                return;
+            }
+            m_location_list.push_back(m_location_arena->NewLocation(names.Name(location_id), cost, location_id));
+        }
+    }
+
+protected:
+    const std::string m_graph_file;
+    std::shared_ptr<const GraphType> m_graph;                                       /// The graph last loaded
+
+    /// @brief This reads the graph from the file
+    /// @return The graph, or nullptr if there is no file or it is malformed
+    virtual std::shared_ptr<const GraphType> LoadGraph() const = 0;
+
+public:
+    /// @brief This is the class constructor
+    /// @param graph_file The path of the graph file
+    GraphDatabase(const std::string& graph_file) :
+    m_file_watcher(graph_file),
+    m_location_arena(),
+    m_location_list(),
+    m_routes(),
+    m_no_routes(),
+    m_graph_file(graph_file),
+    m_graph() {
+    }
+
+    /// @brief This will load the graph file, repeated calls will reload it once it may have changed (see HasChanged()). The database
+    ///        is both the location and the route database, so this also keeps the second of the two loads the route planner asks for
+    ///        from reading the file again. If the file can't be loaded the previous graph is kept
+    /// @return True if the graph was updated, False if there was an error or the file is the same graph as before
+    bool Load() {
+        if (!m_file_watcher.Changed()) {
+            return false;
+        }
+        m_file_watcher.Reset();
+        std::shared_ptr<const GraphType> graph = LoadGraph();
+        if (!graph) {
+            return false;
+        }
+        if (m_graph && graph->Checksum() == m_graph->Checksum()) {
+            return false;
+        }
+
+        m_graph = graph;
+        m_location_list.clear();
+        m_location_arena.reset();
+        m_routes.clear();
+        LOG4CXX_DEBUG(m_logger, "Loaded " << m_graph->LocationCount() << " location(s) from the graph file " << m_graph_file);
+        return true;
+    }
+
+    /// @brief This checks whether the graph file may have changed since it was last loaded, without reading it
+    /// @return True if the file may have changed, False if it hasn't
+    bool HasChanged() const {
+        return m_file_watcher.Changed();
+    }
+
+    /// @brief This returns the current list of locations, they are made the first time they are asked for after a load. The locations
+    ///        have no destinations set, the routes are in the graph
+    /// @return List of locations
+    const std::vector<Location*>& GetLocations() const {
+        MakeLocations();
+        return m_location_list;
+    }
+
+    /// @brief This returns a particular location based on its id, see GetLocations()
+    /// @param location_id The id of the location to get
+    /// @return A location pointer, or nullptr if there is no location with that id
+    Location* const GetLocation(LocationId location_id) const {
+        MakeLocations();
+        if (location_id < m_location_list.size()) {
+            return m_location_list[location_id];
+        }
+        return nullptr;
+    }
+
+    /// @brief This resolves a location name into its id
+    /// @param location_name The name of the location
+    /// @return The location id, or INVALID_LOCATION_ID if there is no location with that name
+    LocationId GetLocationId(const std::string& location_name) const {
+        return m_graph ? m_graph->Names()->Find(location_name) : INVALID_LOCATION_ID;
+    }
+
+    /// @brief This returns the location names straight from the graph file
+    /// @return The location names, or nullptr if nothing is loaded
+    std::shared_ptr<const PerfectNameIndex> GetLocationNameIndex() const {
+        return m_graph ? m_graph->Names() : nullptr;
+    }
+
+    /// @brief This will return a list of routes from a given start location, they are made from the graph the first time they are
+    ///        asked for after a load. If they can't be read from the graph there are no routes, and they are read again the next time
+    /// @param start_location_name This is the name of the start location to get the valid routes for
+    /// @return The list of routes from that start location
+    const std::vector<std::string>& GetRoutes(const std::string& start_location_name) const {
+        const LocationId start_location_id = GetLocationId(start_location_name);
+        if (start_location_id == INVALID_LOCATION_ID) {
+            return m_no_routes;
+        }
+        auto routes = m_routes.find(start_location_id);
+        if (routes == m_routes.end()) {
+            const PerfectNameIndex& names = *m_graph->Names();
+            std::vector<std::string> destinations;
+            const bool read = m_graph->ForEachRoute(start_location_id, [&names, &destinations](LocationId destination, unsigned int) -> void {
+                destinations.emplace_back(names.Name(destination));
+            });
+            if (!read) {
+                LOG4CXX_ERROR(m_logger, "Could not read the routes from the graph file. file=" << m_graph_file << " start=" << start_location_name);
+                return m_no_routes;
+            }
+            routes = m_routes.emplace(start_location_id, std::move(destinations)).first;
+        }
+        return routes->second;
+    }
+};
+
+template <typename GraphType>
+log4cxx::LoggerPtr GraphDatabase<GraphType>::m_logger(log4cxx::Logger::getLogger("GraphDatabase"));
+
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef GRAPHFILE_H
+#define GRAPHFILE_H
+
+#include <log4cxx/logger.h>
+#include <memory>
+#include <string>
+#include "route/LocationOrder.h"
+#include "route/PerfectNameIndex.h"
+#include "route/RouteGraph.h"
+
+namespace route {
+
+/// @brief This is a compiled graph file, the locations and routes of a location file and a route file together in one binary file
+///        that is read with no text parsing. The file is a header (a magic string ending in the format version, a checksum of the rest
+///        of the file and the location and route counts) followed by the location names as a written PerfectNameIndex (the string
+///        table and its perfect hash, so the name lookup isn't built again), the location costs, and the routes in compressed
+///        sparse row form: the offset of the first route of each location then the destination of each route, and last the
+///        location order the route planner searches in (see route/LocationOrder.h), so it isn't worked out again either. Everything
+///        is in the machine's own byte order. The location ids are the ids the location file gives the locations
+class GraphFile {
+    static log4cxx::LoggerPtr m_logger;
+    uint64_t m_checksum;
+    std::shared_ptr<const PerfectNameIndex> m_names;
+    std::shared_ptr<const RouteGraph> m_graph;
+    std::shared_ptr<const LocationOrder> m_location_order;
+
+    GraphFile(uint64_t checksum, std::shared_ptr<const PerfectNameIndex> names, std::shared_ptr<const RouteGraph> graph,
+        std::shared_ptr<const LocationOrder> location_order);
+public:
+    /// @brief This saves a graph file, it is written to the side and renamed over the file so a reader never sees half a file
+    /// @param graph_file The path of the graph file
+    /// @param names The location names, by location id
+    /// @param graph The route graph, by location id
+    /// @param location_order The location order for the route graph
+    /// @return True on success, False if the file couldn't be written
+    static bool Save(const std::string& graph_file, const PerfectNameIndex& names, const RouteGraph& graph, const LocationOrder& location_order);
+
+    /// @brief This loads a graph file saved by Save(). The file is memory mapped and checked against its checksum, then each array is
+    ///        copied out of the mapping in one go and the reverse routes are built. The mapping is closed again before this returns, so
+    ///        the graph file takes the memory of its arrays and nothing else
+    /// @param graph_file The path of the graph file
+    /// @return The graph file, or nullptr if there is no file or it is malformed
+    static std::shared_ptr<const GraphFile> Load(const std::string& graph_file);
+
+    /// @brief This compiles a location file and a route file (see FileLocationDatabase and FileRouteDatabase) into a graph file, the
+    ///        routes are worked out the same way the route planner works them out from the two databases
+    /// @param location_file The path of the location file
+    /// @param route_file The path of the route file
+    /// @param graph_file The path of the graph file to save
+    /// @return True on success, False if the files couldn't be read or the graph file couldn't be written
+    static bool Convert(const std::string& location_file, const std::string& route_file, const std::string& graph_file);
+
+    /// @brief Check if a file starts like a graph file, without loading it
+    /// @param path The path of the file
+    /// @return True if it is a graph file of this format version, False if not
+    static bool IsGraphFile(const std::string& path);
+
+    /// @brief Getter for the checksum of the file, two files with the same checksum are almost certainly the same graph
+    /// @return The checksum
+    uint64_t Checksum() const {
+        return m_checksum;
+    }
+
+    /// @brief Getter for the location names
+    /// @return The names
+    std::shared_ptr<const PerfectNameIndex> Names() const {
+        return m_names;
+    }
+
+    /// @brief Getter for the route graph
+    /// @return The route graph, by location id
+    std::shared_ptr<const RouteGraph> Graph() const {
+        return m_graph;
+    }
+
+    /// @brief Getter for the location order
+    /// @return The location order for the route graph
+    std::shared_ptr<const LocationOrder> Order() const {
+        return m_location_order;
+    }
+
+    /// @brief Getter for the number of locations
+    /// @return The number of locations
+    size_t LocationCount() const {
+        return m_graph->LocationCount();
+    }
+
+    /// @brief Getter for the point cost of a location
+    /// @param location_id The id of the location, it must be in the graph
+    /// @return The point cost
+    unsigned int LocationCost(LocationId location_id) const {
+        return m_graph->LocationCost(location_id);
+    }
+
+    /// @brief This calls a function for each route leaving a location, in the same way as PagedGraph::ForEachRoute()
+    /// @param location_id The id of the location, it must be in the graph
+    /// @param route_function This is called with (destination id, route cost) for each route
+    /// @return True, the routes are always in memory
+    template <typename RouteFunction>
+    bool ForEachRoute(LocationId location_id, RouteFunction route_function) const {
+        for (uint32_t route_i = m_graph->RoutesBegin(location_id); route_i < m_graph->RoutesEnd(location_id); ++route_i) {
+            route_function(m_graph->Destination(route_i), m_graph->RouteCost(route_i));
+        }
+        return true;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef GRAPHFILEDATABASE_H
+#define GRAPHFILEDATABASE_H
+
+#include <memory>
+#include <string>
+#include "route/GraphDatabase.h"
+#include "route/GraphFile.h"
+
+namespace route {
+
+/// @brief This class is both the location database and the route database, loaded from one compiled graph file (see route/GraphFile.h).
+///        The route graph, name lookup and location order are copied out of the file and handed to the route planner as they are (see
+///        ILocationDatabase::GetRouteGraph()), so nothing is parsed or worked out again when it is loaded. The locations and the
+///        routes by name are only made if they are asked for through the older interfaces (see route/GraphDatabase.h)
+class GraphFileDatabase : public GraphDatabase<GraphFile> {
+protected:
+    /// @brief This loads the graph file
+    /// @return The graph file, or nullptr if there is no file or it is malformed
+    std::shared_ptr<const GraphFile> LoadGraph() const;
+
+public:
+    /// @brief This is the class constructor
+    /// @param graph_file The path of the graph file
+    GraphFileDatabase(const std::string& graph_file);
+
+    /// @brief This returns the route graph straight from the graph file
+    /// @return The route graph, or nullptr if nothing is loaded
+    std::shared_ptr<const RouteGraph> GetRouteGraph() const;
+
+    /// @brief This returns the location order straight from the graph file
+    /// @return The location order, or nullptr if nothing is loaded
+    std::shared_ptr<const LocationOrder> GetLocationOrder() const;
+};
+
+}
+
+#endif
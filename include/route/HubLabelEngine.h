@@ -0,0 +1,112 @@
+#ifndef HUBLABELENGINE_H
+#define HUBLABELENGINE_H
+
+#include <log4cxx/logger.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "route/IRouteEngine.h"
+#include "route/RouteGraph.h"
+
+namespace route {
+
+const size_t DEFAULT_HUB_LABEL_MAX_LOCATIONS = 65536;      /// This is the largest graph the hub label engine will label unless told otherwise
+
+/// @brief This is a hub labelling (2-hop labelling) route engine. Every location gets a forward label, the hubs it can reach and the
+///        route cost to each, and a backward label, the hubs that can reach it and the route cost from each, chosen so that some hub on
+///        a cheapest route between any two locations is in both labels. A query is then a merge of two sorted arrays, with no search.
+///        The labels are built with pruned landmark labelling: locations are taken in rank order (busiest first, going by a sample of
+///        shortest path trees), and a search is run from each one in both directions that stops wherever the labels built so far
+///        already give the route cost.
+///        Building the labels is the slow part, so they can be saved to a file and loaded back for the same route graph
+class HubLabelEngine : public IRouteEngine {
+    /// @brief This is one entry of a label, labels are sorted by hub
+    struct LabelEntry {
+        uint32_t hub;           /// The rank of the hub location
+        unsigned int cost;      /// The route cost between the location and the hub
+    };
+
+    /// @brief This is the labels for one direction, in compressed sparse row form
+    struct Labels {
+        std::vector<uint32_t> offsets;          /// This is the offset of the first entry of each location's label, with one extra at the end
+        std::vector<LabelEntry> entries;        /// This is the label entries
+    };
+
+    static log4cxx::LoggerPtr m_logger;
+    std::shared_ptr<const RouteGraph> m_graph;
+    Labels m_forward;       /// The route cost from each location to the hubs in its label
+    Labels m_backward;      /// The route cost to each location from the hubs in its label
+
+    /// @brief class constructor, for labels that have been loaded
+    HubLabelEngine(std::shared_ptr<const RouteGraph> graph, Labels&& forward, Labels&& backward);
+
+    void Build();
+public:
+    /// @brief class constructor, this builds the labels so can take a while on a large graph
+    /// @param graph The route graph snapshot to label
+    HubLabelEngine(std::shared_ptr<const RouteGraph> graph);
+
+    unsigned int GetRouteCost(LocationId start_id, LocationId end_id) const override {
+        const LabelEntry* forward = m_forward.entries.data() + m_forward.offsets[start_id];
+        const LabelEntry* const forward_end = m_forward.entries.data() + m_forward.offsets[start_id + 1];
+        const LabelEntry* backward = m_backward.entries.data() + m_backward.offsets[end_id];
+        const LabelEntry* const backward_end = m_backward.entries.data() + m_backward.offsets[end_id + 1];
+
+        // Each cost is below ROUTE_COST_UNREACHABLE (INT_MAX), so the sum of two can't overflow
+        unsigned int best_cost = ROUTE_COST_UNREACHABLE;
+        while (forward != forward_end && backward != backward_end) {
+            if (forward->hub == backward->hub) {
+                if (forward->cost + backward->cost < best_cost) {
+                    best_cost = forward->cost + backward->cost;
+                }
+                ++forward;
+                ++backward;
+            }
+            else if (forward->hub < backward->hub) {
+                ++forward;
+            }
+            else {
+                ++backward;
+            }
+        }
+        return best_cost;
+    }
+
+    /// @brief This builds the labels for the changed graph from scratch, as a change can move the best hubs of any location. They are
+    ///        only kept in memory, the label file is left for the routes on disk so a restart or reload still loads it
+    RouteEnginePtr ApplyChange(std::shared_ptr<const RouteGraph> graph, const RouteChange& change) const override;
+
+    /// @brief Getter for the average number of entries in a label
+    /// @return The average label size
+    double AverageLabelSize() const;
+
+    /// @brief Getter for the memory used by the labels
+    /// @return The size of the labels in bytes
+    size_t MemoryBytes() const {
+        return (m_forward.offsets.size() + m_backward.offsets.size()) * sizeof(uint32_t) +
+            (m_forward.entries.size() + m_backward.entries.size()) * sizeof(LabelEntry);
+    }
+
+    /// @brief This saves the labels to a file, along with the fingerprint of the route graph they are for (see
+    ///        RouteGraph::Fingerprint())
+    /// @param label_file The path of the file, it is replaced if it exists
+    /// @return True on success, False if the file couldn't be written
+    bool Save(const std::string& label_file) const;
+
+    /// @brief This loads labels saved by Save()
+    /// @param graph The route graph the labels are for
+    /// @param label_file The path of the file
+    /// @return The engine, or nullptr if the file couldn't be read or was saved for a different route graph
+    static std::shared_ptr<const HubLabelEngine> Load(std::shared_ptr<const RouteGraph> graph, const std::string& label_file);
+
+    /// @brief Getter for a factory that builds this engine
+    /// @param max_locations The factory refuses (returns null for) graphs with more locations than this
+    /// @param label_file If this is set the labels are loaded from this file when it was saved for the same route graph, and built
+    ///                   and saved to it when not. A graph changed from a running engine is built by ApplyChange() and never saved
+    /// @return The engine factory
+    static RouteEngineFactory Factory(size_t max_locations = DEFAULT_HUB_LABEL_MAX_LOCATIONS, const std::string& label_file = "");
+};
+
+}
+
+#endif
@@ -1,12 +1,19 @@
 #ifndef ILOCATIONDATABASE_H
 #define ILOCATIONDATABASE_H
 
+#include <memory>
+#include <string>
+#include <vector>
 #include "route/Location.h"
+#include "route/LocationOrder.h"
+#include "route/PagedGraph.h"
+#include "route/PerfectNameIndex.h"
+#include "route/RouteGraph.h"
 
 namespace route {
 
 /// @brief This should represent a source of locations, it should be responsible for the 
-///        lifetime of these locations
+///        lifetime of these locations. The id of each location is its index within GetLocations()
 class ILocationDatabase {
     ILocationDatabase(const ILocationDatabase& other) {} //copying of this is dissallowed
 
@@ -19,16 +26,55 @@ public:
     /// @return True if the locations were updated successfully, False if not
     virtual bool Load() = 0;
 
+    /// @brief This should say whether the database may have changed since it was last loaded, cheaply and without loading it, so the
+    ///        route planner only reloads it when there is something to reload. The default is to always reload it
+    /// @return True if Load() may update the database, False if it won't
+    virtual bool HasChanged() const {
+        return true;
+    }
+
     /// @brief This should load all the locations from the source the concrete version of this
     ///        class represents
     /// @return A list of pointers to the loaded locations
-    virtual const std::vector<Location*> GetLocations() const = 0;
+    virtual const std::vector<Location*>& GetLocations() const = 0;
+
+    /// @brief This should returns a particular location based on its id
+    /// @param location_id The id of the location to get
+    /// @return A location pointer, or nullptr if there is no location with that id
+    virtual Location* const GetLocation(LocationId location_id) const = 0;  
+
+    /// @brief This should resolve a location name into its id
+    /// @param location_name The name of the location
+    /// @return The location id, or INVALID_LOCATION_ID if there is no location with that name
+    virtual LocationId GetLocationId(const std::string& location_name) const = 0;
+
+    /// @brief A database that holds the routes between its locations already compiled (such as a graph file, see route/GraphFile.h)
+    ///        can give the route graph directly, the route planner then takes it as it is rather than working the routes out from
+    ///        the route database
+    /// @return The route graph by location id, or nullptr if the routes have to be worked out (the default)
+    virtual std::shared_ptr<const RouteGraph> GetRouteGraph() const {
+        return nullptr;
+    }
+
+    /// @brief A database that gives the route graph directly should give the location names along with it
+    /// @return The location names by location id, or nullptr if the routes have to be worked out (the default)
+    virtual std::shared_ptr<const PerfectNameIndex> GetLocationNameIndex() const {
+        return nullptr;
+    }
 
-    /// @brief This should returns a particular location based on its name
-    /// @param location_name The name of the location to get
-    /// @return A location pointer
-    virtual Location* const GetLocation(std::string location_name) const = 0;  
+    /// @brief A database that gives the route graph directly may give the location order the route planner searches it in (see
+    ///        route/LocationOrder.h) along with it
+    /// @return The location order, or nullptr for the route planner to work it out (the default)
+    virtual std::shared_ptr<const LocationOrder> GetLocationOrder() const {
+        return nullptr;
+    }
 
+    /// @brief A database that keeps its routes on disk in a paged graph (see route/PagedGraph.h) can give the paged graph directly,
+    ///        the route planner then searches it where it is rather than loading the routes into memory
+    /// @return The paged graph, or nullptr if the routes are in memory (the default)
+    virtual std::shared_ptr<const PagedGraph> GetPagedGraph() const {
+        return nullptr;
+    }
 };
 
 }
@@ -16,10 +16,18 @@ public:
     /// @return True if the routes were updated successfully, False if not
     virtual bool Load() = 0;
 
-    /// @brief This should returns a particular route based on its name
+    /// @brief This should say whether the database may have changed since it was last loaded, cheaply and without loading it, so the
+    ///        route planner only reloads it when there is something to reload. The default is to always reload it
+    /// @return True if Load() may update the routes, False if they won't
+    virtual bool HasChanged() const {
+        return true;
+    }
+
+    /// @brief This should returns a particular route based on its name. Routes are only read when the route graph is built,
+    ///        so they stay keyed on the location name rather than the id
     /// @param start_location_name The name of the route to get based on the start location name
-    /// @return A list of valid routes
-    virtual std::vector<std::string> GetRoutes(const std::string start_location_name) const = 0;
+    /// @return A list of valid routes, this stays valid until the next Load()
+    virtual const std::vector<std::string>& GetRoutes(const std::string& start_location_name) const = 0;
 };
 
 }
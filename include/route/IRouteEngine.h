@@ -0,0 +1,58 @@
+#ifndef IROUTEENGINE_H
+#define IROUTEENGINE_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "route/RouteGraph.h"
+
+namespace route {
+
+class IRouteEngine;
+typedef std::shared_ptr<const IRouteEngine> RouteEnginePtr;
+
+/// @brief This is the interface for a route engine, the part of the route planner that answers route cost queries. An engine is
+///        built for one route graph snapshot, and can do whatever preprocessing it likes then. Queries must be safe to run concurrently
+class IRouteEngine {
+public:
+    virtual ~IRouteEngine() {}
+
+    /// @brief This will find the lowest route cost between two locations. The cost of a route is the sum of the costs of each location
+    ///        entered after the start (the start location's own cost is added by the route planner)
+    /// @param start_id The id of the start location
+    /// @param end_id The id of the end location
+    /// @return The route cost, or ROUTE_COST_UNREACHABLE if there is no route
+    virtual unsigned int GetRouteCost(LocationId start_id, LocationId end_id) const = 0;
+
+    /// @brief This will find the lowest route cost from each of a set of start locations to each of a set of end locations. By default
+    ///        this is one GetRouteCost() per pair, engines that can share work between the pairs override it
+    /// @param start_ids The ids of the start locations
+    /// @param end_ids The ids of the end locations
+    /// @return The route costs as a dense matrix, row by row, so the cost from start_ids[i] to end_ids[j] is at [i * end_ids.size() + j]
+    virtual std::vector<unsigned int> GetRouteCosts(const std::vector<LocationId>& start_ids, const std::vector<LocationId>& end_ids) const {
+        std::vector<unsigned int> route_costs;
+        route_costs.reserve(start_ids.size() * end_ids.size());
+        for (LocationId start_id : start_ids) {
+            for (LocationId end_id : end_ids) {
+                route_costs.push_back(GetRouteCost(start_id, end_id));
+            }
+        }
+        return route_costs;
+    }
+
+    /// @brief This builds the engine for a route graph one change on from this engine's, repairing what this engine has already
+    ///        worked out rather than starting again. This engine must keep answering queries over its own graph while it runs. By
+    ///        default there is nothing to repair and the engine is rebuilt from scratch by its factory
+    /// @param graph The changed route graph
+    /// @param change The change made to this engine's route graph
+    /// @return The engine for the changed route graph, or nullptr to have it built from scratch
+    virtual RouteEnginePtr ApplyChange(std::shared_ptr<const RouteGraph>, const RouteChange&) const {
+        return nullptr;
+    }
+};
+
+typedef std::function<RouteEnginePtr(std::shared_ptr<const RouteGraph>)> RouteEngineFactory;  /// This builds an engine for a route graph snapshot, or returns null to refuse it
+
+}
+
+#endif
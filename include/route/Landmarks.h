@@ -0,0 +1,85 @@
+#ifndef LANDMARKS_H
+#define LANDMARKS_H
+
+#include <log4cxx/logger.h>
+#include <vector>
+#include "route/RouteGraph.h"
+
+namespace route {
+
+/// @brief This is a set of landmark locations with the route cost from and to each of them precomputed for every location. By the
+///        triangle inequality these give a lower bound on the route cost between any two locations, which is what the ALT search uses
+///        as its A* heuristic as the locations have no coordinates to give a geometric one.
+///        Landmarks are picked farthest first, each new landmark is the location farthest from the ones already picked
+class Landmarks {
+    static log4cxx::LoggerPtr m_logger;
+    std::vector<LocationId> m_landmarks;
+    std::vector<unsigned int> m_from_landmarks;  /// The route cost from each landmark to each location, indexed [location * count + landmark]
+    std::vector<unsigned int> m_to_landmarks;    /// The route cost from each location to each landmark, indexed [location * count + landmark]
+
+public:
+    /// @brief class constructor, this picks the landmarks and runs a forward and a backward search from each one
+    /// @param graph The route graph to pick the landmarks from
+    /// @param landmark_count The number of landmarks to pick, fewer are picked if the graph runs out of useful ones
+    Landmarks(const RouteGraph& graph, size_t landmark_count);
+
+    /// @brief Getter for the number of landmarks picked
+    /// @return The landmark count
+    size_t Count() const {
+        return m_landmarks.size();
+    }
+
+    /// @brief Getter for the landmark locations
+    /// @return The ids of the landmark locations, in the order they were picked
+    const std::vector<LocationId>& GetLandmarks() const {
+        return m_landmarks;
+    }
+
+    /// @brief Getter for the memory used by the landmark tables
+    /// @return The size of the tables in bytes
+    size_t MemoryBytes() const {
+        return (m_from_landmarks.size() + m_to_landmarks.size()) * sizeof(unsigned int);
+    }
+
+    /// @brief This gives a lower bound on the route cost between two locations
+    /// @param location_id The id of the location the route starts from
+    /// @param end_id The id of the location the route ends at
+    /// @return The lower bound, or ROUTE_COST_UNREACHABLE if the landmarks show there can't be a route
+    unsigned int LowerBound(LocationId location_id, LocationId end_id) const {
+        const size_t count = m_landmarks.size();
+        const unsigned int* from_location = &m_from_landmarks[location_id * count];
+        const unsigned int* from_end = &m_from_landmarks[end_id * count];
+        const unsigned int* to_location = &m_to_landmarks[location_id * count];
+        const unsigned int* to_end = &m_to_landmarks[end_id * count];
+
+        unsigned int lower_bound = 0;
+        for (size_t i = 0; i < count; ++i) {
+            // cost(L, end) <= cost(L, location) + cost(location, end)
+            if (from_end[i] != ROUTE_COST_UNREACHABLE) {
+                if (from_location[i] != ROUTE_COST_UNREACHABLE && from_end[i] > from_location[i] && from_end[i] - from_location[i] > lower_bound) {
+                    lower_bound = from_end[i] - from_location[i];
+                }
+            }
+            else if (from_location[i] != ROUTE_COST_UNREACHABLE) {
+                // The landmark reaches this location but not the end, so this location can't reach the end either
+                return ROUTE_COST_UNREACHABLE;
+            }
+
+            // cost(location, L) <= cost(location, end) + cost(end, L)
+            if (to_location[i] != ROUTE_COST_UNREACHABLE) {
+                if (to_end[i] != ROUTE_COST_UNREACHABLE && to_location[i] > to_end[i] && to_location[i] - to_end[i] > lower_bound) {
+                    lower_bound = to_location[i] - to_end[i];
+                }
+            }
+            else if (to_end[i] != ROUTE_COST_UNREACHABLE) {
+                // The end reaches the landmark but this location doesn't, so this location can't reach the end either
+                return ROUTE_COST_UNREACHABLE;
+            }
+        }
+        return lower_bound;
+    }
+};
+
+}
+
+#endif
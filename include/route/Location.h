@@ -1,37 +1,60 @@
 #ifndef LOCATION_H
 #define LOCATION_H
 
+#include <cstdint>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace route {
 
-/// @brief This represenst a single location in the graph, and knows valid destinations from this locations
+typedef uint32_t LocationId;                        /// This is the integer id of a location, it is its index within the location database
+const LocationId INVALID_LOCATION_ID = UINT32_MAX;  /// This is the id used for a location that doesn't exist
+
+/// @brief This represenst a single location in the graph, and knows valid destinations from this locations. The name is allocated
+///        from the memory resource the location is given, so a location built in an arena (see route/LocationArena.h) keeps it in the
+///        arena. The destinations are set again every time the routes change, so they stay on the heap where clearing them frees them
 class Location {
-    const std::string m_name;                                               /// This is the string representation of the Location
+public:
+    typedef std::unordered_map<LocationId, const Location* const> ValidDestinationsType;
+private:
+    const std::pmr::string m_name;                                          /// This is the string representation of the Location
     unsigned int m_cost;                                                    /// This is the point cost assoctaied with this point
-    std::unordered_map<std::string, const Location* const> m_destinations;  /// This is a list of destinations that are reachable from this location
+    const LocationId m_id;                                                  /// This is the id of the Location within its database
+    ValidDestinationsType m_destinations;                                   /// This is a list of destinations that are reachable from this location, keyed by their id
 public:
-    typedef std::unordered_map<std::string, const Location* const> ValidDestinationsType;
-
-    Location(const std::string name, unsigned int cost);
+    /// @brief class constructor
+    /// @param name The name of the location
+    /// @param cost The point cost of the location
+    /// @param id The id of the location within its database
+    /// @param resource The memory resource the name is allocated from
+    Location(std::string_view name, unsigned int cost, LocationId id = INVALID_LOCATION_ID,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /// @brief Getter for the string location name
     /// @return String representation of the location
-    const std::string Name() const;
+    std::string_view Name() const;
 
     /// @brief Getter for the point cost of the location
     /// @return Int representing the point cost
     const unsigned int Cost() const; 
 
+    /// @brief Getter for the id of the location
+    /// @return The location id, or INVALID_LOCATION_ID if it doesn't belong to a database
+    LocationId Id() const;
+
     /// @brief Getter for the valid destinations from this location
     /// @return Map of valid destinations
-    ValidDestinationsType Destinations() const; 
+    const ValidDestinationsType& Destinations() const; 
 
     /// @brief Setter for adding a valid destination from this location
     /// @param destination location to add as a valid destination from this
     void AddDestination(const Location* destination);
 
+    /// @brief This removes all the valid destinations from this location, so they can be set again from changed routes
+    void ClearDestinations();
+
     /// @brief Check if a destinaton is valid from this location
     /// @param destination The valid destination to look for
     /// @return True if it is, False if not
@@ -40,4 +63,4 @@ public:
 
 }
 
-#endif
\ No newline at end of file
+#endif
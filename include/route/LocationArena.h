@@ -0,0 +1,63 @@
+#ifndef LOCATIONARENA_H
+#define LOCATIONARENA_H
+
+#include <memory_resource>
+#include <new>
+#include <string_view>
+#include <vector>
+#include "route/Location.h"
+
+namespace route {
+
+const size_t DEFAULT_LOCATION_ARENA_BLOCK_SIZE = 64 * 1024;    /// This is the size of the first block of a location arena, each block after is bigger
+
+/// @brief This is an arena for one load of a location database: the locations and their names are allocated from one monotonic
+///        buffer, block after growing block, rather than one small heap allocation at a time. Nothing is freed until the arena is
+///        destroyed, which destroys the locations, freeing their destinations on the heap, then frees the rest in one go. The
+///        locations must not be used once their arena has gone
+class LocationArena {
+    std::pmr::monotonic_buffer_resource m_resource;
+    std::vector<Location*> m_locations;         /// The locations made in the arena, to be destroyed with it
+
+    LocationArena(const LocationArena& other); //copying of the arena is dissalowed
+public:
+    /// @brief class constructor
+    /// @param initial_size The size of the first block
+    LocationArena(size_t initial_size = DEFAULT_LOCATION_ARENA_BLOCK_SIZE) :
+    m_resource(initial_size) {
+    }
+
+    /// @brief class destructor, this destroys the locations before their memory goes with the arena
+    ~LocationArena() {
+        for (Location* location : m_locations) {
+            location->~Location();
+        }
+    }
+
+    /// @brief This makes a new location in the arena
+    /// @param name The name of the location
+    /// @param cost The point cost of the location
+    /// @param id The id of the location within its database
+    /// @return The location, it lives as long as the arena
+    Location* NewLocation(std::string_view name, unsigned int cost, LocationId id) {
+        void* memory = m_resource.allocate(sizeof(Location), alignof(Location));
+        m_locations.push_back(new (memory) Location(name, cost, id, &m_resource));
+        return m_locations.back();
+    }
+
+    /// @brief Getter for the memory resource of the arena
+    /// @return The memory resource
+    std::pmr::memory_resource* Resource() {
+        return &m_resource;
+    }
+
+    /// @brief Getter for the number of locations made in the arena
+    /// @return The location count
+    size_t LocationCount() const {
+        return m_locations.size();
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef LOCATIONORDER_H
+#define LOCATIONORDER_H
+
+#include <log4cxx/logger.h>
+#include <vector>
+#include "route/RouteGraph.h"
+
+namespace route {
+
+/// @brief This is a renumbering of the locations of a route graph. The location databases number the locations in file order, which
+///        scatters the locations a search touches together all over memory. The route graph is built with internal ids in an order
+///        that puts locations with routes between them close together, and the location database ids (the external ids) are mapped
+///        to and from the internal ids at the edge of the route planner
+class LocationOrder {
+    static log4cxx::LoggerPtr m_logger;
+    std::vector<LocationId> m_internal_ids;     /// The internal id of each location, indexed by external id
+    std::vector<LocationId> m_external_ids;     /// The external id of each location, indexed by internal id
+
+public:
+    /// @brief class constructor
+    /// @param external_ids The external id of each location in internal id order, this must be a permutation of the external ids
+    LocationOrder(std::vector<LocationId>&& external_ids);
+
+    /// @brief This orders the locations with reverse Cuthill-McKee: a breadth first search over the routes (both ways) from a location
+    ///        on the edge of the graph, taking the locations with the fewest routes first, then reversed. Each location ends up close
+    ///        to the locations it has routes to and from
+    /// @param graph The route graph, with the external ids
+    /// @return The location order
+    static LocationOrder ReverseCuthillMcKee(const RouteGraph& graph);
+
+    /// @brief This gets an order that keeps the external ids as they are
+    /// @param location_count The number of locations
+    /// @return The location order
+    static LocationOrder Identity(size_t location_count);
+
+    /// @brief This builds a copy of a route graph with the locations renumbered to the internal ids
+    /// @param graph The route graph, with the external ids
+    /// @return The route graph with the internal ids
+    RouteGraph Apply(const RouteGraph& graph) const;
+
+    /// @brief This measures how far apart the two ends of a route are in memory, the average over the routes of the difference
+    ///        between their ids
+    /// @param graph The route graph
+    /// @return The average route span
+    static double AverageRouteSpan(const RouteGraph& graph);
+
+    /// @brief Getter for the number of locations
+    /// @return The location count
+    size_t LocationCount() const {
+        return m_internal_ids.size();
+    }
+
+    /// @brief This maps an external id to an internal id
+    /// @param external_id The location database id of the location
+    /// @return The route graph id of the location, or INVALID_LOCATION_ID if there is no location with the external id
+    LocationId InternalId(LocationId external_id) const {
+        return external_id < m_internal_ids.size() ? m_internal_ids[external_id] : INVALID_LOCATION_ID;
+    }
+
+    /// @brief This maps an internal id to an external id
+    /// @param internal_id The route graph id of the location
+    /// @return The location database id of the location, or INVALID_LOCATION_ID if there is no location with the internal id
+    LocationId ExternalId(LocationId internal_id) const {
+        return internal_id < m_external_ids.size() ? m_external_ids[internal_id] : INVALID_LOCATION_ID;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace route {
+
+/// @brief This is a read only memory map of a whole file, so it can be parsed in place without copying it into the process first
+class MappedFile {
+    const char* m_data;
+    size_t m_size;
+    bool m_open;
+
+    MappedFile(const MappedFile& other); //copying of the mapped file is dissalowed
+public:
+    /// @brief class constructor, this maps the file
+    /// @param path The path of the file to map
+    MappedFile(const std::string& path);
+
+    /// @brief class destructor, this unmaps the file
+    ~MappedFile();
+
+    /// @brief Getter for whether the file could be opened, an empty file is open but has no contents
+    /// @return True if the file was opened, False if not
+    bool IsOpen() const {
+        return m_open;
+    }
+
+    /// @brief Getter for the contents of the file, this stays valid as long as the mapped file
+    /// @return The contents
+    std::string_view Contents() const {
+        return std::string_view(m_data, m_size);
+    }
+
+    /// @brief This checksums some data, eight bytes at a time in four independent lanes so it runs at memory speed. It is for telling
+    ///        whether a file has changed, not for security
+    /// @param data The data to checksum
+    /// @return The checksum
+    static uint64_t Checksum(std::string_view data);
+};
+
+}
+
+#endif
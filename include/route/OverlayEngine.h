@@ -0,0 +1,107 @@
+#ifndef OVERLAYENGINE_H
+#define OVERLAYENGINE_H
+
+#include <log4cxx/logger.h>
+#include <memory>
+#include <vector>
+#include "route/IRouteEngine.h"
+#include "route/RouteGraph.h"
+
+namespace route {
+
+/// @brief This is the part of a multi-level overlay that only depends on which routes there are, not on the location costs. The
+///        locations are split into cells, and each cell into smaller cells at the level below, by recursive bisection. The boundary
+///        of a cell is its entry locations (with a route in from outside the cell) and exit locations (with a route out of it)
+struct OverlayPartition {
+    /// @brief This is one cell at one level
+    struct Cell {
+        std::vector<LocationId> entries;    /// The locations with a route into the cell from outside it
+        std::vector<LocationId> exits;      /// The locations with a route out of the cell
+        size_t clique_offset;               /// The offset of the cell's clique in the overlay costs, entries.size() x exits.size() row by row
+        uint32_t begin;                     /// The cell's locations are [begin, end) of the location order
+        uint32_t end;
+    };
+
+    /// @brief This is one level of the overlay, level 1 has the smallest cells
+    struct Level {
+        std::vector<Cell> cells;
+        std::vector<uint32_t> location_cells;   /// The cell of each location
+        std::vector<uint32_t> entry_indexes;    /// The position of each location in its cell's entries, or INVALID_BOUNDARY_INDEX
+        std::vector<uint32_t> exit_indexes;     /// The position of each location in its cell's exits, or INVALID_BOUNDARY_INDEX
+    };
+
+    static const uint32_t INVALID_BOUNDARY_INDEX = UINT32_MAX;
+
+    uint64_t topology_fingerprint;              /// The topology fingerprint of the route graph it was built for
+    std::vector<LocationId> order;              /// The locations ordered so each cell at every level is a contiguous range
+    std::vector<Level> levels;                  /// The levels, levels[0] is level 1
+    size_t clique_size;                         /// The number of entries in all the cliques together
+
+    /// @brief This builds the partition, cells get up to the given number of locations at each level
+    /// @param graph The route graph
+    /// @param cell_sizes The most locations in a cell at each level, smallest first. Levels with cells as big as the graph are left out
+    OverlayPartition(const RouteGraph& graph, const std::vector<size_t>& cell_sizes);
+
+    /// @brief Getter for the number of levels above the route graph
+    /// @return The level count
+    size_t LevelCount() const {
+        return levels.size();
+    }
+};
+
+/// @brief This is a customisable route planning engine. Over the route graph sits a multi-level overlay: at each level every cell has a
+///        clique, the cheapest route cost inside the cell from each of its entries to each of its exits, worked out from the cliques of
+///        the level below. A query is a bidirectional search that uses the route graph near the start and end locations and the
+///        cliques of the biggest cells holding neither of them everywhere else.
+///        The partition (see OverlayPartition) only depends on the routes, so a change of location costs only needs the cliques
+///        working out again (the customisation), and a single location cost change only needs the cliques of the cells holding that
+///        location. The factory keeps the partition from one route graph to the next while the routes don't change
+class OverlayEngine : public IRouteEngine {
+    static log4cxx::LoggerPtr m_logger;
+    std::shared_ptr<const RouteGraph> m_graph;
+    std::shared_ptr<const OverlayPartition> m_partition;
+    std::vector<unsigned int> m_clique_costs;   /// The cliques of every cell at every level, see OverlayPartition::Cell::clique_offset
+
+    /// @brief class constructor, for cliques that have already been worked out
+    OverlayEngine(std::shared_ptr<const RouteGraph> graph, std::shared_ptr<const OverlayPartition> partition, std::vector<unsigned int>&& clique_costs);
+
+    /// @brief This works out the cliques of a set of cells at one level, spread across the cores. The cliques of the level below must
+    ///        already be worked out
+    /// @param level_i The level (0 for level 1)
+    /// @param cell_ids The cells
+    void CustomiseCells(size_t level_i, const std::vector<uint32_t>& cell_ids);
+
+    struct Query;
+
+    /// @brief This settles the next search state on one side of a query and relaxes the routes or clique costs leaving it
+    /// @return False if the side has nothing left to settle
+    template <bool Forward>
+    bool Step(Query& query) const;
+public:
+    /// @brief class constructor, this runs the customisation over a partition already built for the route graph's routes
+    /// @param graph The route graph snapshot
+    /// @param partition The partition of the route graph, its topology fingerprint must match the graph's
+    OverlayEngine(std::shared_ptr<const RouteGraph> graph, std::shared_ptr<const OverlayPartition> partition);
+
+    unsigned int GetRouteCost(LocationId start_id, LocationId end_id) const override;
+
+    /// @brief This customises a copy of the engine for the changed graph. A location cost change only works out again the cliques of
+    ///        the cells holding the location, a route change needs a new partition and so is built from scratch
+    RouteEnginePtr ApplyChange(std::shared_ptr<const RouteGraph> graph, const RouteChange& change) const override;
+
+    /// @brief Getter for the partition
+    /// @return The partition
+    std::shared_ptr<const OverlayPartition> GetPartition() const {
+        return m_partition;
+    }
+
+    /// @brief Getter for a factory that builds this engine. The factory keeps the last partition it built, and reuses it for a route
+    ///        graph with the same routes, so only the customisation is run
+    /// @param cell_sizes The most locations in a cell at each level, smallest first
+    /// @return The engine factory
+    static RouteEngineFactory Factory(const std::vector<size_t>& cell_sizes = {128, 2048});
+};
+
+}
+
+#endif
@@ -0,0 +1,174 @@
+#ifndef PAGEDGRAPH_H
+#define PAGEDGRAPH_H
+
+#include <log4cxx/logger.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+#include "route/BufferPool.h"
+#include "route/LocationOrder.h"
+#include "route/PerfectNameIndex.h"
+#include "route/RouteGraph.h"
+
+namespace route {
+
+const size_t DEFAULT_PAGE_SIZE = 16 * 1024;                     /// This is the page size of a paged graph file, it is made bigger for a location with too many routes to fit in a page
+const size_t DEFAULT_BUFFER_POOL_SIZE = 256 * 1024 * 1024;      /// This is the memory a paged graph keeps its pages in by default
+
+/// @brief This is a route graph kept on disk, for graphs too big to hold in memory. The routes are stored in fixed size pages, each
+///        holding a run of locations: their costs, and their routes in compressed sparse row form with the cost of each route next to
+///        its destination. Each page is a compact patch of the graph, grown out from a location over the routes, so the locations a
+///        search reaches together are mostly in the same few pages, and the location ids of the paged graph are the order the
+///        locations were paged in. Only the pages a search touches are read, into a bounded buffer pool (see route/BufferPool.h), and
+///        everything kept in memory besides is the first location of each page and the location names.
+///        The file is a header (a magic string ending in the format version, the page size, the counts and the checksum of the index)
+///        padded to a page, then the pages, then the index: the first location of each page, the checksum of each page and the
+///        location names as a written PerfectNameIndex. Each page is checked against its checksum as it is read
+class PagedGraph {
+    static log4cxx::LoggerPtr m_logger;
+    const std::string m_paged_file;
+    size_t m_page_size;
+    size_t m_location_count;
+    size_t m_route_count;
+    uint64_t m_checksum;                                /// The checksum of the index, which holds the checksum of every page
+    std::vector<LocationId> m_page_first_ids;           /// The first location of each page, with one extra at the end
+    std::vector<uint64_t> m_page_checksums;
+    std::shared_ptr<const PerfectNameIndex> m_names;
+    std::unique_ptr<BufferPool> m_buffer_pool;
+
+    PagedGraph(const std::string& paged_file);
+
+    PagedGraph(const PagedGraph& other); //copying of the paged graph is dissalowed
+
+    /// @brief This checks a page as it is read, against its checksum and the locations it should hold
+    /// @param page_id The page
+    /// @param words The contents of the page
+    /// @return True if the page is good, False if not
+    bool CheckPage(uint32_t page_id, const uint32_t* words) const;
+public:
+    /// @brief This saves a paged graph file, each page is grown by a breadth first search over the routes from the first location in
+    ///        the location order not yet paged. The locations take their ids from the order they are paged in. It is written to the
+    ///        side and renamed over the file so a reader never sees half a file
+    /// @param paged_file The path of the paged graph file
+    /// @param names The location names, by location id
+    /// @param graph The route graph, by location id
+    /// @param location_order The order to start the pages from
+    /// @param page_size The page size to use, it is made bigger if a location has too many routes to fit in a page
+    /// @return True on success, False if the file couldn't be written
+    static bool Save(const std::string& paged_file, const PerfectNameIndex& names, const RouteGraph& graph, const LocationOrder& location_order,
+        size_t page_size = DEFAULT_PAGE_SIZE);
+
+    /// @brief This opens a paged graph file saved by Save(). The index is read and checked, the pages are only read as they are needed
+    /// @param paged_file The path of the paged graph file
+    /// @param buffer_pool_size The memory to keep pages in, at least one page is kept whatever this is
+    /// @return The paged graph, or nullptr if there is no file or it is malformed
+    static std::shared_ptr<const PagedGraph> Open(const std::string& paged_file, size_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+
+    /// @brief This makes a paged graph file from a compiled graph file (see route/GraphFile.h), in the location order kept in it
+    /// @param graph_file The path of the graph file
+    /// @param paged_file The path of the paged graph file to save
+    /// @param page_size The page size to use
+    /// @return True on success, False if the graph file couldn't be loaded or the paged graph file couldn't be written
+    static bool Convert(const std::string& graph_file, const std::string& paged_file, size_t page_size = DEFAULT_PAGE_SIZE);
+
+    /// @brief Check if a file starts like a paged graph file, without opening it
+    /// @param path The path of the file
+    /// @return True if it is a paged graph file of this format version, False if not
+    static bool IsPagedGraphFile(const std::string& path);
+
+    /// @brief Getter for the checksum of the file, two files with the same checksum are almost certainly the same graph
+    /// @return The checksum
+    uint64_t Checksum() const {
+        return m_checksum;
+    }
+
+    /// @brief Getter for the location names
+    /// @return The names, by location id
+    std::shared_ptr<const PerfectNameIndex> Names() const {
+        return m_names;
+    }
+
+    /// @brief Getter for the number of locations
+    /// @return The number of locations
+    size_t LocationCount() const {
+        return m_location_count;
+    }
+
+    /// @brief Getter for the number of routes
+    /// @return The number of routes
+    size_t RouteCount() const {
+        return m_route_count;
+    }
+
+    /// @brief Getter for the number of pages
+    /// @return The number of pages
+    size_t PageCount() const {
+        return m_page_checksums.size();
+    }
+
+    /// @brief Getter for the page size
+    /// @return The page size in bytes
+    size_t PageSize() const {
+        return m_page_size;
+    }
+
+    /// @brief Getter for the counters of the buffer pool, for its hit rate and the I/O done
+    /// @return The counters
+    BufferPoolCounters Counters() const {
+        return m_buffer_pool->Counters();
+    }
+
+    /// @brief Getter for the number of pages the buffer pool holds
+    /// @return The frame count
+    size_t FrameCount() const {
+        return m_buffer_pool->FrameCount();
+    }
+
+    /// @brief This finds the page a location is in
+    /// @param location_id The id of the location, it must be in the graph
+    /// @return The page
+    uint32_t PageOf(LocationId location_id) const {
+        return static_cast<uint32_t>(std::upper_bound(m_page_first_ids.begin(), m_page_first_ids.end(), location_id) - m_page_first_ids.begin() - 1);
+    }
+
+    /// @brief This asks for a page to be read ahead of it being needed, see BufferPool::Prefetch()
+    /// @param page_id The page
+    void Prefetch(uint32_t page_id) const {
+        m_buffer_pool->Prefetch(page_id);
+    }
+
+    /// @brief Getter for the point cost of a location, this reads its page if it isn't in the buffer pool
+    /// @param location_id The id of the location, it must be in the graph
+    /// @return The point cost, or ROUTE_COST_ERROR if its page couldn't be read
+    unsigned int LocationCost(LocationId location_id) const;
+
+    /// @brief This calls a function for each route leaving a location, reading its page if it isn't in the buffer pool. The page is
+    ///        pinned while the function is called, so the function mustn't read other pages
+    /// @param location_id The id of the location, it must be in the graph
+    /// @param route_function This is called with (destination id, route cost) for each route
+    /// @return True if the routes were read, False if the page couldn't be read, the function isn't called
+    template <typename RouteFunction>
+    bool ForEachRoute(LocationId location_id, RouteFunction route_function) const {
+        const uint32_t page_id = PageOf(location_id);
+        const BufferPool::PageHandle page = m_buffer_pool->Fetch(page_id);
+        const uint32_t* const words = page.Words();
+        if (!words) {
+            return false;
+        }
+        const uint32_t location_i = location_id - m_page_first_ids[page_id];
+        const uint32_t page_location_count = m_page_first_ids[page_id + 1] - m_page_first_ids[page_id];
+        // The page is the location count and first location, the route offsets, the location costs and then the routes, as pairs of
+        // (destination, route cost)
+        const uint32_t* const offsets = words + 2;
+        const uint32_t* const routes = offsets + 2 * page_location_count + 1;
+        for (uint32_t route_i = offsets[location_i]; route_i < offsets[location_i + 1]; ++route_i) {
+            route_function(routes[2 * route_i], routes[2 * route_i + 1]);
+        }
+        return true;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef PAGEDGRAPHDATABASE_H
+#define PAGEDGRAPHDATABASE_H
+
+#include <memory>
+#include <string>
+#include "route/GraphDatabase.h"
+#include "route/PagedGraph.h"
+
+namespace route {
+
+/// @brief This class is both the location database and the route database, over a paged graph file (see route/PagedGraph.h) for graphs
+///        too big to hold in memory. Loading it only reads the index of the file, the paged graph is handed to the route planner as
+///        it is (see ILocationDatabase::GetPagedGraph()) and searched where it is on disk, with at most the buffer pool size of it in
+///        memory at once. The location ids are the ids of the paged graph, which is the order its locations are paged in. Asking for
+///        the locations through the older interfaces reads every page for the location costs and keeps every location in memory, so
+///        it is only for graphs that fit (see route/GraphDatabase.h)
+class PagedGraphDatabase : public GraphDatabase<PagedGraph> {
+    const size_t m_buffer_pool_size;                                                /// The memory the paged graph keeps its pages in
+
+protected:
+    /// @brief This opens the paged graph file
+    /// @return The paged graph, or nullptr if there is no file or it is malformed
+    std::shared_ptr<const PagedGraph> LoadGraph() const;
+
+public:
+    /// @brief This is the class constructor
+    /// @param paged_file The path of the paged graph file
+    /// @param buffer_pool_size The memory the paged graph keeps its pages in
+    PagedGraphDatabase(const std::string& paged_file, size_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE);
+
+    /// @brief This returns the paged graph
+    /// @return The paged graph, or nullptr if nothing is loaded
+    std::shared_ptr<const PagedGraph> GetPagedGraph() const;
+};
+
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef PAGEDROUTEENGINE_H
+#define PAGEDROUTEENGINE_H
+
+#include <log4cxx/logger.h>
+#include <memory>
+#include <vector>
+#include "route/IRouteEngine.h"
+#include "route/PagedGraph.h"
+
+namespace route {
+
+/// @brief This is a route engine over a paged graph kept on disk (see route/PagedGraph.h), for graphs too big to hold in memory. Each
+///        query is a Dijkstra search that only keeps the locations it has reached, and reads the routes of each location it settles
+///        through the buffer pool of the paged graph. As it goes it asks for the pages its routes lead into to be read ahead, so they
+///        are on their way by the time the search settles a location in them. There is no preprocessing, so it can't be rebuilt for
+///        a change to the route graph, a paged graph can only be changed by writing the file again. A query that needs a page that
+///        can't be read gives ROUTE_COST_ERROR rather than a route cost
+class PagedRouteEngine : public IRouteEngine {
+    static log4cxx::LoggerPtr m_logger;
+    std::shared_ptr<const PagedGraph> m_graph;
+
+    /// @brief This runs one search from a start location until every end location is settled
+    /// @param start_id The id of the start location
+    /// @param end_ids The ids of the end locations
+    /// @return The route cost to each end location, ROUTE_COST_UNREACHABLE where there is no route, or ROUTE_COST_ERROR for every
+    ///         end location if a page the search needed couldn't be read
+    std::vector<unsigned int> RouteCosts(LocationId start_id, const std::vector<LocationId>& end_ids) const;
+public:
+    /// @brief class constructor
+    /// @param graph The paged graph to search over
+    PagedRouteEngine(std::shared_ptr<const PagedGraph> graph);
+
+    unsigned int GetRouteCost(LocationId start_id, LocationId end_id) const override;
+
+    /// @brief The search from each start location is shared between all the end locations, the start locations are spread across
+    ///        the cores
+    std::vector<unsigned int> GetRouteCosts(const std::vector<LocationId>& start_ids, const std::vector<LocationId>& end_ids) const override;
+
+    /// @brief Getter for the paged graph searched over, for the counters of its buffer pool
+    /// @return The paged graph
+    std::shared_ptr<const PagedGraph> Graph() const {
+        return m_graph;
+    }
+};
+
+}
+
+#endif
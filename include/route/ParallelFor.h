@@ -0,0 +1,47 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <vector>
+
+namespace route {
+
+/// @brief This gets the number of worker threads to use for parallel work
+/// @return The number of hardware threads, or 1 if that isn't known
+inline size_t WorkerCount() {
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/// @brief This runs a function over every index in [0, count) spread across a set of worker threads, returning once all are done.
+///        Indexes are handed out one at a time so uneven amounts of work per index still balance across the workers
+/// @param count The number of indexes
+/// @param worker_count The number of worker threads to use, the calling thread is one of them
+/// @param function This is called with (index, worker index), the worker index is in [0, worker_count) so it can be used to pick
+///                 per worker scratch space
+inline void ParallelFor(size_t count, size_t worker_count, const std::function<void(size_t, size_t)>& function) {
+    worker_count = std::max<size_t>(1, std::min(worker_count, count));
+    std::atomic<size_t> next_index(0);
+
+    auto worker = [&next_index, count, &function](size_t worker_i) -> void {
+        for (size_t index = next_index++; index < count; index = next_index++) {
+            function(index, worker_i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t worker_i = 1; worker_i < worker_count; ++worker_i) {
+        threads.emplace_back(worker, worker_i);
+    }
+    worker(0);
+    std::for_each(threads.begin(), threads.end(), [](std::thread& thread) -> void {
+        thread.join();
+    });
+}
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef PERFECTNAMEINDEX_H
+#define PERFECTNAMEINDEX_H
+
+#include <log4cxx/logger.h>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "route/Location.h"
+
+namespace route {
+
+const size_t PERFECT_NAME_INDEX_BUCKET_SIZE = 4;    /// This is the average number of names per bucket of the perfect hash, more is smaller but slower to build
+
+/// @brief This is a read only lookup of location name -> location id for a set of names fixed when it is built, such as the locations
+///        of one load of the location database. The names are kept back to back in one string, and looked up through a minimal perfect
+///        hash built with hash and displace (CHD): each name hashes once to a bucket, and each bucket has a seed chosen when the index is
+///        built so its names land in slots no other name has. There is a slot for every distinct name and nothing else, each holding
+///        the id of its name and where the name is kept, so a lookup is one hash, one seed, one slot and one compare of the name in the
+///        slot against the name looked up (the verification, as a name that isn't in the index still lands in some slot)
+class PerfectNameIndex {
+    /// @brief This is one slot, the offset of the name is kept alongside its id so checking the name is one less memory access
+    struct Slot {
+        uint32_t name_offset;
+        LocationId id;
+    };
+
+    static log4cxx::LoggerPtr m_logger;
+    std::string m_characters;                   /// The names in id order, each followed by a '\0'
+    std::vector<uint32_t> m_name_offsets;       /// The offset of each name in m_characters, with one extra at the end
+    std::vector<uint32_t> m_bucket_seeds;       /// The seed of each bucket
+    std::vector<Slot> m_slots;                  /// The slots, one per distinct name
+    uint64_t m_hash_seed;                       /// The seed of the name hash, changed if two names collide when the index is built
+
+    /// @brief This works out the buckets and slots, it fails if the names can't be placed with the current hash seed
+    /// @return True on success, False if the hash seed needs changing
+    bool Build();
+
+    static uint64_t Mix(uint64_t value) {
+        value ^= value >> 32;
+        value *= 0xd6e8feb86659fd93ULL;
+        value ^= value >> 32;
+        value *= 0xd6e8feb86659fd93ULL;
+        value ^= value >> 32;
+        return value;
+    }
+
+    /// @brief This hashes a name, eight characters at a time
+    static uint64_t Hash(std::string_view name, uint64_t hash_seed) {
+        uint64_t hash = hash_seed ^ (name.size() * 0x9e3779b97f4a7c15ULL);
+        size_t character_i = 0;
+        for (; character_i + sizeof(uint64_t) <= name.size(); character_i += sizeof(uint64_t)) {
+            uint64_t word;
+            std::memcpy(&word, name.data() + character_i, sizeof(word));
+            hash = Mix(hash ^ word);
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, name.data() + character_i, name.size() - character_i);
+        return Mix(hash ^ tail);
+    }
+
+    /// @brief This maps a 32 bit value onto [0, count) with a multiply rather than a divide
+    static uint32_t Range(uint64_t value, size_t count) {
+        return static_cast<uint32_t>(((value & 0xffffffffULL) * count) >> 32);
+    }
+
+    uint32_t Bucket(uint64_t hash) const {
+        return Range(hash >> 32, m_bucket_seeds.size());
+    }
+
+    uint32_t SlotIndex(uint64_t hash, uint32_t bucket_seed) const {
+        return Range(Mix(hash + bucket_seed * 0x9e3779b97f4a7c15ULL), m_slots.size());
+    }
+public:
+    /// @brief class constructor, for an index with no names
+    PerfectNameIndex();
+
+    /// @brief class constructor, this builds the index
+    /// @param names The names, the id of each name is its position in the list. Where a name is repeated the first id is used. The names
+    ///              can't have a '\0' in them
+    PerfectNameIndex(const std::vector<std::string_view>& names);
+
+    /// @brief This writes the index, names and all, so it can be read back with Read() rather than built again. It is written in the
+    ///        machine's own byte order
+    /// @param file The stream to write to
+    void Write(std::ostream& file) const;
+
+    /// @brief This reads an index written by Write(), replacing this one. The index is checked as it is read so a malformed one can't
+    ///        make a lookup read out of bounds
+    /// @param data The bytes written by Write(), on success this is moved on past them
+    /// @return True on success, False if the index is malformed (this index is left empty)
+    bool Read(std::string_view& data);
+
+    /// @brief This will look up the id of a name
+    /// @param name The name to look up
+    /// @return The id of the name, or INVALID_LOCATION_ID if it isn't in the index
+    LocationId Find(std::string_view name) const {
+        if (m_slots.empty()) {
+            return INVALID_LOCATION_ID;
+        }
+        const uint64_t hash = Hash(name, m_hash_seed);
+        const Slot& slot = m_slots[SlotIndex(hash, m_bucket_seeds[Bucket(hash)])];
+        // The name in the slot matches if it starts with the name looked up and ends straight after it
+        if (slot.name_offset + name.size() >= m_characters.size()) {
+            return INVALID_LOCATION_ID;
+        }
+        const char* const slot_name = m_characters.data() + slot.name_offset;
+        return std::memcmp(slot_name, name.data(), name.size()) == 0 && slot_name[name.size()] == '\0' ? slot.id : INVALID_LOCATION_ID;
+    }
+
+    /// @brief This will look up the name for an id
+    /// @param id The id of the name, it must be in the index
+    /// @return The name
+    std::string_view Name(LocationId id) const {
+        return std::string_view(m_characters.data() + m_name_offsets[id], m_name_offsets[id + 1] - m_name_offsets[id] - 1);
+    }
+
+    /// @brief Getter for the number of names in the index, repeated names included
+    /// @return The number of names
+    size_t Size() const {
+        return m_name_offsets.size() - 1;
+    }
+
+    /// @brief Getter for the memory used by the index
+    /// @return The size of the index in bytes
+    size_t MemoryBytes() const {
+        return m_characters.size() + (m_name_offsets.size() + m_bucket_seeds.size()) * sizeof(uint32_t) + m_slots.size() * sizeof(Slot);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,310 @@
+#ifndef PRIORITYQUEUE_H
+#define PRIORITYQUEUE_H
+
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "route/Location.h"
+
+namespace route {
+
+/// @brief This is a single entry held in one of the route search priority queues
+struct QueueEntry {
+    LocationId index;   /// This is the id of the location the entry is for
+    unsigned int cost;  /// This is the route cost used to order the entry
+
+    QueueEntry(LocationId index, unsigned int cost) :
+    index(index),
+    cost(cost) {
+    }
+};
+
+/// @brief This is a d-ary min heap priority queue policy. Push() never removes an older entry for the same location, so the search
+///        is expected to skip stale entries as they are popped
+/// @tparam Arity The number of children each heap node has
+template <size_t Arity>
+class DaryHeapQueue {
+    static_assert(Arity >= 2, "A heap needs at least two children per node");
+    std::vector<QueueEntry> m_heap;
+
+    void SiftUp(size_t i) {
+        QueueEntry entry = m_heap[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / Arity;
+            if (m_heap[parent].cost <= entry.cost) {
+                break;
+            }
+            m_heap[i] = m_heap[parent];
+            i = parent;
+        }
+        m_heap[i] = entry;
+    }
+
+    void SiftDown(size_t i) {
+        QueueEntry entry = m_heap[i];
+        const size_t size = m_heap.size();
+        while (true) {
+            size_t first_child = i * Arity + 1;
+            if (first_child >= size) {
+                break;
+            }
+            size_t last_child = first_child + Arity < size ? first_child + Arity : size;
+            size_t min_child = first_child;
+            for (size_t child = first_child + 1; child < last_child; ++child) {
+                if (m_heap[child].cost < m_heap[min_child].cost) {
+                    min_child = child;
+                }
+            }
+            if (entry.cost <= m_heap[min_child].cost) {
+                break;
+            }
+            m_heap[i] = m_heap[min_child];
+            i = min_child;
+        }
+        m_heap[i] = entry;
+    }
+
+public:
+    /// @brief This will empty the queue ready for a new search, keeping any memory already allocated
+    /// @param location_count The number of locations the search can push, this queue doesn't need it
+    void Reset(size_t) {
+        m_heap.clear();
+    }
+
+    /// @brief Check if there is anything left in the queue
+    /// @return True if empty, False if not
+    bool Empty() const {
+        return m_heap.empty();
+    }
+
+    /// @brief This will add a location to the queue at the given cost
+    /// @param index The id of the location
+    /// @param cost The route cost to the location
+    void Push(LocationId index, unsigned int cost) {
+        m_heap.emplace_back(index, cost);
+        SiftUp(m_heap.size() - 1);
+    }
+
+    /// @brief This will remove the lowest cost entry from the queue
+    /// @return The lowest cost entry
+    QueueEntry Pop() {
+        QueueEntry top = m_heap.front();
+        m_heap.front() = m_heap.back();
+        m_heap.pop_back();
+        if (!m_heap.empty()) {
+            SiftDown(0);
+        }
+        return top;
+    }
+};
+
+typedef DaryHeapQueue<2> BinaryHeapQueue;       /// The classic binary heap
+typedef DaryHeapQueue<4> QuaternaryHeapQueue;   /// A shallower heap, trading more compares per level for fewer cache lines touched
+
+/// @brief This is a pairing heap priority queue policy. Unlike the other policies it supports decrease-key, so each location is in the
+///        queue at most once and the search never sees stale entries
+class PairingHeapQueue {
+    static const LocationId NONE = INVALID_LOCATION_ID;
+
+    /// @brief This is a heap node, there is one per location
+    struct Node {
+        unsigned int cost;
+        LocationId child;   /// The left most child of this node
+        LocationId sibling; /// The next sibling to the right of this node
+        LocationId prev;    /// The parent if this is the left most child, otherwise the sibling to the left
+        bool in_heap;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<LocationId> m_pairs;    /// Scratch space for the two pass merge in Pop()
+    LocationId m_root;
+
+    LocationId Meld(LocationId a, LocationId b) {
+        if (a == NONE) {
+            return b;
+        }
+        if (b == NONE) {
+            return a;
+        }
+        if (m_nodes[b].cost < m_nodes[a].cost) {
+            std::swap(a, b);
+        }
+        // b becomes the left most child of a
+        m_nodes[b].sibling = m_nodes[a].child;
+        if (m_nodes[a].child != NONE) {
+            m_nodes[m_nodes[a].child].prev = b;
+        }
+        m_nodes[b].prev = a;
+        m_nodes[a].child = b;
+        m_nodes[a].sibling = NONE;
+        m_nodes[a].prev = NONE;
+        return a;
+    }
+
+    void Detach(LocationId index) {
+        Node& node = m_nodes[index];
+        if (m_nodes[node.prev].child == index) {
+            m_nodes[node.prev].child = node.sibling;
+        }
+        else {
+            m_nodes[node.prev].sibling = node.sibling;
+        }
+        if (node.sibling != NONE) {
+            m_nodes[node.sibling].prev = node.prev;
+        }
+        node.sibling = NONE;
+        node.prev = NONE;
+    }
+
+public:
+    PairingHeapQueue() :
+    m_root(NONE) {
+    }
+
+    /// @brief This will empty the queue ready for a new search, keeping any memory already allocated
+    /// @param location_count The number of locations the search can push
+    void Reset(size_t location_count) {
+        m_nodes.assign(location_count, Node{0, NONE, NONE, NONE, false});
+        m_root = NONE;
+    }
+
+    /// @brief Check if there is anything left in the queue
+    /// @return True if empty, False if not
+    bool Empty() const {
+        return m_root == NONE;
+    }
+
+    /// @brief This will add a location to the queue at the given cost, or lower its cost if it is already queued
+    /// @param index The id of the location
+    /// @param cost The route cost to the location
+    void Push(LocationId index, unsigned int cost) {
+        Node& node = m_nodes[index];
+        if (node.in_heap) {
+            if (cost >= node.cost) {
+                return;
+            }
+            node.cost = cost;
+            if (index != m_root) {
+                Detach(index);
+                m_root = Meld(m_root, index);
+            }
+            return;
+        }
+        node = Node{cost, NONE, NONE, NONE, true};
+        m_root = Meld(m_root, index);
+    }
+
+    /// @brief This will remove the lowest cost entry from the queue
+    /// @return The lowest cost entry
+    QueueEntry Pop() {
+        const LocationId top = m_root;
+        m_nodes[top].in_heap = false;
+
+        // Two pass merge, pair the children up left to right then meld the pairs right to left
+        m_pairs.clear();
+        LocationId child = m_nodes[top].child;
+        while (child != NONE) {
+            LocationId first = child;
+            LocationId second = m_nodes[first].sibling;
+            child = second != NONE ? m_nodes[second].sibling : NONE;
+            m_nodes[first].sibling = m_nodes[first].prev = NONE;
+            if (second != NONE) {
+                m_nodes[second].sibling = m_nodes[second].prev = NONE;
+            }
+            m_pairs.push_back(Meld(first, second));
+        }
+
+        m_root = NONE;
+        for (auto pair = m_pairs.rbegin(); pair != m_pairs.rend(); ++pair) {
+            m_root = Meld(m_root, *pair);
+        }
+        m_nodes[top].child = NONE;
+
+        return QueueEntry(top, m_nodes[top].cost);
+    }
+};
+
+/// @brief This is a radix heap priority queue policy for integer costs. It relies on the search being monotone (nothing is pushed
+///        below the last popped cost), which always holds for Dijkstra with non negative location costs
+class RadixHeapQueue {
+    static const size_t BUCKET_COUNT = sizeof(unsigned int) * 8 + 1;
+
+    std::array<std::vector<QueueEntry>, BUCKET_COUNT> m_buckets;
+    unsigned int m_last;
+    size_t m_size;
+
+    /// @brief Bucket 0 holds entries equal to the last popped cost, bucket i holds entries whose highest bit differing from it is i - 1
+    static size_t Bucket(unsigned int cost, unsigned int last) {
+        unsigned int diff = cost ^ last;
+        size_t bucket = 0;
+        while (diff) {
+            diff >>= 1;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+public:
+    RadixHeapQueue() :
+    m_last(0),
+    m_size(0) {
+    }
+
+    /// @brief This will empty the queue ready for a new search, keeping any memory already allocated
+    /// @param location_count The number of locations the search can push, this queue doesn't need it
+    void Reset(size_t) {
+        for (auto& bucket : m_buckets) {
+            bucket.clear();
+        }
+        m_last = 0;
+        m_size = 0;
+    }
+
+    /// @brief Check if there is anything left in the queue
+    /// @return True if empty, False if not
+    bool Empty() const {
+        return m_size == 0;
+    }
+
+    /// @brief This will add a location to the queue at the given cost
+    /// @param index The id of the location
+    /// @param cost The route cost to the location, this must not be lower than the last popped cost
+    void Push(LocationId index, unsigned int cost) {
+        m_buckets[Bucket(cost, m_last)].emplace_back(index, cost);
+        ++m_size;
+    }
+
+    /// @brief This will remove the lowest cost entry from the queue
+    /// @return The lowest cost entry
+    QueueEntry Pop() {
+        if (m_buckets[0].empty()) {
+            size_t i = 1;
+            while (m_buckets[i].empty()) {
+                ++i;
+            }
+
+            // Move the minimum up to last, then everything in this bucket lands in a lower one
+            unsigned int new_last = m_buckets[i].front().cost;
+            for (const QueueEntry& entry : m_buckets[i]) {
+                if (entry.cost < new_last) {
+                    new_last = entry.cost;
+                }
+            }
+            m_last = new_last;
+            for (const QueueEntry& entry : m_buckets[i]) {
+                m_buckets[Bucket(entry.cost, m_last)].push_back(entry);
+            }
+            m_buckets[i].clear();
+        }
+
+        QueueEntry top = m_buckets[0].back();
+        m_buckets[0].pop_back();
+        --m_size;
+        return top;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef REACHABILITYINDEX_H
+#define REACHABILITYINDEX_H
+
+#include <log4cxx/logger.h>
+#include <vector>
+#include "route/RouteGraph.h"
+
+namespace route {
+
+const size_t DEFAULT_REACHABILITY_LABELLINGS = 2;   /// This is the number of interval labellings of the component graph, more of them rule out more pairs
+
+/// @brief This is an index of which locations can reach which, so a query between locations with no route between them can be
+///        answered without a search. The locations are split into strongly connected components, every location in a component can
+///        reach every other one. The components form a DAG (the condensation of the graph), which is labelled with intervals from
+///        randomised depth first searches: a component can only reach another if each of its intervals contains the other's.
+///        The index never says there is no route when there is one, but it can miss that there is no route, in which case the
+///        search finds out
+class ReachabilityIndex {
+    /// @brief This is the [low, post] interval of a component in one labelling, post is its depth first post order number and low is
+    ///        the lowest post order number of everything it reaches
+    struct Interval {
+        uint32_t low;
+        uint32_t post;
+    };
+
+    static log4cxx::LoggerPtr m_logger;
+    std::vector<uint32_t> m_components;     /// The component of each location. Components are numbered sinks first, so a component only reaches lower numbered ones
+    size_t m_component_count;
+    size_t m_labelling_count;
+    std::vector<Interval> m_intervals;      /// The intervals of each component, indexed [component * labelling count + labelling]
+
+    /// @brief This works out the strongly connected components with Tarjan's algorithm, run without recursion as the graphs can be
+    ///        deep
+    void BuildComponents(const RouteGraph& graph);
+
+    /// @brief This labels the component graph with the intervals
+    void BuildIntervals(const RouteGraph& graph);
+public:
+    /// @brief class constructor, this builds the index
+    /// @param graph The route graph to index
+    /// @param labelling_count The number of interval labellings
+    ReachabilityIndex(const RouteGraph& graph, size_t labelling_count = DEFAULT_REACHABILITY_LABELLINGS);
+
+    /// @brief Getter for the number of strongly connected components
+    /// @return The component count
+    size_t ComponentCount() const {
+        return m_component_count;
+    }
+
+    /// @brief Getter for the strongly connected component of a location
+    /// @param location_id The id of the location
+    /// @return The component
+    uint32_t Component(LocationId location_id) const {
+        return m_components[location_id];
+    }
+
+    /// @brief Getter for the memory used by the index
+    /// @return The size of the index in bytes
+    size_t MemoryBytes() const {
+        return m_components.size() * sizeof(uint32_t) + m_intervals.size() * sizeof(Interval);
+    }
+
+    /// @brief This checks whether there may be a route between two locations, in constant time
+    /// @param start_id The id of the start location
+    /// @param end_id The id of the end location
+    /// @return False if there is no route, True if there may be one
+    bool MayReach(LocationId start_id, LocationId end_id) const {
+        const uint32_t start_component = m_components[start_id];
+        const uint32_t end_component = m_components[end_id];
+        if (start_component == end_component) {
+            return true;
+        }
+        if (end_component > start_component) {
+            return false;
+        }
+
+        const Interval* start_intervals = &m_intervals[start_component * m_labelling_count];
+        const Interval* end_intervals = &m_intervals[end_component * m_labelling_count];
+        for (size_t labelling_i = 0; labelling_i < m_labelling_count; ++labelling_i) {
+            if (end_intervals[labelling_i].low < start_intervals[labelling_i].low || end_intervals[labelling_i].post > start_intervals[labelling_i].post) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}
+
+#endif
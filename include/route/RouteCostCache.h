@@ -0,0 +1,110 @@
+#ifndef ROUTECOSTCACHE_H
+#define ROUTECOSTCACHE_H
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include "route/RouteGraph.h"
+
+namespace route {
+
+const size_t DEFAULT_ROUTE_COST_CACHE_CAPACITY = 1024;  /// This is the number of route costs the route planner keeps by default
+
+/// @brief This is a bounded least recently used cache of route costs, keyed by the (start, end) location id pair. Every entry is
+///        tagged with the version of the route graph snapshot it was worked out on, and the whole cache is flushed when a lookup or
+///        insert arrives with a newer version, so a stale route cost is never served. A lookup or insert with an older version misses
+///        and leaves the cache alone. A version made by a small change can instead carry over the route costs it can't have touched
+///        (see Advance). It is safe to use from several threads
+class RouteCostCache {
+    /// @brief This is a cached route cost
+    struct Entry {
+        uint64_t key;               /// This is the (start, end) pair packed into one value
+        unsigned int route_cost;
+    };
+
+    size_t m_capacity;
+    mutable std::mutex m_mutex;
+    uint64_t m_version;                                                     /// The route graph version the cached route costs belong to
+    std::list<Entry> m_entries;                                             /// The cached route costs, most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> m_index;       /// The position of each cached route cost in m_entries
+    size_t m_hit_count;
+    size_t m_miss_count;
+    size_t m_eviction_count;
+
+    /// @brief This packs a route into a single cache key
+    static uint64_t Key(LocationId start_id, LocationId end_id) {
+        return (static_cast<uint64_t>(start_id) << 32) | end_id;
+    }
+
+    /// @brief This flushes the cache if the version has moved on, the caller must hold m_mutex
+    /// @param version The route graph version of the caller
+    /// @return True if the cached route costs are for the version of the caller, False if the caller is on an older version
+    bool CheckVersion(uint64_t version);
+public:
+    /// @brief class constructor
+    /// @param capacity The most route costs to keep, 0 disables the cache
+    RouteCostCache(size_t capacity = DEFAULT_ROUTE_COST_CACHE_CAPACITY);
+
+    /// @brief This looks up a route cost, marking it as most recently used if found
+    /// @param version The version of the route graph snapshot the caller is using
+    /// @param start_id The id of the start location
+    /// @param end_id The id of the end location
+    /// @param route_cost This is set to the cached route cost if found
+    /// @return True if the route cost was found
+    bool Lookup(uint64_t version, LocationId start_id, LocationId end_id, unsigned int& route_cost);
+
+    /// @brief This adds a route cost, evicting the least recently used route cost if the cache is full
+    /// @param version The version of the route graph snapshot the route cost was worked out on
+    /// @param start_id The id of the start location
+    /// @param end_id The id of the end location
+    /// @param route_cost The route cost
+    void Insert(uint64_t version, LocationId start_id, LocationId end_id, unsigned int route_cost);
+
+    /// @brief This moves the cache on to the route graph version made by one change to the version it holds, keeping the route costs
+    ///        the change can't have touched. If the cache holds any other version every route cost is flushed
+    /// @param version The version before the change
+    /// @param new_version The version after the change
+    /// @param keep This is called with (start id, end id, route cost) for each cached route cost, it returns true to keep it
+    template <typename KeepFunction>
+    void Advance(uint64_t version, uint64_t new_version, KeepFunction keep) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_version != version) {
+            CheckVersion(new_version);
+            return;
+        }
+        for (auto entry = m_entries.begin(); entry != m_entries.end();) {
+            if (keep(static_cast<LocationId>(entry->key >> 32), static_cast<LocationId>(entry->key), entry->route_cost)) {
+                ++entry;
+            }
+            else {
+                m_index.erase(entry->key);
+                entry = m_entries.erase(entry);
+            }
+        }
+        m_version = new_version;
+    }
+
+    /// @brief This removes every cached route cost, the counters are kept
+    void Clear();
+
+    /// @brief Getter for the most route costs the cache keeps
+    size_t Capacity() const {
+        return m_capacity;
+    }
+
+    /// @brief Getter for the number of route costs currently cached
+    size_t Size() const;
+
+    /// @brief Getter for the number of lookups that found a route cost
+    size_t HitCount() const;
+
+    /// @brief Getter for the number of lookups that did not find a route cost
+    size_t MissCount() const;
+
+    /// @brief Getter for the number of route costs evicted to make room for new ones, flushes on a version change are not counted
+    size_t EvictionCount() const;
+};
+
+}
+
+#endif
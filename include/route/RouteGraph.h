@@ -0,0 +1,178 @@
+#ifndef ROUTEGRAPH_H
+#define ROUTEGRAPH_H
+
+#include <climits>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "route/Location.h"
+
+namespace route {
+
+const unsigned int ROUTE_COST_UNREACHABLE = INT_MAX;   /// This is the route cost of a location that cannot be reached
+const unsigned int ROUTE_COST_ERROR = UINT_MAX;         /// This is the cost given when it couldn't be worked out, as a page of a paged graph couldn't be read
+
+/// @brief This is a single change to a route graph: a new cost for one location, or one route added or removed
+struct RouteChange {
+    enum ChangeType {
+        LOCATION_COST,
+        ADD_ROUTE,
+        REMOVE_ROUTE
+    };
+
+    ChangeType type;
+    LocationId start_id;    /// The location whose cost changes, or the start of the route
+    LocationId end_id;      /// The end of the route, INVALID_LOCATION_ID for a location cost change
+    unsigned int cost;      /// The new location cost, 0 for a route change
+
+    /// @brief This makes a change to the cost of a location
+    static RouteChange LocationCost(LocationId location_id, unsigned int cost) {
+        return RouteChange{LOCATION_COST, location_id, INVALID_LOCATION_ID, cost};
+    }
+
+    /// @brief This makes a change adding a route
+    static RouteChange AddRoute(LocationId start_id, LocationId end_id) {
+        return RouteChange{ADD_ROUTE, start_id, end_id, 0};
+    }
+
+    /// @brief This makes a change removing a route
+    static RouteChange RemoveRoute(LocationId start_id, LocationId end_id) {
+        return RouteChange{REMOVE_ROUTE, start_id, end_id, 0};
+    }
+};
+
+/// @brief This is an immutable snapshot of the routes between locations, stored in compressed sparse row form. Locations are referred
+///        to by their index (which is their LocationId), and the routes leaving a location are the contiguous range [RoutesBegin(), RoutesEnd()) of the destination
+///        and route cost arrays. The route cost of each route is the cost of the location it enters, copied next to the destination
+///        so the search doesn't have to look it up.
+///        The reverse adjacency (the routes entering each location) is built alongside, for searches that run backwards from the end
+///        location. A reverse route keeps the cost of the forward route it mirrors, which is the cost of the location it leaves
+class RouteGraph {
+    std::vector<unsigned int> m_location_costs;         /// This is the point cost of each location
+    std::vector<uint32_t> m_offsets;                    /// This is the offset of the first route of each location, with one extra at the end
+    std::vector<LocationId> m_destinations;             /// This is the destination id of each route
+    std::vector<unsigned int> m_route_costs;            /// This is the cost of each route (the cost of the destination location)
+    std::vector<uint32_t> m_reverse_offsets;            /// This is the offset of the first route entering each location, with one extra at the end
+    std::vector<LocationId> m_origins;                  /// This is the origin id of each reverse route
+    std::vector<unsigned int> m_reverse_route_costs;    /// This is the cost of each reverse route (the cost of the location it leaves)
+
+    void Build(const std::vector<std::pair<size_t, size_t>>& routes);
+public:
+    /// @brief This will build the graph from a list of locations and the destinations set on each of them. Destinations that are not
+    ///        in the list are ignored
+    /// @param locations The list of locations, the id of each location must be its position in this list
+    RouteGraph(const std::vector<Location*>& locations);
+
+    /// @brief This will build the graph from a list of location costs and a list of routes
+    /// @param location_costs The point cost of each location
+    /// @param routes The list of (start id, end id) routes
+    RouteGraph(const std::vector<unsigned int>& location_costs, const std::vector<std::pair<size_t, size_t>>& routes);
+
+    /// @brief This will build the graph from routes already in compressed sparse row form, such as the ones kept in a compiled graph
+    ///        file (see route/GraphFile.h), taking the arrays on rather than copying them
+    /// @param location_costs The point cost of each location
+    /// @param offsets The offset of the first route of each location, with one extra at the end. They must run from 0 up to the number
+    ///                of routes
+    /// @param destinations The destination id of each route, each must be a location
+    RouteGraph(std::vector<unsigned int>&& location_costs, std::vector<uint32_t>&& offsets, std::vector<LocationId>&& destinations);
+
+    /// @brief This will build a copy of a graph with one change made to it, the change must be valid for the graph (see
+    ///        HasRoute())
+    /// @param graph The graph to copy
+    /// @param change The change to make
+    RouteGraph(const RouteGraph& graph, const RouteChange& change);
+
+    /// @brief Check if there is a route between two locations
+    /// @param start_id The id of the start location
+    /// @param end_id The id of the end location
+    /// @return True if there is a route, False if not
+    bool HasRoute(LocationId start_id, LocationId end_id) const;
+
+    /// @brief This hashes the location costs and the routes, two graphs with the same fingerprint are almost certainly the same graph.
+    ///        It is for checking that something worked out from a graph and kept (in a file, say) is still for the same graph
+    /// @return The fingerprint
+    uint64_t Fingerprint() const;
+
+    /// @brief This hashes the routes alone, like Fingerprint() but two graphs that only differ in location costs get the same one
+    /// @return The topology fingerprint
+    uint64_t TopologyFingerprint() const;
+
+    /// @brief Getter for the number of locations in the graph
+    /// @return The number of locations
+    size_t LocationCount() const {
+        return m_location_costs.size();
+    }
+
+    /// @brief Getter for the number of routes in the graph
+    /// @return The number of routes
+    size_t RouteCount() const {
+        return m_destinations.size();
+    }
+
+    /// @brief Getter for the point cost of a location
+    /// @param location_id The id of the location
+    /// @return The point cost
+    unsigned int LocationCost(LocationId location_id) const {
+        return m_location_costs[location_id];
+    }
+
+    /// @brief Getter for the first route leaving a location
+    /// @param location_id The id of the location
+    /// @return The index of the first route
+    uint32_t RoutesBegin(LocationId location_id) const {
+        return m_offsets[location_id];
+    }
+
+    /// @brief Getter for one past the last route leaving a location
+    /// @param location_id The id of the location
+    /// @return The index one past the last route
+    uint32_t RoutesEnd(LocationId location_id) const {
+        return m_offsets[location_id + 1];
+    }
+
+    /// @brief Getter for the destination of a route
+    /// @param route_i The index of the route
+    /// @return The id of the destination location
+    LocationId Destination(uint32_t route_i) const {
+        return m_destinations[route_i];
+    }
+
+    /// @brief Getter for the cost of a route
+    /// @param route_i The index of the route
+    /// @return The cost of taking the route
+    unsigned int RouteCost(uint32_t route_i) const {
+        return m_route_costs[route_i];
+    }
+
+    /// @brief Getter for the first route entering a location
+    /// @param location_id The id of the location
+    /// @return The index of the first reverse route
+    uint32_t ReverseRoutesBegin(LocationId location_id) const {
+        return m_reverse_offsets[location_id];
+    }
+
+    /// @brief Getter for one past the last route entering a location
+    /// @param location_id The id of the location
+    /// @return The index one past the last reverse route
+    uint32_t ReverseRoutesEnd(LocationId location_id) const {
+        return m_reverse_offsets[location_id + 1];
+    }
+
+    /// @brief Getter for the origin of a reverse route
+    /// @param route_i The index of the reverse route
+    /// @return The id of the location the route starts from
+    LocationId Origin(uint32_t route_i) const {
+        return m_origins[route_i];
+    }
+
+    /// @brief Getter for the cost of a reverse route
+    /// @param route_i The index of the reverse route
+    /// @return The cost of the forward route it mirrors
+    unsigned int ReverseRouteCost(uint32_t route_i) const {
+        return m_reverse_route_costs[route_i];
+    }
+};
+
+}
+
+#endif
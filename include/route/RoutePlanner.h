@@ -2,55 +2,243 @@
 #define ROUTEPLANNER_H
 
 #include <log4cxx/logger.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include "route/ILocationDatabase.h"
 #include "route/IRouteDatabase.h"
+#include "route/IRouteEngine.h"
 #include "route/Location.h"
+#include "route/RouteCostCache.h"
+#include "route/RouteGraph.h"
+#include "route/RouteSnapshot.h"
 
 namespace route {
 
-/// @brief this is the main Route planner class, it should know how to create all the routes between locations
+const std::chrono::milliseconds DEFAULT_RELOAD_POLL_INTERVAL(250);   /// This is how often the databases are checked for changes when they are reloaded in the background
+
+/// @brief this is the main Route planner class, it should know how to create all the routes between locations. Queries are answered
+///        from an immutable route snapshot that is swapped atomically when the databases are reloaded, so they never block on a
+///        reload and never see the locations being changed underneath them.
+///        The location ids taken and given out are the location database ids, the route graph numbers the locations in its own order
+///        (see route/LocationOrder.h) and they are mapped to and from it here
 class RoutePlanner {
     static log4cxx::LoggerPtr m_logger;
     std::shared_ptr<ILocationDatabase> m_location_db;
     std::shared_ptr<IRouteDatabase> m_route_db;
+    mutable std::mutex m_reload_mutex;                  /// This is held while the databases are reloaded and a snapshot is built, queries never take it
+    mutable RouteSnapshotPtr m_snapshot;                /// This is the current route snapshot, only ever read with std::atomic_load and written with std::atomic_store
+    RouteEngineFactory m_engine_factory;                /// This builds the route engine for each route graph snapshot
+    mutable uint64_t m_graph_version;                   /// This is bumped every time the route graph snapshot is rebuilt
+    RouteCostCache m_route_cost_cache;                  /// This holds the most recently requested route costs for the current route graph snapshot
+    std::thread m_reload_thread;                        /// This reloads the databases in the background when they change, see StartReloading()
+    std::mutex m_reload_wait_mutex;                     /// This guards m_reload_stop
+    std::condition_variable m_reload_wait;              /// The reload thread waits on this between checks, it is woken to stop
+    bool m_reload_stop;                                 /// This tells the reload thread to stop
+    std::atomic<bool> m_reloading;                      /// This is set while the reload thread is running, queries then only read the current snapshot
+
+    /// @brief Getter for the current route snapshot
+    /// @return The snapshot, or nullptr if the routes haven't been set up yet
+    RouteSnapshotPtr Snapshot() const {
+        return std::atomic_load(&m_snapshot);
+    }
+
+    /// @brief This brings the route snapshot up to date with the databases, they are only reloaded if they may have changed (see
+    ///        ILocationDatabase::HasChanged()). If another thread is already reloading them this doesn't wait for it, the current
+    ///        snapshot is good enough, unless there isn't one yet. While the databases are reloaded in the background (see
+    ///        StartReloading()) this only gives the current snapshot
+    /// @return The current route snapshot, or nullptr if there are no routes
+    RouteSnapshotPtr Refresh() const;
+
+    /// @brief This is the reload thread, it checks the databases for changes every poll interval and reloads them when they have
+    /// @param poll_interval How long to wait between checks
+    void ReloadLoop(std::chrono::milliseconds poll_interval);
+
+    /// @brief This will build a new route snapshot from the locations, along with a route engine for it, and publish it. This must be
+    ///        called with m_reload_mutex held
+    /// @param locations The list of locations with all the end destinations set
+    void BuildRouteGraph(const std::vector<Location*>& locations) const;
+
+    /// @brief This will build a new route snapshot from a route graph over the location database ids, along with a route engine for
+    ///        it, and publish it. This must be called with m_reload_mutex held
+    /// @param database_graph The route graph, by location database id
+    /// @param location_names The location names, by location database id
+    /// @param location_order The location order to search the route graph in, or nullptr to work it out
+    void BuildRouteGraph(const RouteGraph& database_graph, std::shared_ptr<const PerfectNameIndex> location_names,
+        std::shared_ptr<const LocationOrder> location_order = nullptr) const;
+
+    /// @brief This will build a new route snapshot over a paged graph kept on disk, searched with the paged route engine (see
+    ///        route/PagedRouteEngine.h), and publish it. This must be called with m_reload_mutex held
+    /// @param paged_graph The paged graph, its location ids are the location database ids
+    void BuildRouteGraph(std::shared_ptr<const PagedGraph> paged_graph) const;
+
+    /// @brief This will build the route engine for a route graph. If the engine factory refuses the graph this falls back to plain
+    ///        Dijkstra, so there is always an engine to answer queries
+    /// @param graph The route graph
+    /// @return The route engine
+    RouteEnginePtr BuildRouteEngine(std::shared_ptr<const RouteGraph> graph) const;
+
+    /// @brief This publishes a new route snapshot with one change made to the current one. The route engine repairs what it has
+    ///        worked out where it can (see IRouteEngine::ApplyChange()) and is rebuilt where it can't, and the cached route costs the
+    ///        change can't have touched are kept (see CarryRouteCosts())
+    /// @param change The change, it is checked against the current route snapshot
+    /// @return True if the change was made, False if it isn't valid
+    bool ApplyChange(const RouteChange& change);
+
+    /// @brief This carries the cached route costs over to the route snapshot made by a change, dropping those the change may have
+    ///        touched. A route cost is kept if every route through the change costs more, both before and after the change, which
+    ///        takes one search to the change and one from it over the whole graph before the change
+    /// @param current The route snapshot before the change
+    /// @param snapshot The route snapshot after the change, not yet published
+    /// @param change The change, in the internal location ids of the route graph
+    void CarryRouteCosts(const RouteSnapshot& current, const RouteSnapshot& snapshot, const RouteChange& change);
+
+    /// @brief This gets the cost to travle between two locations over one route snapshot
+    /// @param snapshot The route snapshot
+    /// @param start_location_id This is the id of the start location
+    /// @param end_location_id This is the id of the end location
+    /// @return The route cost on success, ROUTE_COST_UNREACHABLE if there is no route, ROUTE_COST_ERROR if a location is unknown or
+    ///         the route graph couldn't be read
+    unsigned int GetRouteCost(const RouteSnapshot& snapshot, LocationId start_location_id, LocationId end_location_id);
+
+    /// @brief This gets the route cost matrix over one route snapshot, see GetRouteCosts()
+    /// @param snapshot The route snapshot
+    /// @param start_location_ids These are the ids of the start locations
+    /// @param end_location_ids These are the ids of the end locations
+    /// @return The route costs as a dense matrix, row by row, or empty on failure
+    std::vector<unsigned int> GetRouteCosts(const RouteSnapshot& snapshot, const std::vector<LocationId>& start_location_ids, const std::vector<LocationId>& end_location_ids);
     
     /// @brief Disable copying of this class
     RoutePlanner(const RoutePlanner& other) {};
 protected:
-    /// @brief This should use the Location/Route databases to calculate all the destinations from each start location
-    /// @return A list of locations with all the end destinations for each location set
+    /// @brief This should use the Location/Route databases to calculate all the destinations from each start location, and rebuild
+    ///        the route snapshot from them. The databases may free and reallocate their locations, so this must only be called by one
+    ///        thread at a time (Refresh() makes sure of that) and the locations are not used by queries. Where the location database
+    ///        gives the route graph directly (see ILocationDatabase::GetRouteGraph()) or a paged graph (see
+    ///        ILocationDatabase::GetPagedGraph()) the snapshot is built from that instead
+    /// @return A list of locations with all the end destinations for each location set, empty where the location database gave the
+    ///         route graph or paged graph directly
     virtual const std::vector<Location*> SetupRoutes() const;
-
-    /// @brief Utility method to get the index of the current min route cost within a cost array, 
-    /// ignoring any that have already been processed (as indicated by the shortest path tree set)
-    /// @param route_costs Current list of route costs from start to each location 
-    /// @param spt_set Current shortest path tree set, indicating whats been proessed and not
-    /// @return The index of the minimum route cost in route_costs
-    size_t GetMinCostIndex(std::vector<unsigned int>& route_costs, std::vector<bool>& spt_set);
-
-    /// @brief Utility method to covert a location name into a index within a location set
-    /// @param locations The list of locations to search
-    /// @param location_name The location name to find
-    /// @return The index of that location in locations
-    size_t GetLocationIndex(const std::vector<Location*>& locations, std::string location_name);
 public:
 
     /// @brief This is the class constructor
     /// @param location_db A unique pointer for the location database
     /// @param route_db A unique pointer for the route database
-    RoutePlanner(std::shared_ptr<ILocationDatabase> location_db, std::shared_ptr<IRouteDatabase> route_db);
+    /// @param route_cost_cache_capacity The number of route costs to cache, 0 disables the cache
+    RoutePlanner(std::shared_ptr<ILocationDatabase> location_db, std::shared_ptr<IRouteDatabase> route_db,
+        size_t route_cost_cache_capacity = DEFAULT_ROUTE_COST_CACHE_CAPACITY);
+
+    /// @brief This is the class destructor, it stops the reload thread
+    virtual ~RoutePlanner();
+
+    /// @brief This starts reloading the databases in a background thread whenever they change, the first load is started straight
+    ///        away. From then on queries never load the databases, they only read the current route snapshot. A class deriving from
+    ///        this one that overrides SetupRoutes() should call StopReloading() before it is destroyed
+    /// @param poll_interval How often to check the databases for changes, the check doesn't read the database files
+    void StartReloading(std::chrono::milliseconds poll_interval = DEFAULT_RELOAD_POLL_INTERVAL);
+
+    /// @brief This stops the background reloading started by StartReloading(), waiting for a reload in progress to finish. Queries
+    ///        go back to reloading the databases themselves when they have changed
+    void StopReloading();
+
+    /// @brief This sets the route engine used to answer route cost queries (see route/SearchEngine.h), the default is plain Dijkstra.
+    ///        If there is already a route graph snapshot the engine is rebuilt for it straight away. If the factory refuses a route graph
+    ///        snapshot plain Dijkstra is used for it instead. A paged graph is always searched with the paged route engine
+    /// @param engine_factory The factory that builds the route engine for each route graph snapshot
+    void SetRouteEngine(RouteEngineFactory engine_factory);
+
+    /// @brief Getter for the route cost cache in front of GetRouteCost, for its hit/miss/eviction counters
+    /// @return The route cost cache
+    const RouteCostCache& GetRouteCostCache() const {
+        return m_route_cost_cache;
+    }
 
     /// @brief This should get a list of all the location names avaliable to route between
     /// @return The list of locations avaliable
     std::vector<std::string> GetLocationNames() const;
 
-    /// @brief This gets the cost to travle between two locations
-    /// @param start This is the start location
-    /// @param destination This is the end location
-    /// @return The route cost on success, 0 on failure
-    unsigned int GetRouteCost(std::string start_location_name, std::string end_location_name);
+    /// @brief This should get the number of locations avaliable to route between, the ids of the locations are 0 to this count - 1
+    /// @return The number of locations avaliable
+    size_t GetLocationCount() const;
+
+    /// @brief This resolves a location name into its id, it is intended for use at the protocol edge
+    /// @param location_name The name of the location
+    /// @return The location id, or INVALID_LOCATION_ID if there is no location with that name
+    LocationId GetLocationId(const std::string& location_name) const;
+
+    /// @brief This checks whether there may be a route between two locations without searching for it, from the reachability index
+    ///        of the current route snapshot (see route/ReachabilityIndex.h). It doesn't bring the route snapshot up to date
+    /// @param start_location_id This is the id of the start location
+    /// @param end_location_id This is the id of the end location
+    /// @return False if there is no route, a location is unknown or there are no routes set up yet, True if there may be a route
+    bool MayHaveRoute(LocationId start_location_id, LocationId end_location_id) const;
+
+    /// @brief This gets the cost to travle between two locations, recently requested route costs are served from the route cost cache.
+    ///        Locations with no route between them are answered from the reachability index without a search
+    /// @param start_location_id This is the id of the start location
+    /// @param end_location_id This is the id of the end location
+    /// @return The route cost on success, ROUTE_COST_UNREACHABLE if there is no route, 0 on failure
+    unsigned int GetRouteCost(LocationId start_location_id, LocationId end_location_id);
+
+    /// @brief This gets the cost to travel from each of a set of start locations to each of a set of end locations, sharing the work
+    ///        between the pairs where the route engine can
+    /// @param start_location_ids These are the ids of the start locations
+    /// @param end_location_ids These are the ids of the end locations
+    /// @return The route costs as a dense matrix, row by row, so the cost from start_location_ids[i] to end_location_ids[j] is at
+    ///         [i * end_location_ids.size() + j], ROUTE_COST_UNREACHABLE where there is no route. This is empty on failure
+    std::vector<unsigned int> GetRouteCosts(const std::vector<LocationId>& start_location_ids, const std::vector<LocationId>& end_location_ids);
+
+    /// @brief This answers a route request from the protocol edge, where the locations are indexes into the location list. The route
+    ///        snapshot is brought up to date first (as GetLocationCount() does) and the whole request is answered from it, so the range
+    ///        check, the reachability check and the route cost all belong to the same route graph even if a reload lands meanwhile. The
+    ///        indexes are range checked before they are narrowed to location ids
+    /// @param start_location This is the index of the start location
+    /// @param end_location This is the index of the end location
+    /// @return The route cost on success, ROUTE_COST_UNREACHABLE if there is no route, ROUTE_COST_ERROR if a location is unknown or
+    ///         the route cost couldn't be worked out, as the route graph couldn't be read. Unlike GetRouteCost() a failure is never 0,
+    ///         which is a real route cost
+    unsigned int AnswerRouteRequest(size_t start_location, size_t end_location);
+
+    /// @brief This answers a route matrix request from the protocol edge from one route snapshot, in the same way as
+    ///        AnswerRouteRequest()
+    /// @param start_locations These are the indexes of the start locations
+    /// @param end_locations These are the indexes of the end locations
+    /// @return The route costs as a dense matrix, row by row (see GetRouteCosts()). This is empty if a location is unknown or on
+    ///         failure
+    std::vector<unsigned int> AnswerRouteMatrixRequest(const std::vector<size_t>& start_locations, const std::vector<size_t>& end_locations);
+
+    /// @brief This changes the cost of one location without reloading the databases. The change is kept until the databases change
+    ///        on disk and are reloaded. The cached route costs that don't pass through the location are kept
+    /// @param location_id This is the id of the location
+    /// @param cost This is the new cost of the location
+    /// @return True on success, False if the location is unknown, there are no routes set up yet or they are in a paged graph
+    bool UpdateLocationCost(LocationId location_id, unsigned int cost);
+
+    /// @brief This adds one route without reloading the databases. The change is kept until the databases change on disk and are
+    ///        reloaded
+    /// @param start_location_id This is the id of the start location
+    /// @param end_location_id This is the id of the end location
+    /// @return True on success, False if a location is unknown, the route already exists, there are no routes set up yet or they are
+    ///         in a paged graph
+    bool AddRoute(LocationId start_location_id, LocationId end_location_id);
+
+    /// @brief This removes one route without reloading the databases. The change is kept until the databases change on disk and are
+    ///        reloaded
+    /// @param start_location_id This is the id of the start location
+    /// @param end_location_id This is the id of the end location
+    /// @return True on success, False if a location is unknown, there is no such route, there are no routes set up yet or they are in
+    ///         a paged graph
+    bool RemoveRoute(LocationId start_location_id, LocationId end_location_id);
+
+    /// @brief This gets the cost to travle between two locations given by name, the names are resolved to ids first
+    /// @param start_location_name This is the start location
+    /// @param end_location_name This is the end location
+    /// @return The route cost on success, ROUTE_COST_UNREACHABLE if there is no route, 0 on failure
+    unsigned int GetRouteCost(const std::string& start_location_name, const std::string& end_location_name);
 };
 
 }
 
-#endif
\ No newline at end of file
+#endif
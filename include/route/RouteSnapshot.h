@@ -0,0 +1,65 @@
+#ifndef ROUTESNAPSHOT_H
+#define ROUTESNAPSHOT_H
+
+#include <memory>
+#include "route/IRouteEngine.h"
+#include "route/LocationOrder.h"
+#include "route/PagedGraph.h"
+#include "route/PerfectNameIndex.h"
+#include "route/ReachabilityIndex.h"
+#include "route/RouteGraph.h"
+
+namespace route {
+
+/// @brief This is everything the route planner needs to answer a query, as of one load of the databases. A snapshot is never changed
+///        once it is published, a reload builds a new one to the side and swaps it in, so a query can hold on to the snapshot it
+///        started with for as long as it runs and the old snapshot is freed when the last query using it finishes. A snapshot of a
+///        paged graph kept on disk has no route graph, location order or reachability index in memory, the paged graph takes their
+///        place and its location ids are the location database ids
+struct RouteSnapshot {
+    uint64_t version;                                               /// This goes up by one for every route graph built
+    std::shared_ptr<const RouteGraph> graph;                        /// The route graph, over the internal location ids
+    std::shared_ptr<const LocationOrder> location_order;            /// The mapping between the location database ids and the route graph ids
+    RouteEnginePtr engine;                                          /// The route engine answering queries over the route graph
+    std::shared_ptr<const ReachabilityIndex> reachability;          /// Which locations can reach which, to answer queries with no route without a search
+    std::shared_ptr<const PerfectNameIndex> location_names;         /// The names of the locations by location database id and the lookup of name -> id, shared by the snapshots built from this one by single changes
+    std::shared_ptr<const PagedGraph> paged_graph;                  /// The paged graph when the routes are kept on disk, nullptr when they are in the route graph
+
+    /// @brief Getter for the number of locations
+    /// @return The number of locations
+    size_t LocationCount() const {
+        return paged_graph ? paged_graph->LocationCount() : graph->LocationCount();
+    }
+
+    /// @brief This maps a location database id to the id the route engine searches with
+    /// @param location_id The location database id
+    /// @return The internal id, or INVALID_LOCATION_ID if there is no such location
+    LocationId InternalId(LocationId location_id) const {
+        if (paged_graph) {
+            return location_id < paged_graph->LocationCount() ? location_id : INVALID_LOCATION_ID;
+        }
+        return location_order->InternalId(location_id);
+    }
+
+    /// @brief Getter for the point cost of a location
+    /// @param internal_id The internal id of the location, it must be in the snapshot
+    /// @return The point cost
+    unsigned int LocationCost(LocationId internal_id) const {
+        return paged_graph ? paged_graph->LocationCost(internal_id) : graph->LocationCost(internal_id);
+    }
+
+    /// @brief This checks whether there may be a route between two locations without searching, a paged graph has no reachability
+    ///        index so there may always be one
+    /// @param start_id The internal id of the start location
+    /// @param end_id The internal id of the end location
+    /// @return False if there is no route, True if there may be
+    bool MayReach(LocationId start_id, LocationId end_id) const {
+        return !reachability || reachability->MayReach(start_id, end_id);
+    }
+};
+
+typedef std::shared_ptr<const RouteSnapshot> RouteSnapshotPtr;
+
+}
+
+#endif
@@ -0,0 +1,102 @@
+#ifndef SEARCHENGINE_H
+#define SEARCHENGINE_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "route/BidirectionalDijkstraSearch.h"
+#include "route/DijkstraSearch.h"
+#include "route/IRouteEngine.h"
+#include "route/SearchTreeCache.h"
+#include "route/ThreadPool.h"
+
+namespace route {
+
+/// @brief This is a route engine that runs a search for every query, there is no preprocessing. Searches that can carry on from an
+///        earlier query (plain Dijkstra) keep the shortest path trees of recently used start locations
+/// @tparam SearchType The search to run, this needs a RouteCost(graph, start_id, end_id) method (see route/DijkstraSearch.h)
+template <typename SearchType>
+class SearchEngine : public IRouteEngine {
+    std::shared_ptr<const RouteGraph> m_graph;
+    mutable SearchTreeCache<SearchType> m_search_trees;    /// The shortest path trees of recently used start locations
+
+public:
+    /// @brief class constructor
+    /// @param graph The route graph snapshot to search over
+    /// @param search_tree_capacity The number of shortest path trees to keep, for searches that can resume
+    SearchEngine(std::shared_ptr<const RouteGraph> graph, size_t search_tree_capacity = DEFAULT_SEARCH_TREE_CACHE_CAPACITY) :
+    m_graph(graph),
+    m_search_trees(search_tree_capacity) {
+    }
+
+    unsigned int GetRouteCost(LocationId start_id, LocationId end_id) const override {
+        // Each thread keeps its own search, so its buffers are allocated once and only reset between queries
+        static thread_local SearchType search;
+        return search.RouteCost(*m_graph, start_id, end_id);
+    }
+
+    std::vector<unsigned int> GetRouteCosts(const std::vector<LocationId>& start_ids, const std::vector<LocationId>& end_ids) const override {
+        return IRouteEngine::GetRouteCosts(start_ids, end_ids);
+    }
+
+    RouteEnginePtr ApplyChange(std::shared_ptr<const RouteGraph> graph, const RouteChange& change) const override {
+        return IRouteEngine::ApplyChange(graph, change);
+    }
+
+    /// @brief Getter for a factory that builds this engine
+    /// @param search_tree_capacity The number of shortest path trees to keep, for searches that can resume
+    /// @return The engine factory
+    static RouteEngineFactory Factory(size_t search_tree_capacity = DEFAULT_SEARCH_TREE_CACHE_CAPACITY) {
+        return [search_tree_capacity](std::shared_ptr<const RouteGraph> graph) -> RouteEnginePtr {
+            return std::make_shared<const SearchEngine<SearchType>>(graph, search_tree_capacity);
+        };
+    }
+};
+
+/// @brief Dijkstra carries on from the shortest path tree of an earlier query from the same start location where there is one
+template <>
+inline unsigned int SearchEngine<DijkstraSearch<BinaryHeapQueue>>::GetRouteCost(LocationId start_id, LocationId end_id) const {
+    std::unique_ptr<DijkstraSearch<BinaryHeapQueue>> search = m_search_trees.Acquire(start_id);
+    const unsigned int route_cost = search->ResumeRouteCost(*m_graph, start_id, end_id);
+    m_search_trees.Release(std::move(search));
+    return route_cost;
+}
+
+/// @brief Dijkstra carries its shortest path trees over to the engine for the changed graph, each one repaired back to the part the
+///        change can't have touched (see DijkstraSearch::Repair), so a query from the same start location carries on from there
+template <>
+inline RouteEnginePtr SearchEngine<DijkstraSearch<BinaryHeapQueue>>::ApplyChange(std::shared_ptr<const RouteGraph> graph, const RouteChange& change) const {
+    auto engine = std::make_shared<SearchEngine<DijkstraSearch<BinaryHeapQueue>>>(graph, m_search_trees.Capacity());
+    m_search_trees.MoveTo(engine->m_search_trees, [this, &graph, &change](DijkstraSearch<BinaryHeapQueue>& search) -> bool {
+        search.Repair(*m_graph, *graph, change);
+        return true;
+    });
+    return engine;
+}
+
+/// @brief Dijkstra shares one shortest path tree per start location between all the end locations, the start locations are spread
+///        across the cores on the shared thread pool
+template <>
+inline std::vector<unsigned int> SearchEngine<DijkstraSearch<BinaryHeapQueue>>::GetRouteCosts(const std::vector<LocationId>& start_ids, const std::vector<LocationId>& end_ids) const {
+    std::vector<unsigned int> route_costs(start_ids.size() * end_ids.size());
+    if (route_costs.empty()) {
+        return route_costs;
+    }
+    ThreadPool::Shared().ParallelFor(start_ids.size(), 1, [this, &start_ids, &end_ids, &route_costs](size_t first, size_t end, size_t) -> void {
+        for (size_t start_i = first; start_i < end; ++start_i) {
+            std::unique_ptr<DijkstraSearch<BinaryHeapQueue>> search = m_search_trees.Acquire(start_ids[start_i]);
+            for (size_t end_i = 0; end_i < end_ids.size(); ++end_i) {
+                route_costs[start_i * end_ids.size() + end_i] = search->ResumeRouteCost(*m_graph, start_ids[start_i], end_ids[end_i]);
+            }
+            m_search_trees.Release(std::move(search));
+        }
+    });
+    return route_costs;
+}
+
+typedef SearchEngine<DijkstraSearch<BinaryHeapQueue>> DijkstraEngine;                           /// Plain Dijkstra from the start location
+typedef SearchEngine<BidirectionalDijkstraSearch<BinaryHeapQueue>> BidirectionalDijkstraEngine; /// Dijkstra from both ends, meeting in the middle
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef SEARCHTREECACHE_H
+#define SEARCHTREECACHE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include "route/Location.h"
+
+namespace route {
+
+const size_t DEFAULT_SEARCH_TREE_CACHE_CAPACITY = 16;  /// This is the number of shortest path trees a route engine keeps by default
+
+/// @brief This is a bounded least recently used cache of searches, keyed by the start location of the shortest path tree each one
+///        holds (see DijkstraSearch::ResumeRouteCost). A search is taken out of the cache while it is in use and put back afterwards,
+///        so concurrent queries never share one. The cache belongs to a route engine, which only lives as long as its route graph
+///        snapshot, so the trees are dropped whenever the graph is rebuilt
+/// @tparam SearchType The search to cache, this needs a Root() method giving the start location of the tree it holds
+template <typename SearchType>
+class SearchTreeCache {
+    size_t m_capacity;
+    std::mutex m_mutex;
+    std::list<std::unique_ptr<SearchType>> m_searches;  /// The searches not in use, most recently used first
+
+public:
+    /// @brief class constructor
+    /// @param capacity The most searches to keep
+    SearchTreeCache(size_t capacity = DEFAULT_SEARCH_TREE_CACHE_CAPACITY) :
+    m_capacity(capacity) {
+    }
+
+    /// @brief Getter for the most searches the cache keeps
+    size_t Capacity() const {
+        return m_capacity;
+    }
+
+    /// @brief This takes a search out of the cache for a query. If there is none holding a tree for the start location, the least
+    ///        recently used search is handed out instead so its buffers get reused, or a new one once the cache is empty
+    /// @param start_id The id of the start location of the query
+    /// @return The search, to be handed back with Release
+    std::unique_ptr<SearchType> Acquire(LocationId start_id) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (auto search = m_searches.begin(); search != m_searches.end(); ++search) {
+            if ((*search)->Root() == start_id) {
+                std::unique_ptr<SearchType> found = std::move(*search);
+                m_searches.erase(search);
+                return found;
+            }
+        }
+        if (m_searches.size() >= m_capacity && !m_searches.empty()) {
+            std::unique_ptr<SearchType> oldest = std::move(m_searches.back());
+            m_searches.pop_back();
+            return oldest;
+        }
+        return std::unique_ptr<SearchType>(new SearchType());
+    }
+
+    /// @brief This moves the searches a predicate picks into another cache, most recently used first, and drops the rest
+    /// @param other The cache to move the searches into
+    /// @param keep This is called with each search, it may change the search and returns true to move it
+    template <typename KeepFunction>
+    void MoveTo(SearchTreeCache& other, KeepFunction keep) {
+        std::list<std::unique_ptr<SearchType>> searches;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            searches.swap(m_searches);
+        }
+        for (auto search = searches.rbegin(); search != searches.rend(); ++search) {
+            if (keep(**search)) {
+                other.Release(std::move(*search));
+            }
+        }
+    }
+
+    /// @brief This hands a search back to the cache once the query is done with it, as the most recently used. If a concurrent query
+    ///        already handed back a tree for the same start location that one is dropped
+    /// @param search The search
+    void Release(std::unique_ptr<SearchType> search) {
+        if (m_capacity == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const LocationId start_id = search->Root();
+        m_searches.remove_if([start_id](const std::unique_ptr<SearchType>& cached) -> bool {
+            return cached->Root() == start_id;
+        });
+        m_searches.push_front(std::move(search));
+        if (m_searches.size() > m_capacity) {
+            m_searches.pop_back();
+        }
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include <cstdint>
+#include <vector>
+#include "route/RouteGraph.h"
+
+namespace route {
+
+/// @brief This is the per location state of a search: the current route cost to each location and whether it has been settled. The
+///        arrays are only allocated when the graph grows, and each location carries the generation of the search that last wrote it,
+///        so starting a new search is a counter bump rather than a pass over every location. Anything stamped with an older
+///        generation reads as unreached, so the cost of a search is only the locations it touches
+class SearchWorkspace {
+    /// @brief This is the state of one location, kept together so a relaxation touches one cache line
+    struct Slot {
+        unsigned int route_cost;
+        uint32_t stamp;         /// 2 * generation once reached by the current search, 2 * generation + 1 once settled
+    };
+
+    std::vector<Slot> m_slots;
+    uint32_t m_generation;
+
+public:
+    SearchWorkspace() :
+    m_slots(),
+    m_generation(0) {
+    }
+
+    /// @brief This empties the workspace ready for a new search
+    /// @param location_count The number of locations in the graph to be searched
+    void Reset(size_t location_count) {
+        if (m_slots.size() < location_count) {
+            m_slots.resize(location_count, Slot{ROUTE_COST_UNREACHABLE, 0});
+        }
+        if (++m_generation >= UINT32_MAX / 2) {
+            // The stamps are about to wrap, so this one time every location really is cleared
+            for (Slot& slot : m_slots) {
+                slot.stamp = 0;
+            }
+            m_generation = 1;
+        }
+    }
+
+    /// @brief Getter for the current route cost to a location
+    /// @param location_id The id of the location
+    /// @return The route cost, ROUTE_COST_UNREACHABLE if the search hasn't reached the location
+    unsigned int RouteCost(LocationId location_id) const {
+        const Slot& slot = m_slots[location_id];
+        return (slot.stamp >> 1) == m_generation ? slot.route_cost : ROUTE_COST_UNREACHABLE;
+    }
+
+    /// @brief Setter for the current route cost to a location
+    /// @param location_id The id of the location
+    /// @param route_cost The route cost
+    void SetRouteCost(LocationId location_id, unsigned int route_cost) {
+        Slot& slot = m_slots[location_id];
+        if ((slot.stamp >> 1) != m_generation) {
+            slot.stamp = m_generation << 1;
+        }
+        slot.route_cost = route_cost;
+    }
+
+    /// @brief This lowers the route cost to a location if the new route is cheaper and the location isn't settled yet, the usual
+    ///        Dijkstra relaxation done with a single look at the location's state
+    /// @param location_id The id of the location
+    /// @param route_cost The route cost through the new route
+    /// @return True if the route cost was lowered
+    bool Relax(LocationId location_id, unsigned int route_cost) {
+        Slot& slot = m_slots[location_id];
+        if ((slot.stamp >> 1) != m_generation) {
+            slot.stamp = m_generation << 1;
+            slot.route_cost = route_cost;
+            return true;
+        }
+        if ((slot.stamp & 1) || route_cost >= slot.route_cost) {
+            return false;
+        }
+        slot.route_cost = route_cost;
+        return true;
+    }
+
+    /// @brief Check if a location has been settled by the search
+    /// @param location_id The id of the location
+    /// @return True if settled, False if not
+    bool Settled(LocationId location_id) const {
+        return m_slots[location_id].stamp == ((m_generation << 1) | 1);
+    }
+
+    /// @brief This marks a location the search has reached as settled
+    /// @param location_id The id of the location
+    void Settle(LocationId location_id) {
+        m_slots[location_id].stamp = (m_generation << 1) | 1;
+    }
+};
+
+}
+
+#endif
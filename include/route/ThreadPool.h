@@ -0,0 +1,74 @@
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace route {
+
+/// @brief This is a fixed set of worker threads for running many short parallel loops, where starting threads for every loop (as
+///        ParallelFor in route/ParallelFor.h does) would cost more than the loop. The workers sleep between loops. The workers run one
+///        loop at a time, a loop asked for from another thread while they are busy is run on that thread instead of waiting for them
+class ThreadPool {
+    /// @brief This is a parallel loop being run by the pool
+    struct Loop {
+        size_t count;
+        size_t chunk_size;
+        const std::function<void(size_t, size_t, size_t)>* function;
+        std::atomic<size_t> next_index;
+    };
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_loop_mutex;            /// Held by the thread running a loop on the workers
+    std::mutex m_mutex;
+    std::condition_variable m_start;    /// Signalled when there is a new loop for the workers, or they are to stop
+    std::condition_variable m_done;     /// Signalled when the last worker finishes its part of a loop
+    uint64_t m_generation;              /// This is bumped for every loop handed to the workers
+    size_t m_busy_count;                /// The number of workers yet to finish the current loop
+    bool m_stop;
+    Loop m_loop;
+
+    /// @brief This is the body of each worker thread
+    /// @param worker_i The index of the worker
+    void WorkerThread(size_t worker_i);
+
+    /// @brief This runs chunks of the current loop until there are none left
+    /// @param worker_i The index of the worker
+    void RunChunks(size_t worker_i);
+public:
+    /// @brief class constructor, this starts the worker threads
+    /// @param worker_count The number of workers, the thread running a loop is one of them so one fewer thread is started
+    ThreadPool(size_t worker_count);
+
+    /// @brief class destructor, this stops the worker threads
+    ~ThreadPool();
+
+    /// @brief Getter for the pool shared by the route engines, so a query or an update spread across the cores doesn't start threads
+    ///        of its own. It is started the first time it is asked for, with a worker for each core
+    /// @return The shared pool
+    static ThreadPool& Shared();
+
+    /// @brief Getter for the number of workers, including the thread running a loop
+    /// @return The worker count
+    size_t WorkerCount() const {
+        return m_threads.size() + 1;
+    }
+
+    /// @brief This runs a function over every index in [0, count) spread across the workers, returning once all are done. Indexes are
+    ///        handed out in chunks, and a loop of a single chunk, or one asked for while the workers are busy with another thread's loop,
+    ///        is run straight on the calling thread. Per worker scratch space has to belong to the loop rather than the pool
+    /// @param count The number of indexes
+    /// @param chunk_size The number of indexes handed to a worker at a time
+    /// @param function This is called with (first index, end index, worker index) for each chunk, the worker index is in
+    ///                 [0, WorkerCount()) so it can be used to pick per worker scratch space
+    void ParallelFor(size_t count, size_t chunk_size, const std::function<void(size_t, size_t, size_t)>& function);
+};
+
+}
+
+#endif
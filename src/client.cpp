@@ -103,7 +103,12 @@ public:
     /// @return A Locations Request Message, to start the main loop again
     MsgHeader::MsgPointer HandleRouteResponseMsg(MsgRouteResponse::MsgPointer route_response) {
         LOG4CXX_INFO(m_logger, "Received Route Response Msg. timestamp=" << route_response->DateString()); 
-        std::cout << "Route Calculation cost " << route_response->GetData()->cost << std::endl;
+        if (route_response->GetData()->cost == MSG_ROUTE_NO_ROUTE) {
+            std::cout << "There is no route between these locations" << std::endl;
+        }
+        else {
+            std::cout << "Route Calculation cost " << route_response->GetData()->cost << std::endl;
+        }
 
         m_locations_cache.clear();
         return m_msg_factory->Create(MSG_LOCATIONS_REQUEST_ID);
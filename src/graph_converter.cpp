@@ -0,0 +1,40 @@
+#include <iostream>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <string>
+#include "route/GraphFile.h"
+#include "route/PagedGraph.h"
+
+using namespace log4cxx;
+using namespace route;
+
+int main(int argc, char* argv[])
+{
+    PropertyConfigurator::configure("log4cxx.properties");
+    LoggerPtr logger = Logger::getLogger("graph_converter");
+
+    if (argc != 4) {
+        std::cout << "Usage:" << std::endl;
+        std::cout << "\tgraph_converter [LOCATION DB FILE] [ROUTE DB FILE] [GRAPH FILE]" << std::endl;
+        std::cout << "\tgraph_converter --paged [GRAPH FILE] [PAGED GRAPH FILE]" << std::endl;
+        std::cout << "Example:" << std::endl;
+        std::cout << "\tgraph_converter locations.dat routes.dat routes.graph" << std::endl;
+        std::cout << "\tgraph_converter --paged routes.graph routes.paged" << std::endl;
+        return 1;
+    }
+
+    if (std::string(argv[1]) == "--paged") {
+        if (!PagedGraph::Convert(argv[2], argv[3])) {
+            LOG4CXX_ERROR(logger, "Could not convert the graph file into a paged graph file");
+            return 1;
+        }
+        return 0;
+    }
+
+    if (!GraphFile::Convert(argv[1], argv[2], argv[3])) {
+        LOG4CXX_ERROR(logger, "Could not convert the location and route files into a graph file");
+        return 1;
+    }
+    return 0;
+}
@@ -23,6 +23,10 @@ MsgHeader::MsgPointer MsgFactory::Create(const unsigned int id) const {
             return MsgRouteRequest::MsgPointer(new MsgRouteRequest());
         case MSG_ROUTE_RESPONSE_ID:
             return MsgRouteResponse::MsgPointer(new MsgRouteResponse());
+        case MSG_ROUTE_MATRIX_REQUEST_ID:
+            return MsgRouteMatrixRequest::MsgPointer(new MsgRouteMatrixRequest());
+        case MSG_ROUTE_MATRIX_RESPONSE_ID:
+            return MsgRouteMatrixResponse::MsgPointer(new MsgRouteMatrixResponse());
     }
     LOG4CXX_WARN(m_logger, "Unkown msg id=" << id);
     return MsgHeader::MsgPointer(nullptr);
@@ -33,7 +37,7 @@ MsgHeader::MsgPointer MsgFactory::Header() const {
 }
 
 size_t MsgFactory::MaxLength() const {
-    return sizeof(MsgHeaderData) + sizeof(MsgLocationsResponseData);
+    return sizeof(MsgHeaderData) + std::max(sizeof(MsgLocationsResponseData), sizeof(MsgRouteMatrixResponseData));
 }
 
 }
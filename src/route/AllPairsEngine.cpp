@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <chrono>
+#include "route/AllPairsEngine.h"
+#include "route/DijkstraSearch.h"
+#include "route/ThreadPool.h"
+
+namespace route {
+
+log4cxx::LoggerPtr AllPairsEngine::m_logger(log4cxx::Logger::getLogger("AllPairsEngine"));
+
+AllPairsEngine::AllPairsEngine(std::shared_ptr<const RouteGraph> graph, ThreadPool& thread_pool) :
+m_graph(graph),
+m_location_count(graph->LocationCount()),
+m_route_costs(graph->LocationCount() * graph->LocationCount()),
+m_thread_pool(thread_pool) {
+    const auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<LocationId> start_ids(m_location_count);
+    for (size_t start_i = 0; start_i < m_location_count; ++start_i) {
+        start_ids[start_i] = static_cast<LocationId>(start_i);
+    }
+    FillRows(start_ids);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    LOG4CXX_INFO(m_logger, "Built all pairs route cost table. locations.n=" << m_location_count << " memory_bytes=" << MemoryBytes()
+        << " workers.n=" << m_thread_pool.WorkerCount() << " time_ms=" << elapsed.count());
+}
+
+AllPairsEngine::AllPairsEngine(std::shared_ptr<const RouteGraph> graph, std::vector<unsigned int>&& route_costs, ThreadPool& thread_pool) :
+m_graph(graph),
+m_location_count(graph->LocationCount()),
+m_route_costs(std::move(route_costs)),
+m_thread_pool(thread_pool) {
+}
+
+void AllPairsEngine::FillRows(const std::vector<LocationId>& start_ids) {
+    // Each worker has its own search, and each start location fills its own row of the table
+    std::vector<DijkstraSearch<BinaryHeapQueue>> searches(m_thread_pool.WorkerCount());
+    m_thread_pool.ParallelFor(start_ids.size(), 1, [this, &start_ids, &searches](size_t first, size_t end, size_t worker_i) -> void {
+        for (size_t start_i = first; start_i < end; ++start_i) {
+            const std::vector<unsigned int>& route_costs = searches[worker_i].RouteCostsFrom(*m_graph, start_ids[start_i]);
+            std::copy(route_costs.begin(), route_costs.end(), m_route_costs.begin() + start_ids[start_i] * m_location_count);
+        }
+    });
+}
+
+RouteEnginePtr AllPairsEngine::ApplyChange(std::shared_ptr<const RouteGraph> graph, const RouteChange& change) const {
+    const auto start_time = std::chrono::steady_clock::now();
+    const size_t n = m_location_count;
+    std::vector<unsigned int> table(m_route_costs);
+    auto reachable = [](unsigned int route_cost) -> bool {
+        return route_cost != ROUTE_COST_UNREACHABLE;
+    };
+
+    // The change is a route (via_start -> via_end) whose cost went from old_cost to new_cost. For a location cost change that is
+    // entering the location, and the route cost from a start location to the end of it is the route cost to the location
+    LocationId via_start = change.start_id;
+    LocationId via_end = change.start_id;
+    unsigned int old_cost = 0;
+    unsigned int new_cost = 0;
+    if (change.type == RouteChange::LOCATION_COST) {
+        old_cost = m_graph->LocationCost(change.start_id);
+        new_cost = change.cost;
+    }
+    else {
+        via_end = change.end_id;
+        old_cost = change.type == RouteChange::ADD_ROUTE ? ROUTE_COST_UNREACHABLE : graph->LocationCost(change.end_id);
+        new_cost = change.type == RouteChange::ADD_ROUTE ? graph->LocationCost(change.end_id) : ROUTE_COST_UNREACHABLE;
+    }
+
+    // The route cost from a start location up to the start of the changed route, before the change
+    auto to_via = [this, &change, via_start](size_t start_i) -> unsigned int {
+        if (change.type == RouteChange::LOCATION_COST) {
+            // Reaching the location paid its old cost, which is taken back off to leave the route cost just before entering it
+            const unsigned int route_cost = m_route_costs[start_i * m_location_count + via_start];
+            return start_i == via_start || route_cost == ROUTE_COST_UNREACHABLE ? ROUTE_COST_UNREACHABLE : route_cost - m_graph->LocationCost(via_start);
+        }
+        return m_route_costs[start_i * m_location_count + via_start];
+    };
+    const unsigned int* via_row = &m_route_costs[via_end * n];
+
+    std::vector<LocationId> stale_rows;
+    for (size_t start_i = 0; start_i < n; ++start_i) {
+        const unsigned int before_via = to_via(start_i);
+        if (!reachable(before_via)) {
+            continue;
+        }
+        unsigned int* row = &table[start_i * n];
+        if (new_cost < old_cost) {
+            // Cheaper, so every route cost is the lower of the old one and the one through the changed route
+            const unsigned long long through = static_cast<unsigned long long>(before_via) + new_cost;
+            for (size_t end_i = 0; end_i < n; ++end_i) {
+                if (reachable(via_row[end_i]) && through + via_row[end_i] < row[end_i]) {
+                    row[end_i] = static_cast<unsigned int>(through + via_row[end_i]);
+                }
+            }
+        }
+        else {
+            // Dearer, so only a start location with a cheapest route through the changed route can be affected. The route to a
+            // dearer location itself always goes through the change, but it just costs the difference more
+            const unsigned long long through = static_cast<unsigned long long>(before_via) + old_cost;
+            const bool location_cost = change.type == RouteChange::LOCATION_COST;
+            bool stale = false;
+            for (size_t end_i = 0; end_i < n && !stale; ++end_i) {
+                stale = reachable(via_row[end_i]) && through + via_row[end_i] == row[end_i] && !(location_cost && end_i == via_end);
+            }
+            if (stale) {
+                stale_rows.push_back(static_cast<LocationId>(start_i));
+            }
+            else if (location_cost) {
+                row[via_end] = before_via + new_cost;
+            }
+        }
+    }
+
+    std::shared_ptr<AllPairsEngine> engine(new AllPairsEngine(graph, std::move(table), m_thread_pool));
+    engine->FillRows(stale_rows);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    LOG4CXX_INFO(m_logger, "Repaired all pairs route cost table. change.type=" << change.type << " rows_rebuilt.n=" << stale_rows.size()
+        << " locations.n=" << n << " time_ms=" << elapsed.count());
+    return engine;
+}
+
+RouteEngineFactory AllPairsEngine::Factory(size_t max_locations) {
+    return [max_locations](std::shared_ptr<const RouteGraph> graph) -> RouteEnginePtr {
+        if (graph->LocationCount() > max_locations) {
+            LOG4CXX_ERROR(m_logger, "Refusing to build an all pairs route cost table, there are too many locations. locations.n=" << graph->LocationCount()
+                << " max_locations=" << max_locations << " memory_bytes=" << graph->LocationCount() * graph->LocationCount() * sizeof(unsigned int));
+            return nullptr;
+        }
+        return std::make_shared<const AllPairsEngine>(graph);
+    };
+}
+
+}
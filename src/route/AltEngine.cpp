@@ -0,0 +1,22 @@
+#include "route/AltEngine.h"
+
+namespace route {
+
+AltEngine::AltEngine(std::shared_ptr<const RouteGraph> graph, size_t landmark_count) :
+m_graph(graph),
+m_landmarks(*graph, landmark_count) {
+}
+
+unsigned int AltEngine::GetRouteCost(LocationId start_id, LocationId end_id) const {
+    // Each thread keeps its own search, so its buffers are allocated once and only reset between queries
+    static thread_local AltSearch<BinaryHeapQueue> search;
+    return search.RouteCost(*m_graph, m_landmarks, start_id, end_id);
+}
+
+RouteEngineFactory AltEngine::Factory(size_t landmark_count) {
+    return [landmark_count](std::shared_ptr<const RouteGraph> graph) -> RouteEnginePtr {
+        return std::make_shared<const AltEngine>(graph, landmark_count);
+    };
+}
+
+}
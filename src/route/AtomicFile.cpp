@@ -0,0 +1,31 @@
+#include <cstdio>
+#include <fstream>
+#include "route/AtomicFile.h"
+
+namespace route {
+
+log4cxx::LoggerPtr AtomicFile::m_logger(log4cxx::Logger::getLogger("AtomicFile"));
+
+bool AtomicFile::Save(const std::string& path, const std::string& description, const std::function<void(std::ostream&)>& write_function) {
+    const std::string temp_file = path + ".tmp";
+    std::ofstream file(temp_file, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        LOG4CXX_ERROR(m_logger, "Could not open the " << description << " " << temp_file);
+        return false;
+    }
+    write_function(file);
+    file.close();
+    if (!file) {
+        LOG4CXX_ERROR(m_logger, "Could not write the " << description << " " << temp_file);
+        std::remove(temp_file.c_str());
+        return false;
+    }
+    if (std::rename(temp_file.c_str(), path.c_str()) != 0) {
+        LOG4CXX_ERROR(m_logger, "Could not rename the " << description << " " << temp_file << " to " << path);
+        std::remove(temp_file.c_str());
+        return false;
+    }
+    return true;
+}
+
+}
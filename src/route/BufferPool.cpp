@@ -0,0 +1,158 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include "route/BufferPool.h"
+
+namespace route {
+
+log4cxx::LoggerPtr BufferPool::m_logger(log4cxx::Logger::getLogger("BufferPool"));
+
+BufferPool::BufferPool(const std::string& path, uint64_t first_page_offset, size_t page_size, uint32_t page_count, size_t frame_count, PageCheck page_check) :
+m_path(path),
+m_file(open(path.c_str(), O_RDONLY | O_CLOEXEC)),
+m_first_page_offset(first_page_offset),
+m_page_size(page_size),
+m_page_check(page_check),
+m_frame_words(std::max<size_t>(1, frame_count) * (page_size / sizeof(uint32_t))),
+m_frames(std::max<size_t>(1, frame_count), Frame{NO_FRAME, 0, false, false}),
+m_page_frames(page_count, NO_FRAME),
+m_clock_hand(0),
+m_counters(),
+m_mutex(),
+m_frame_changed() {
+    if (m_file < 0) {
+        LOG4CXX_ERROR(m_logger, "Could not open the paged file " << m_path);
+        return;
+    }
+    // The pages are read in whatever order the searches want them, so the kernel shouldn't read ahead of each one
+    posix_fadvise(m_file, 0, 0, POSIX_FADV_RANDOM);
+}
+
+BufferPool::~BufferPool() {
+    if (m_file >= 0) {
+        close(m_file);
+    }
+}
+
+uint32_t BufferPool::ChooseFrame() {
+    // Two full turns of the clock are enough to clear every reference bit and come back round to an unpinned frame, if there is one
+    for (size_t step = 0; step < 2 * m_frames.size(); ++step) {
+        const uint32_t frame_i = static_cast<uint32_t>(m_clock_hand);
+        m_clock_hand = (m_clock_hand + 1) % m_frames.size();
+        Frame& frame = m_frames[frame_i];
+        if (frame.pin_count || frame.loading) {
+            continue;
+        }
+        if (frame.page_id != NO_FRAME && frame.referenced) {
+            frame.referenced = false;
+            continue;
+        }
+        return frame_i;
+    }
+    return NO_FRAME;
+}
+
+bool BufferPool::ReadPage(uint32_t page_id, uint32_t* words) {
+    char* const data = reinterpret_cast<char*>(words);
+    size_t read_size = 0;
+    while (m_file >= 0 && read_size < m_page_size) {
+        const ssize_t size = pread(m_file, data + read_size, m_page_size - read_size, m_first_page_offset + static_cast<uint64_t>(page_id) * m_page_size + read_size);
+        if (size <= 0) {
+            break;
+        }
+        read_size += size;
+    }
+    if (read_size == m_page_size && (!m_page_check || m_page_check(page_id, words))) {
+        return true;
+    }
+    LOG4CXX_ERROR(m_logger, "Could not read the page, it isn't kept in the pool. file=" << m_path << " page=" << page_id << " bytes_read=" << read_size);
+    return false;
+}
+
+BufferPool::PageHandle BufferPool::Fetch(uint32_t page_id) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        uint32_t frame_i = m_page_frames[page_id];
+        if (frame_i != NO_FRAME) {
+            Frame& frame = m_frames[frame_i];
+            if (frame.loading) {
+                // Another thread is reading the page
+                m_frame_changed.wait(lock);
+                continue;
+            }
+            ++frame.pin_count;
+            frame.referenced = true;
+            ++m_counters.hits;
+            return PageHandle(this, frame_i, m_frame_words.data() + frame_i * (m_page_size / sizeof(uint32_t)));
+        }
+
+        frame_i = ChooseFrame();
+        if (frame_i == NO_FRAME) {
+            LOG4CXX_DEBUG(m_logger, "Every frame is pinned, waiting for one. file=" << m_path << " frames=" << m_frames.size());
+            m_frame_changed.wait(lock);
+            continue;
+        }
+        Frame& frame = m_frames[frame_i];
+        if (frame.page_id != NO_FRAME) {
+            m_page_frames[frame.page_id] = NO_FRAME;
+            ++m_counters.evictions;
+        }
+        frame.page_id = page_id;
+        frame.pin_count = 1;
+        frame.referenced = true;
+        frame.loading = true;
+        m_page_frames[page_id] = frame_i;
+        ++m_counters.misses;
+
+        // The page is read without the lock, the frame is pinned and marked as loading so nothing else touches it meanwhile
+        uint32_t* const words = m_frame_words.data() + frame_i * (m_page_size / sizeof(uint32_t));
+        lock.unlock();
+        const bool read = ReadPage(page_id, words);
+        lock.lock();
+        frame.loading = false;
+        m_counters.bytes_read += m_page_size;
+        m_frame_changed.notify_all();
+        if (!read) {
+            // The frame is left empty rather than holding a page that isn't there, a thread waiting for the page reads it itself
+            ++m_counters.read_errors;
+            frame.page_id = NO_FRAME;
+            frame.pin_count = 0;
+            frame.referenced = false;
+            m_page_frames[page_id] = NO_FRAME;
+            return PageHandle(nullptr, NO_FRAME, nullptr);
+        }
+        return PageHandle(this, frame_i, words);
+    }
+}
+
+void BufferPool::Prefetch(uint32_t page_id) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_page_frames[page_id] != NO_FRAME) {
+            return;
+        }
+        ++m_counters.prefetches;
+    }
+    if (m_file >= 0) {
+        posix_fadvise(m_file, m_first_page_offset + static_cast<uint64_t>(page_id) * m_page_size, m_page_size, POSIX_FADV_WILLNEED);
+    }
+}
+
+bool BufferPool::Resident(uint32_t page_id) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_page_frames[page_id] != NO_FRAME && !m_frames[m_page_frames[page_id]].loading;
+}
+
+BufferPoolCounters BufferPool::Counters() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_counters;
+}
+
+void BufferPool::Unpin(uint32_t frame_i) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_frames[frame_i].pin_count == 0) {
+        m_frame_changed.notify_all();
+    }
+}
+
+}
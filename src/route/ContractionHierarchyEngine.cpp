@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <chrono>
+#include <queue>
+#include "route/ContractionHierarchyEngine.h"
+#include "route/PriorityQueue.h"
+
+namespace route {
+
+log4cxx::LoggerPtr ContractionHierarchyEngine::m_logger(log4cxx::Logger::getLogger("ContractionHierarchyEngine"));
+
+namespace {
+
+const size_t WITNESS_SETTLE_LIMIT = 500;    /// The most locations a witness search settles before giving up and keeping the shortcut
+
+/// @brief This is a route in the graph being contracted
+struct Arc {
+    LocationId target;
+    unsigned int cost;
+};
+
+/// @brief This is the working state of the contraction, the remaining graph is held as adjacency lists so routes can be removed and
+///        shortcuts added as locations are contracted
+class Contraction {
+    std::vector<std::vector<Arc>> m_out;        /// The routes leaving each location
+    std::vector<std::vector<Arc>> m_in;         /// The routes entering each location, the target is the origin
+    std::vector<bool> m_contracted;
+    std::vector<unsigned int> m_witness_costs;  /// Witness search route costs, reset through m_witness_touched after each search
+    std::vector<LocationId> m_witness_touched;
+    BinaryHeapQueue m_witness_queue;
+
+    static void SetArc(std::vector<Arc>& arcs, LocationId target, unsigned int cost) {
+        auto arc = std::find_if(arcs.begin(), arcs.end(), [target](const Arc& arc) -> bool {
+            return arc.target == target;
+        });
+        if (arc == arcs.end()) {
+            arcs.push_back(Arc{target, cost});
+        }
+        else if (cost < arc->cost) {
+            arc->cost = cost;
+        }
+    }
+
+    static void RemoveArc(std::vector<Arc>& arcs, LocationId target) {
+        arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [target](const Arc& arc) -> bool {
+            return arc.target == target;
+        }), arcs.end());
+    }
+
+    /// @brief This is a Dijkstra search over the remaining graph that avoids one location, looking for a route that is no more
+    ///        expensive than a shortcut through it would be. It gives up past max_cost or after settling WITNESS_SETTLE_LIMIT locations
+    void WitnessSearch(LocationId start_id, LocationId avoid_id, unsigned int max_cost) {
+        for (LocationId touched : m_witness_touched) {
+            m_witness_costs[touched] = ROUTE_COST_UNREACHABLE;
+        }
+        m_witness_touched.clear();
+        m_witness_queue.Reset(m_out.size());
+
+        m_witness_costs[start_id] = 0;
+        m_witness_touched.push_back(start_id);
+        m_witness_queue.Push(start_id, 0);
+
+        size_t settled_count = 0;
+        while (!m_witness_queue.Empty() && settled_count < WITNESS_SETTLE_LIMIT) {
+            QueueEntry min_cost = m_witness_queue.Pop();
+            if (min_cost.cost > m_witness_costs[min_cost.index]) {
+                continue;
+            }
+            if (min_cost.cost > max_cost) {
+                break;
+            }
+            ++settled_count;
+
+            for (const Arc& arc : m_out[min_cost.index]) {
+                if (arc.target == avoid_id || m_contracted[arc.target]) {
+                    continue;
+                }
+                const unsigned int adjacent_cost = min_cost.cost + arc.cost;
+                if (adjacent_cost < m_witness_costs[arc.target]) {
+                    if (m_witness_costs[arc.target] == ROUTE_COST_UNREACHABLE) {
+                        m_witness_touched.push_back(arc.target);
+                    }
+                    m_witness_costs[arc.target] = adjacent_cost;
+                    m_witness_queue.Push(arc.target, adjacent_cost);
+                }
+            }
+        }
+    }
+
+public:
+    Contraction(const RouteGraph& graph) :
+    m_out(graph.LocationCount()),
+    m_in(graph.LocationCount()),
+    m_contracted(graph.LocationCount(), false),
+    m_witness_costs(graph.LocationCount(), ROUTE_COST_UNREACHABLE) {
+        for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+            for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+                // Routes back to the same location can never be part of a cheapest route
+                if (graph.Destination(route_i) != location_id) {
+                    SetArc(m_out[location_id], graph.Destination(route_i), graph.RouteCost(route_i));
+                    SetArc(m_in[graph.Destination(route_i)], location_id, graph.RouteCost(route_i));
+                }
+            }
+        }
+    }
+
+    const std::vector<Arc>& Out(LocationId location_id) const {
+        return m_out[location_id];
+    }
+
+    const std::vector<Arc>& In(LocationId location_id) const {
+        return m_in[location_id];
+    }
+
+    /// @brief This finds the shortcuts that contracting a location needs, a shortcut u -> w is needed for each u -> v -> w unless a
+    ///        witness route u -> w that avoids v is at least as cheap
+    /// @param location_id The location v to contract
+    /// @param shortcuts This is filled with the (origin, arc) shortcuts
+    void FindShortcuts(LocationId location_id, std::vector<std::pair<LocationId, Arc>>& shortcuts) {
+        shortcuts.clear();
+        const std::vector<Arc>& out = m_out[location_id];
+        if (out.empty()) {
+            return;
+        }
+        unsigned int max_out_cost = 0;
+        for (const Arc& arc : out) {
+            max_out_cost = std::max(max_out_cost, arc.cost);
+        }
+
+        for (const Arc& in_arc : m_in[location_id]) {
+            WitnessSearch(in_arc.target, location_id, in_arc.cost + max_out_cost);
+            for (const Arc& out_arc : out) {
+                if (out_arc.target == in_arc.target) {
+                    continue;
+                }
+                const unsigned int shortcut_cost = in_arc.cost + out_arc.cost;
+                if (m_witness_costs[out_arc.target] > shortcut_cost) {
+                    shortcuts.push_back(std::make_pair(in_arc.target, Arc{out_arc.target, shortcut_cost}));
+                }
+            }
+        }
+    }
+
+    /// @brief This removes a location from the remaining graph, adding the shortcuts that replace the routes through it
+    void Contract(LocationId location_id, const std::vector<std::pair<LocationId, Arc>>& shortcuts) {
+        m_contracted[location_id] = true;
+        for (const Arc& arc : m_out[location_id]) {
+            RemoveArc(m_in[arc.target], location_id);
+        }
+        for (const Arc& arc : m_in[location_id]) {
+            RemoveArc(m_out[arc.target], location_id);
+        }
+        for (const auto& shortcut : shortcuts) {
+            SetArc(m_out[shortcut.first], shortcut.second.target, shortcut.second.cost);
+            SetArc(m_in[shortcut.second.target], shortcut.first, shortcut.second.cost);
+        }
+    }
+};
+
+}
+
+ContractionHierarchyEngine::ContractionHierarchyEngine(std::shared_ptr<const RouteGraph> graph) :
+m_graph(graph),
+m_ranks(),
+m_forward(),
+m_backward(),
+m_shortcut_count(0) {
+    Build();
+}
+
+void ContractionHierarchyEngine::Build() {
+    const auto start_time = std::chrono::steady_clock::now();
+    const size_t location_count = m_graph->LocationCount();
+    Contraction contraction(*m_graph);
+    std::vector<std::pair<LocationId, Arc>> shortcuts;
+    std::vector<int> contracted_neighbours(location_count, 0);
+    std::vector<int> levels(location_count, 0);
+
+    // The priority of a location is its edge difference (the shortcuts it needs less the routes it removes), weighted up, plus the
+    // number of its neighbours already contracted and its level (how deep the hierarchy below it is). The last two spread the
+    // contraction evenly over the graph, which keeps the upward searches small
+    auto priority = [&](LocationId location_id) -> int {
+        contraction.FindShortcuts(location_id, shortcuts);
+        const int removed = static_cast<int>(contraction.Out(location_id).size() + contraction.In(location_id).size());
+        return 2 * (static_cast<int>(shortcuts.size()) - removed) + contracted_neighbours[location_id] + levels[location_id];
+    };
+
+    typedef std::pair<int, LocationId> QueuedLocation;
+    std::priority_queue<QueuedLocation, std::vector<QueuedLocation>, std::greater<QueuedLocation>> order;
+    for (LocationId location_id = 0; location_id < location_count; ++location_id) {
+        order.push(std::make_pair(priority(location_id), location_id));
+    }
+
+    std::vector<std::vector<Arc>> forward(location_count);
+    std::vector<std::vector<Arc>> backward(location_count);
+    m_ranks.assign(location_count, 0);
+    uint32_t next_rank = 0;
+    while (!order.empty()) {
+        const LocationId location_id = order.top().second;
+        order.pop();
+
+        // Priorities go stale as the graph changes, so recheck the one picked and put it back if it is no longer the lowest
+        const int current_priority = priority(location_id);
+        if (!order.empty() && current_priority > order.top().first) {
+            order.push(std::make_pair(current_priority, location_id));
+            continue;
+        }
+
+        // Everything still connected to this location will be ranked higher, so its remaining routes are its upward routes
+        m_ranks[location_id] = next_rank++;
+        forward[location_id] = contraction.Out(location_id);
+        backward[location_id] = contraction.In(location_id);
+        for (const Arc& arc : forward[location_id]) {
+            ++contracted_neighbours[arc.target];
+            levels[arc.target] = std::max(levels[arc.target], levels[location_id] + 1);
+        }
+        for (const Arc& arc : backward[location_id]) {
+            ++contracted_neighbours[arc.target];
+            levels[arc.target] = std::max(levels[arc.target], levels[location_id] + 1);
+        }
+
+        m_shortcut_count += shortcuts.size();
+        contraction.Contract(location_id, shortcuts);
+    }
+
+    auto flatten = [](const std::vector<std::vector<Arc>>& arcs, UpwardGraph& graph) -> void {
+        graph.offsets.assign(1, 0);
+        for (const std::vector<Arc>& location_arcs : arcs) {
+            for (const Arc& arc : location_arcs) {
+                graph.targets.push_back(arc.target);
+                graph.costs.push_back(arc.cost);
+            }
+            graph.offsets.push_back(static_cast<uint32_t>(graph.targets.size()));
+        }
+    };
+    flatten(forward, m_forward);
+    flatten(backward, m_backward);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    LOG4CXX_INFO(m_logger, "Built contraction hierarchy. locations.n=" << location_count << " routes.n=" << m_graph->RouteCount()
+        << " shortcuts.n=" << m_shortcut_count << " upward_routes.n=" << (m_forward.targets.size() + m_backward.targets.size()) << " time_ms=" << elapsed.count());
+}
+
+void ContractionHierarchyEngine::SearchSide::Reset(size_t location_count) {
+    if (route_costs.size() != location_count) {
+        route_costs.assign(location_count, ROUTE_COST_UNREACHABLE);
+        settled.assign(location_count, false);
+    }
+    else {
+        for (LocationId location_id : touched) {
+            route_costs[location_id] = ROUTE_COST_UNREACHABLE;
+            settled[location_id] = false;
+        }
+    }
+    touched.clear();
+    queue.Reset(location_count);
+}
+
+void ContractionHierarchyEngine::SearchSide::SetRouteCost(LocationId location_id, unsigned int route_cost) {
+    if (route_costs[location_id] == ROUTE_COST_UNREACHABLE) {
+        touched.push_back(location_id);
+    }
+    route_costs[location_id] = route_cost;
+    queue.Push(location_id, route_cost);
+}
+
+bool ContractionHierarchyEngine::Step(const UpwardGraph& graph, const UpwardGraph& stall_graph, SearchSide& side, const SearchSide& other, unsigned int& best_cost) const {
+    while (!side.queue.Empty()) {
+        QueueEntry min_cost = side.queue.Pop();
+        if (side.settled[min_cost.index]) {
+            continue;
+        }
+        // Nothing left on this side can improve on the best meeting cost
+        if (min_cost.cost >= best_cost) {
+            return false;
+        }
+        side.settled[min_cost.index] = true;
+
+        if (other.route_costs[min_cost.index] != ROUTE_COST_UNREACHABLE && min_cost.cost + other.route_costs[min_cost.index] < best_cost) {
+            best_cost = min_cost.cost + other.route_costs[min_cost.index];
+        }
+
+        // Stall on demand, if a higher ranked location this side has reached gets here cheaper by coming down the hierarchy then the
+        // upward route found isn't a cheapest route, so don't carry on from it
+        bool stalled = false;
+        for (uint32_t route_i = stall_graph.offsets[min_cost.index]; route_i < stall_graph.offsets[min_cost.index + 1] && !stalled; ++route_i) {
+            const unsigned int higher_cost = side.route_costs[stall_graph.targets[route_i]];
+            stalled = higher_cost != ROUTE_COST_UNREACHABLE && higher_cost + stall_graph.costs[route_i] < min_cost.cost;
+        }
+        if (stalled) {
+            return true;
+        }
+
+        for (uint32_t route_i = graph.offsets[min_cost.index]; route_i < graph.offsets[min_cost.index + 1]; ++route_i) {
+            const LocationId adjacent = graph.targets[route_i];
+            const unsigned int adjacent_cost = min_cost.cost + graph.costs[route_i];
+            if (!side.settled[adjacent] && adjacent_cost < side.route_costs[adjacent]) {
+                side.SetRouteCost(adjacent, adjacent_cost);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+unsigned int ContractionHierarchyEngine::GetRouteCost(LocationId start_id, LocationId end_id) const {
+    if (start_id == end_id) {
+        return 0;
+    }
+
+    std::unique_ptr<Workspace> workspace;
+    {
+        std::lock_guard<std::mutex> lock(m_workspaces_mutex);
+        if (!m_workspaces.empty()) {
+            workspace = std::move(m_workspaces.back());
+            m_workspaces.pop_back();
+        }
+    }
+    if (!workspace) {
+        workspace.reset(new Workspace());
+    }
+
+    SearchSide& forward = workspace->forward;
+    SearchSide& backward = workspace->backward;
+    forward.Reset(m_ranks.size());
+    backward.Reset(m_ranks.size());
+    forward.SetRouteCost(start_id, 0);
+    backward.SetRouteCost(end_id, 0);
+
+    // The sides take turns, each stopping once it can't improve on the best meeting cost. Unlike a plain bidirectional search the
+    // sides can't stop as soon as they meet, the cheapest route may meet at a higher ranked location that is settled later
+    unsigned int best_cost = ROUTE_COST_UNREACHABLE;
+    bool forward_active = true;
+    bool backward_active = true;
+    while (forward_active || backward_active) {
+        if (forward_active) {
+            forward_active = Step(m_forward, m_backward, forward, backward, best_cost);
+        }
+        if (backward_active) {
+            backward_active = Step(m_backward, m_forward, backward, forward, best_cost);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_workspaces_mutex);
+        m_workspaces.push_back(std::move(workspace));
+    }
+    return best_cost;
+}
+
+RouteEngineFactory ContractionHierarchyEngine::Factory() {
+    return [](std::shared_ptr<const RouteGraph> graph) -> RouteEnginePtr {
+        return std::make_shared<const ContractionHierarchyEngine>(graph);
+    };
+}
+
+}
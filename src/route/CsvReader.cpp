@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include "route/CsvReader.h"
+
+namespace route {
+
+CsvReader::CsvReader(std::string_view contents) :
+m_end(contents.data() + contents.size()),
+m_position(contents.data()),
+m_block(contents.data()),
+m_mask(0),
+m_row() {
+    if (m_block != m_end) {
+        ScanBlock();
+    }
+}
+
+bool CsvReader::ParseUnsigned(std::string_view field, unsigned int& value) {
+    const char* const field_end = field.data() + field.size();
+    const auto result = std::from_chars(field.data(), field_end, value);
+    return result.ec == std::errc() && result.ptr == field_end;
+}
+
+std::vector<std::string_view> CsvReader::SplitRows(std::string_view contents, size_t chunk_size) {
+    std::vector<std::string_view> chunks;
+    size_t chunk_begin = 0;
+    while (chunk_begin < contents.size()) {
+        size_t chunk_end = contents.size();
+        if (contents.size() - chunk_begin > chunk_size) {
+            // The chunk ends at the first newline from its last character on
+            const size_t last_i = chunk_begin + std::max<size_t>(chunk_size, 1) - 1;
+            const void* newline = std::memchr(contents.data() + last_i, '\n', contents.size() - last_i);
+            if (newline) {
+                chunk_end = static_cast<const char*>(newline) - contents.data() + 1;
+            }
+        }
+        chunks.push_back(contents.substr(chunk_begin, chunk_end - chunk_begin));
+        chunk_begin = chunk_end;
+    }
+    return chunks;
+}
+
+}
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include "route/DeltaSteppingEngine.h"
+#include "route/SearchEngine.h"
+
+namespace route {
+
+namespace {
+const uint32_t NO_BUCKET = UINT32_MAX;      /// This is the bucket of a location that isn't queued
+const size_t RELAX_CHUNK_SIZE = 256;        /// The number of locations handed to a worker at a time
+}
+
+log4cxx::LoggerPtr DeltaSteppingEngine::m_logger(log4cxx::Logger::getLogger("DeltaSteppingEngine"));
+
+DeltaSteppingEngine::DeltaSteppingEngine(std::shared_ptr<const RouteGraph> graph, unsigned int delta, ThreadPool& thread_pool) :
+m_graph(graph),
+m_delta(delta),
+m_bucket_count(0),
+m_thread_pool(thread_pool),
+m_mutex(),
+m_workspaces() {
+    unsigned long long total_route_cost = 0;
+    unsigned int max_route_cost = 0;
+    for (uint32_t route_i = 0; route_i < m_graph->RouteCount(); ++route_i) {
+        total_route_cost += m_graph->RouteCost(route_i);
+        max_route_cost = std::max(max_route_cost, m_graph->RouteCost(route_i));
+    }
+    if (m_delta == 0) {
+        m_delta = m_graph->RouteCount() ? static_cast<unsigned int>(total_route_cost / m_graph->RouteCount()) : 1;
+    }
+    m_delta = std::max(1u, m_delta);
+
+    // A queued location is never more than the most expensive route past the bucket being worked on
+    m_bucket_count = max_route_cost / m_delta + 2;
+
+    LOG4CXX_INFO(m_logger, "Built delta-stepping engine. locations.n=" << m_graph->LocationCount() << " delta=" << m_delta
+        << " buckets.n=" << m_bucket_count << " workers.n=" << m_thread_pool.WorkerCount());
+}
+
+std::unique_ptr<DeltaSteppingEngine::Workspace> DeltaSteppingEngine::AcquireWorkspace() const {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_workspaces.empty()) {
+            std::unique_ptr<Workspace> workspace = std::move(m_workspaces.back());
+            m_workspaces.pop_back();
+            return workspace;
+        }
+    }
+
+    // A new workspace is only made when every one made so far is in use, so there are as many as the most concurrent queries
+    std::unique_ptr<Workspace> workspace(new Workspace());
+    workspace->route_costs = std::vector<std::atomic<unsigned int>>(m_graph->LocationCount());
+    for (auto& route_cost : workspace->route_costs) {
+        route_cost.store(ROUTE_COST_UNREACHABLE, std::memory_order_relaxed);
+    }
+    workspace->buckets_of.assign(m_graph->LocationCount(), NO_BUCKET);
+    workspace->buckets.resize(m_bucket_count);
+    workspace->updated.resize(m_thread_pool.WorkerCount());
+    workspace->touched.resize(m_thread_pool.WorkerCount());
+    return workspace;
+}
+
+void DeltaSteppingEngine::ReleaseWorkspace(std::unique_ptr<Workspace> workspace) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_workspaces.push_back(std::move(workspace));
+}
+
+unsigned int DeltaSteppingEngine::GetRouteCost(LocationId start_id, LocationId end_id) const {
+    std::unique_ptr<Workspace> workspace = AcquireWorkspace();
+    Search(*workspace, start_id, {end_id});
+    const unsigned int route_cost = workspace->route_costs[end_id].load(std::memory_order_relaxed);
+    Reset(*workspace);
+    ReleaseWorkspace(std::move(workspace));
+    return route_cost;
+}
+
+std::vector<unsigned int> DeltaSteppingEngine::GetRouteCosts(const std::vector<LocationId>& start_ids, const std::vector<LocationId>& end_ids) const {
+    std::vector<unsigned int> route_costs(start_ids.size() * end_ids.size());
+    if (route_costs.empty()) {
+        return route_costs;
+    }
+    std::unique_ptr<Workspace> workspace = AcquireWorkspace();
+    for (size_t start_i = 0; start_i < start_ids.size(); ++start_i) {
+        Search(*workspace, start_ids[start_i], end_ids);
+        for (size_t end_i = 0; end_i < end_ids.size(); ++end_i) {
+            route_costs[start_i * end_ids.size() + end_i] = workspace->route_costs[end_ids[end_i]].load(std::memory_order_relaxed);
+        }
+        Reset(*workspace);
+    }
+    ReleaseWorkspace(std::move(workspace));
+    return route_costs;
+}
+
+void DeltaSteppingEngine::Search(Workspace& workspace, LocationId start_id, const std::vector<LocationId>& end_ids) const {
+    const size_t ring_size = workspace.buckets.size();
+
+    workspace.route_costs[start_id].store(0, std::memory_order_relaxed);
+    workspace.touched[0].push_back(start_id);
+    workspace.buckets_of[start_id] = 0;
+    workspace.buckets[0].push_back(start_id);
+    size_t queued_count = 1;
+
+    // Everything cheaper than the bucket being worked on is final
+    auto ends_final = [&workspace, &end_ids](unsigned long long final_below) -> bool {
+        return std::all_of(end_ids.begin(), end_ids.end(), [&workspace, final_below](LocationId end_id) -> bool {
+            return workspace.route_costs[end_id].load(std::memory_order_relaxed) < final_below;
+        });
+    };
+
+    for (uint32_t bucket = 0; queued_count > 0; ++bucket) {
+        std::vector<LocationId>& bucket_locations = workspace.buckets[bucket % ring_size];
+        if (bucket_locations.empty()) {
+            continue;
+        }
+        if (ends_final(static_cast<unsigned long long>(bucket) * m_delta)) {
+            break;
+        }
+
+        workspace.settled.clear();
+        while (!bucket_locations.empty()) {
+            queued_count -= bucket_locations.size();
+            workspace.frontier.clear();
+            workspace.frontier.swap(bucket_locations);
+
+            // A location whose route cost dropped into a lower bucket is still listed in this one
+            auto stale = std::remove_if(workspace.frontier.begin(), workspace.frontier.end(), [&workspace, bucket](LocationId location_id) -> bool {
+                return workspace.buckets_of[location_id] != bucket;
+            });
+            workspace.frontier.erase(stale, workspace.frontier.end());
+            for (LocationId location_id : workspace.frontier) {
+                workspace.buckets_of[location_id] = NO_BUCKET;
+            }
+            workspace.settled.insert(workspace.settled.end(), workspace.frontier.begin(), workspace.frontier.end());
+
+            Relax(workspace, workspace.frontier, true);
+            queued_count += Enqueue(workspace);
+        }
+        Relax(workspace, workspace.settled, false);
+        queued_count += Enqueue(workspace);
+    }
+
+    // Whatever is still queued is reset with the rest of the touched locations
+    for (auto& bucket_locations : workspace.buckets) {
+        bucket_locations.clear();
+    }
+}
+
+void DeltaSteppingEngine::Relax(Workspace& workspace, const std::vector<LocationId>& locations, bool light) const {
+    const RouteGraph& graph = *m_graph;
+    const unsigned int delta = m_delta;
+
+    m_thread_pool.ParallelFor(locations.size(), RELAX_CHUNK_SIZE, [&graph, &workspace, &locations, light, delta](size_t first, size_t end, size_t worker_i) -> void {
+        std::vector<LocationId>& updated = workspace.updated[worker_i];
+        std::vector<LocationId>& touched = workspace.touched[worker_i];
+        for (size_t location_i = first; location_i < end; ++location_i) {
+            const LocationId location_id = locations[location_i];
+            const unsigned int base_cost = workspace.route_costs[location_id].load(std::memory_order_relaxed);
+            const uint32_t routes_end = graph.RoutesEnd(location_id);
+            for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < routes_end; ++route_i) {
+                if ((graph.RouteCost(route_i) <= delta) != light) {
+                    continue;
+                }
+                const LocationId adjacent = graph.Destination(route_i);
+                const unsigned int adjacent_cost = base_cost + graph.RouteCost(route_i);
+
+                // Lower the route cost if this route is cheaper, racing any other worker reaching the same location
+                std::atomic<unsigned int>& route_cost = workspace.route_costs[adjacent];
+                unsigned int current_cost = route_cost.load(std::memory_order_relaxed);
+                while (adjacent_cost < current_cost && !route_cost.compare_exchange_weak(current_cost, adjacent_cost, std::memory_order_relaxed)) {
+                }
+                if (adjacent_cost < current_cost) {
+                    updated.push_back(adjacent);
+                    if (current_cost == ROUTE_COST_UNREACHABLE) {
+                        touched.push_back(adjacent);
+                    }
+                }
+            }
+        }
+    });
+}
+
+size_t DeltaSteppingEngine::Enqueue(Workspace& workspace) const {
+    const size_t ring_size = workspace.buckets.size();
+    size_t queued_count = 0;
+
+    for (auto& updated : workspace.updated) {
+        for (LocationId location_id : updated) {
+            const uint32_t bucket = workspace.route_costs[location_id].load(std::memory_order_relaxed) / m_delta;
+            if (workspace.buckets_of[location_id] != bucket) {
+                workspace.buckets_of[location_id] = bucket;
+                workspace.buckets[bucket % ring_size].push_back(location_id);
+                ++queued_count;
+            }
+        }
+        updated.clear();
+    }
+    return queued_count;
+}
+
+void DeltaSteppingEngine::Reset(Workspace& workspace) const {
+    for (auto& touched : workspace.touched) {
+        for (LocationId location_id : touched) {
+            workspace.route_costs[location_id].store(ROUTE_COST_UNREACHABLE, std::memory_order_relaxed);
+            workspace.buckets_of[location_id] = NO_BUCKET;
+        }
+        touched.clear();
+    }
+}
+
+RouteEngineFactory DeltaSteppingEngine::Factory(size_t min_locations, unsigned int delta, ThreadPool& thread_pool) {
+    return [min_locations, delta, &thread_pool](std::shared_ptr<const RouteGraph> graph) -> RouteEnginePtr {
+        if (graph->LocationCount() < min_locations) {
+            LOG4CXX_INFO(m_logger, "The route graph is too small for delta-stepping to pay off, using Dijkstra. locations.n=" << graph->LocationCount()
+                << " min_locations=" << min_locations);
+            return DijkstraEngine::Factory()(graph);
+        }
+        return std::make_shared<const DeltaSteppingEngine>(graph, delta, thread_pool);
+    };
+}
+
+}
@@ -0,0 +1,41 @@
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include "route/FileContents.h"
+
+namespace route {
+
+FileContents::FileContents(const std::string& path) :
+m_open(false) {
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return;
+    }
+    struct stat file_stat;
+    if (fstat(file, &file_stat) == 0) {
+        // The file is read front to back once, so the kernel can read ahead aggressively
+        posix_fadvise(file, 0, 0, POSIX_FADV_SEQUENTIAL);
+        m_contents.resize(file_stat.st_size);
+        size_t read_size = 0;
+        m_open = true;
+        while (read_size < m_contents.size()) {
+            const ssize_t chunk_size = pread(file, &m_contents[read_size], m_contents.size() - read_size, read_size);
+            if (chunk_size > 0) {
+                read_size += chunk_size;
+            }
+            else if (chunk_size == 0) {
+                // The file was truncated since it was opened, what is left of it is all there is to parse
+                break;
+            }
+            else if (errno != EINTR) {
+                m_open = false;
+                break;
+            }
+        }
+        m_contents.resize(read_size);
+    }
+    close(file);
+}
+
+}
@@ -1,11 +1,10 @@
 #include <algorithm>
-#include <boost/algorithm/string.hpp>
-#include <iostream>
-#include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
+#include <string_view>
+#include "route/CsvReader.h"
 #include "route/FileLocationDatabase.h"
+#include "route/MappedFile.h"
 
 namespace route {
 
@@ -13,107 +12,127 @@ log4cxx::LoggerPtr FileLocationDatabase::m_logger(log4cxx::Logger::getLogger("Fi
 
 FileLocationDatabase::FileLocationDatabase(const std::string location_file) :
 m_database_file(location_file),
-m_location_map(),
-m_location_list() {
+m_location_names(),
+m_location_list(),
+m_location_arena(),
+m_disk_arena(),
+m_file_watcher(location_file),
+m_contents_checksum(0) {
 }
 
 FileLocationDatabase::~FileLocationDatabase() {
-    DeleteLocations(m_location_list);
+    DeleteLocations(m_location_list, m_location_arena);
 }
 
-void FileLocationDatabase::DeleteLocations(std::vector<Location*>& locations) {
-    std::for_each (m_location_list.begin(), m_location_list.end(), [this](Location* location) -> void {
-        delete location;
-    });
+void FileLocationDatabase::DeleteLocations(std::vector<Location*>& locations, std::unique_ptr<LocationArena>& arena) {
+    // The arena destroys the locations along with it, so freeing the arena is all the deleting there is to do
+    arena.reset();
     locations.clear();
 }
 
 void FileLocationDatabase::AddLocation(Location* location) {
     m_location_list.push_back(location);
-    m_location_map.insert(std::make_pair(location->Name(), location));
 }
 
-std::vector<Location*> FileLocationDatabase::GetLocationsOnDisk() {
+std::vector<Location*> FileLocationDatabase::GetLocationsOnDisk(const FileContents& file) {
     std::vector<Location*> locations_on_disk;
-    std::ifstream file(m_database_file);
-    
-    if (!file.is_open()) {
+    m_disk_arena.reset();
+
+    if (!file.IsOpen()) {
         LOG4CXX_ERROR(m_logger, "Could not open the database file " << m_database_file);
         return locations_on_disk;
     }
 
-    bool error = false;
-    std::string line;
+    m_disk_arena = std::make_unique<LocationArena>();
+    CsvReader reader(file.Contents());
+    std::vector<std::string_view> location_data;
 
     const unsigned int name_i = 0;
     const unsigned int cost_i = 1;
 
-    while (file.good() && !error) {
-        std::getline(file, line);
-        std::stringstream ss(boost::trim_copy(line));   
-        std::string value;
-        std::vector<std::string> location_data; 
-
-        if (ss.str().length()) {
-            while (std::getline(ss, value, ',')) { 
-                location_data.push_back(boost::trim_copy(value));
-            }
-
-            try {
-                locations_on_disk.push_back(
-                    new Location(
-                        location_data[name_i], 
-                        std::stoi(location_data[cost_i])
-                    )  
-                );
-                LOG4CXX_DEBUG(m_logger, "Adding location. name=" << locations_on_disk.back()->Name() << " cost=" << locations_on_disk.back()->Cost()); 
-            }
-            catch (const std::invalid_argument& ex) {
-                LOG4CXX_ERROR(m_logger, "Could not parse string to number the database file entry: '" << line << "'");
-                LOG4CXX_ERROR(m_logger, "Assuming the database file is malformed");
-                DeleteLocations(locations_on_disk);
-                error = true;
-            }
+    // The fields are views into the file contents, the name is copied once straight into the arena
+    while (reader.NextRow(location_data)) {
+        unsigned int cost = 0;
+        if (location_data.size() <= cost_i || !CsvReader::ParseUnsigned(location_data[cost_i], cost)) {
+            LOG4CXX_ERROR(m_logger, "Could not parse string to number the database file entry: '" << reader.Row() << "'");
+            LOG4CXX_ERROR(m_logger, "Assuming the database file is malformed");
+            DeleteLocations(locations_on_disk, m_disk_arena);
+            break;
         }
+        locations_on_disk.push_back(m_disk_arena->NewLocation(location_data[name_i], cost, static_cast<LocationId>(locations_on_disk.size())));
+        LOG4CXX_DEBUG(m_logger, "Adding location. name=" << locations_on_disk.back()->Name() << " cost=" << locations_on_disk.back()->Cost()); 
     }
 
     LOG4CXX_DEBUG(m_logger, "Loaded " << locations_on_disk.size() << " location(s) config from disk");    
 
-    file.close(); 
     return locations_on_disk;
 }
 
 
 bool FileLocationDatabase::Load() {
+    // The file is only read again once it may have changed, and only parsed again if its contents have. A file that is touched or
+    // rewritten as it was is checksummed and left at that
+    if (!m_file_watcher.Changed()) {
+        return false;
+    }
+    m_file_watcher.Reset();
+    const FileContents file(m_database_file);
+    const uint64_t contents_checksum = MappedFile::Checksum(file.Contents());
+    if (m_location_list.size() && contents_checksum == m_contents_checksum) {
+        LOG4CXX_DEBUG(m_logger, "The database file is unchanged. file=" << m_database_file);
+        return false;
+    }
+
     //Get the locations on disk
-    auto locations_on_disk = GetLocationsOnDisk();
-    if (!locations_on_disk.size() || locations_on_disk.size() == m_location_map.size()) {
+    auto locations_on_disk = GetLocationsOnDisk(file);
+    if (!locations_on_disk.size()) {
+        m_disk_arena.reset();
         return false;
     } 
+    m_contents_checksum = contents_checksum;
 
-    // Reset the current location database
-    DeleteLocations(m_location_list);
-
-    m_location_map.clear();    
+    // Reset the current location database, the new locations come with their arena
+    DeleteLocations(m_location_list, m_location_arena);
+    m_location_arena = std::move(m_disk_arena);
 
     // Re-load with the new locations from disk
     std::for_each (locations_on_disk.begin(), locations_on_disk.end(), [this](Location* location) -> void {
         AddLocation(location);
     });
 
+    // The names are fixed until the next load, so they are indexed once with a perfect hash
+    std::vector<std::string_view> names;
+    names.reserve(m_location_list.size());
+    std::for_each(m_location_list.begin(), m_location_list.end(), [&names](const Location* location) -> void {
+        names.push_back(location->Name());
+    });
+    m_location_names = PerfectNameIndex(names);
+    std::for_each(m_location_list.begin(), m_location_list.end(), [this](const Location* location) -> void {
+        if (m_location_names.Find(location->Name()) != location->Id()) {
+            LOG4CXX_WARN(m_logger, "Duplicate location in the database, only the first will be used by name. name=" << location->Name() << " id=" << location->Id());
+        }
+    });
+
     return true;
 }
 
-const std::vector<Location*> FileLocationDatabase::GetLocations() const {
+bool FileLocationDatabase::HasChanged() const {
+    return m_file_watcher.Changed();
+}
+
+const std::vector<Location*>& FileLocationDatabase::GetLocations() const {
     return m_location_list;
 }
 
-Location* const FileLocationDatabase::GetLocation(std::string location_name) const {
-    auto location = m_location_map.find(location_name);
-    if (location != m_location_map.end()) {
-        return location->second;
+Location* const FileLocationDatabase::GetLocation(LocationId location_id) const {
+    if (location_id < m_location_list.size()) {
+        return m_location_list[location_id];
     }
     return nullptr;
 }
 
+LocationId FileLocationDatabase::GetLocationId(const std::string& location_name) const {
+    return m_location_names.Find(location_name);
+}
+
 }
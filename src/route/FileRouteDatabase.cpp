@@ -1,10 +1,11 @@
-#include <boost/algorithm/string.hpp>
-#include <iostream>
-#include <fstream>
-#include <sstream>
+#include <iterator>
+#include <utility>
 #include <vector>
 #include <string>
+#include <string_view>
+#include "route/CsvReader.h"
 #include "route/FileRouteDatabase.h"
+#include "route/MappedFile.h"
 
 namespace route {
 
@@ -12,71 +13,99 @@ log4cxx::LoggerPtr FileRouteDatabase::m_logger(log4cxx::Logger::getLogger("FileR
 
 FileRouteDatabase::FileRouteDatabase(const std::string route_file) :
 m_route_file(route_file),
-m_routes() {
+m_routes(),
+m_no_routes(),
+m_file_watcher(route_file),
+m_contents_checksum(0) {
 }
 
-std::unordered_map<std::string, std::vector<std::string>> FileRouteDatabase::GetRoutesOnDisk() const {
-    std::unordered_map<std::string, std::vector<std::string>> routes_on_disk;
-    std::ifstream file(m_route_file);
-    if (!file.is_open()) {
+std::unordered_map<std::string, std::vector<std::string>> FileRouteDatabase::GetRoutesOnDisk(const FileContents& file) const {
+    if (!file.IsOpen()) {
         LOG4CXX_ERROR(m_logger, "Could not open the route database file " << m_route_file);
-        return routes_on_disk;
+        return std::unordered_map<std::string, std::vector<std::string>>();
     }
 
-    bool error = false;
-    std::string line;
-    
-    while (file.good() && !error) {
-        std::getline(file, line);
-        std::stringstream ss(boost::trim_copy(line));   
-        std::string value;
-        std::vector<std::string> route_data; 
-        
-        if (ss.str().length()) {
-            while (std::getline(ss, value, ',')) { 
-                route_data.push_back(boost::trim_copy(value));
-            }
-        
-            const std::string source = route_data[0];
-            const std::vector<std::string> destinations(route_data.begin() + 1, route_data.end());
-
-            auto route = routes_on_disk.find(source);
-
-            if (route == routes_on_disk.end()) {
-                routes_on_disk.insert(std::make_pair(route_data[0], destinations));
-            }
-            else {
-                route->second.insert(route->second.end(), destinations.begin(), destinations.end());
-            }  
-        }     
-    }
+    auto routes_on_disk = ParseRoutes(file.Contents());
 
     LOG4CXX_DEBUG(m_logger, "Loaded " << routes_on_disk.size() << " route(s) config from disk");    
 
-    file.close(); 
     return routes_on_disk;
 }
 
+std::unordered_map<std::string, std::vector<std::string>> FileRouteDatabase::ParseRoutes(std::string_view contents, size_t chunk_size, size_t worker_count) {
+    const std::vector<std::string_view> chunks = CsvReader::SplitRows(contents, chunk_size);
+    std::vector<std::unordered_map<std::string, std::vector<std::string>>> chunk_routes(chunks.size());
+
+    // The fields are views into the file contents, each is copied once straight into the routes of its chunk. A start location on more
+    // than one row has all of its destinations
+    ParallelFor(chunks.size(), worker_count, [&chunks, &chunk_routes](size_t chunk_i, size_t) -> void {
+        std::unordered_map<std::string, std::vector<std::string>>& routes = chunk_routes[chunk_i];
+        CsvReader reader(chunks[chunk_i]);
+        std::vector<std::string_view> route_data;
+        while (reader.NextRow(route_data)) {
+            std::vector<std::string>& destinations = routes[std::string(route_data[0])];
+            destinations.insert(destinations.end(), route_data.begin() + 1, route_data.end());
+        }
+    });
+    if (chunk_routes.empty()) {
+        return std::unordered_map<std::string, std::vector<std::string>>();
+    }
+
+    // The chunks are merged in file order, so the result doesn't depend on which worker parsed which chunk. A start location seen for
+    // the first time is moved across whole, one seen in an earlier chunk has its destinations added after the ones already there
+    size_t start_location_count = 0;
+    for (const auto& chunk : chunk_routes) {
+        start_location_count += chunk.size();
+    }
+    std::unordered_map<std::string, std::vector<std::string>> routes = std::move(chunk_routes.front());
+    routes.reserve(start_location_count);
+    for (size_t chunk_i = 1; chunk_i < chunk_routes.size(); ++chunk_i) {
+        routes.merge(chunk_routes[chunk_i]);
+        for (auto& start_location : chunk_routes[chunk_i]) {
+            std::vector<std::string>& destinations = routes.find(start_location.first)->second;
+            destinations.insert(destinations.end(), std::make_move_iterator(start_location.second.begin()), std::make_move_iterator(start_location.second.end()));
+        }
+    }
+    return routes;
+}
+
 
 bool FileRouteDatabase::Load() {
+    // The file is only read again once it may have changed, and only parsed again if its contents have
+    if (!m_file_watcher.Changed()) {
+        return false;
+    }
+    m_file_watcher.Reset();
+    const FileContents file(m_route_file);
+    const uint64_t contents_checksum = MappedFile::Checksum(file.Contents());
+    if (m_routes.size() && contents_checksum == m_contents_checksum) {
+        LOG4CXX_DEBUG(m_logger, "The route database file is unchanged. file=" << m_route_file);
+        return false;
+    }
+
     //Get the routes on disk
-    auto routes_on_disk = GetRoutesOnDisk();
-    if (!routes_on_disk.size() || routes_on_disk.size() == m_routes.size()) {
+    auto routes_on_disk = GetRoutesOnDisk(file);
+    if (!routes_on_disk.size()) {
         return false;
     }
 
     // Update the routes database
-    m_routes = routes_on_disk;    
+    m_routes = std::move(routes_on_disk);
+    m_contents_checksum = contents_checksum;
 
     return true;
 }
 
-std::vector<std::string> FileRouteDatabase::GetRoutes(const std::string start_location) const {
+bool FileRouteDatabase::HasChanged() const {
+    return m_file_watcher.Changed();
+}
+
+const std::vector<std::string>& FileRouteDatabase::GetRoutes(const std::string& start_location) const {
     auto routes = m_routes.find(start_location);
     if (routes != m_routes.end()) {
         return routes->second;
     }
-    return std::vector<std::string>();
+    return m_no_routes;
 }
 
 }
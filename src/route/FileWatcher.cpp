@@ -0,0 +1,104 @@
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include "route/FileWatcher.h"
+
+namespace route {
+
+log4cxx::LoggerPtr FileWatcher::m_logger(log4cxx::Logger::getLogger("FileWatcher"));
+
+namespace {
+/// The directory events that can change what is at the path of the file, reading the file raises none of them
+const uint32_t WATCH_EVENTS = IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+}
+
+FileWatcher::FileWatcher(const std::string& path, bool use_inotify) :
+m_path(path),
+m_file_name(),
+m_inotify_fd(-1),
+m_changed(true),
+m_stamp(Stamp()) {
+    const size_t name_i = m_path.find_last_of('/');
+    const std::string directory = name_i == std::string::npos ? "." : (name_i == 0 ? "/" : m_path.substr(0, name_i));
+    m_file_name = name_i == std::string::npos ? m_path : m_path.substr(name_i + 1);
+    if (!use_inotify) {
+        return;
+    }
+
+    m_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotify_fd < 0) {
+        LOG4CXX_WARN(m_logger, "Could not start inotify, comparing the file stamp instead. file=" << m_path << " error=" << std::strerror(errno));
+        return;
+    }
+    if (inotify_add_watch(m_inotify_fd, directory.c_str(), WATCH_EVENTS) < 0) {
+        LOG4CXX_WARN(m_logger, "Could not watch the directory, comparing the file stamp instead. file=" << m_path << " directory=" << directory
+            << " error=" << std::strerror(errno));
+        StopInotify();
+    }
+}
+
+FileWatcher::~FileWatcher() {
+    StopInotify();
+}
+
+FileWatcher::FileStamp FileWatcher::Stamp() const {
+    struct stat file_stat;
+    if (stat(m_path.c_str(), &file_stat) != 0) {
+        return FileStamp{-1, -1, static_cast<uint64_t>(-1)};
+    }
+    return FileStamp{static_cast<int64_t>(file_stat.st_size), static_cast<int64_t>(file_stat.st_mtim.tv_sec) * 1000000000 + file_stat.st_mtim.tv_nsec,
+        static_cast<uint64_t>(file_stat.st_ino)};
+}
+
+void FileWatcher::StopInotify() {
+    if (m_inotify_fd >= 0) {
+        close(m_inotify_fd);
+        m_inotify_fd = -1;
+    }
+}
+
+void FileWatcher::ReadEvents() {
+    alignas(struct inotify_event) char buffer[4096];
+    while (m_inotify_fd >= 0) {
+        const ssize_t size = read(m_inotify_fd, buffer, sizeof(buffer));
+        if (size <= 0) {
+            // EAGAIN, there are no more events
+            return;
+        }
+        for (ssize_t event_i = 0; event_i < size;) {
+            const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + event_i);
+            event_i += sizeof(struct inotify_event) + event->len;
+            if (event->mask & IN_Q_OVERFLOW) {
+                // Events were dropped, one of them may have been for the file
+                m_changed = true;
+            }
+            else if (event->mask & IN_IGNORED) {
+                // The directory has gone, so there is nothing left to watch
+                LOG4CXX_WARN(m_logger, "The directory of the file is no longer watched, comparing the file stamp instead. file=" << m_path);
+                m_changed = true;
+                StopInotify();
+            }
+            else if (event->len && m_file_name == event->name) {
+                m_changed = true;
+            }
+        }
+    }
+}
+
+bool FileWatcher::Changed() {
+    if (UsesInotify()) {
+        ReadEvents();
+        return m_changed;
+    }
+    return m_changed || !(Stamp() == m_stamp);
+}
+
+void FileWatcher::Reset() {
+    ReadEvents();
+    m_changed = false;
+    m_stamp = Stamp();
+}
+
+}
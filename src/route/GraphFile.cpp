@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include "route/AtomicFile.h"
+#include "route/FileLocationDatabase.h"
+#include "route/FileRouteDatabase.h"
+#include "route/GraphFile.h"
+#include "route/MappedFile.h"
+
+namespace route {
+
+log4cxx::LoggerPtr GraphFile::m_logger(log4cxx::Logger::getLogger("GraphFile"));
+
+namespace {
+const char GRAPH_FILE_MAGIC[8] = {'R', 'P', 'G', 'R', 'A', 'P', 'H', '1'};     /// This starts every graph file, the last character is the format version
+
+/// @brief This is the start of a graph file
+struct GraphFileHeader {
+    char magic[8];
+    uint64_t checksum;              /// The checksum of everything after the header
+    uint64_t location_count;
+    uint64_t route_count;
+};
+
+/// @brief This copies a run of values out of the graph file and moves on past them
+template <typename T>
+bool ReadValues(std::string_view& data, size_t count, std::vector<T>& values) {
+    if (data.size() / sizeof(T) < count) {
+        return false;
+    }
+    values.resize(count);
+    std::memcpy(values.data(), data.data(), count * sizeof(T));
+    data.remove_prefix(count * sizeof(T));
+    return true;
+}
+}
+
+GraphFile::GraphFile(uint64_t checksum, std::shared_ptr<const PerfectNameIndex> names, std::shared_ptr<const RouteGraph> graph,
+    std::shared_ptr<const LocationOrder> location_order) :
+m_checksum(checksum),
+m_names(names),
+m_graph(graph),
+m_location_order(location_order) {
+}
+
+bool GraphFile::Save(const std::string& graph_file, const PerfectNameIndex& names, const RouteGraph& graph, const LocationOrder& location_order) {
+    // The body is put together first, as the header carries its checksum
+    std::ostringstream body;
+    names.Write(body);
+    for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+        const uint32_t cost = graph.LocationCost(location_id);
+        body.write(reinterpret_cast<const char*>(&cost), sizeof(cost));
+    }
+    for (LocationId location_id = 0; location_id <= graph.LocationCount(); ++location_id) {
+        const uint32_t offset = location_id < graph.LocationCount() ? graph.RoutesBegin(location_id) : graph.RouteCount();
+        body.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
+    for (uint32_t route_i = 0; route_i < graph.RouteCount(); ++route_i) {
+        const LocationId destination = graph.Destination(route_i);
+        body.write(reinterpret_cast<const char*>(&destination), sizeof(destination));
+    }
+    for (LocationId internal_id = 0; internal_id < graph.LocationCount(); ++internal_id) {
+        const LocationId external_id = location_order.ExternalId(internal_id);
+        body.write(reinterpret_cast<const char*>(&external_id), sizeof(external_id));
+    }
+    const std::string body_bytes = body.str();
+
+    GraphFileHeader header;
+    std::memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+    header.checksum = MappedFile::Checksum(body_bytes);
+    header.location_count = graph.LocationCount();
+    header.route_count = graph.RouteCount();
+
+    const bool saved = AtomicFile::Save(graph_file, "graph file", [&header, &body_bytes](std::ostream& file) -> void {
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(body_bytes.data(), body_bytes.size());
+    });
+    if (!saved) {
+        return false;
+    }
+
+    LOG4CXX_INFO(m_logger, "Saved graph file. file=" << graph_file << " locations.n=" << header.location_count << " routes.n=" << header.route_count
+        << " bytes=" << sizeof(header) + body_bytes.size());
+    return true;
+}
+
+std::shared_ptr<const GraphFile> GraphFile::Load(const std::string& graph_file) {
+    const auto start_time = std::chrono::steady_clock::now();
+    const MappedFile file(graph_file);
+    if (!file.IsOpen()) {
+        LOG4CXX_ERROR(m_logger, "Could not open the graph file " << graph_file);
+        return nullptr;
+    }
+
+    GraphFileHeader header;
+    std::string_view data = file.Contents();
+    if (data.size() >= sizeof(header)) {
+        std::memcpy(&header, data.data(), sizeof(header));
+        data.remove_prefix(sizeof(header));
+    }
+    if (data.size() == file.Contents().size() || std::memcmp(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        LOG4CXX_ERROR(m_logger, "The graph file is malformed or of another format version " << graph_file);
+        return nullptr;
+    }
+    if (MappedFile::Checksum(data) != header.checksum) {
+        LOG4CXX_ERROR(m_logger, "The graph file doesn't match its checksum " << graph_file);
+        return nullptr;
+    }
+
+    // Each array is copied out of the mapping with one memcpy, the mapping doesn't outlive the load. The checksum catches a damaged
+    // file, the counts and routes are still checked so a file that was written wrong can't make a search read past the route graph
+    auto names = std::make_shared<PerfectNameIndex>();
+    std::vector<unsigned int> location_costs;
+    std::vector<uint32_t> offsets;
+    std::vector<LocationId> destinations;
+    std::vector<LocationId> external_ids;
+    const uint64_t location_count = header.location_count;
+    std::vector<bool> ordered(location_count, false);
+    if (!names->Read(data) || names->Size() != location_count || !ReadValues(data, location_count, location_costs) ||
+        !ReadValues(data, location_count + 1, offsets) || !ReadValues(data, header.route_count, destinations) ||
+        !ReadValues(data, location_count, external_ids) || !data.empty() ||
+        offsets.front() != 0 || offsets.back() != header.route_count || !std::is_sorted(offsets.begin(), offsets.end()) ||
+        !std::all_of(destinations.begin(), destinations.end(), [location_count](LocationId destination) -> bool {
+            return destination < location_count;
+        }) ||
+        !std::all_of(external_ids.begin(), external_ids.end(), [location_count, &ordered](LocationId external_id) -> bool {
+            if (external_id >= location_count || ordered[external_id]) {
+                return false;
+            }
+            ordered[external_id] = true;
+            return true;
+        })) {
+        LOG4CXX_ERROR(m_logger, "The graph file is malformed " << graph_file);
+        return nullptr;
+    }
+
+    auto graph = std::make_shared<const RouteGraph>(std::move(location_costs), std::move(offsets), std::move(destinations));
+    auto location_order = std::make_shared<const LocationOrder>(std::move(external_ids));
+    LOG4CXX_INFO(m_logger, "Loaded graph file. file=" << graph_file << " locations.n=" << graph->LocationCount() << " routes.n=" << graph->RouteCount()
+        << " time_ms=" << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count());
+    return std::shared_ptr<const GraphFile>(new GraphFile(header.checksum, names, graph, location_order));
+}
+
+bool GraphFile::Convert(const std::string& location_file, const std::string& route_file, const std::string& graph_file) {
+    FileLocationDatabase location_db(location_file);
+    FileRouteDatabase route_db(route_file);
+    if (!location_db.Load()) {
+        LOG4CXX_ERROR(m_logger, "Could not load any locations to convert from " << location_file);
+        return false;
+    }
+    route_db.Load();
+
+    const std::vector<Location*>& locations = location_db.GetLocations();
+    std::vector<std::string_view> names;
+    names.reserve(locations.size());
+    for (Location* start_location : locations) {
+        for (const std::string& location : route_db.GetRoutes(std::string(start_location->Name()))) {
+            const Location* end_location = location_db.GetLocation(location_db.GetLocationId(location));
+            if (end_location) {
+                start_location->AddDestination(end_location);
+            }
+        }
+        names.push_back(start_location->Name());
+    }
+    const RouteGraph graph(locations);
+    return Save(graph_file, PerfectNameIndex(names), graph, LocationOrder::ReverseCuthillMcKee(graph));
+}
+
+bool GraphFile::IsGraphFile(const std::string& path) {
+    char magic[sizeof(GRAPH_FILE_MAGIC)];
+    std::ifstream file(path, std::ios::binary);
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, GRAPH_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+}
@@ -0,0 +1,21 @@
+#include "route/GraphFileDatabase.h"
+
+namespace route {
+
+GraphFileDatabase::GraphFileDatabase(const std::string& graph_file) :
+GraphDatabase<GraphFile>(graph_file) {
+}
+
+std::shared_ptr<const GraphFile> GraphFileDatabase::LoadGraph() const {
+    return GraphFile::Load(m_graph_file);
+}
+
+std::shared_ptr<const RouteGraph> GraphFileDatabase::GetRouteGraph() const {
+    return m_graph ? m_graph->Graph() : nullptr;
+}
+
+std::shared_ptr<const LocationOrder> GraphFileDatabase::GetLocationOrder() const {
+    return m_graph ? m_graph->Order() : nullptr;
+}
+
+}
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include "route/AtomicFile.h"
+#include "route/HubLabelEngine.h"
+#include "route/PriorityQueue.h"
+#include "route/SearchWorkspace.h"
+
+namespace route {
+
+log4cxx::LoggerPtr HubLabelEngine::m_logger(log4cxx::Logger::getLogger("HubLabelEngine"));
+
+namespace {
+const size_t HUB_LABEL_ORDER_SAMPLES = 256;      /// This is the number of shortest path trees sampled to rank the locations
+const char LABEL_FILE_MAGIC[8] = {'R', 'P', 'H', 'U', 'B', 'L', 'B', '1'};     /// This starts every label file, the last character is the format version
+
+/// @brief This is the start of a label file, it is followed by the forward offsets and entries and then the backward offsets and
+///        entries, all in the machine's own byte order
+struct LabelFileHeader {
+    char magic[8];
+    uint64_t fingerprint;           /// The fingerprint of the route graph the labels are for
+    uint64_t location_count;
+    uint64_t forward_entry_count;
+    uint64_t backward_entry_count;
+};
+}
+
+HubLabelEngine::HubLabelEngine(std::shared_ptr<const RouteGraph> graph) :
+m_graph(graph),
+m_forward(),
+m_backward() {
+    Build();
+}
+
+HubLabelEngine::HubLabelEngine(std::shared_ptr<const RouteGraph> graph, Labels&& forward, Labels&& backward) :
+m_graph(graph),
+m_forward(std::move(forward)),
+m_backward(std::move(backward)) {
+}
+
+void HubLabelEngine::Build() {
+    const auto start_time = std::chrono::steady_clock::now();
+    const RouteGraph& graph = *m_graph;
+    const size_t location_count = graph.LocationCount();
+
+    SearchWorkspace workspace;
+    BinaryHeapQueue queue;
+
+    // The busiest locations are labelled first, they are on the most cheapest routes so their labels prune the most of the later
+    // searches. How busy a location is, is estimated from the shortest path trees of a sample of start locations: the number of
+    // locations below it in the trees is the number of sampled cheapest routes running through it
+    std::vector<uint64_t> busyness(location_count, 0);
+    std::vector<LocationId> parents(location_count);
+    std::vector<LocationId> settle_order;
+    std::mt19937 random(1);
+    for (size_t sample_i = 0; sample_i < std::min(HUB_LABEL_ORDER_SAMPLES, location_count); ++sample_i) {
+        const LocationId root_id = static_cast<LocationId>(random() % location_count);
+        workspace.Reset(location_count);
+        queue.Reset(location_count);
+        settle_order.clear();
+        workspace.Relax(root_id, 0);
+        parents[root_id] = root_id;
+        queue.Push(root_id, 0);
+        while (!queue.Empty()) {
+            const QueueEntry min_cost = queue.Pop();
+            if (workspace.Settled(min_cost.index)) {
+                continue;
+            }
+            workspace.Settle(min_cost.index);
+            settle_order.push_back(min_cost.index);
+            const unsigned int route_cost = workspace.RouteCost(min_cost.index);
+            for (uint32_t route_i = graph.RoutesBegin(min_cost.index); route_i < graph.RoutesEnd(min_cost.index); ++route_i) {
+                if (workspace.Relax(graph.Destination(route_i), route_cost + graph.RouteCost(route_i))) {
+                    parents[graph.Destination(route_i)] = min_cost.index;
+                    queue.Push(graph.Destination(route_i), route_cost + graph.RouteCost(route_i));
+                }
+            }
+        }
+
+        // Each location is settled after its parent, so going backwards every location's count is done before it is added to its
+        // parent's
+        std::vector<uint32_t> descendants(location_count, 1);
+        for (auto settled = settle_order.rbegin(); settled != settle_order.rend(); ++settled) {
+            busyness[*settled] += descendants[*settled];
+            if (*settled != root_id) {
+                descendants[parents[*settled]] += descendants[*settled];
+            }
+        }
+    }
+
+    // The number of routes in and out of a location breaks ties, it puts the junctions first among locations no sampled route uses
+    std::vector<LocationId> order(location_count);
+    std::iota(order.begin(), order.end(), 0);
+    auto degree = [&graph](LocationId location_id) -> uint64_t {
+        return static_cast<uint64_t>(graph.RoutesEnd(location_id) - graph.RoutesBegin(location_id) + 1) *
+            (graph.ReverseRoutesEnd(location_id) - graph.ReverseRoutesBegin(location_id) + 1);
+    };
+    std::stable_sort(order.begin(), order.end(), [&busyness, &degree](LocationId a, LocationId b) -> bool {
+        return busyness[a] != busyness[b] ? busyness[a] > busyness[b] : degree(a) > degree(b);
+    });
+    std::vector<uint32_t> ranks(location_count);
+    for (uint32_t rank = 0; rank < location_count; ++rank) {
+        ranks[order[rank]] = rank;
+    }
+
+    std::vector<std::vector<LabelEntry>> forward(location_count);
+    std::vector<std::vector<LabelEntry>> backward(location_count);
+    std::vector<unsigned int> hub_costs(location_count, ROUTE_COST_UNREACHABLE);    // The hub's own label, indexed by rank
+
+    // One pruned search from a hub. Going forwards it finds the route cost from the hub to each location, which goes in that location's
+    // backward label, and going backwards it finds the route cost to the hub, which goes in the forward label. A location whose route
+    // cost the labels already give is left alone and not searched past. Lower ranked locations aren't searched past either, every
+    // route through them is already covered by their own labels
+    auto pruned_search = [&](LocationId hub_id, uint32_t hub_rank, bool forward_search) -> void {
+        const std::vector<LabelEntry>& hub_label = forward_search ? forward[hub_id] : backward[hub_id];
+        std::vector<std::vector<LabelEntry>>& labels = forward_search ? backward : forward;
+        for (const LabelEntry& entry : hub_label) {
+            hub_costs[entry.hub] = entry.cost;
+        }
+
+        workspace.Reset(location_count);
+        queue.Reset(location_count);
+        workspace.Relax(hub_id, 0);
+        queue.Push(hub_id, 0);
+        while (!queue.Empty()) {
+            const QueueEntry min_cost = queue.Pop();
+            if (workspace.Settled(min_cost.index)) {
+                continue;
+            }
+            workspace.Settle(min_cost.index);
+            const LocationId location_id = min_cost.index;
+            const unsigned int route_cost = workspace.RouteCost(location_id);
+
+            std::vector<LabelEntry>& label = labels[location_id];
+            const bool covered = std::any_of(label.begin(), label.end(), [&hub_costs, route_cost](const LabelEntry& entry) -> bool {
+                return hub_costs[entry.hub] != ROUTE_COST_UNREACHABLE && hub_costs[entry.hub] + entry.cost <= route_cost;
+            });
+            if (covered) {
+                continue;
+            }
+            label.push_back(LabelEntry{hub_rank, route_cost});
+
+            const uint32_t routes_begin = forward_search ? graph.RoutesBegin(location_id) : graph.ReverseRoutesBegin(location_id);
+            const uint32_t routes_end = forward_search ? graph.RoutesEnd(location_id) : graph.ReverseRoutesEnd(location_id);
+            for (uint32_t route_i = routes_begin; route_i < routes_end; ++route_i) {
+                const LocationId next_id = forward_search ? graph.Destination(route_i) : graph.Origin(route_i);
+                const unsigned int next_cost = route_cost + (forward_search ? graph.RouteCost(route_i) : graph.ReverseRouteCost(route_i));
+                if (ranks[next_id] > hub_rank && workspace.Relax(next_id, next_cost)) {
+                    queue.Push(next_id, next_cost);
+                }
+            }
+        }
+
+        for (const LabelEntry& entry : hub_label) {
+            hub_costs[entry.hub] = ROUTE_COST_UNREACHABLE;
+        }
+    };
+
+    for (uint32_t rank = 0; rank < location_count; ++rank) {
+        pruned_search(order[rank], rank, true);
+        pruned_search(order[rank], rank, false);
+    }
+
+    // The entries went into each label in rank order, so the flat labels come out sorted by hub
+    auto flatten = [location_count](std::vector<std::vector<LabelEntry>>& labels, Labels& flat) -> void {
+        flat.offsets.assign(location_count + 1, 0);
+        for (size_t location_i = 0; location_i < location_count; ++location_i) {
+            flat.offsets[location_i + 1] = flat.offsets[location_i] + static_cast<uint32_t>(labels[location_i].size());
+        }
+        flat.entries.reserve(flat.offsets[location_count]);
+        for (std::vector<LabelEntry>& label : labels) {
+            flat.entries.insert(flat.entries.end(), label.begin(), label.end());
+            std::vector<LabelEntry>().swap(label);
+        }
+    };
+    flatten(forward, m_forward);
+    flatten(backward, m_backward);
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    LOG4CXX_INFO(m_logger, "Built hub labels. locations.n=" << location_count << " average_label_size=" << AverageLabelSize()
+        << " memory_bytes=" << MemoryBytes() << " time_ms=" << elapsed.count());
+}
+
+RouteEnginePtr HubLabelEngine::ApplyChange(std::shared_ptr<const RouteGraph> graph, const RouteChange&) const {
+    return std::make_shared<const HubLabelEngine>(graph);
+}
+
+double HubLabelEngine::AverageLabelSize() const {
+    const size_t location_count = m_graph->LocationCount();
+    return location_count ? static_cast<double>(m_forward.entries.size() + m_backward.entries.size()) / (2 * location_count) : 0.0;
+}
+
+bool HubLabelEngine::Save(const std::string& label_file) const {
+    LabelFileHeader header;
+    std::memcpy(header.magic, LABEL_FILE_MAGIC, sizeof(header.magic));
+    header.fingerprint = m_graph->Fingerprint();
+    header.location_count = m_graph->LocationCount();
+    header.forward_entry_count = m_forward.entries.size();
+    header.backward_entry_count = m_backward.entries.size();
+
+    const bool saved = AtomicFile::Save(label_file, "hub label file", [this, &header](std::ostream& file) -> void {
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (const Labels* labels : {&m_forward, &m_backward}) {
+            file.write(reinterpret_cast<const char*>(labels->offsets.data()), labels->offsets.size() * sizeof(uint32_t));
+            file.write(reinterpret_cast<const char*>(labels->entries.data()), labels->entries.size() * sizeof(LabelEntry));
+        }
+    });
+    if (!saved) {
+        return false;
+    }
+
+    LOG4CXX_INFO(m_logger, "Saved hub labels. file=" << label_file << " memory_bytes=" << MemoryBytes());
+    return true;
+}
+
+std::shared_ptr<const HubLabelEngine> HubLabelEngine::Load(std::shared_ptr<const RouteGraph> graph, const std::string& label_file) {
+    std::ifstream file(label_file, std::ios::binary);
+    if (!file.is_open()) {
+        LOG4CXX_INFO(m_logger, "There is no hub label file " << label_file);
+        return nullptr;
+    }
+
+    LabelFileHeader header;
+    const size_t location_count = graph->LocationCount();
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, LABEL_FILE_MAGIC, sizeof(header.magic)) != 0) {
+        LOG4CXX_ERROR(m_logger, "The hub label file is malformed " << label_file);
+        return nullptr;
+    }
+    if (header.fingerprint != graph->Fingerprint() || header.location_count != location_count) {
+        LOG4CXX_INFO(m_logger, "The hub label file is for a different route graph " << label_file);
+        return nullptr;
+    }
+
+    const uint64_t offsets_bytes = (location_count + 1) * sizeof(uint32_t);
+    const uint64_t file_bytes = sizeof(header) + 2 * offsets_bytes + (header.forward_entry_count + header.backward_entry_count) * sizeof(LabelEntry);
+    file.seekg(0, std::ios::end);
+    if (static_cast<uint64_t>(file.tellg()) != file_bytes) {
+        LOG4CXX_ERROR(m_logger, "The hub label file is malformed " << label_file);
+        return nullptr;
+    }
+    file.seekg(sizeof(header));
+
+    // The offsets must run from 0 up to the entry count, and every hub must be a location, or a query could read past the labels
+    auto read_labels = [&file, location_count](Labels& labels, uint64_t entry_count) -> bool {
+        labels.offsets.resize(location_count + 1);
+        labels.entries.resize(entry_count);
+        file.read(reinterpret_cast<char*>(labels.offsets.data()), labels.offsets.size() * sizeof(uint32_t));
+        file.read(reinterpret_cast<char*>(labels.entries.data()), labels.entries.size() * sizeof(LabelEntry));
+        return file && labels.offsets.front() == 0 && labels.offsets.back() == entry_count &&
+            std::is_sorted(labels.offsets.begin(), labels.offsets.end()) &&
+            std::all_of(labels.entries.begin(), labels.entries.end(), [location_count](const LabelEntry& entry) -> bool {
+                return entry.hub < location_count;
+            });
+    };
+    Labels forward;
+    Labels backward;
+    if (!read_labels(forward, header.forward_entry_count) || !read_labels(backward, header.backward_entry_count)) {
+        LOG4CXX_ERROR(m_logger, "The hub label file is malformed " << label_file);
+        return nullptr;
+    }
+
+    std::shared_ptr<const HubLabelEngine> engine(new HubLabelEngine(graph, std::move(forward), std::move(backward)));
+    LOG4CXX_INFO(m_logger, "Loaded hub labels. file=" << label_file << " locations.n=" << location_count << " average_label_size="
+        << engine->AverageLabelSize() << " memory_bytes=" << engine->MemoryBytes());
+    return engine;
+}
+
+RouteEngineFactory HubLabelEngine::Factory(size_t max_locations, const std::string& label_file) {
+    return [max_locations, label_file](std::shared_ptr<const RouteGraph> graph) -> RouteEnginePtr {
+        if (graph->LocationCount() > max_locations) {
+            LOG4CXX_ERROR(m_logger, "Refusing to build hub labels, there are too many locations. locations.n=" << graph->LocationCount()
+                << " max_locations=" << max_locations);
+            return nullptr;
+        }
+        if (!label_file.empty()) {
+            std::shared_ptr<const HubLabelEngine> engine = Load(graph, label_file);
+            if (engine) {
+                return engine;
+            }
+        }
+        auto engine = std::make_shared<const HubLabelEngine>(graph);
+        if (!label_file.empty()) {
+            engine->Save(label_file);
+        }
+        return engine;
+    };
+}
+
+}
@@ -0,0 +1,68 @@
+#include <algorithm>
+#include <chrono>
+#include "route/DijkstraSearch.h"
+#include "route/Landmarks.h"
+
+namespace route {
+
+log4cxx::LoggerPtr Landmarks::m_logger(log4cxx::Logger::getLogger("Landmarks"));
+
+Landmarks::Landmarks(const RouteGraph& graph, size_t landmark_count) :
+m_landmarks(),
+m_from_landmarks(),
+m_to_landmarks() {
+    const auto start_time = std::chrono::steady_clock::now();
+    const size_t location_count = graph.LocationCount();
+    DijkstraSearch<BinaryHeapQueue> search;
+
+    // The lowest route cost from any landmark picked so far to each location. Locations no landmark reaches are left out of the
+    // running, they are usually isolated and make poor landmarks
+    std::vector<unsigned int> nearest_landmark(location_count, ROUTE_COST_UNREACHABLE);
+    std::vector<std::vector<unsigned int>> from_landmarks;
+    std::vector<std::vector<unsigned int>> to_landmarks;
+
+    // The first landmark is the location farthest from location 0, rather than location 0 itself which could be anywhere
+    LocationId next_landmark = INVALID_LOCATION_ID;
+    if (location_count > 0) {
+        const std::vector<unsigned int>& route_costs = search.RouteCostsFrom(graph, 0);
+        next_landmark = 0;
+        for (LocationId location_id = 0; location_id < location_count; ++location_id) {
+            if (route_costs[location_id] != ROUTE_COST_UNREACHABLE && route_costs[location_id] > route_costs[next_landmark]) {
+                next_landmark = location_id;
+            }
+        }
+    }
+
+    while (next_landmark != INVALID_LOCATION_ID && m_landmarks.size() < landmark_count) {
+        m_landmarks.push_back(next_landmark);
+        from_landmarks.push_back(search.RouteCostsFrom(graph, next_landmark));
+        to_landmarks.push_back(search.RouteCostsTo(graph, next_landmark));
+
+        const std::vector<unsigned int>& route_costs = from_landmarks.back();
+        next_landmark = INVALID_LOCATION_ID;
+        unsigned int farthest = 0;
+        for (LocationId location_id = 0; location_id < location_count; ++location_id) {
+            nearest_landmark[location_id] = std::min(nearest_landmark[location_id], route_costs[location_id]);
+            if (nearest_landmark[location_id] != ROUTE_COST_UNREACHABLE && nearest_landmark[location_id] > farthest) {
+                farthest = nearest_landmark[location_id];
+                next_landmark = location_id;
+            }
+        }
+    }
+
+    // Interleave the tables so the bounds for one location against every landmark sit next to each other
+    const size_t count = m_landmarks.size();
+    m_from_landmarks.resize(location_count * count);
+    m_to_landmarks.resize(location_count * count);
+    for (size_t landmark_i = 0; landmark_i < count; ++landmark_i) {
+        for (size_t location_i = 0; location_i < location_count; ++location_i) {
+            m_from_landmarks[location_i * count + landmark_i] = from_landmarks[landmark_i][location_i];
+            m_to_landmarks[location_i * count + landmark_i] = to_landmarks[landmark_i][location_i];
+        }
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    LOG4CXX_INFO(m_logger, "Built landmarks. locations.n=" << location_count << " landmarks.n=" << count << " memory_bytes=" << MemoryBytes() << " time_ms=" << elapsed.count());
+}
+
+}
@@ -2,14 +2,15 @@
 #include "route/Location.h"
 
 namespace route {
-Location::Location(const std::string name, unsigned int cost) :
-m_name(name),
-m_cost(cost)
+Location::Location(std::string_view name, unsigned int cost, LocationId id, std::pmr::memory_resource* resource) :
+m_name(name, resource),
+m_cost(cost),
+m_id(id)
 {
 
 }
 
-const std::string Location::Name() const {
+std::string_view Location::Name() const {
     return m_name;
 }
 
@@ -17,16 +18,24 @@ const unsigned int Location::Cost() const {
     return m_cost;
 }
 
-Location::ValidDestinationsType Location::Destinations() const {
+LocationId Location::Id() const {
+    return m_id;
+}
+
+const Location::ValidDestinationsType& Location::Destinations() const {
     return m_destinations;
 }
 
 void Location::AddDestination(const Location *const destination) {
-    m_destinations.insert(std::make_pair(destination->Name(), destination));
+    m_destinations.insert(std::make_pair(destination->Id(), destination));
+}
+
+void Location::ClearDestinations() {
+    m_destinations.clear();
 }
 
 bool Location::DestinationIsValid(const Location *const destination) const {
-    auto location = m_destinations.find(destination->Name());
+    auto location = m_destinations.find(destination->Id());
     return location != m_destinations.end();
 }
 
@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <numeric>
+#include "route/LocationOrder.h"
+
+namespace route {
+
+log4cxx::LoggerPtr LocationOrder::m_logger(log4cxx::Logger::getLogger("LocationOrder"));
+
+LocationOrder::LocationOrder(std::vector<LocationId>&& external_ids) :
+m_internal_ids(external_ids.size()),
+m_external_ids(std::move(external_ids)) {
+    for (LocationId internal_id = 0; internal_id < m_external_ids.size(); ++internal_id) {
+        m_internal_ids[m_external_ids[internal_id]] = internal_id;
+    }
+}
+
+LocationOrder LocationOrder::ReverseCuthillMcKee(const RouteGraph& graph) {
+    const auto start_time = std::chrono::steady_clock::now();
+    const size_t location_count = graph.LocationCount();
+    std::vector<uint32_t> degrees(location_count);
+    for (LocationId location_id = 0; location_id < location_count; ++location_id) {
+        degrees[location_id] = (graph.RoutesEnd(location_id) - graph.RoutesBegin(location_id)) +
+            (graph.ReverseRoutesEnd(location_id) - graph.ReverseRoutesBegin(location_id));
+    }
+    auto fewer_routes = [&degrees](LocationId a, LocationId b) -> bool {
+        return degrees[a] < degrees[b];
+    };
+
+    // Each part of the graph that isn't connected to the rest is searched from its location with the fewest routes, which tends to be
+    // on its edge
+    std::vector<LocationId> roots(location_count);
+    std::iota(roots.begin(), roots.end(), 0);
+    std::stable_sort(roots.begin(), roots.end(), fewer_routes);
+
+    std::vector<LocationId> external_ids;
+    external_ids.reserve(location_count);
+    std::vector<bool> visited(location_count, false);
+    std::vector<LocationId> adjacent_ids;
+    auto visit = [&visited, &adjacent_ids](LocationId location_id) -> void {
+        if (!visited[location_id]) {
+            visited[location_id] = true;
+            adjacent_ids.push_back(location_id);
+        }
+    };
+
+    for (LocationId root_id : roots) {
+        if (visited[root_id]) {
+            continue;
+        }
+        visited[root_id] = true;
+        external_ids.push_back(root_id);
+
+        for (size_t queue_i = external_ids.size() - 1; queue_i < external_ids.size(); ++queue_i) {
+            const LocationId location_id = external_ids[queue_i];
+            adjacent_ids.clear();
+            for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+                visit(graph.Destination(route_i));
+            }
+            for (uint32_t route_i = graph.ReverseRoutesBegin(location_id); route_i < graph.ReverseRoutesEnd(location_id); ++route_i) {
+                visit(graph.Origin(route_i));
+            }
+            std::stable_sort(adjacent_ids.begin(), adjacent_ids.end(), fewer_routes);
+            external_ids.insert(external_ids.end(), adjacent_ids.begin(), adjacent_ids.end());
+        }
+    }
+    std::reverse(external_ids.begin(), external_ids.end());
+
+    LocationOrder order(std::move(external_ids));
+    LOG4CXX_INFO(m_logger, "Ordered the locations. locations.n=" << location_count << " time_ms="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count());
+    return order;
+}
+
+LocationOrder LocationOrder::Identity(size_t location_count) {
+    std::vector<LocationId> external_ids(location_count);
+    std::iota(external_ids.begin(), external_ids.end(), 0);
+    return LocationOrder(std::move(external_ids));
+}
+
+RouteGraph LocationOrder::Apply(const RouteGraph& graph) const {
+    // The routes are already grouped by location, so they are laid out in the internal order straight away
+    std::vector<unsigned int> location_costs(m_external_ids.size());
+    std::vector<uint32_t> offsets(m_external_ids.size() + 1, 0);
+    std::vector<LocationId> destinations;
+    destinations.reserve(graph.RouteCount());
+    for (LocationId internal_id = 0; internal_id < m_external_ids.size(); ++internal_id) {
+        const LocationId external_id = m_external_ids[internal_id];
+        location_costs[internal_id] = graph.LocationCost(external_id);
+        for (uint32_t route_i = graph.RoutesBegin(external_id); route_i < graph.RoutesEnd(external_id); ++route_i) {
+            destinations.push_back(m_internal_ids[graph.Destination(route_i)]);
+        }
+        offsets[internal_id + 1] = static_cast<uint32_t>(destinations.size());
+    }
+    return RouteGraph(std::move(location_costs), std::move(offsets), std::move(destinations));
+}
+
+double LocationOrder::AverageRouteSpan(const RouteGraph& graph) {
+    if (graph.RouteCount() == 0) {
+        return 0.0;
+    }
+    uint64_t total_span = 0;
+    for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+        for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+            total_span += static_cast<uint64_t>(std::llabs(static_cast<long long>(graph.Destination(route_i)) - location_id));
+        }
+    }
+    return static_cast<double>(total_span) / graph.RouteCount();
+}
+
+}
@@ -0,0 +1,65 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include "route/MappedFile.h"
+
+namespace route {
+
+MappedFile::MappedFile(const std::string& path) :
+m_data(nullptr),
+m_size(0),
+m_open(false) {
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return;
+    }
+    struct stat file_stat;
+    if (fstat(file, &file_stat) == 0) {
+        m_open = true;
+        if (file_stat.st_size > 0) {
+            void* data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED) {
+                // The file is read front to back once, so the kernel can read ahead aggressively and drop the pages behind
+                madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+                m_data = static_cast<const char*>(data);
+                m_size = file_stat.st_size;
+            }
+            else {
+                m_open = false;
+            }
+        }
+    }
+    close(file);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data) {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+}
+
+uint64_t MappedFile::Checksum(std::string_view data) {
+    const uint64_t prime = 0x9e3779b97f4a7c15ULL;
+    uint64_t lanes[4] = {prime, prime * 3, prime * 5, prime * 7};
+    size_t byte_i = 0;
+    for (; byte_i + sizeof(lanes) <= data.size(); byte_i += sizeof(lanes)) {
+        for (int lane_i = 0; lane_i < 4; ++lane_i) {
+            uint64_t word;
+            std::memcpy(&word, data.data() + byte_i + lane_i * sizeof(uint64_t), sizeof(word));
+            lanes[lane_i] = ((lanes[lane_i] ^ word) * 0xff51afd7ed558ccdULL);
+            lanes[lane_i] ^= lanes[lane_i] >> 31;
+        }
+    }
+    uint64_t hash = data.size();
+    for (uint64_t lane : lanes) {
+        hash = (hash ^ lane) * prime;
+    }
+    for (; byte_i < data.size(); ++byte_i) {
+        hash = (hash ^ static_cast<unsigned char>(data[byte_i])) * 1099511628211ULL;
+    }
+    return hash ^ (hash >> 29);
+}
+
+}
@@ -0,0 +1,469 @@
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <tuple>
+#include "route/OverlayEngine.h"
+#include "route/ParallelFor.h"
+#include "route/PriorityQueue.h"
+#include "route/SearchWorkspace.h"
+
+namespace route {
+
+log4cxx::LoggerPtr OverlayEngine::m_logger(log4cxx::Logger::getLogger("OverlayEngine"));
+
+const uint32_t OverlayPartition::INVALID_BOUNDARY_INDEX;
+
+namespace {
+/// @brief The searches over the overlay are over states rather than locations, each location has two: reached by a route (or as the
+///        root), and reached through a clique, as an exit of a cell going forwards or an entry of a cell going backwards. Only the
+///        second kind go on to leave the cell, the first kind cross their cell by its clique
+inline LocationId RouteState(LocationId location_id) {
+    return location_id * 2;
+}
+
+inline LocationId CliqueState(LocationId location_id) {
+    return location_id * 2 + 1;
+}
+
+/// @brief This is the search state of one worker working out cliques
+struct CustomiseWorkspace {
+    SearchWorkspace workspace;
+    BinaryHeapQueue queue;
+};
+
+/// @brief This is the last partition built by a factory, so it can be used again while the routes don't change
+struct PartitionCache {
+    std::mutex mutex;
+    std::shared_ptr<const OverlayPartition> partition;
+};
+}
+
+OverlayPartition::OverlayPartition(const RouteGraph& graph, const std::vector<size_t>& cell_sizes) :
+topology_fingerprint(graph.TopologyFingerprint()),
+order(graph.LocationCount()),
+levels(),
+clique_size(0) {
+    const size_t location_count = graph.LocationCount();
+    std::vector<size_t> level_sizes;
+    std::copy_if(cell_sizes.begin(), cell_sizes.end(), std::back_inserter(level_sizes), [location_count](size_t cell_size) -> bool {
+        return cell_size > 0 && cell_size < location_count;
+    });
+    levels.resize(level_sizes.size());
+    if (levels.empty()) {
+        return;
+    }
+
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<uint32_t> positions(location_count);
+    std::iota(positions.begin(), positions.end(), 0);
+    std::vector<uint32_t> visited(location_count, 0);
+    uint32_t visit_stamp = 0;
+    std::vector<LocationId> bfs_queue;
+    std::vector<uint32_t> gains(location_count, 0);
+
+    // This calls visit for each location with a route to or from the given one
+    auto for_each_adjacent = [&graph](LocationId location_id, const std::function<void(LocationId)>& visit) -> void {
+        for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+            visit(graph.Destination(route_i));
+        }
+        for (uint32_t route_i = graph.ReverseRoutesBegin(location_id); route_i < graph.ReverseRoutesEnd(location_id); ++route_i) {
+            visit(graph.Origin(route_i));
+        }
+    };
+
+    // Each range is split in two by growing a region from a location on its edge (the last one a breadth first search reaches) until
+    // it holds half the range. The region grows by the location with the most routes into it so far, which keeps it compact rather
+    // than following the odd long route out across the graph. A range that isn't connected carries on growing from the next location
+    // not in the region
+    std::function<void(uint32_t, uint32_t, size_t)> split = [&](uint32_t begin, uint32_t end, size_t parent_size) -> void {
+        const size_t size = end - begin;
+        for (size_t level_i = 0; level_i < levels.size(); ++level_i) {
+            if (size <= level_sizes[level_i] && parent_size > level_sizes[level_i]) {
+                levels[level_i].cells.push_back(Cell{{}, {}, 0, begin, end});
+            }
+        }
+        if (size <= level_sizes[0]) {
+            return;
+        }
+        auto in_range = [&positions, begin, end](LocationId location_id) -> bool {
+            return positions[location_id] >= begin && positions[location_id] < end;
+        };
+
+        ++visit_stamp;
+        bfs_queue.assign(1, order[begin]);
+        visited[order[begin]] = visit_stamp;
+        for (size_t queue_i = 0; queue_i < bfs_queue.size(); ++queue_i) {
+            for_each_adjacent(bfs_queue[queue_i], [&](LocationId adjacent) -> void {
+                if (in_range(adjacent) && visited[adjacent] != visit_stamp) {
+                    visited[adjacent] = visit_stamp;
+                    bfs_queue.push_back(adjacent);
+                }
+            });
+        }
+
+        // The candidates are ordered by their routes into the region, then by the order they were first reached
+        ++visit_stamp;
+        for (uint32_t position = begin; position < end; ++position) {
+            gains[order[position]] = 0;
+        }
+        std::priority_queue<std::tuple<uint32_t, int64_t, LocationId>> candidates;
+        int64_t candidate_count = 0;
+        candidates.emplace(0, candidate_count--, bfs_queue.back());
+        const size_t half = size / 2;
+        uint32_t next_position = begin;
+        for (size_t region_size = 0; region_size < half;) {
+            if (candidates.empty()) {
+                while (visited[order[next_position]] == visit_stamp) {
+                    ++next_position;
+                }
+                candidates.emplace(0, candidate_count--, order[next_position]);
+            }
+            const LocationId location_id = std::get<2>(candidates.top());
+            const uint32_t gain = std::get<0>(candidates.top());
+            candidates.pop();
+            if (visited[location_id] == visit_stamp || gain != gains[location_id]) {
+                continue;
+            }
+            visited[location_id] = visit_stamp;
+            ++region_size;
+            for_each_adjacent(location_id, [&](LocationId adjacent) -> void {
+                if (in_range(adjacent) && visited[adjacent] != visit_stamp) {
+                    candidates.emplace(++gains[adjacent], candidate_count--, adjacent);
+                }
+            });
+        }
+
+        std::stable_partition(order.begin() + begin, order.begin() + end, [&visited, visit_stamp](LocationId location_id) -> bool {
+            return visited[location_id] == visit_stamp;
+        });
+        for (uint32_t position = begin; position < end; ++position) {
+            positions[order[position]] = position;
+        }
+        const uint32_t middle = begin + static_cast<uint32_t>(half);
+        split(begin, middle, size);
+        split(middle, end, size);
+    };
+    split(0, static_cast<uint32_t>(location_count), SIZE_MAX);
+
+    for (Level& level : levels) {
+        level.location_cells.resize(location_count);
+        for (uint32_t cell_id = 0; cell_id < level.cells.size(); ++cell_id) {
+            for (uint32_t position = level.cells[cell_id].begin; position < level.cells[cell_id].end; ++position) {
+                level.location_cells[order[position]] = cell_id;
+            }
+        }
+
+        level.entry_indexes.assign(location_count, INVALID_BOUNDARY_INDEX);
+        level.exit_indexes.assign(location_count, INVALID_BOUNDARY_INDEX);
+        for (LocationId location_id = 0; location_id < location_count; ++location_id) {
+            Cell& cell = level.cells[level.location_cells[location_id]];
+            for (uint32_t route_i = graph.ReverseRoutesBegin(location_id); route_i < graph.ReverseRoutesEnd(location_id); ++route_i) {
+                if (level.location_cells[graph.Origin(route_i)] != level.location_cells[location_id]) {
+                    level.entry_indexes[location_id] = static_cast<uint32_t>(cell.entries.size());
+                    cell.entries.push_back(location_id);
+                    break;
+                }
+            }
+            for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+                if (level.location_cells[graph.Destination(route_i)] != level.location_cells[location_id]) {
+                    level.exit_indexes[location_id] = static_cast<uint32_t>(cell.exits.size());
+                    cell.exits.push_back(location_id);
+                    break;
+                }
+            }
+        }
+        for (Cell& cell : level.cells) {
+            cell.clique_offset = clique_size;
+            clique_size += cell.entries.size() * cell.exits.size();
+        }
+    }
+}
+
+OverlayEngine::OverlayEngine(std::shared_ptr<const RouteGraph> graph, std::shared_ptr<const OverlayPartition> partition) :
+m_graph(graph),
+m_partition(partition),
+m_clique_costs(partition->clique_size, ROUTE_COST_UNREACHABLE) {
+    const auto start_time = std::chrono::steady_clock::now();
+    for (size_t level_i = 0; level_i < m_partition->LevelCount(); ++level_i) {
+        std::vector<uint32_t> cell_ids(m_partition->levels[level_i].cells.size());
+        std::iota(cell_ids.begin(), cell_ids.end(), 0);
+        CustomiseCells(level_i, cell_ids);
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+    LOG4CXX_INFO(m_logger, "Customised the overlay. locations.n=" << graph->LocationCount() << " levels.n=" << m_partition->LevelCount()
+        << " clique_costs.n=" << m_clique_costs.size() << " time_ms=" << elapsed.count());
+}
+
+OverlayEngine::OverlayEngine(std::shared_ptr<const RouteGraph> graph, std::shared_ptr<const OverlayPartition> partition, std::vector<unsigned int>&& clique_costs) :
+m_graph(graph),
+m_partition(partition),
+m_clique_costs(std::move(clique_costs)) {
+}
+
+void OverlayEngine::CustomiseCells(size_t level_i, const std::vector<uint32_t>& cell_ids) {
+    const RouteGraph& graph = *m_graph;
+    const OverlayPartition::Level& level = m_partition->levels[level_i];
+    const size_t state_count = graph.LocationCount() * 2;
+    const size_t worker_count = std::max<size_t>(1, std::min(WorkerCount(), cell_ids.size()));
+    std::vector<CustomiseWorkspace> workspaces(worker_count);
+
+    // Each cell's clique comes from one search per entry that stays inside the cell. At level 1 the search is over the route graph, above
+    // that it crosses each cell of the level below by its clique and only takes the routes between them
+    ParallelFor(cell_ids.size(), worker_count, [&](size_t cell_i, size_t worker_i) -> void {
+        const uint32_t cell_id = cell_ids[cell_i];
+        const OverlayPartition::Cell& cell = level.cells[cell_id];
+        unsigned int* const clique = &m_clique_costs[cell.clique_offset];
+        std::fill(clique, clique + cell.entries.size() * cell.exits.size(), ROUTE_COST_UNREACHABLE);
+        SearchWorkspace& workspace = workspaces[worker_i].workspace;
+        BinaryHeapQueue& queue = workspaces[worker_i].queue;
+
+        auto relax = [&workspace, &queue](LocationId state, unsigned int route_cost) -> void {
+            if (workspace.Relax(state, route_cost)) {
+                queue.Push(state, route_cost);
+            }
+        };
+
+        for (size_t entry_i = 0; entry_i < cell.entries.size(); ++entry_i) {
+            unsigned int* const clique_row = clique + entry_i * cell.exits.size();
+            workspace.Reset(state_count);
+            queue.Reset(state_count);
+            relax(RouteState(cell.entries[entry_i]), 0);
+
+            while (!queue.Empty()) {
+                const QueueEntry min_cost = queue.Pop();
+                if (workspace.Settled(min_cost.index)) {
+                    continue;
+                }
+                workspace.Settle(min_cost.index);
+                const LocationId location_id = min_cost.index / 2;
+                const unsigned int route_cost = workspace.RouteCost(min_cost.index);
+
+                if (level_i == 0) {
+                    if (level.exit_indexes[location_id] != OverlayPartition::INVALID_BOUNDARY_INDEX) {
+                        clique_row[level.exit_indexes[location_id]] = route_cost;
+                    }
+                    for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+                        if (level.location_cells[graph.Destination(route_i)] == cell_id) {
+                            relax(RouteState(graph.Destination(route_i)), route_cost + graph.RouteCost(route_i));
+                        }
+                    }
+                    continue;
+                }
+
+                const OverlayPartition::Level& lower = m_partition->levels[level_i - 1];
+                const uint32_t lower_cell_id = lower.location_cells[location_id];
+                if (min_cost.index == RouteState(location_id)) {
+                    // Reached from outside its cell at the level below, so it is an entry of it
+                    const OverlayPartition::Cell& lower_cell = lower.cells[lower_cell_id];
+                    const unsigned int* const lower_row = &m_clique_costs[lower_cell.clique_offset + lower.entry_indexes[location_id] * lower_cell.exits.size()];
+                    for (size_t exit_i = 0; exit_i < lower_cell.exits.size(); ++exit_i) {
+                        if (lower_row[exit_i] != ROUTE_COST_UNREACHABLE) {
+                            relax(CliqueState(lower_cell.exits[exit_i]), route_cost + lower_row[exit_i]);
+                        }
+                    }
+                }
+                else {
+                    if (level.exit_indexes[location_id] != OverlayPartition::INVALID_BOUNDARY_INDEX) {
+                        clique_row[level.exit_indexes[location_id]] = route_cost;
+                    }
+                    for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+                        const LocationId destination_id = graph.Destination(route_i);
+                        if (lower.location_cells[destination_id] != lower_cell_id && level.location_cells[destination_id] == cell_id) {
+                            relax(RouteState(destination_id), route_cost + graph.RouteCost(route_i));
+                        }
+                    }
+                }
+            }
+        }
+    });
+}
+
+/// @brief This is the state of a query, both sides search over the location states (see RouteState() and CliqueState())
+struct OverlayEngine::Query {
+    struct Side {
+        BinaryHeapQueue queue;
+        SearchWorkspace workspace;
+        unsigned int radius;        /// The cost of the last state this side settled
+
+        void Reset(size_t state_count, LocationId root_state) {
+            workspace.Reset(state_count);
+            queue.Reset(state_count);
+            radius = 0;
+            workspace.SetRouteCost(root_state, 0);
+            queue.Push(root_state, 0);
+        }
+    };
+
+    Side forward;
+    Side backward;
+    LocationId start_id;
+    LocationId end_id;
+    unsigned int best_cost;
+};
+
+template <bool Forward>
+bool OverlayEngine::Step(Query& query) const {
+    const RouteGraph& graph = *m_graph;
+    Query::Side& side = Forward ? query.forward : query.backward;
+    const Query::Side& other = Forward ? query.backward : query.forward;
+
+    auto relax = [&side, &other, &query](LocationId state, unsigned int route_cost) -> void {
+        if (side.workspace.Relax(state, route_cost)) {
+            side.queue.Push(state, route_cost);
+        }
+        // Either state of the location reached by the other side joins up into a route
+        const LocationId location_id = state / 2;
+        for (LocationId other_state : {RouteState(location_id), CliqueState(location_id)}) {
+            const unsigned int other_cost = other.workspace.RouteCost(other_state);
+            if (other_cost != ROUTE_COST_UNREACHABLE && route_cost + other_cost < query.best_cost) {
+                query.best_cost = route_cost + other_cost;
+            }
+        }
+    };
+
+    while (!side.queue.Empty()) {
+        const QueueEntry min_cost = side.queue.Pop();
+        if (side.workspace.Settled(min_cost.index)) {
+            continue;
+        }
+        side.workspace.Settle(min_cost.index);
+        side.radius = min_cost.cost;
+        const LocationId location_id = min_cost.index / 2;
+        const unsigned int route_cost = side.workspace.RouteCost(min_cost.index);
+
+        // The search level of a location is that of the biggest cell holding it but neither the start nor the end location, the
+        // route graph (level 0) is only used in the cells around them
+        size_t level_n = m_partition->LevelCount();
+        for (; level_n > 0; --level_n) {
+            const std::vector<uint32_t>& location_cells = m_partition->levels[level_n - 1].location_cells;
+            if (location_cells[location_id] != location_cells[query.start_id] && location_cells[location_id] != location_cells[query.end_id]) {
+                break;
+            }
+        }
+
+        if (level_n == 0) {
+            const uint32_t routes_end = Forward ? graph.RoutesEnd(location_id) : graph.ReverseRoutesEnd(location_id);
+            for (uint32_t route_i = Forward ? graph.RoutesBegin(location_id) : graph.ReverseRoutesBegin(location_id); route_i < routes_end; ++route_i) {
+                const LocationId adjacent = Forward ? graph.Destination(route_i) : graph.Origin(route_i);
+                relax(RouteState(adjacent), route_cost + (Forward ? graph.RouteCost(route_i) : graph.ReverseRouteCost(route_i)));
+            }
+            return true;
+        }
+
+        const OverlayPartition::Level& level = m_partition->levels[level_n - 1];
+        const uint32_t cell_id = level.location_cells[location_id];
+        const OverlayPartition::Cell& cell = level.cells[cell_id];
+        if (min_cost.index == RouteState(location_id)) {
+            // Reached from outside the cell, so going forwards this is an entry and the clique takes the search to each exit, and going
+            // backwards this is an exit and the clique takes it back to each entry
+            const unsigned int* const clique = &m_clique_costs[cell.clique_offset];
+            if (Forward) {
+                const unsigned int* const clique_row = clique + level.entry_indexes[location_id] * cell.exits.size();
+                for (size_t exit_i = 0; exit_i < cell.exits.size(); ++exit_i) {
+                    if (clique_row[exit_i] != ROUTE_COST_UNREACHABLE) {
+                        relax(CliqueState(cell.exits[exit_i]), route_cost + clique_row[exit_i]);
+                    }
+                }
+            }
+            else {
+                const size_t exit_i = level.exit_indexes[location_id];
+                for (size_t entry_i = 0; entry_i < cell.entries.size(); ++entry_i) {
+                    const unsigned int clique_cost = clique[entry_i * cell.exits.size() + exit_i];
+                    if (clique_cost != ROUTE_COST_UNREACHABLE) {
+                        relax(CliqueState(cell.entries[entry_i]), route_cost + clique_cost);
+                    }
+                }
+            }
+        }
+        else {
+            // Reached through the clique, so the search carries on out of the cell
+            const uint32_t routes_end = Forward ? graph.RoutesEnd(location_id) : graph.ReverseRoutesEnd(location_id);
+            for (uint32_t route_i = Forward ? graph.RoutesBegin(location_id) : graph.ReverseRoutesBegin(location_id); route_i < routes_end; ++route_i) {
+                const LocationId adjacent = Forward ? graph.Destination(route_i) : graph.Origin(route_i);
+                if (level.location_cells[adjacent] != cell_id) {
+                    relax(RouteState(adjacent), route_cost + (Forward ? graph.RouteCost(route_i) : graph.ReverseRouteCost(route_i)));
+                }
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+unsigned int OverlayEngine::GetRouteCost(LocationId start_id, LocationId end_id) const {
+    if (start_id == end_id) {
+        return 0;
+    }
+
+    static thread_local Query query;
+    const size_t state_count = m_graph->LocationCount() * 2;
+    query.forward.Reset(state_count, RouteState(start_id));
+    query.backward.Reset(state_count, RouteState(end_id));
+    query.start_id = start_id;
+    query.end_id = end_id;
+    query.best_cost = ROUTE_COST_UNREACHABLE;
+
+    // The two sides search the same overlay in opposite directions, so the usual bidirectional stopping rule holds
+    bool forward_turn = true;
+    while (static_cast<unsigned long long>(query.forward.radius) + query.backward.radius < query.best_cost) {
+        const bool stepped = forward_turn ? Step<true>(query) : Step<false>(query);
+        if (!stepped) {
+            break;
+        }
+        forward_turn = !forward_turn;
+    }
+    return query.best_cost;
+}
+
+RouteEnginePtr OverlayEngine::ApplyChange(std::shared_ptr<const RouteGraph> graph, const RouteChange& change) const {
+    if (change.type != RouteChange::LOCATION_COST) {
+        return nullptr;
+    }
+
+    // Only the routes into the location changed cost, and those are inside the cells holding it at each level, so only their cliques
+    // (and nothing else) can change
+    const auto start_time = std::chrono::steady_clock::now();
+    std::shared_ptr<OverlayEngine> engine(new OverlayEngine(graph, m_partition, std::vector<unsigned int>(m_clique_costs)));
+    for (size_t level_i = 0; level_i < m_partition->LevelCount(); ++level_i) {
+        engine->CustomiseCells(level_i, {m_partition->levels[level_i].location_cells[change.start_id]});
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time);
+    LOG4CXX_INFO(m_logger, "Customised the overlay for a location cost change. location_id=" << change.start_id << " cost=" << change.cost
+        << " time_us=" << elapsed.count());
+    return engine;
+}
+
+RouteEngineFactory OverlayEngine::Factory(const std::vector<size_t>& cell_sizes) {
+    auto partition_cache = std::make_shared<PartitionCache>();
+    return [cell_sizes, partition_cache](std::shared_ptr<const RouteGraph> graph) -> RouteEnginePtr {
+        std::shared_ptr<const OverlayPartition> partition;
+        {
+            std::lock_guard<std::mutex> lock(partition_cache->mutex);
+            if (partition_cache->partition && partition_cache->partition->topology_fingerprint == graph->TopologyFingerprint()) {
+                partition = partition_cache->partition;
+            }
+        }
+
+        if (partition) {
+            LOG4CXX_INFO(m_logger, "The routes are unchanged, keeping the overlay partition. locations.n=" << graph->LocationCount());
+        }
+        else {
+            const auto start_time = std::chrono::steady_clock::now();
+            partition = std::make_shared<const OverlayPartition>(*graph, cell_sizes);
+
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+            LOG4CXX_INFO(m_logger, "Partitioned the overlay. locations.n=" << graph->LocationCount() << " levels.n=" << partition->LevelCount()
+                << " clique_costs.n=" << partition->clique_size << " time_ms=" << elapsed.count());
+            std::lock_guard<std::mutex> lock(partition_cache->mutex);
+            partition_cache->partition = partition;
+        }
+        return std::make_shared<const OverlayEngine>(graph, partition);
+    };
+}
+
+}
@@ -0,0 +1,323 @@
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include "route/AtomicFile.h"
+#include "route/GraphFile.h"
+#include "route/MappedFile.h"
+#include "route/PagedGraph.h"
+
+namespace route {
+
+log4cxx::LoggerPtr PagedGraph::m_logger(log4cxx::Logger::getLogger("PagedGraph"));
+
+namespace {
+const char PAGED_GRAPH_MAGIC[8] = {'R', 'P', 'P', 'A', 'G', 'E', 'D', '1'};    /// This starts every paged graph file, the last character is the format version
+const size_t PAGE_HEADER_WORDS = 3;                                             /// The location count, the first location and the end offset of the last location
+
+/// @brief This is the start of a paged graph file, it is padded out to a page
+struct PagedGraphHeader {
+    char magic[8];
+    uint64_t page_size;
+    uint64_t location_count;
+    uint64_t route_count;
+    uint64_t page_count;
+    uint64_t index_size;            /// The size of the index after the pages
+    uint64_t index_checksum;        /// The checksum of the index
+};
+
+/// @brief This gets the number of words a page needs for a run of locations
+size_t PageWords(size_t location_count, size_t route_count) {
+    return PAGE_HEADER_WORDS + 2 * location_count + 2 * route_count;
+}
+
+/// @brief This works out which locations go in which page. Each page is grown from a seed location by a breadth first search over
+///        the routes (both ways) until it is full, so a page is a compact patch of the graph rather than a thin slice of it, and a
+///        search whose frontier crosses the graph touches as few pages as it can. When the search runs out of locations before the
+///        page is full it carries on from the next seed. The seeds are taken in the location order
+/// @param graph The route graph
+/// @param location_order The order to take the seeds in
+/// @param page_words The size of a page in words
+/// @param page_first_ids This is filled with the paged id of the first location of each page, with one extra at the end
+/// @return The location ids in the order they are paged in, which is the order of the paged ids
+std::vector<LocationId> GrowPages(const RouteGraph& graph, const LocationOrder& location_order, size_t page_words, std::vector<uint32_t>& page_first_ids) {
+    const size_t location_count = graph.LocationCount();
+    std::vector<LocationId> paged_ids;
+    paged_ids.reserve(location_count);
+    std::vector<bool> paged(location_count, false);
+    // The last page each location was queued for, so a location is only queued once per page
+    std::vector<uint32_t> queued_page(location_count, UINT32_MAX);
+    std::vector<LocationId> queue;
+    LocationId seed_i = 0;
+
+    while (paged_ids.size() < location_count) {
+        const uint32_t page_id = page_first_ids.size();
+        page_first_ids.push_back(paged_ids.size());
+        size_t page_location_count = 0;
+        size_t page_route_count = 0;
+        queue.clear();
+        for (size_t queue_i = 0;; ++queue_i) {
+            if (queue_i == queue.size()) {
+                while (seed_i < location_count && paged[location_order.ExternalId(seed_i)]) {
+                    ++seed_i;
+                }
+                if (seed_i == location_count) {
+                    break;
+                }
+                queue.push_back(location_order.ExternalId(seed_i));
+                queued_page[queue.back()] = page_id;
+            }
+            const LocationId location_id = queue[queue_i];
+            const size_t route_count = graph.RoutesEnd(location_id) - graph.RoutesBegin(location_id);
+            if (PageWords(page_location_count + 1, page_route_count + route_count) > page_words) {
+                break;
+            }
+            paged[location_id] = true;
+            paged_ids.push_back(location_id);
+            ++page_location_count;
+            page_route_count += route_count;
+
+            auto visit = [&](LocationId adjacent_id) -> void {
+                if (!paged[adjacent_id] && queued_page[adjacent_id] != page_id) {
+                    queued_page[adjacent_id] = page_id;
+                    queue.push_back(adjacent_id);
+                }
+            };
+            for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+                visit(graph.Destination(route_i));
+            }
+            for (uint32_t route_i = graph.ReverseRoutesBegin(location_id); route_i < graph.ReverseRoutesEnd(location_id); ++route_i) {
+                visit(graph.Origin(route_i));
+            }
+        }
+    }
+    page_first_ids.push_back(location_count);
+    return paged_ids;
+}
+
+/// @brief This copies a run of values out of the index and moves on past them
+template <typename T>
+bool ReadValues(std::string_view& data, size_t count, std::vector<T>& values) {
+    if (data.size() / sizeof(T) < count) {
+        return false;
+    }
+    values.resize(count);
+    std::memcpy(values.data(), data.data(), count * sizeof(T));
+    data.remove_prefix(count * sizeof(T));
+    return true;
+}
+}
+
+PagedGraph::PagedGraph(const std::string& paged_file) :
+m_paged_file(paged_file),
+m_page_size(0),
+m_location_count(0),
+m_route_count(0),
+m_checksum(0),
+m_page_first_ids(),
+m_page_checksums(),
+m_names(),
+m_buffer_pool() {
+}
+
+bool PagedGraph::Save(const std::string& paged_file, const PerfectNameIndex& names, const RouteGraph& graph, const LocationOrder& location_order,
+    size_t page_size) {
+    const size_t location_count = graph.LocationCount();
+    // The page is made bigger until the location with the most routes fits in one, so every location is in exactly one page
+    uint32_t max_route_count = 0;
+    for (LocationId location_id = 0; location_id < location_count; ++location_id) {
+        max_route_count = std::max(max_route_count, graph.RoutesEnd(location_id) - graph.RoutesBegin(location_id));
+    }
+    page_size = std::max<size_t>(page_size - page_size % sizeof(uint32_t), sizeof(PagedGraphHeader));
+    while (PageWords(1, max_route_count) * sizeof(uint32_t) > page_size) {
+        page_size *= 2;
+    }
+    const size_t page_words = page_size / sizeof(uint32_t);
+
+    PagedGraphHeader header;
+    const bool saved = AtomicFile::Save(paged_file, "paged graph file", [&](std::ostream& file) -> void {
+        // The header goes in last, once the index checksum is known
+        const std::vector<char> padding(page_size, '\0');
+        file.write(padding.data(), padding.size());
+
+        std::vector<uint32_t> page_first_ids;
+        const LocationOrder paged_order(GrowPages(graph, location_order, page_words, page_first_ids));
+        std::vector<uint64_t> page_checksums;
+        std::vector<uint32_t> page(page_words);
+        for (size_t page_id = 0; page_id + 1 < page_first_ids.size(); ++page_id) {
+            const LocationId first_id = page_first_ids[page_id];
+            const uint32_t page_location_count = page_first_ids[page_id + 1] - first_id;
+            std::fill(page.begin(), page.end(), 0);
+            page[0] = page_location_count;
+            page[1] = first_id;
+            uint32_t* const offsets = page.data() + 2;
+            uint32_t* const costs = offsets + page_location_count + 1;
+            uint32_t* const routes = costs + page_location_count;
+            uint32_t route_i = 0;
+            for (uint32_t location_i = 0; location_i < page_location_count; ++location_i) {
+                const LocationId external_id = paged_order.ExternalId(first_id + location_i);
+                offsets[location_i] = route_i;
+                costs[location_i] = graph.LocationCost(external_id);
+                for (uint32_t graph_route_i = graph.RoutesBegin(external_id); graph_route_i < graph.RoutesEnd(external_id); ++graph_route_i) {
+                    const LocationId destination = graph.Destination(graph_route_i);
+                    routes[2 * route_i] = paged_order.InternalId(destination);
+                    routes[2 * route_i + 1] = graph.LocationCost(destination);
+                    ++route_i;
+                }
+            }
+            offsets[page_location_count] = route_i;
+
+            page_checksums.push_back(MappedFile::Checksum(std::string_view(reinterpret_cast<const char*>(page.data()), page_size)));
+            file.write(reinterpret_cast<const char*>(page.data()), page_size);
+        }
+
+        // The names are kept by the paged graph's own ids
+        std::vector<std::string_view> paged_names;
+        paged_names.reserve(location_count);
+        for (LocationId location_id = 0; location_id < location_count; ++location_id) {
+            paged_names.push_back(names.Name(paged_order.ExternalId(location_id)));
+        }
+        std::ostringstream index;
+        index.write(reinterpret_cast<const char*>(page_first_ids.data()), page_first_ids.size() * sizeof(uint32_t));
+        index.write(reinterpret_cast<const char*>(page_checksums.data()), page_checksums.size() * sizeof(uint64_t));
+        PerfectNameIndex(paged_names).Write(index);
+        const std::string index_bytes = index.str();
+        file.write(index_bytes.data(), index_bytes.size());
+
+        std::memcpy(header.magic, PAGED_GRAPH_MAGIC, sizeof(header.magic));
+        header.page_size = page_size;
+        header.location_count = location_count;
+        header.route_count = graph.RouteCount();
+        header.page_count = page_checksums.size();
+        header.index_size = index_bytes.size();
+        header.index_checksum = MappedFile::Checksum(index_bytes);
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    });
+    if (!saved) {
+        return false;
+    }
+
+    LOG4CXX_INFO(m_logger, "Saved paged graph file. file=" << paged_file << " locations.n=" << header.location_count << " routes.n=" << header.route_count
+        << " pages.n=" << header.page_count << " page_size=" << page_size << " bytes=" << page_size * (1 + header.page_count) + header.index_size);
+    return true;
+}
+
+std::shared_ptr<const PagedGraph> PagedGraph::Open(const std::string& paged_file, size_t buffer_pool_size) {
+    const auto start_time = std::chrono::steady_clock::now();
+    std::ifstream file(paged_file, std::ios::binary);
+    if (!file.is_open()) {
+        LOG4CXX_ERROR(m_logger, "Could not open the paged graph file " << paged_file);
+        return nullptr;
+    }
+
+    PagedGraphHeader header;
+    struct stat file_stat;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) || std::memcmp(header.magic, PAGED_GRAPH_MAGIC, sizeof(header.magic)) != 0 ||
+        header.page_size < sizeof(header) || header.page_size % sizeof(uint32_t) != 0 || header.location_count >= INVALID_LOCATION_ID ||
+        header.page_count > header.location_count || stat(paged_file.c_str(), &file_stat) != 0 ||
+        static_cast<uint64_t>(file_stat.st_size) != header.page_size * (1 + header.page_count) + header.index_size) {
+        LOG4CXX_ERROR(m_logger, "The paged graph file is malformed or of another format version " << paged_file);
+        return nullptr;
+    }
+
+    // Only the index is read now, the pages are read as they are needed and checked against their checksums in the index
+    std::string index_bytes(header.index_size, '\0');
+    if (!file.seekg(header.page_size * (1 + header.page_count)) || !file.read(&index_bytes[0], index_bytes.size())) {
+        LOG4CXX_ERROR(m_logger, "Could not read the paged graph file " << paged_file);
+        return nullptr;
+    }
+    if (MappedFile::Checksum(index_bytes) != header.index_checksum) {
+        LOG4CXX_ERROR(m_logger, "The paged graph file doesn't match its checksum " << paged_file);
+        return nullptr;
+    }
+
+    std::shared_ptr<PagedGraph> paged_graph(new PagedGraph(paged_file));
+    auto names = std::make_shared<PerfectNameIndex>();
+    std::string_view data(index_bytes);
+    if (!ReadValues(data, header.page_count + 1, paged_graph->m_page_first_ids) || !ReadValues(data, header.page_count, paged_graph->m_page_checksums) ||
+        !names->Read(data) || !data.empty() || names->Size() != header.location_count ||
+        paged_graph->m_page_first_ids.front() != 0 || paged_graph->m_page_first_ids.back() != header.location_count ||
+        std::adjacent_find(paged_graph->m_page_first_ids.begin(), paged_graph->m_page_first_ids.end(), std::greater_equal<LocationId>()) !=
+            paged_graph->m_page_first_ids.end()) {
+        LOG4CXX_ERROR(m_logger, "The paged graph file is malformed " << paged_file);
+        return nullptr;
+    }
+
+    paged_graph->m_page_size = header.page_size;
+    paged_graph->m_location_count = header.location_count;
+    paged_graph->m_route_count = header.route_count;
+    paged_graph->m_checksum = header.index_checksum;
+    paged_graph->m_names = names;
+    const PagedGraph* const checked_graph = paged_graph.get();
+    paged_graph->m_buffer_pool = std::make_unique<BufferPool>(paged_file, header.page_size, header.page_size, header.page_count,
+        buffer_pool_size / header.page_size, [checked_graph](uint32_t page_id, const uint32_t* words) -> bool {
+            return checked_graph->CheckPage(page_id, words);
+        });
+    if (!paged_graph->m_buffer_pool->IsOpen()) {
+        return nullptr;
+    }
+
+    LOG4CXX_INFO(m_logger, "Opened paged graph file. file=" << paged_file << " locations.n=" << header.location_count << " routes.n=" << header.route_count
+        << " pages.n=" << header.page_count << " frames.n=" << paged_graph->FrameCount()
+        << " time_ms=" << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count());
+    return paged_graph;
+}
+
+bool PagedGraph::CheckPage(uint32_t page_id, const uint32_t* words) const {
+    if (MappedFile::Checksum(std::string_view(reinterpret_cast<const char*>(words), m_page_size)) != m_page_checksums[page_id]) {
+        LOG4CXX_ERROR(m_logger, "The page doesn't match its checksum. file=" << m_paged_file << " page=" << page_id);
+        return false;
+    }
+
+    // The checksum catches a damaged page, the page is still checked so a file that was written wrong can't make a search read
+    // past the page or out of the graph
+    const uint32_t page_location_count = m_page_first_ids[page_id + 1] - m_page_first_ids[page_id];
+    const uint32_t* const offsets = words + 2;
+    const uint32_t* const routes = offsets + 2 * page_location_count + 1;
+    const uint32_t route_count = offsets[page_location_count];
+    if (words[0] != page_location_count || words[1] != m_page_first_ids[page_id] || offsets[0] != 0 ||
+        !std::is_sorted(offsets, offsets + page_location_count + 1) ||
+        PageWords(page_location_count, route_count) > m_page_size / sizeof(uint32_t)) {
+        LOG4CXX_ERROR(m_logger, "The page is malformed. file=" << m_paged_file << " page=" << page_id);
+        return false;
+    }
+    for (uint32_t route_i = 0; route_i < route_count; ++route_i) {
+        if (routes[2 * route_i] >= m_location_count) {
+            LOG4CXX_ERROR(m_logger, "The page has a route out of the graph. file=" << m_paged_file << " page=" << page_id);
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned int PagedGraph::LocationCost(LocationId location_id) const {
+    const uint32_t page_id = PageOf(location_id);
+    const BufferPool::PageHandle page = m_buffer_pool->Fetch(page_id);
+    if (!page.Words()) {
+        return ROUTE_COST_ERROR;
+    }
+    const uint32_t page_location_count = m_page_first_ids[page_id + 1] - m_page_first_ids[page_id];
+    const uint32_t* const costs = page.Words() + 2 + page_location_count + 1;
+    return costs[location_id - m_page_first_ids[page_id]];
+}
+
+bool PagedGraph::Convert(const std::string& graph_file, const std::string& paged_file, size_t page_size) {
+    std::shared_ptr<const GraphFile> graph = GraphFile::Load(graph_file);
+    if (!graph) {
+        LOG4CXX_ERROR(m_logger, "Could not load the graph file to convert from " << graph_file);
+        return false;
+    }
+    return Save(paged_file, *graph->Names(), *graph->Graph(), *graph->Order(), page_size);
+}
+
+bool PagedGraph::IsPagedGraphFile(const std::string& path) {
+    char magic[sizeof(PAGED_GRAPH_MAGIC)];
+    std::ifstream file(path, std::ios::binary);
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, PAGED_GRAPH_MAGIC, sizeof(magic)) == 0;
+}
+
+}
@@ -0,0 +1,18 @@
+#include "route/PagedGraphDatabase.h"
+
+namespace route {
+
+PagedGraphDatabase::PagedGraphDatabase(const std::string& paged_file, size_t buffer_pool_size) :
+GraphDatabase<PagedGraph>(paged_file),
+m_buffer_pool_size(buffer_pool_size) {
+}
+
+std::shared_ptr<const PagedGraph> PagedGraphDatabase::LoadGraph() const {
+    return PagedGraph::Open(m_graph_file, m_buffer_pool_size);
+}
+
+std::shared_ptr<const PagedGraph> PagedGraphDatabase::GetPagedGraph() const {
+    return m_graph;
+}
+
+}
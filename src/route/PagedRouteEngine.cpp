@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "route/PagedRouteEngine.h"
+#include "route/ThreadPool.h"
+#include "route/PriorityQueue.h"
+
+namespace route {
+
+namespace {
+/// @brief This is what a search knows about a location it has reached
+struct SearchState {
+    unsigned int cost;
+    bool settled;
+};
+}
+
+log4cxx::LoggerPtr PagedRouteEngine::m_logger(log4cxx::Logger::getLogger("PagedRouteEngine"));
+
+PagedRouteEngine::PagedRouteEngine(std::shared_ptr<const PagedGraph> graph) :
+m_graph(graph) {
+}
+
+std::vector<unsigned int> PagedRouteEngine::RouteCosts(LocationId start_id, const std::vector<LocationId>& end_ids) const {
+    const PagedGraph& graph = *m_graph;
+    // Only the locations reached are kept, the search can't have an array over every location of a graph too big for memory
+    std::unordered_map<LocationId, SearchState> states;
+    std::unordered_set<LocationId> unsettled_ends(end_ids.begin(), end_ids.end());
+    std::unordered_set<uint32_t> prefetched_pages;
+    BinaryHeapQueue queue;
+    queue.Reset(0);
+    states[start_id] = SearchState{0, false};
+    queue.Push(start_id, 0);
+
+    while (!queue.Empty() && !unsettled_ends.empty()) {
+        const QueueEntry entry = queue.Pop();
+        SearchState& state = states[entry.index];
+        if (state.settled || entry.cost > state.cost) {
+            continue;
+        }
+        state.settled = true;
+        unsettled_ends.erase(entry.index);
+
+        const uint32_t page_id = graph.PageOf(entry.index);
+        const bool read = graph.ForEachRoute(entry.index, [&](LocationId destination, unsigned int route_cost) -> void {
+            const unsigned int cost = entry.cost + route_cost;
+            auto reached = states.emplace(destination, SearchState{cost, false});
+            if (!reached.second) {
+                if (reached.first->second.settled || reached.first->second.cost <= cost) {
+                    return;
+                }
+                reached.first->second.cost = cost;
+            }
+            queue.Push(destination, cost);
+            // A route into another page means the search will likely want that page soon, so it is read ahead while this one is
+            // worked through
+            const uint32_t destination_page_id = graph.PageOf(destination);
+            if (destination_page_id != page_id && prefetched_pages.insert(destination_page_id).second) {
+                graph.Prefetch(destination_page_id);
+            }
+        });
+        if (!read) {
+            // Without the routes of this location the search can't tell what is cheapest, so no cost is given rather than a wrong one
+            LOG4CXX_ERROR(m_logger, "Could not read the routes of a location, the query has failed. start_id=" << start_id << " location_id=" << entry.index
+                << " page=" << page_id);
+            return std::vector<unsigned int>(end_ids.size(), ROUTE_COST_ERROR);
+        }
+    }
+
+    std::vector<unsigned int> route_costs;
+    route_costs.reserve(end_ids.size());
+    for (LocationId end_id : end_ids) {
+        auto state = states.find(end_id);
+        route_costs.push_back(state != states.end() && state->second.settled ? state->second.cost : ROUTE_COST_UNREACHABLE);
+    }
+    return route_costs;
+}
+
+unsigned int PagedRouteEngine::GetRouteCost(LocationId start_id, LocationId end_id) const {
+    return RouteCosts(start_id, std::vector<LocationId>{end_id}).front();
+}
+
+std::vector<unsigned int> PagedRouteEngine::GetRouteCosts(const std::vector<LocationId>& start_ids, const std::vector<LocationId>& end_ids) const {
+    std::vector<unsigned int> route_costs(start_ids.size() * end_ids.size());
+    if (route_costs.empty()) {
+        return route_costs;
+    }
+    ThreadPool::Shared().ParallelFor(start_ids.size(), 1, [this, &start_ids, &end_ids, &route_costs](size_t first, size_t end, size_t) -> void {
+        for (size_t start_i = first; start_i < end; ++start_i) {
+            const std::vector<unsigned int> start_route_costs = RouteCosts(start_ids[start_i], end_ids);
+            std::copy(start_route_costs.begin(), start_route_costs.end(), route_costs.begin() + start_i * end_ids.size());
+        }
+    });
+    return route_costs;
+}
+
+}
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include "route/PerfectNameIndex.h"
+
+namespace route {
+
+log4cxx::LoggerPtr PerfectNameIndex::m_logger(log4cxx::Logger::getLogger("PerfectNameIndex"));
+
+namespace {
+const uint32_t MAX_BUCKET_SEED = 1 << 24;   /// A bucket that can't be placed with this many seeds means starting again with a new hash seed
+
+/// @brief This is the start of a written index, it is followed by the name offsets, the names, the bucket seeds and the slots
+struct IndexHeader {
+    uint64_t hash_seed;
+    uint64_t name_count;
+    uint64_t characters_size;
+    uint64_t bucket_count;
+    uint64_t slot_count;
+};
+
+/// @brief This copies a run of values out of the written index and moves on past them
+template <typename T>
+bool ReadValues(std::string_view& data, size_t count, std::vector<T>& values) {
+    if (data.size() / sizeof(T) < count) {
+        return false;
+    }
+    values.resize(count);
+    std::memcpy(values.data(), data.data(), count * sizeof(T));
+    data.remove_prefix(count * sizeof(T));
+    return true;
+}
+}
+
+PerfectNameIndex::PerfectNameIndex() :
+m_characters(),
+m_name_offsets(1, 0),
+m_bucket_seeds(),
+m_slots(),
+m_hash_seed(0) {
+}
+
+PerfectNameIndex::PerfectNameIndex(const std::vector<std::string_view>& names) :
+m_characters(),
+m_name_offsets(),
+m_bucket_seeds(),
+m_slots(),
+m_hash_seed(0) {
+    const auto start_time = std::chrono::steady_clock::now();
+    m_name_offsets.reserve(names.size() + 1);
+    m_name_offsets.push_back(0);
+    for (std::string_view name : names) {
+        m_characters.append(name);
+        m_characters.push_back('\0');
+        m_name_offsets.push_back(static_cast<uint32_t>(m_characters.size()));
+    }
+
+    while (!Build()) {
+        ++m_hash_seed;
+        LOG4CXX_DEBUG(m_logger, "Rebuilding the perfect name index with a new hash seed. hash_seed=" << m_hash_seed);
+    }
+
+    LOG4CXX_INFO(m_logger, "Built the perfect name index. names.n=" << Size() << " slots.n=" << m_slots.size() << " bytes=" << MemoryBytes()
+        << " time_ms=" << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count());
+}
+
+bool PerfectNameIndex::Build() {
+    // Repeated names are dropped, keeping the first id. Two different names with the same hash can never be told apart by the bucket
+    // seeds, so they need a new hash seed
+    std::vector<std::pair<uint64_t, LocationId>> keys(Size());
+    for (LocationId id = 0; id < keys.size(); ++id) {
+        keys[id] = std::make_pair(Hash(Name(id), m_hash_seed), id);
+    }
+    std::sort(keys.begin(), keys.end());
+    size_t distinct_count = 0;
+    for (const auto& key : keys) {
+        if (distinct_count > 0 && key.first == keys[distinct_count - 1].first) {
+            if (Name(key.second) != Name(keys[distinct_count - 1].second)) {
+                return false;
+            }
+            continue;
+        }
+        keys[distinct_count++] = key;
+    }
+    keys.resize(distinct_count);
+
+    m_slots.assign(distinct_count, Slot{0, INVALID_LOCATION_ID});
+    m_bucket_seeds.assign((distinct_count + PERFECT_NAME_INDEX_BUCKET_SIZE - 1) / PERFECT_NAME_INDEX_BUCKET_SIZE, 0);
+
+    // The names grouped by bucket, in compressed sparse row form
+    std::vector<uint32_t> bucket_offsets(m_bucket_seeds.size() + 1, 0);
+    for (const auto& key : keys) {
+        ++bucket_offsets[Bucket(key.first) + 1];
+    }
+    std::partial_sum(bucket_offsets.begin(), bucket_offsets.end(), bucket_offsets.begin());
+    std::vector<std::pair<uint64_t, LocationId>> bucket_keys(distinct_count);
+    std::vector<uint32_t> next(bucket_offsets.begin(), bucket_offsets.end() - 1);
+    for (const auto& key : keys) {
+        bucket_keys[next[Bucket(key.first)]++] = key;
+    }
+
+    // The biggest buckets are placed first, while most of the slots are still free
+    std::vector<uint32_t> buckets(m_bucket_seeds.size());
+    std::iota(buckets.begin(), buckets.end(), 0);
+    std::stable_sort(buckets.begin(), buckets.end(), [&bucket_offsets](uint32_t a, uint32_t b) -> bool {
+        return bucket_offsets[a + 1] - bucket_offsets[a] > bucket_offsets[b + 1] - bucket_offsets[b];
+    });
+
+    std::vector<bool> taken(distinct_count, false);
+    std::vector<uint32_t> slots;
+    for (uint32_t bucket : buckets) {
+        const uint32_t keys_begin = bucket_offsets[bucket];
+        const uint32_t keys_end = bucket_offsets[bucket + 1];
+        if (keys_begin == keys_end) {
+            break;
+        }
+
+        for (uint32_t bucket_seed = 0;; ++bucket_seed) {
+            if (bucket_seed == MAX_BUCKET_SEED) {
+                return false;
+            }
+            slots.clear();
+            for (uint32_t key_i = keys_begin; key_i < keys_end; ++key_i) {
+                const uint32_t slot = SlotIndex(bucket_keys[key_i].first, bucket_seed);
+                if (taken[slot] || std::find(slots.begin(), slots.end(), slot) != slots.end()) {
+                    break;
+                }
+                slots.push_back(slot);
+            }
+            if (slots.size() == keys_end - keys_begin) {
+                for (uint32_t key_i = keys_begin; key_i < keys_end; ++key_i) {
+                    taken[slots[key_i - keys_begin]] = true;
+                    const LocationId id = bucket_keys[key_i].second;
+                    m_slots[slots[key_i - keys_begin]] = Slot{m_name_offsets[id], id};
+                }
+                m_bucket_seeds[bucket] = bucket_seed;
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+void PerfectNameIndex::Write(std::ostream& file) const {
+    const IndexHeader header = {m_hash_seed, Size(), m_characters.size(), m_bucket_seeds.size(), m_slots.size()};
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(m_name_offsets.data()), m_name_offsets.size() * sizeof(uint32_t));
+    file.write(m_characters.data(), m_characters.size());
+    file.write(reinterpret_cast<const char*>(m_bucket_seeds.data()), m_bucket_seeds.size() * sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(m_slots.data()), m_slots.size() * sizeof(Slot));
+}
+
+bool PerfectNameIndex::Read(std::string_view& data) {
+    *this = PerfectNameIndex();
+    IndexHeader header;
+    if (data.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    std::string_view rest = data.substr(sizeof(header));
+
+    std::vector<uint32_t> name_offsets;
+    std::vector<uint32_t> bucket_seeds;
+    std::vector<Slot> slots;
+    if (header.name_count >= INVALID_LOCATION_ID || header.characters_size > UINT32_MAX || !ReadValues(rest, header.name_count + 1, name_offsets) ||
+        rest.size() < header.characters_size) {
+        return false;
+    }
+    std::string characters(rest.substr(0, header.characters_size));
+    rest.remove_prefix(header.characters_size);
+    if (!ReadValues(rest, header.bucket_count, bucket_seeds) || !ReadValues(rest, header.slot_count, slots)) {
+        return false;
+    }
+
+    // Every name must sit inside the characters and end with a '\0', and every slot must point at the start of the name it names.
+    // There must be a bucket for the slots to be reached through, and no more slots than names
+    if (name_offsets.front() != 0 || name_offsets.back() != characters.size() || (slots.empty() != bucket_seeds.empty()) || slots.size() > header.name_count) {
+        return false;
+    }
+    for (size_t name_i = 0; name_i < header.name_count; ++name_i) {
+        if (name_offsets[name_i] >= name_offsets[name_i + 1] || characters[name_offsets[name_i + 1] - 1] != '\0') {
+            return false;
+        }
+    }
+    for (const Slot& slot : slots) {
+        if (slot.id >= header.name_count || slot.name_offset != name_offsets[slot.id]) {
+            return false;
+        }
+    }
+
+    m_characters = std::move(characters);
+    m_name_offsets = std::move(name_offsets);
+    m_bucket_seeds = std::move(bucket_seeds);
+    m_slots = std::move(slots);
+    m_hash_seed = header.hash_seed;
+    data = rest;
+    return true;
+}
+
+}
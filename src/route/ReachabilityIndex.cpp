@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include "route/ReachabilityIndex.h"
+
+namespace route {
+
+log4cxx::LoggerPtr ReachabilityIndex::m_logger(log4cxx::Logger::getLogger("ReachabilityIndex"));
+
+namespace {
+const uint32_t UNVISITED = UINT32_MAX;
+}
+
+ReachabilityIndex::ReachabilityIndex(const RouteGraph& graph, size_t labelling_count) :
+m_components(),
+m_component_count(0),
+m_labelling_count(labelling_count),
+m_intervals() {
+    const auto start_time = std::chrono::steady_clock::now();
+    BuildComponents(graph);
+    BuildIntervals(graph);
+
+    LOG4CXX_INFO(m_logger, "Built the reachability index. locations.n=" << graph.LocationCount() << " components.n=" << m_component_count
+        << " labellings.n=" << m_labelling_count << " bytes=" << MemoryBytes() << " ms="
+        << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count());
+}
+
+void ReachabilityIndex::BuildComponents(const RouteGraph& graph) {
+    const size_t location_count = graph.LocationCount();
+    m_components.assign(location_count, UNVISITED);
+
+    // A location that has been visited but isn't in a component yet is on the Tarjan stack
+    std::vector<uint32_t> visit_order(location_count, UNVISITED);
+    std::vector<uint32_t> low_links(location_count, 0);
+    std::vector<LocationId> stack;
+    std::vector<std::pair<LocationId, uint32_t>> frames;    // The location being searched from and its next route
+    uint32_t visit_count = 0;
+
+    auto visit = [&](LocationId location_id) -> void {
+        visit_order[location_id] = low_links[location_id] = visit_count++;
+        stack.push_back(location_id);
+        frames.push_back(std::make_pair(location_id, graph.RoutesBegin(location_id)));
+    };
+
+    for (LocationId root_id = 0; root_id < location_count; ++root_id) {
+        if (visit_order[root_id] != UNVISITED) {
+            continue;
+        }
+        visit(root_id);
+
+        while (!frames.empty()) {
+            const LocationId location_id = frames.back().first;
+            uint32_t& route_i = frames.back().second;
+
+            if (route_i < graph.RoutesEnd(location_id)) {
+                const LocationId destination_id = graph.Destination(route_i++);
+                if (visit_order[destination_id] == UNVISITED) {
+                    visit(destination_id);
+                }
+                else if (m_components[destination_id] == UNVISITED) {
+                    low_links[location_id] = std::min(low_links[location_id], visit_order[destination_id]);
+                }
+                continue;
+            }
+
+            if (low_links[location_id] == visit_order[location_id]) {
+                LocationId member_id;
+                do {
+                    member_id = stack.back();
+                    stack.pop_back();
+                    m_components[member_id] = static_cast<uint32_t>(m_component_count);
+                } while (member_id != location_id);
+                ++m_component_count;
+            }
+            frames.pop_back();
+            if (!frames.empty()) {
+                const LocationId parent_id = frames.back().first;
+                low_links[parent_id] = std::min(low_links[parent_id], low_links[location_id]);
+            }
+        }
+    }
+}
+
+void ReachabilityIndex::BuildIntervals(const RouteGraph& graph) {
+    // The component graph, in compressed sparse row form with the repeated routes between two components merged
+    std::vector<std::pair<uint32_t, uint32_t>> component_routes;
+    for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+        for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+            const uint32_t start_component = m_components[location_id];
+            const uint32_t end_component = m_components[graph.Destination(route_i)];
+            if (start_component != end_component) {
+                component_routes.push_back(std::make_pair(start_component, end_component));
+            }
+        }
+    }
+    std::sort(component_routes.begin(), component_routes.end());
+    component_routes.erase(std::unique(component_routes.begin(), component_routes.end()), component_routes.end());
+
+    std::vector<uint32_t> offsets(m_component_count + 1, 0);
+    std::vector<uint32_t> destinations;
+    destinations.reserve(component_routes.size());
+    for (const auto& component_route : component_routes) {
+        ++offsets[component_route.first + 1];
+        destinations.push_back(component_route.second);
+    }
+    for (size_t component = 0; component < m_component_count; ++component) {
+        offsets[component + 1] += offsets[component];
+    }
+
+    m_intervals.assign(m_component_count * m_labelling_count, Interval{UNVISITED, UNVISITED});
+    std::vector<uint32_t> roots(m_component_count);
+    std::vector<std::pair<uint32_t, uint32_t>> frames;     // The component being searched from and its next route
+
+    for (size_t labelling_i = 0; labelling_i < m_labelling_count; ++labelling_i) {
+        // Each labelling visits the components and their routes in a different order, so where one labelling's intervals happen to
+        // overlap another's tell the components apart
+        std::mt19937 random(static_cast<unsigned>(labelling_i + 1));
+        for (uint32_t component = 0; component < m_component_count; ++component) {
+            roots[component] = component;
+            std::shuffle(destinations.begin() + offsets[component], destinations.begin() + offsets[component + 1], random);
+        }
+        std::shuffle(roots.begin(), roots.end(), random);
+
+        auto interval = [this, labelling_i](uint32_t component) -> Interval& {
+            return m_intervals[component * m_labelling_count + labelling_i];
+        };
+        uint32_t post_count = 0;
+
+        for (uint32_t root : roots) {
+            if (interval(root).post != UNVISITED) {
+                continue;
+            }
+            frames.push_back(std::make_pair(root, offsets[root]));
+            // A component is marked as visited when the search reaches it, the component graph has no cycles so the search never
+            // comes back to a component it is still searching from
+            interval(root).post = UNVISITED - 1;
+
+            while (!frames.empty()) {
+                const uint32_t component = frames.back().first;
+                uint32_t& route_i = frames.back().second;
+
+                if (route_i < offsets[component + 1]) {
+                    const uint32_t destination = destinations[route_i++];
+                    if (interval(destination).post == UNVISITED) {
+                        interval(destination).post = UNVISITED - 1;
+                        frames.push_back(std::make_pair(destination, offsets[destination]));
+                    }
+                    else {
+                        interval(component).low = std::min(interval(component).low, interval(destination).low);
+                    }
+                    continue;
+                }
+
+                interval(component).post = post_count++;
+                interval(component).low = std::min(interval(component).low, interval(component).post);
+                frames.pop_back();
+                if (!frames.empty()) {
+                    const uint32_t parent = frames.back().first;
+                    interval(parent).low = std::min(interval(parent).low, interval(component).low);
+                }
+            }
+        }
+    }
+}
+
+}
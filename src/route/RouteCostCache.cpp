@@ -0,0 +1,103 @@
+#include "route/RouteCostCache.h"
+
+namespace route {
+
+RouteCostCache::RouteCostCache(size_t capacity) :
+m_capacity(capacity),
+m_mutex(),
+m_version(0),
+m_entries(),
+m_index(),
+m_hit_count(0),
+m_miss_count(0),
+m_eviction_count(0)
+{
+    m_index.reserve(capacity);
+}
+
+bool RouteCostCache::CheckVersion(uint64_t version) {
+    // A caller still on an older snapshot while a newer one is swapped in must not flush the newer route costs
+    if (version < m_version) {
+        return false;
+    }
+    if (version > m_version) {
+        m_entries.clear();
+        m_index.clear();
+        m_version = version;
+    }
+    return true;
+}
+
+bool RouteCostCache::Lookup(uint64_t version, LocationId start_id, LocationId end_id, unsigned int& route_cost) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!CheckVersion(version)) {
+        ++m_miss_count;
+        return false;
+    }
+
+    auto found = m_index.find(Key(start_id, end_id));
+    if (found == m_index.end()) {
+        ++m_miss_count;
+        return false;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, found->second);
+    route_cost = found->second->route_cost;
+    ++m_hit_count;
+    return true;
+}
+
+void RouteCostCache::Insert(uint64_t version, LocationId start_id, LocationId end_id, unsigned int route_cost) {
+    if (m_capacity == 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!CheckVersion(version)) {
+        return;
+    }
+
+    const uint64_t key = Key(start_id, end_id);
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        found->second->route_cost = route_cost;
+        m_entries.splice(m_entries.begin(), m_entries, found->second);
+        return;
+    }
+
+    if (m_entries.size() >= m_capacity) {
+        m_index.erase(m_entries.back().key);
+        m_entries.pop_back();
+        ++m_eviction_count;
+    }
+    m_entries.push_front(Entry{key, route_cost});
+    m_index[key] = m_entries.begin();
+}
+
+void RouteCostCache::Clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+}
+
+size_t RouteCostCache::Size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+size_t RouteCostCache::HitCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_hit_count;
+}
+
+size_t RouteCostCache::MissCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_miss_count;
+}
+
+size_t RouteCostCache::EvictionCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_eviction_count;
+}
+
+}
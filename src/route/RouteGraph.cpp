@@ -0,0 +1,173 @@
+#include <algorithm>
+#include "route/RouteGraph.h"
+
+namespace route {
+
+RouteGraph::RouteGraph(const std::vector<Location*>& locations) :
+m_location_costs(),
+m_offsets(),
+m_destinations(),
+m_route_costs(),
+m_reverse_offsets(),
+m_origins(),
+m_reverse_route_costs() {
+    m_location_costs.reserve(locations.size());
+    std::for_each(locations.begin(), locations.end(), [this](const Location* const location) -> void {
+        m_location_costs.push_back(location->Cost());
+    });
+
+    std::vector<std::pair<size_t, size_t>> routes;
+    for (size_t i = 0; i < locations.size(); ++i) {
+        const Location::ValidDestinationsType& destinations = locations[i]->Destinations();
+        std::for_each(destinations.begin(), destinations.end(), [&routes, &locations, i](const Location::ValidDestinationsType::value_type& destination) -> void {
+            if (destination.first < locations.size() && locations[destination.first] == destination.second) {
+                routes.push_back(std::make_pair(i, destination.first));
+            }
+        });
+    }
+    Build(routes);
+}
+
+RouteGraph::RouteGraph(const std::vector<unsigned int>& location_costs, const std::vector<std::pair<size_t, size_t>>& routes) :
+m_location_costs(location_costs),
+m_offsets(),
+m_destinations(),
+m_route_costs(),
+m_reverse_offsets(),
+m_origins(),
+m_reverse_route_costs() {
+    Build(routes);
+}
+
+RouteGraph::RouteGraph(std::vector<unsigned int>&& location_costs, std::vector<uint32_t>&& offsets, std::vector<LocationId>&& destinations) :
+m_location_costs(std::move(location_costs)),
+m_offsets(std::move(offsets)),
+m_destinations(std::move(destinations)),
+m_route_costs(),
+m_reverse_offsets(),
+m_origins(),
+m_reverse_route_costs() {
+    const size_t location_count = m_location_costs.size();
+    m_route_costs.resize(m_destinations.size());
+    m_reverse_offsets.assign(location_count + 1, 0);
+    for (size_t route_i = 0; route_i < m_destinations.size(); ++route_i) {
+        m_route_costs[route_i] = m_location_costs[m_destinations[route_i]];
+        ++m_reverse_offsets[m_destinations[route_i] + 1];
+    }
+    for (size_t i = 0; i < location_count; ++i) {
+        m_reverse_offsets[i + 1] += m_reverse_offsets[i];
+    }
+
+    // The reverse routes are filled in location by location, so they come out in the same order Build() gives them
+    std::vector<uint32_t> reverse_next(m_reverse_offsets.begin(), m_reverse_offsets.end() - 1);
+    m_origins.resize(m_destinations.size());
+    m_reverse_route_costs.resize(m_destinations.size());
+    for (LocationId location_id = 0; location_id < location_count; ++location_id) {
+        for (uint32_t route_i = m_offsets[location_id]; route_i < m_offsets[location_id + 1]; ++route_i) {
+            const uint32_t reverse_route_i = reverse_next[m_destinations[route_i]]++;
+            m_origins[reverse_route_i] = location_id;
+            m_reverse_route_costs[reverse_route_i] = m_route_costs[route_i];
+        }
+    }
+}
+
+RouteGraph::RouteGraph(const RouteGraph& graph, const RouteChange& change) :
+m_location_costs(graph.m_location_costs),
+m_offsets(),
+m_destinations(),
+m_route_costs(),
+m_reverse_offsets(),
+m_origins(),
+m_reverse_route_costs() {
+    if (change.type == RouteChange::LOCATION_COST) {
+        m_location_costs[change.start_id] = change.cost;
+    }
+
+    std::vector<std::pair<size_t, size_t>> routes;
+    routes.reserve(graph.RouteCount() + 1);
+    for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+        for (uint32_t route_i = graph.RoutesBegin(location_id); route_i < graph.RoutesEnd(location_id); ++route_i) {
+            if (change.type != RouteChange::REMOVE_ROUTE || location_id != change.start_id || graph.Destination(route_i) != change.end_id) {
+                routes.push_back(std::make_pair(location_id, graph.Destination(route_i)));
+            }
+        }
+    }
+    if (change.type == RouteChange::ADD_ROUTE) {
+        routes.push_back(std::make_pair(change.start_id, change.end_id));
+    }
+    Build(routes);
+}
+
+bool RouteGraph::HasRoute(LocationId start_id, LocationId end_id) const {
+    for (uint32_t route_i = RoutesBegin(start_id); route_i < RoutesEnd(start_id); ++route_i) {
+        if (Destination(route_i) == end_id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+namespace {
+/// @brief This adds a value to a 64 bit FNV-1a hash, a byte at a time
+void HashValue(uint64_t& hash, uint64_t value) {
+    for (int byte_i = 0; byte_i < 8; ++byte_i) {
+        hash = (hash ^ ((value >> (byte_i * 8)) & 0xff)) * 1099511628211ULL;
+    }
+}
+}
+
+uint64_t RouteGraph::Fingerprint() const {
+    uint64_t hash = TopologyFingerprint();
+    for (unsigned int location_cost : m_location_costs) {
+        HashValue(hash, location_cost);
+    }
+    return hash;
+}
+
+uint64_t RouteGraph::TopologyFingerprint() const {
+    uint64_t hash = 14695981039346656037ULL;
+    HashValue(hash, m_location_costs.size());
+    HashValue(hash, m_destinations.size());
+    for (uint32_t offset : m_offsets) {
+        HashValue(hash, offset);
+    }
+    for (LocationId destination : m_destinations) {
+        HashValue(hash, destination);
+    }
+    return hash;
+}
+
+void RouteGraph::Build(const std::vector<std::pair<size_t, size_t>>& routes) {
+    const size_t location_count = m_location_costs.size();
+
+    // Count the routes leaving and entering each location, then turn the counts into offsets
+    m_offsets.assign(location_count + 1, 0);
+    m_reverse_offsets.assign(location_count + 1, 0);
+    std::for_each(routes.begin(), routes.end(), [this](const std::pair<size_t, size_t>& route) -> void {
+        ++m_offsets[route.first + 1];
+        ++m_reverse_offsets[route.second + 1];
+    });
+    for (size_t i = 0; i < location_count; ++i) {
+        m_offsets[i + 1] += m_offsets[i];
+        m_reverse_offsets[i + 1] += m_reverse_offsets[i];
+    }
+
+    // Fill in each location's range, keeping the routes in the order they were given
+    std::vector<uint32_t> next(m_offsets.begin(), m_offsets.end() - 1);
+    std::vector<uint32_t> reverse_next(m_reverse_offsets.begin(), m_reverse_offsets.end() - 1);
+    m_destinations.resize(routes.size());
+    m_route_costs.resize(routes.size());
+    m_origins.resize(routes.size());
+    m_reverse_route_costs.resize(routes.size());
+    std::for_each(routes.begin(), routes.end(), [this, &next, &reverse_next](const std::pair<size_t, size_t>& route) -> void {
+        uint32_t route_i = next[route.first]++;
+        m_destinations[route_i] = static_cast<LocationId>(route.second);
+        m_route_costs[route_i] = m_location_costs[route.second];
+
+        uint32_t reverse_route_i = reverse_next[route.second]++;
+        m_origins[reverse_route_i] = static_cast<LocationId>(route.first);
+        m_reverse_route_costs[reverse_route_i] = m_location_costs[route.second];
+    });
+}
+
+}
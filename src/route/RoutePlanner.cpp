@@ -1,130 +1,482 @@
 #include <algorithm>   
 #include <iostream>
 #include <iterator> 
+#include "route/PagedRouteEngine.h"
 #include "route/RoutePlanner.h"
+#include "route/SearchEngine.h"
 
 namespace route {
 
 log4cxx::LoggerPtr RoutePlanner::m_logger(log4cxx::Logger::getLogger("RoutePlanner"));
 
-RoutePlanner::RoutePlanner(std::shared_ptr<ILocationDatabase> location_db, std::shared_ptr<IRouteDatabase> route_db) :
+RoutePlanner::RoutePlanner(std::shared_ptr<ILocationDatabase> location_db, std::shared_ptr<IRouteDatabase> route_db, size_t route_cost_cache_capacity) :
 m_location_db(location_db),
-m_route_db(route_db)
+m_route_db(route_db),
+m_reload_mutex(),
+m_snapshot(),
+m_engine_factory(DijkstraEngine::Factory()),
+m_graph_version(0),
+m_route_cost_cache(route_cost_cache_capacity),
+m_reload_thread(),
+m_reload_wait_mutex(),
+m_reload_wait(),
+m_reload_stop(false),
+m_reloading(false)
 {
 }
 
+RoutePlanner::~RoutePlanner() {
+    StopReloading();
+}
+
+void RoutePlanner::StartReloading(std::chrono::milliseconds poll_interval) {
+    StopReloading();
+    m_reload_stop = false;
+    m_reloading = true;
+    m_reload_thread = std::thread(&RoutePlanner::ReloadLoop, this, poll_interval);
+    LOG4CXX_INFO(m_logger, "Reloading the databases in the background. poll_interval_ms=" << poll_interval.count());
+}
+
+void RoutePlanner::StopReloading() {
+    if (!m_reload_thread.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> wait_lock(m_reload_wait_mutex);
+        m_reload_stop = true;
+    }
+    m_reload_wait.notify_all();
+    m_reload_thread.join();
+    m_reloading = false;
+}
+
+void RoutePlanner::ReloadLoop(std::chrono::milliseconds poll_interval) {
+    std::unique_lock<std::mutex> wait_lock(m_reload_wait_mutex);
+    while (!m_reload_stop) {
+        wait_lock.unlock();
+        {
+            std::lock_guard<std::mutex> lock(m_reload_mutex);
+            if (!Snapshot() || m_location_db->HasChanged() || m_route_db->HasChanged()) {
+                LOG4CXX_DEBUG(m_logger, "The databases may have changed, reloading them in the background");
+                SetupRoutes();
+            }
+        }
+        wait_lock.lock();
+        m_reload_wait.wait_for(wait_lock, poll_interval, [this]() -> bool {
+            return m_reload_stop;
+        });
+    }
+}
+
+void RoutePlanner::SetRouteEngine(RouteEngineFactory engine_factory) {
+    std::lock_guard<std::mutex> lock(m_reload_mutex);
+    m_engine_factory = engine_factory;
+
+    RouteSnapshotPtr current = Snapshot();
+    if (current && current->paged_graph) {
+        LOG4CXX_INFO(m_logger, "The routes are in a paged graph, it keeps the paged route engine. version=" << current->version);
+    }
+    else if (current) {
+        auto snapshot = std::make_shared<RouteSnapshot>(*current);
+        snapshot->engine = BuildRouteEngine(snapshot->graph);
+        std::atomic_store(&m_snapshot, RouteSnapshotPtr(snapshot));
+    }
+}
+
+bool RoutePlanner::UpdateLocationCost(LocationId location_id, unsigned int cost) {
+    return ApplyChange(RouteChange::LocationCost(location_id, cost));
+}
+
+bool RoutePlanner::AddRoute(LocationId start_location_id, LocationId end_location_id) {
+    return ApplyChange(RouteChange::AddRoute(start_location_id, end_location_id));
+}
+
+bool RoutePlanner::RemoveRoute(LocationId start_location_id, LocationId end_location_id) {
+    return ApplyChange(RouteChange::RemoveRoute(start_location_id, end_location_id));
+}
+
+bool RoutePlanner::ApplyChange(const RouteChange& change) {
+    std::lock_guard<std::mutex> lock(m_reload_mutex);
+    RouteSnapshotPtr current = Snapshot();
+    if (!current) {
+        LOG4CXX_ERROR(m_logger, "There is no route graph to change, SetupRoutes() must be called first");
+        return false;
+    }
+    if (current->paged_graph) {
+        LOG4CXX_ERROR(m_logger, "The routes are in a paged graph on disk, they can only be changed by writing the file again. type=" << change.type);
+        return false;
+    }
+
+    const RouteGraph& graph = *current->graph;
+    const bool route_change = change.type != RouteChange::LOCATION_COST;
+    RouteChange internal_change = change;
+    internal_change.start_id = current->location_order->InternalId(change.start_id);
+    if (route_change) {
+        internal_change.end_id = current->location_order->InternalId(change.end_id);
+    }
+    if (internal_change.start_id >= graph.LocationCount() || (route_change && internal_change.end_id >= graph.LocationCount())) {
+        LOG4CXX_ERROR(m_logger, "Unknown location id in route change. start_location_id=" << change.start_id << " end_location_id=" << change.end_id
+            << " locations.n=" << graph.LocationCount());
+        return false;
+    }
+    if ((change.type == RouteChange::ADD_ROUTE && graph.HasRoute(internal_change.start_id, internal_change.end_id)) ||
+        (change.type == RouteChange::REMOVE_ROUTE && !graph.HasRoute(internal_change.start_id, internal_change.end_id))) {
+        LOG4CXX_ERROR(m_logger, "Route change doesn't match the routes. type=" << change.type << " start_location_id=" << change.start_id
+            << " end_location_id=" << change.end_id);
+        return false;
+    }
+    if (change.type == RouteChange::LOCATION_COST && graph.LocationCost(internal_change.start_id) == change.cost) {
+        return true;
+    }
+
+    auto snapshot = std::make_shared<RouteSnapshot>(*current);
+    snapshot->version = ++m_graph_version;
+    snapshot->graph = std::make_shared<const RouteGraph>(graph, internal_change);
+    // A location cost change doesn't change which locations can reach which
+    if (route_change) {
+        snapshot->reachability = std::make_shared<const ReachabilityIndex>(*snapshot->graph);
+    }
+    snapshot->engine = current->engine->ApplyChange(snapshot->graph, internal_change);
+    if (!snapshot->engine) {
+        LOG4CXX_INFO(m_logger, "The route engine can't be repaired, rebuilding it. version=" << snapshot->version);
+        snapshot->engine = BuildRouteEngine(snapshot->graph);
+    }
+    CarryRouteCosts(*current, *snapshot, internal_change);
+    std::atomic_store(&m_snapshot, RouteSnapshotPtr(snapshot));
+
+    LOG4CXX_INFO(m_logger, "Applied route change. type=" << change.type << " start_location_id=" << change.start_id << " end_location_id=" << change.end_id
+        << " cost=" << change.cost << " version=" << snapshot->version);
+    return true;
+}
+
+void RoutePlanner::CarryRouteCosts(const RouteSnapshot& current, const RouteSnapshot& snapshot, const RouteChange& change) {
+    if (!m_route_cost_cache.Size()) {
+        return;
+    }
+    // A route through a location cost change runs to the location and on from it, a route through a route change runs to its start,
+    // takes the route and runs on from its end
+    const RouteGraph& graph = *current.graph;
+    const bool route_change = change.type != RouteChange::LOCATION_COST;
+    DijkstraSearch<BinaryHeapQueue> search;
+    const std::vector<unsigned int> route_costs_to = search.RouteCostsTo(graph, change.start_id);
+    const std::vector<unsigned int>& route_costs_from = search.RouteCostsFrom(graph, route_change ? change.end_id : change.start_id);
+    const unsigned int change_cost = route_change ? graph.LocationCost(change.end_id) : 0;
+    const unsigned int old_cost = graph.LocationCost(change.start_id);
+    const unsigned int cost_drop = !route_change && old_cost > change.cost ? old_cost - change.cost : 0;
+
+    size_t kept_count = 0;
+    const size_t cached_count = m_route_cost_cache.Size();
+    m_route_cost_cache.Advance(current.version, snapshot.version, [&](LocationId start_id, LocationId end_id, unsigned int route_cost) -> bool {
+        // The cost of the start location is part of every route cost from it
+        if (!route_change && start_id == change.start_id) {
+            return false;
+        }
+        if (route_costs_to[start_id] == ROUTE_COST_UNREACHABLE || route_costs_from[end_id] == ROUTE_COST_UNREACHABLE) {
+            ++kept_count;
+            return true;
+        }
+        // A cheaper location makes the routes through it cheaper by as much, the route into it is always the last route taken
+        const uint64_t through_cost = static_cast<uint64_t>(graph.LocationCost(start_id)) + route_costs_to[start_id] + change_cost +
+            route_costs_from[end_id] - cost_drop;
+        if (route_cost == ROUTE_COST_UNREACHABLE || through_cost <= route_cost) {
+            return false;
+        }
+        ++kept_count;
+        return true;
+    });
+    LOG4CXX_DEBUG(m_logger, "Carried the cached route costs over the route change. kept=" << kept_count << " cached=" << cached_count
+        << " version=" << snapshot.version);
+}
+
+RouteSnapshotPtr RoutePlanner::Refresh() const {
+    RouteSnapshotPtr snapshot = Snapshot();
+    if (snapshot && m_reloading) {
+        return snapshot;
+    }
+    std::unique_lock<std::mutex> lock(m_reload_mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        if (snapshot) {
+            LOG4CXX_DEBUG(m_logger, "Reload already in progress, using the current route snapshot. version=" << snapshot->version);
+            return snapshot;
+        }
+        lock.lock();
+    }
+    // The databases only say they have changed once their files may have, so an unchanged database isn't read again
+    if (!Snapshot() || m_location_db->HasChanged() || m_route_db->HasChanged()) {
+        SetupRoutes();
+    }
+    return Snapshot();
+}
+
+void RoutePlanner::BuildRouteGraph(const std::vector<Location*>& locations) const {
+    std::vector<std::string_view> names;
+    names.reserve(locations.size());
+    for (const Location* location : locations) {
+        names.push_back(location->Name());
+    }
+    BuildRouteGraph(RouteGraph(locations), std::make_shared<const PerfectNameIndex>(names));
+}
+
+void RoutePlanner::BuildRouteGraph(const RouteGraph& database_graph, std::shared_ptr<const PerfectNameIndex> location_names,
+    std::shared_ptr<const LocationOrder> location_order) const {
+    auto snapshot = std::make_shared<RouteSnapshot>();
+    snapshot->version = ++m_graph_version;
+    // The route graph is renumbered so the locations a search touches together are close together in memory, the location
+    // databases keep their own ids and the route planner maps between the two
+    snapshot->location_order = location_order ? location_order : std::make_shared<const LocationOrder>(LocationOrder::ReverseCuthillMcKee(database_graph));
+    snapshot->graph = std::make_shared<const RouteGraph>(snapshot->location_order->Apply(database_graph));
+    LOG4CXX_DEBUG(m_logger, "Reordered the route graph. route_span_before=" << LocationOrder::AverageRouteSpan(database_graph)
+        << " route_span_after=" << LocationOrder::AverageRouteSpan(*snapshot->graph));
+    snapshot->engine = BuildRouteEngine(snapshot->graph);
+    snapshot->reachability = std::make_shared<const ReachabilityIndex>(*snapshot->graph);
+    snapshot->location_names = location_names;
+    std::atomic_store(&m_snapshot, RouteSnapshotPtr(snapshot));
+}
+
+void RoutePlanner::BuildRouteGraph(std::shared_ptr<const PagedGraph> paged_graph) const {
+    auto snapshot = std::make_shared<RouteSnapshot>();
+    snapshot->version = ++m_graph_version;
+    // The paged graph is already in the order it is searched in, and a reachability index would need every route in memory
+    snapshot->engine = std::make_shared<const PagedRouteEngine>(paged_graph);
+    snapshot->location_names = paged_graph->Names();
+    snapshot->paged_graph = paged_graph;
+    std::atomic_store(&m_snapshot, RouteSnapshotPtr(snapshot));
+}
+
+RouteEnginePtr RoutePlanner::BuildRouteEngine(std::shared_ptr<const RouteGraph> graph) const {
+    RouteEnginePtr engine = m_engine_factory(graph);
+    if (!engine) {
+        LOG4CXX_WARN(m_logger, "The route engine refused the route graph, falling back to Dijkstra. locations.n=" << graph->LocationCount());
+        engine = DijkstraEngine::Factory()(graph);
+    }
+    return engine;
+}
+
 const std::vector<Location*> RoutePlanner::SetupRoutes() const{
     bool locations_updated = m_location_db->Load();
     bool routes_updated = m_route_db->Load();
 
+    // A paged graph is searched where it is on disk, the locations and routes by name aren't needed
+    std::shared_ptr<const PagedGraph> paged_graph = m_location_db->GetPagedGraph();
+    if (paged_graph) {
+        if (locations_updated || routes_updated || !Snapshot()) {
+            BuildRouteGraph(paged_graph);
+            LOG4CXX_DEBUG(m_logger, "Configured " << paged_graph->LocationCount() << " locations from the paged graph. graph.routes=" << paged_graph->RouteCount()
+                << " graph.pages=" << paged_graph->PageCount());
+        }
+        return std::vector<Location*>();
+    }
+
+    // A compiled route graph is taken as it is, the locations and routes by name aren't needed
+    std::shared_ptr<const RouteGraph> database_graph = m_location_db->GetRouteGraph();
+    if (database_graph) {
+        if (locations_updated || routes_updated || !Snapshot()) {
+            BuildRouteGraph(*database_graph, m_location_db->GetLocationNameIndex(), m_location_db->GetLocationOrder());
+            LOG4CXX_DEBUG(m_logger, "Configured " << database_graph->LocationCount() << " locations from the compiled route graph. graph.routes=" << database_graph->RouteCount());
+        }
+        return std::vector<Location*>();
+    }
+
     if (locations_updated || routes_updated) {
         LOG4CXX_DEBUG(m_logger, "locations/Routes db changed, re-configuring database. locations_updated=" << locations_updated << " routes_updated=" << routes_updated);
         const std::vector<Location*> locations = m_location_db->GetLocations();
 
+        // The locations may be the ones set up before if only the routes changed, so their destinations are set again from scratch
         std::for_each(locations.begin(), locations.end(), [this](Location* const start_location) -> void {
-            std::vector<std::string> routes = m_route_db->GetRoutes(start_location->Name());
-            std::for_each(routes.begin(), routes.end(), [this, start_location](std::string location) -> void {
-                const Location* end_location = m_location_db->GetLocation(location);
+            start_location->ClearDestinations();
+            const std::vector<std::string>& routes = m_route_db->GetRoutes(std::string(start_location->Name()));
+            std::for_each(routes.begin(), routes.end(), [this, start_location](const std::string& location) -> void {
+                const Location* end_location = m_location_db->GetLocation(m_location_db->GetLocationId(location));
                 if (end_location) {
                     start_location->AddDestination(end_location);
                     LOG4CXX_DEBUG(m_logger, "Configured route Added. " << start_location->Name() << " -> " << end_location->Name());
                 }
             });
         });
-        LOG4CXX_DEBUG(m_logger, "Configured " << locations.size() << " routes");
+        BuildRouteGraph(locations);
+        LOG4CXX_DEBUG(m_logger, "Configured " << locations.size() << " routes. graph.routes=" << Snapshot()->graph->RouteCount());
         return locations;
     }
     else {
         const std::vector<Location*> locations = m_location_db->GetLocations();
+        if (!Snapshot()) {
+            BuildRouteGraph(locations);
+        }
         LOG4CXX_DEBUG(m_logger, "Currently " << locations.size() << " routes configured");
         return locations;
     }
 }
 
 std::vector<std::string> RoutePlanner::GetLocationNames() const {
+    RouteSnapshotPtr snapshot = Refresh();
     std::vector<std::string> location_names;
+    if (snapshot) {
+        location_names.reserve(snapshot->location_names->Size());
+        for (LocationId location_id = 0; location_id < snapshot->location_names->Size(); ++location_id) {
+            location_names.emplace_back(snapshot->location_names->Name(location_id));
+        }
+    }
+    return location_names;
+}
 
-    const std::vector<Location*> locations = SetupRoutes();
+size_t RoutePlanner::GetLocationCount() const {
+    RouteSnapshotPtr snapshot = Refresh();
+    return snapshot ? snapshot->LocationCount() : 0;
+}
 
-    std::for_each(locations.begin(), locations.end(), [this, &location_names](Location* location) -> void {
-        location_names.push_back(location->Name());
-    });  
+LocationId RoutePlanner::GetLocationId(const std::string& location_name) const {
+    RouteSnapshotPtr snapshot = Snapshot();
+    if (!snapshot) {
+        return INVALID_LOCATION_ID;
+    }
+    return snapshot->location_names->Find(location_name);
+}
 
-    return location_names;
+bool RoutePlanner::MayHaveRoute(LocationId start_location_id, LocationId end_location_id) const {
+    RouteSnapshotPtr snapshot = Snapshot();
+    if (!snapshot || start_location_id >= snapshot->LocationCount() || end_location_id >= snapshot->LocationCount()) {
+        return false;
+    }
+    return snapshot->MayReach(snapshot->InternalId(start_location_id), snapshot->InternalId(end_location_id));
+}
+
+unsigned int RoutePlanner::GetRouteCost(LocationId start_location_id, LocationId end_location_id) {
+    RouteSnapshotPtr snapshot = Snapshot();
+    if (!snapshot) {
+        LOG4CXX_ERROR(m_logger, "There is no route graph to search, SetupRoutes() must be called first");
+        return 0;
+    }
+    const unsigned int route_cost = GetRouteCost(*snapshot, start_location_id, end_location_id);
+    return route_cost == ROUTE_COST_ERROR ? 0 : route_cost;
+}
+
+unsigned int RoutePlanner::AnswerRouteRequest(size_t start_location, size_t end_location) {
+    // The whole request is answered from one route snapshot, a reload landing part way through can't mix two route graphs
+    RouteSnapshotPtr snapshot = Refresh();
+    const size_t location_count = snapshot ? snapshot->LocationCount() : 0;
+    if (start_location >= location_count || end_location >= location_count) {
+        LOG4CXX_ERROR(m_logger, "Unknown location in route request. start_location=" << start_location << " end_location=" << end_location << " locations.n=" << location_count);
+        return ROUTE_COST_ERROR;
+    }
+    return GetRouteCost(*snapshot, static_cast<LocationId>(start_location), static_cast<LocationId>(end_location));
 }
 
- size_t RoutePlanner::GetMinCostIndex(std::vector<unsigned int>& route_costs, std::vector<bool>& spt_set) {
-    int min = INT_MAX, min_index;
+std::vector<unsigned int> RoutePlanner::AnswerRouteMatrixRequest(const std::vector<size_t>& start_locations, const std::vector<size_t>& end_locations) {
+    RouteSnapshotPtr snapshot = Refresh();
+    const size_t location_count = snapshot ? snapshot->LocationCount() : 0;
+    auto in_range = [location_count](size_t location) -> bool {
+        return location < location_count;
+    };
+    if (!snapshot || !std::all_of(start_locations.begin(), start_locations.end(), in_range) || !std::all_of(end_locations.begin(), end_locations.end(), in_range)) {
+        LOG4CXX_ERROR(m_logger, "Unknown location in route matrix request. start_locations.n=" << start_locations.size() << " end_locations.n=" << end_locations.size()
+            << " locations.n=" << location_count);
+        return std::vector<unsigned int>();
+    }
+    // Each index is in range, so it fits in a location id
+    return GetRouteCosts(*snapshot, std::vector<LocationId>(start_locations.begin(), start_locations.end()),
+        std::vector<LocationId>(end_locations.begin(), end_locations.end()));
+}
 
-	for (size_t i = 0; i < route_costs.size(); ++i) {
-		if (spt_set[i] == false && route_costs[i] <= min) {
-			min = route_costs[i], min_index = i;
-		}
-	}
+unsigned int RoutePlanner::GetRouteCost(const RouteSnapshot& snapshot, LocationId start_location_id, LocationId end_location_id) {
+    const size_t location_count = snapshot.LocationCount();
+    const LocationId start_id = snapshot.InternalId(start_location_id);
+    const LocationId end_id = snapshot.InternalId(end_location_id);
+    unsigned int route_cost = ROUTE_COST_ERROR;
+
+    if (start_id < location_count && end_id < location_count) {
+        if (!snapshot.MayReach(start_id, end_id)) {
+            LOG4CXX_INFO(m_logger, "No route: " << start_location_id << " -> " << end_location_id);
+            return ROUTE_COST_UNREACHABLE;
+        }
+        if (m_route_cost_cache.Lookup(snapshot.version, start_id, end_id, route_cost)) {
+            LOG4CXX_INFO(m_logger, "Cached route cost: " << start_location_id << " -> " << end_location_id << " cost=" << route_cost);
+            return route_cost;
+        }
+        LOG4CXX_INFO(m_logger, "Calculating the route cost for: " << start_location_id << " -> " << end_location_id);
 
-	return min_index;
- }
+        route_cost = snapshot.engine->GetRouteCost(start_id, end_id);
+        if (route_cost != ROUTE_COST_UNREACHABLE && route_cost != ROUTE_COST_ERROR) {
+            const unsigned int start_cost = snapshot.LocationCost(start_id);
+            route_cost = start_cost == ROUTE_COST_ERROR ? ROUTE_COST_ERROR : route_cost + start_cost;
+        }
+        if (route_cost == ROUTE_COST_ERROR) {
+            LOG4CXX_ERROR(m_logger, "Could not calculate the route cost, the route graph couldn't be read: " << start_location_id << " -> " << end_location_id);
+            return ROUTE_COST_ERROR;
+        }
+        m_route_cost_cache.Insert(snapshot.version, start_id, end_id, route_cost);
+        LOG4CXX_INFO(m_logger, "Calculated the route cost: " << start_location_id << " -> " << end_location_id << " cost=" << route_cost);
+    }
+    else {
+        LOG4CXX_ERROR(m_logger, "Unknown location id. start_location_id=" << start_location_id << " end_location_id=" << end_location_id << " locations.n=" << location_count);
+    }
 
-size_t RoutePlanner::GetLocationIndex(const std::vector<Location*>& locations, std::string location_name) {
-    return std::distance(locations.begin(), std::find_if(locations.begin(), locations.end(), [location_name](Location* location) -> bool{
-        return location->Name() == location_name;
-    }));
+    return route_cost;
 }
 
-unsigned int RoutePlanner::GetRouteCost(std::string start_location_name, std::string end_location_name) {
-    Location* const start_location = m_location_db->GetLocation(start_location_name);
-    Location* const end_location = m_location_db->GetLocation(end_location_name);
+std::vector<unsigned int> RoutePlanner::GetRouteCosts(const std::vector<LocationId>& start_location_ids, const std::vector<LocationId>& end_location_ids) {
+    RouteSnapshotPtr snapshot = Snapshot();
+    if (!snapshot) {
+        LOG4CXX_ERROR(m_logger, "There is no route graph to search, SetupRoutes() must be called first");
+        return std::vector<unsigned int>();
+    }
+    return GetRouteCosts(*snapshot, start_location_ids, end_location_ids);
+}
 
-    size_t route_cost = 0;
+std::vector<unsigned int> RoutePlanner::GetRouteCosts(const RouteSnapshot& snapshot, const std::vector<LocationId>& start_location_ids, const std::vector<LocationId>& end_location_ids) {
+    std::vector<unsigned int> route_costs;
+    const size_t location_count = snapshot.LocationCount();
 
-    if (start_location && end_location) {
-        const std::vector<Location*> locations = m_location_db->GetLocations();
+    std::vector<LocationId> start_ids(start_location_ids.size());
+    std::vector<LocationId> end_ids(end_location_ids.size());
+    auto internal_id = [&snapshot](LocationId location_id) -> LocationId {
+        return snapshot.InternalId(location_id);
+    };
+    std::transform(start_location_ids.begin(), start_location_ids.end(), start_ids.begin(), internal_id);
+    std::transform(end_location_ids.begin(), end_location_ids.end(), end_ids.begin(), internal_id);
 
-        LOG4CXX_INFO(m_logger, "Calculating the route cost for: " << start_location->Name() << " -> " << end_location->Name());
-
-        // Use Dijkstra’s Algorithm to find the shortest route coset between start -> end 
-        std::vector<unsigned int> route_costs(locations.size(), INT_MAX); // The final route costs which will hold the result of the route from start -> end											                            
-        std::vector<bool> spt_set(locations.size(), false);  // shortest path tree list to keep track of which paths have already been calculated
-
-        size_t start_i = GetLocationIndex(locations, start_location_name);
-        size_t end_i = GetLocationIndex(locations, end_location_name);
-
-        // Distance of source vertex from itself is always 0
-        route_costs[start_i] = 0;
-
-        // Find the minimum costs for all locations, stopping before the end
-        for (size_t count = 0; count < locations.size() - 1; ++count) {
-            int min_cost_i = GetMinCostIndex(route_costs, spt_set);
-            spt_set[min_cost_i] = true;
-            const Location* const ref_location = locations[min_cost_i];
-            unsigned int base_cost = route_costs[min_cost_i];
-            bool bSearch = true;
-
-            // Update the distance cost for all the adjacent locations
-            for (size_t adj_i = 0; adj_i < locations.size() && bSearch; ++adj_i) {
-                size_t adjacent_location = adj_i;
-
-                //Check the adjacent locations of the current reference location
-                if (ref_location->DestinationIsValid(locations[adjacent_location])) {
-                    
-                    unsigned int dest_cost = locations[adjacent_location]->Cost();
-                    
-                    //Update the route cost of the current adjacent location and the total route cost from reference
-                    //location through this is less than the current cost
-                    if (!spt_set[adj_i] && base_cost != INT_MAX && base_cost + dest_cost < route_costs[adj_i]) {
-                        route_costs[adj_i] = base_cost + dest_cost;
-
-                        if(adj_i == end_i) {
-                            bSearch = false;   
-                        }
-                    }
-                }
+    auto unknown_location = [location_count](LocationId location_id) -> bool {
+        return location_id >= location_count;
+    };
+    if (std::any_of(start_ids.begin(), start_ids.end(), unknown_location) || std::any_of(end_ids.begin(), end_ids.end(), unknown_location)) {
+        LOG4CXX_ERROR(m_logger, "Unknown location id in route cost matrix request. locations.n=" << location_count);
+        return route_costs;
+    }
+
+    LOG4CXX_INFO(m_logger, "Calculating the route cost matrix for: " << start_location_ids.size() << " x " << end_location_ids.size() << " locations");
+    route_costs = snapshot.engine->GetRouteCosts(start_ids, end_ids);
+    for (size_t start_i = 0; start_i < start_ids.size(); ++start_i) {
+        const unsigned int start_cost = snapshot.LocationCost(start_ids[start_i]);
+        for (size_t end_i = 0; end_i < end_location_ids.size(); ++end_i) {
+            unsigned int& route_cost = route_costs[start_i * end_location_ids.size() + end_i];
+            if (route_cost == ROUTE_COST_ERROR || start_cost == ROUTE_COST_ERROR) {
+                LOG4CXX_ERROR(m_logger, "Could not calculate the route cost matrix, the route graph couldn't be read");
+                return std::vector<unsigned int>();
+            }
+            if (route_cost != ROUTE_COST_UNREACHABLE) {
+                route_cost += start_cost;
             }
         }
-        route_cost = route_costs[end_i] + locations[start_i]->Cost();
-        LOG4CXX_INFO(m_logger, "Calculated the route cost: " << start_location->Name() << " -> " << end_location->Name() << " cost=" << route_cost);
     }
-   
-    return route_cost;
+    return route_costs;
+}
+
+unsigned int RoutePlanner::GetRouteCost(const std::string& start_location_name, const std::string& end_location_name) {
+    // The names are resolved against the same snapshot that answers the query, so the ids can't change in between
+    RouteSnapshotPtr snapshot = Snapshot();
+    if (!snapshot) {
+        LOG4CXX_ERROR(m_logger, "There is no route graph to search, SetupRoutes() must be called first");
+        return 0;
+    }
+    const LocationId start_location_id = snapshot->location_names->Find(start_location_name);
+    const LocationId end_location_id = snapshot->location_names->Find(end_location_name);
+
+    if (start_location_id == INVALID_LOCATION_ID || end_location_id == INVALID_LOCATION_ID) {
+        LOG4CXX_ERROR(m_logger, "Unknown location name. start=" << start_location_name << " end=" << end_location_name);
+        return 0;
+    }
+
+    LOG4CXX_INFO(m_logger, "Resolved route request: " << start_location_name << " -> " << end_location_name);
+    const unsigned int route_cost = GetRouteCost(*snapshot, start_location_id, end_location_id);
+    return route_cost == ROUTE_COST_ERROR ? 0 : route_cost;
 }
 }
@@ -0,0 +1,95 @@
+#include <algorithm>
+#include "route/ParallelFor.h"
+#include "route/ThreadPool.h"
+
+namespace route {
+
+ThreadPool::ThreadPool(size_t worker_count) :
+m_threads(),
+m_loop_mutex(),
+m_mutex(),
+m_start(),
+m_done(),
+m_generation(0),
+m_busy_count(0),
+m_stop(false),
+m_loop() {
+    for (size_t worker_i = 1; worker_i < std::max<size_t>(1, worker_count); ++worker_i) {
+        m_threads.emplace_back(&ThreadPool::WorkerThread, this, worker_i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start.notify_all();
+    std::for_each(m_threads.begin(), m_threads.end(), [](std::thread& thread) -> void {
+        thread.join();
+    });
+}
+
+ThreadPool& ThreadPool::Shared() {
+    static ThreadPool thread_pool(route::WorkerCount());
+    return thread_pool;
+}
+
+void ThreadPool::WorkerThread(size_t worker_i) {
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+        m_start.wait(lock, [this, generation]() -> bool {
+            return m_stop || m_generation != generation;
+        });
+        if (m_stop) {
+            return;
+        }
+        generation = m_generation;
+
+        lock.unlock();
+        RunChunks(worker_i);
+        lock.lock();
+
+        if (--m_busy_count == 0) {
+            m_done.notify_one();
+        }
+    }
+}
+
+void ThreadPool::RunChunks(size_t worker_i) {
+    for (size_t first = m_loop.next_index.fetch_add(m_loop.chunk_size); first < m_loop.count; first = m_loop.next_index.fetch_add(m_loop.chunk_size)) {
+        (*m_loop.function)(first, std::min(first + m_loop.chunk_size, m_loop.count), worker_i);
+    }
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t chunk_size, const std::function<void(size_t, size_t, size_t)>& function) {
+    chunk_size = std::max<size_t>(1, chunk_size);
+    std::unique_lock<std::mutex> loop_lock(m_loop_mutex, std::defer_lock);
+    if (count <= chunk_size || m_threads.empty() || !loop_lock.try_lock()) {
+        if (count > 0) {
+            function(0, count, 0);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_loop.count = count;
+        m_loop.chunk_size = chunk_size;
+        m_loop.function = &function;
+        m_loop.next_index = 0;
+        m_busy_count = m_threads.size();
+        ++m_generation;
+    }
+    m_start.notify_all();
+
+    RunChunks(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_done.wait(lock, [this]() -> bool {
+        return m_busy_count == 0;
+    });
+}
+
+}
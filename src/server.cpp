@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <boost/asio.hpp>
 #include <log4cxx/logger.h>
@@ -6,9 +7,18 @@
 #include "comms/TcpServer.h"
 #include "messages/MsgFactory.h"
 #include "messages/MsgHeader.h"
+#include "route/AllPairsEngine.h"
+#include "route/AltEngine.h"
+#include "route/ContractionHierarchyEngine.h"
+#include "route/DeltaSteppingEngine.h"
 #include "route/FileLocationDatabase.h"
 #include "route/FileRouteDatabase.h"
+#include "route/GraphFileDatabase.h"
+#include "route/PagedGraphDatabase.h"
+#include "route/HubLabelEngine.h"
+#include "route/OverlayEngine.h"
 #include "route/RoutePlanner.h"
+#include "route/SearchEngine.h"
 
 using namespace log4cxx;
 using namespace messages;
@@ -74,18 +84,44 @@ public:
         size_t start_location = route_request->GetData()->start_location;
         size_t end_location = route_request->GetData()->end_location;
 
-        auto locations = m_route_planner->GetLocationNames();
-        if (start_location < locations.size() && end_location < locations.size()) {
-            size_t cost = m_route_planner->GetRouteCost(locations[start_location], locations[end_location]);
-
+        // The location indexes in the message are the location ids, as the locations are listed to the client in id order. The
+        // whole request is answered from one route snapshot, locations with no route between them straight from its reachability index
+        unsigned int cost = m_route_planner->AnswerRouteRequest(start_location, end_location);
+        if (cost != ROUTE_COST_ERROR) {
             auto response_msg = MsgHeader::GetDerivedType<MsgRouteResponse>(m_msg_factory->Create(MSG_ROUTE_RESPONSE_ID));
-            response_msg->SetCost(cost);
+            response_msg->SetCost(cost == ROUTE_COST_UNREACHABLE ? MSG_ROUTE_NO_ROUTE : cost);
 
             return response_msg;
         }
-        else {
-            LOG4CXX_ERROR(m_logger, "Unexpected start_location / end_location in Route Request msg. start_location=" << start_location << " end_location=" << end_location << " locations.n" << locations.size());
+        // A disk error is never sent as a route cost, the client gets no response as it does for a bad location
+        LOG4CXX_ERROR(m_logger, "Could not answer the Route Request msg, unexpected start_location / end_location or the route graph couldn't be read. start_location="
+            << start_location << " end_location=" << end_location);
+        return nullptr;
+    }
+
+    /// @brief This method will handle a Route Matrix Request Message received from the client, it will use the route planner to calculate
+    /// the route cost from each start location to each end location, sending the whole matrix back to the client
+    /// @param route_matrix_request This is the Route Matrix Request Message to handle
+    /// @return A Route Matrix Response Message
+    MsgHeader::MsgPointer HandleRouteMatrixRequestMsg(MsgRouteMatrixRequest::MsgPointer route_matrix_request) {
+        LOG4CXX_INFO(m_logger, "Received Route Matrix Request Msg. timestamp=" << route_matrix_request->DateString());
+        const MsgRouteMatrixRequestData* const data = route_matrix_request->GetData();
+
+        if (data->start_count <= MSG_ROUTE_MATRIX_MAX_LOCATIONS && data->end_count <= MSG_ROUTE_MATRIX_MAX_LOCATIONS) {
+            // The location indexes in the message are the location ids, as the locations are listed to the client in id order. Every
+            // index is range checked against the same route snapshot that answers the request, before it is narrowed to a location id
+            std::vector<size_t> start_locations(data->start_locations, data->start_locations + data->start_count);
+            std::vector<size_t> end_locations(data->end_locations, data->end_locations + data->end_count);
+
+            std::vector<unsigned int> costs = m_route_planner->AnswerRouteMatrixRequest(start_locations, end_locations);
+            if (costs.size() == start_locations.size() * end_locations.size()) {
+                auto response_msg = MsgHeader::GetDerivedType<MsgRouteMatrixResponse>(m_msg_factory->Create(MSG_ROUTE_MATRIX_RESPONSE_ID));
+                response_msg->SetCosts(start_locations.size(), end_locations.size(), costs, ROUTE_COST_UNREACHABLE);
+
+                return response_msg;
+            }
         }
+        LOG4CXX_ERROR(m_logger, "Could not answer the Route Matrix Request msg, unexpected start_locations / end_locations or the route graph couldn't be read. start_count=" << data->start_count << " end_count=" << data->end_count);
         return nullptr;
     }
 
@@ -102,6 +138,9 @@ public:
         else if (msg->Id() == MSG_ROUTE_REQUEST_ID) {
             return HandleRouteRequestMsg(MsgHeader::GetDerivedType<MsgRouteRequest>(msg));
         }
+        else if (msg->Id() == MSG_ROUTE_MATRIX_REQUEST_ID) {
+            return HandleRouteMatrixRequestMsg(MsgHeader::GetDerivedType<MsgRouteMatrixRequest>(msg));
+        }
         else {
             LOG4CXX_WARN(m_logger, "Unknown response Msg. id=" << msg->Id());
         }
@@ -111,16 +150,56 @@ public:
 
 log4cxx::LoggerPtr ServerMsgHandler::m_logger(log4cxx::Logger::getLogger("ServerMsgHandler"));
 
+/// @brief This maps a route engine name given on the command line to the factory for that engine
+/// @param engine_name The name of the route engine
+/// @param routes_db The path of the route db file, the hub labels are kept next to it
+/// @param engine_factory This is set to the engine factory
+/// @return True if the engine name is known, False if not
+bool GetRouteEngineFactory(const std::string& engine_name, const std::string& routes_db, RouteEngineFactory& engine_factory) {
+    if (engine_name == "dijkstra") {
+        engine_factory = DijkstraEngine::Factory();
+    }
+    else if (engine_name == "bidirectional") {
+        engine_factory = BidirectionalDijkstraEngine::Factory();
+    }
+    else if (engine_name == "ch") {
+        engine_factory = ContractionHierarchyEngine::Factory();
+    }
+    else if (engine_name == "alt") {
+        engine_factory = AltEngine::Factory();
+    }
+    else if (engine_name == "table") {
+        engine_factory = AllPairsEngine::Factory();
+    }
+    else if (engine_name == "delta") {
+        engine_factory = DeltaSteppingEngine::Factory();
+    }
+    else if (engine_name == "hub") {
+        engine_factory = HubLabelEngine::Factory(DEFAULT_HUB_LABEL_MAX_LOCATIONS, routes_db + ".hub");
+    }
+    else if (engine_name == "overlay") {
+        engine_factory = OverlayEngine::Factory();
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
 int main(int argc, char* argv[])
 {
     PropertyConfigurator::configure("log4cxx.properties");
     LoggerPtr logger = Logger::getLogger("server");
 
-    if (argc != 4) {
+    RouteEngineFactory engine_factory;
+    if ((argc != 4 && argc != 5) || !GetRouteEngineFactory(argc == 5 ? argv[4] : "dijkstra", argv[3], engine_factory)) {
         std::cout << "Usage:" << std::endl;
-        std::cout << "\tserver [PORT NUMBER] [LOCATION DB FILE] [ROUTE DB FILE]" << std::endl;
+        std::cout << "\tserver [PORT NUMBER] [LOCATION DB FILE] [ROUTE DB FILE] [ROUTE ENGINE (optional)]" << std::endl;
+        std::cout << "\tThe LOCATION DB FILE may be a graph file or a paged graph file made by graph_converter, the routes are then taken from it" << std::endl;
+        std::cout << "Route engines:" << std::endl;
+        std::cout << "\tdijkstra (default), bidirectional, ch, alt, table, delta, hub, overlay" << std::endl;
         std::cout << "Example:" << std::endl;
-        std::cout << "\tserver 8080 locations.dat routes.dat" << std::endl;
+        std::cout << "\tserver 8080 locations.dat routes.dat bidirectional" << std::endl;
         return 1;
     }
 
@@ -128,11 +207,29 @@ int main(int argc, char* argv[])
     const std::string locations_db(argv[2]);
     const std::string routes_db(argv[3]);
 
-    std::shared_ptr<FileLocationDatabase> location_db = std::make_shared<FileLocationDatabase>(locations_db);
-    std::shared_ptr<FileRouteDatabase> route_db = std::make_shared<FileRouteDatabase>(routes_db);
+    std::shared_ptr<ILocationDatabase> location_db;
+    std::shared_ptr<IRouteDatabase> route_db;
+    if (GraphFile::IsGraphFile(locations_db)) {
+        LOG4CXX_INFO(logger, "Using the graph file for the locations and routes. file=" << locations_db);
+        std::shared_ptr<GraphFileDatabase> graph_db = std::make_shared<GraphFileDatabase>(locations_db);
+        location_db = graph_db;
+        route_db = graph_db;
+    }
+    else if (PagedGraph::IsPagedGraphFile(locations_db)) {
+        LOG4CXX_INFO(logger, "Using the paged graph file for the locations and routes, the routes are searched on disk. file=" << locations_db);
+        std::shared_ptr<PagedGraphDatabase> paged_db = std::make_shared<PagedGraphDatabase>(locations_db);
+        location_db = paged_db;
+        route_db = paged_db;
+    }
+    else {
+        location_db = std::make_shared<FileLocationDatabase>(locations_db);
+        route_db = std::make_shared<FileRouteDatabase>(routes_db);
+    }
     std::shared_ptr<MsgFactory> msg_factory = std::make_shared<MsgFactory>();
 
     RoutePlanner route_planner(location_db, route_db);
+    route_planner.SetRouteEngine(engine_factory);
+    route_planner.StartReloading();
     ServerMsgHandler msg_handler(msg_factory, &route_planner);    
 
     try {
@@ -90,6 +90,24 @@ TEST_F(MsgFactoryTest, MsgRouteResponseCreate)
     EXPECT_NE(MsgHeader::GetDerivedType<MsgRouteResponse>(route_response), nullptr);
 }
 
+TEST_F(MsgFactoryTest, MsgRouteMatrixRequestCreate)
+{
+    auto route_matrix_request = msg_factory->Create(MSG_ROUTE_MATRIX_REQUEST_ID);
+
+    EXPECT_EQ(route_matrix_request->Id(), MSG_ROUTE_MATRIX_REQUEST_ID);
+    EXPECT_EQ(route_matrix_request->Length(), sizeof(MsgHeaderData) + sizeof(MsgRouteMatrixRequestData));
+    EXPECT_NE(MsgHeader::GetDerivedType<MsgRouteMatrixRequest>(route_matrix_request), nullptr);
+}
+
+TEST_F(MsgFactoryTest, MsgRouteMatrixResponseCreate)
+{
+    auto route_matrix_response = msg_factory->Create(MSG_ROUTE_MATRIX_RESPONSE_ID);
+
+    EXPECT_EQ(route_matrix_response->Id(), MSG_ROUTE_MATRIX_RESPONSE_ID);
+    EXPECT_EQ(route_matrix_response->Length(), sizeof(MsgHeaderData) + sizeof(MsgRouteMatrixResponseData));
+    EXPECT_NE(MsgHeader::GetDerivedType<MsgRouteMatrixResponse>(route_matrix_response), nullptr);
+}
+
 TEST_F(MsgFactoryTest, MsgNoMatchCreate)
 {
     auto msg = msg_factory->Create(0);
@@ -106,7 +124,9 @@ TEST_F(MsgFactoryTest, MaxMsgLength)
         MSG_LOCATIONS_REQUEST_ID, 
         MSG_LOCATIONS_RESPONSE_ID,
         MSG_ROUTE_REQUEST_ID,
-        MSG_ROUTE_RESPONSE_ID
+        MSG_ROUTE_RESPONSE_ID,
+        MSG_ROUTE_MATRIX_REQUEST_ID,
+        MSG_ROUTE_MATRIX_RESPONSE_ID
     };
 
     size_t max_message_size = 0;
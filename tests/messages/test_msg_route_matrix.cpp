@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include "messages/MsgRouteMatrix.h"
+
+using namespace messages;
+
+class MsgRouteMatrixTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+};
+
+TEST_F(MsgRouteMatrixTest, MsgRouteMatrixRequestConstructor)
+{
+    unsigned int id = 107;
+    unsigned int length = sizeof(MsgHeaderData) + sizeof(MsgRouteMatrixRequestData);
+
+    MsgRouteMatrixRequest route_matrix_request;
+
+    EXPECT_EQ(route_matrix_request.Id(), id);
+    EXPECT_EQ(route_matrix_request.Length(), length);
+    EXPECT_EQ(route_matrix_request.GetData()->start_count, 0);
+    EXPECT_EQ(route_matrix_request.GetData()->end_count, 0);
+}
+
+TEST_F(MsgRouteMatrixTest, MsgRouteMatrixRequestAddLocations)
+{
+    MsgRouteMatrixRequest route_matrix_request;
+
+    for (size_t i = 0; i < MSG_ROUTE_MATRIX_MAX_LOCATIONS; ++i) {
+        EXPECT_TRUE(route_matrix_request.AddStartLocation(i));
+        EXPECT_TRUE(route_matrix_request.AddEndLocation(i * 2));
+    }
+    // The message is full
+    EXPECT_FALSE(route_matrix_request.AddStartLocation(0));
+    EXPECT_FALSE(route_matrix_request.AddEndLocation(0));
+
+    EXPECT_EQ(route_matrix_request.GetData()->start_count, MSG_ROUTE_MATRIX_MAX_LOCATIONS);
+    EXPECT_EQ(route_matrix_request.GetData()->end_count, MSG_ROUTE_MATRIX_MAX_LOCATIONS);
+    EXPECT_EQ(route_matrix_request.GetData()->start_locations[3], 3);
+    EXPECT_EQ(route_matrix_request.GetData()->end_locations[3], 6);
+}
+
+TEST_F(MsgRouteMatrixTest, MsgRouteMatrixResponseConstructor)
+{
+    unsigned int id = 108;
+    unsigned int length = sizeof(MsgHeaderData) + sizeof(MsgRouteMatrixResponseData);
+
+    MsgRouteMatrixResponse route_matrix_response;
+
+    EXPECT_EQ(route_matrix_response.Id(), id);
+    EXPECT_EQ(route_matrix_response.Length(), length);
+    EXPECT_EQ(route_matrix_response.GetData()->start_count, 0);
+    EXPECT_EQ(route_matrix_response.GetData()->end_count, 0);
+}
+
+TEST_F(MsgRouteMatrixTest, MsgRouteMatrixResponseSetCosts)
+{
+    MsgRouteMatrixResponse route_matrix_response;
+
+    EXPECT_TRUE(route_matrix_response.SetCosts(2, 3, {1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(route_matrix_response.GetData()->start_count, 2);
+    EXPECT_EQ(route_matrix_response.GetData()->end_count, 3);
+    EXPECT_EQ(route_matrix_response.GetCost(0, 2), 3);
+    EXPECT_EQ(route_matrix_response.GetCost(1, 0), 4);
+
+    // The costs don't match the size, or the matrix is too big for the message
+    EXPECT_FALSE(route_matrix_response.SetCosts(2, 2, {1, 2, 3}));
+    EXPECT_FALSE(route_matrix_response.SetCosts(MSG_ROUTE_MATRIX_MAX_LOCATIONS + 1, 1, std::vector<unsigned int>(MSG_ROUTE_MATRIX_MAX_LOCATIONS + 1, 0)));
+}
+
+TEST_F(MsgRouteMatrixTest, MsgRouteMatrixResponseSetCostsNoRoute)
+{
+    MsgRouteMatrixResponse route_matrix_response;
+
+    EXPECT_TRUE(route_matrix_response.SetCosts(1, 3, {1, 7, 3}, 7));
+    EXPECT_EQ(route_matrix_response.GetCost(0, 0), 1);
+    EXPECT_EQ(route_matrix_response.GetCost(0, 1), MSG_ROUTE_NO_ROUTE);
+    EXPECT_EQ(route_matrix_response.GetCost(0, 2), 3);
+}
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "route/CsvReader.h"
+#include "route/FileContents.h"
+
+using namespace route;
+
+class CsvReaderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    /// @brief Utility method to read all the rows, useful for simplifying the test code
+    /// @param contents The rows to read
+    /// @return The fields of each row
+    static std::vector<std::vector<std::string>> ReadRows(std::string_view contents) {
+        CsvReader reader(contents);
+        std::vector<std::string_view> fields;
+        std::vector<std::vector<std::string>> rows;
+        while (reader.NextRow(fields)) {
+            rows.emplace_back(fields.begin(), fields.end());
+        }
+        return rows;
+    }
+};
+
+/// @brief Test case for CsvReader::NextRow() splitting and trimming the fields, skipping blank rows and with or without a newline at
+/// the end
+TEST_F(CsvReaderTest, TestNextRow)
+{
+    typedef std::vector<std::vector<std::string>> Rows;
+    EXPECT_EQ(Rows({{"London", "5"}, {"Glasgow", "3"}}), ReadRows("London, 5\nGlasgow ,3\n"));
+    EXPECT_EQ(Rows({{"London", "5"}, {"Glasgow", "3"}}), ReadRows("\n  London,\t5\r\n\r\n   \nGlasgow, 3"));
+    EXPECT_EQ(Rows({{"London"}, {"Glasgow", "", "3"}}), ReadRows("London,\nGlasgow,,3, \n"));
+    EXPECT_EQ(Rows(), ReadRows(""));
+    EXPECT_EQ(Rows(), ReadRows("\n \r\n"));
+}
+
+/// @brief Test case for CsvReader::NextRow() over rows long enough to cross many scan blocks, with delimiters right at the block edges
+TEST_F(CsvReaderTest, TestNextRowAcrossBlocks)
+{
+    std::string contents;
+    std::vector<std::vector<std::string>> expected_rows;
+    for (size_t row_i = 0; row_i < 50; ++row_i) {
+        std::vector<std::string> row;
+        for (size_t field_i = 0; field_i <= row_i % 7; ++field_i) {
+            row.push_back(std::string(row_i + field_i * 13 + 1, static_cast<char>('a' + field_i)));
+            contents += (field_i ? "," : "") + row.back();
+        }
+        contents += "\n";
+        expected_rows.push_back(row);
+    }
+    EXPECT_EQ(expected_rows, ReadRows(contents));
+
+    CsvReader reader(contents);
+    std::vector<std::string_view> fields;
+    ASSERT_TRUE(reader.NextRow(fields));
+    EXPECT_EQ(contents.data(), fields[0].data());
+    EXPECT_EQ("a", reader.Row());
+}
+
+/// @brief Test case for CsvReader::ParseUnsigned()
+TEST_F(CsvReaderTest, TestParseUnsigned)
+{
+    unsigned int value = 0;
+    EXPECT_TRUE(CsvReader::ParseUnsigned("5", value));
+    EXPECT_EQ(5, value);
+    EXPECT_TRUE(CsvReader::ParseUnsigned("4294967295", value));
+    EXPECT_EQ(4294967295u, value);
+    EXPECT_FALSE(CsvReader::ParseUnsigned("4294967296", value));
+    EXPECT_FALSE(CsvReader::ParseUnsigned("Glasgow", value));
+    EXPECT_FALSE(CsvReader::ParseUnsigned("5a", value));
+    EXPECT_FALSE(CsvReader::ParseUnsigned("-5", value));
+    EXPECT_FALSE(CsvReader::ParseUnsigned("", value));
+}
+
+/// @brief Test case for CsvReader::SplitRows(), every chunk but the last ends with a newline and together they are the whole contents
+TEST_F(CsvReaderTest, TestSplitRows)
+{
+    const std::string contents("London, Brighton\nGlasgow\n\nBath, London, Oxford\nOxford, Bath");
+    for (size_t chunk_size = 0; chunk_size <= contents.size() + 1; ++chunk_size) {
+        const std::vector<std::string_view> chunks = CsvReader::SplitRows(contents, chunk_size);
+        std::string joined;
+        for (size_t chunk_i = 0; chunk_i < chunks.size(); ++chunk_i) {
+            EXPECT_FALSE(chunks[chunk_i].empty());
+            if (chunk_i + 1 < chunks.size()) {
+                EXPECT_EQ('\n', chunks[chunk_i].back());
+                EXPECT_GE(chunks[chunk_i].size(), chunk_size);
+            }
+            joined += chunks[chunk_i];
+        }
+        EXPECT_EQ(contents, joined);
+    }
+
+    EXPECT_EQ(1, CsvReader::SplitRows(contents, contents.size()).size());
+    EXPECT_EQ(5, CsvReader::SplitRows(contents, 1).size());
+    EXPECT_TRUE(CsvReader::SplitRows("", 16).empty());
+}
+
+/// @brief Test case for MappedFile for a file that exists, an empty file and a file that doesn't exist
+TEST_F(CsvReaderTest, TestMappedFile)
+{
+    const std::string file_name("test_csv_reader.csv");
+    std::ofstream(file_name) << "London, 5\n";
+    {
+        MappedFile file(file_name);
+        EXPECT_TRUE(file.IsOpen());
+        EXPECT_EQ("London, 5\n", file.Contents());
+    }
+
+    std::ofstream(file_name, std::ios::trunc).close();
+    {
+        MappedFile file(file_name);
+        EXPECT_TRUE(file.IsOpen());
+        EXPECT_EQ("", file.Contents());
+    }
+    std::remove(file_name.c_str());
+
+    MappedFile missing_file("test_non_existant_file.csv");
+    EXPECT_FALSE(missing_file.IsOpen());
+}
+
+/// @brief Test case for FileContents for a file that exists, an empty file and a file that doesn't exist
+TEST_F(CsvReaderTest, TestFileContents)
+{
+    const std::string file_name("test_csv_reader.csv");
+    std::ofstream(file_name) << "London, 5\n";
+    {
+        FileContents file(file_name);
+        EXPECT_TRUE(file.IsOpen());
+        EXPECT_EQ("London, 5\n", file.Contents());
+
+        // The contents are owned, so rewriting the file in place after it was read leaves them as they were
+        std::ofstream(file_name, std::ios::trunc) << "Paris";
+        EXPECT_EQ("London, 5\n", file.Contents());
+    }
+
+    std::ofstream(file_name, std::ios::trunc).close();
+    {
+        FileContents file(file_name);
+        EXPECT_TRUE(file.IsOpen());
+        EXPECT_EQ("", file.Contents());
+    }
+    std::remove(file_name.c_str());
+
+    FileContents missing_file("test_non_existant_file.csv");
+    EXPECT_FALSE(missing_file.IsOpen());
+}
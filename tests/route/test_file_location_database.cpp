@@ -3,6 +3,8 @@
 #include <log4cxx/logger.h>
 #include <log4cxx/propertyconfigurator.h>
 #include <log4cxx/helpers/exception.h>
+#include <cstdio>
+#include <fstream>
 #include "route/Location.h"
 #include "route/FileLocationDatabase.h"
 
@@ -16,18 +18,18 @@ public:
     MockFileLocationDatabase() : FileLocationDatabase("test_data.csv") {}
     MockFileLocationDatabase(const std::string location_file) : FileLocationDatabase(location_file) {}
     
-    MOCK_METHOD(void, DeleteLocations, (std::vector<Location*>&), (override));
-    MOCK_METHOD(std::vector<Location*>, GetLocationsOnDisk, (), (override));
+    MOCK_METHOD(void, DeleteLocations, (std::vector<Location*>&, std::unique_ptr<LocationArena>&), (override));
+    MOCK_METHOD(std::vector<Location*>, GetLocationsOnDisk, (const FileContents&), (override));
     MOCK_METHOD(void, AddLocation, (Location* const), (override));
 
     /// @brief Adapter method to call FileLocationDatabase::GetLocationsOnDisk from the mock
-    const std::vector<Location*> RealGetLocationsOnDisk() {
-        return FileLocationDatabase::GetLocationsOnDisk();
+    const std::vector<Location*> RealGetLocationsOnDisk(const FileContents& file) {
+        return FileLocationDatabase::GetLocationsOnDisk(file);
     }
 
     /// @brief Adapter method to call FileLocationDatabase::DeleteLocations from the mock
-    void RealDeleteLocations(std::vector<Location*>& locations) {
-        FileLocationDatabase::DeleteLocations(locations);
+    void RealDeleteLocations(std::vector<Location*>& locations, std::unique_ptr<LocationArena>& arena) {
+        FileLocationDatabase::DeleteLocations(locations, arena);
     }
 
     /// @brief Adapter method to call FileLocationDatabase::AddLocation from the mock
@@ -88,7 +90,7 @@ TEST_F(FileLocationDatabaseTest, TestLocationsOnDiskSuccess)
     const std::string test_data_file = MockFileLocationDatabase::GetDataPath("test_load_success.csv");
     MockFileLocationDatabase test_db(test_data_file);
 
-    auto locations = test_db.RealGetLocationsOnDisk();
+    auto locations = test_db.RealGetLocationsOnDisk(FileContents(test_data_file));
     
     EXPECT_EQ(3, locations.size());
 
@@ -118,9 +120,9 @@ TEST_F(FileLocationDatabaseTest, TestLocationsOnDiskErrorFileMissing)
     const std::string test_data_file = MockFileLocationDatabase::GetDataPath("test_non_existant_file.csv");
     MockFileLocationDatabase test_db(test_data_file);
 
-    EXPECT_CALL(test_db, DeleteLocations(testing::_)).Times(0);
+    EXPECT_CALL(test_db, DeleteLocations(testing::_, testing::_)).Times(0);
 
-    auto locations = test_db.RealGetLocationsOnDisk();
+    auto locations = test_db.RealGetLocationsOnDisk(FileContents(test_data_file));
 
     EXPECT_EQ(0, locations.size());
 }
@@ -131,11 +133,13 @@ TEST_F(FileLocationDatabaseTest, TestLocationsOnDiskErrorWhileParsing)
     const std::string test_data_file = MockFileLocationDatabase::GetDataPath("test_load_bad_data.csv");
     MockFileLocationDatabase test_db(test_data_file);
 
-    EXPECT_CALL(test_db, DeleteLocations(testing::_)).Times(1).WillOnce([&test_db](std::vector<Location*>& locations){
-        test_db.RealDeleteLocations(locations);
+    EXPECT_CALL(test_db, DeleteLocations(testing::_, testing::_)).Times(1).WillOnce([&test_db](std::vector<Location*>& locations, std::unique_ptr<LocationArena>& arena){
+        EXPECT_NE(nullptr, arena);
+        test_db.RealDeleteLocations(locations, arena);
+        EXPECT_EQ(nullptr, arena);
     }); 
 
-    auto locations = test_db.RealGetLocationsOnDisk();
+    auto locations = test_db.RealGetLocationsOnDisk(FileContents(test_data_file));
 
     EXPECT_EQ(0, locations.size());
 }
@@ -151,11 +155,11 @@ TEST_F(FileLocationDatabaseTest, TestLocationsLoadSuccess)
 
     const std::vector<Location*> locations = {&london, &glasgow, &brighton};
 
-    EXPECT_CALL(test_db, GetLocationsOnDisk()).WillOnce([locations](){
+    EXPECT_CALL(test_db, GetLocationsOnDisk(testing::_)).WillOnce([locations](const FileContents&){
         return locations;
     }); 
 
-    EXPECT_CALL(test_db, DeleteLocations(testing::_)).WillOnce([](const std::vector<Location*>& locations) {
+    EXPECT_CALL(test_db, DeleteLocations(testing::_, testing::_)).WillOnce([](const std::vector<Location*>& locations, std::unique_ptr<LocationArena>&) {
         EXPECT_EQ(0, locations.size());
     }); 
 
@@ -180,14 +184,86 @@ TEST_F(FileLocationDatabaseTest, TestLocationsLoadFailed)
 {
     MockFileLocationDatabase test_db;
 
-    EXPECT_CALL(test_db, GetLocationsOnDisk()).WillOnce([](){
+    EXPECT_CALL(test_db, GetLocationsOnDisk(testing::_)).WillOnce([](const FileContents&){
         return std::vector<Location*>();
     }); 
 
-    EXPECT_CALL(test_db, DeleteLocations(testing::_)).Times(0);
+    EXPECT_CALL(test_db, DeleteLocations(testing::_, testing::_)).Times(0);
 
     EXPECT_CALL(test_db, AddLocation(testing::_)).Times(0);
 
     bool result = test_db.Load();
     EXPECT_FALSE(result);
-}
\ No newline at end of file
+}
+
+/// @brief Test case for FileLocationDatabase::GetLocationId() and FileLocationDatabase::GetLocation() after loading from disk, the
+/// ids follow the order of the file
+TEST_F(FileLocationDatabaseTest, TestLocationsLoadIds)
+{
+    FileLocationDatabase test_db(MockFileLocationDatabase::GetDataPath("test_load_success.csv"));
+
+    EXPECT_TRUE(test_db.Load());
+
+    const std::vector<Location*>& locations = test_db.GetLocations();
+    ASSERT_EQ(3, locations.size());
+
+    for (LocationId id = 0; id < locations.size(); ++id) {
+        EXPECT_EQ(id, locations[id]->Id());
+        EXPECT_EQ(locations[id], test_db.GetLocation(id));
+        EXPECT_EQ(id, test_db.GetLocationId(std::string(locations[id]->Name())));
+    }
+
+    EXPECT_EQ(INVALID_LOCATION_ID, test_db.GetLocationId("Atlantis"));
+    EXPECT_EQ(nullptr, test_db.GetLocation(3));
+    EXPECT_EQ(nullptr, test_db.GetLocation(INVALID_LOCATION_ID));
+}
+
+/// @brief Test case for FileLocationDatabase::Load() and FileLocationDatabase::HasChanged(), the file is only read again once it may
+/// have changed and the locations are only replaced if its contents have
+TEST_F(FileLocationDatabaseTest, TestLocationsLoadOnlyWhenChanged)
+{
+    const std::string location_file("test_locations_load_only_when_changed.csv");
+    std::ofstream(location_file, std::ios::trunc) << "London,5\nGlasgow,3\nBrighton,1\n";
+    FileLocationDatabase test_db(location_file);
+
+    EXPECT_TRUE(test_db.HasChanged());
+    EXPECT_TRUE(test_db.Load());
+    EXPECT_FALSE(test_db.HasChanged());
+    EXPECT_FALSE(test_db.Load());
+
+    // Rewritten with the same contents, it is read again but the locations are kept
+    const Location* const london = test_db.GetLocation(0);
+    std::ofstream(location_file, std::ios::trunc) << "London,5\nGlasgow,3\nBrighton,1\n";
+    EXPECT_TRUE(test_db.HasChanged());
+    EXPECT_FALSE(test_db.Load());
+    EXPECT_FALSE(test_db.HasChanged());
+    EXPECT_EQ(london, test_db.GetLocation(0));
+
+    // A changed cost is a change, even with the same number of locations
+    std::ofstream(location_file, std::ios::trunc) << "London,7\nGlasgow,3\nBrighton,1\n";
+    EXPECT_TRUE(test_db.HasChanged());
+    EXPECT_TRUE(test_db.Load());
+    ASSERT_EQ(3, test_db.GetLocations().size());
+    EXPECT_EQ(7, test_db.GetLocation(0)->Cost());
+
+    std::remove(location_file.c_str());
+}
+
+/// @brief Test case for FileLocationDatabase::GetLocationId() with a location name repeated part way through the file, the first id is
+/// used for the name and every location after the repeat still resolves to its own id
+TEST_F(FileLocationDatabaseTest, TestLocationsLoadDuplicateName)
+{
+    FileLocationDatabase test_db(MockFileLocationDatabase::GetDataPath("test_load_duplicate.csv"));
+
+    EXPECT_TRUE(test_db.Load());
+    ASSERT_EQ(5, test_db.GetLocations().size());
+
+    EXPECT_EQ(0, test_db.GetLocationId("London"));
+    EXPECT_EQ(1, test_db.GetLocationId("Glasgow"));
+    EXPECT_EQ(3, test_db.GetLocationId("Brighton"));
+    EXPECT_EQ(4, test_db.GetLocationId("Leeds"));
+
+    EXPECT_EQ(5, test_db.GetLocation(test_db.GetLocationId("London"))->Cost());
+    EXPECT_EQ(1, test_db.GetLocation(test_db.GetLocationId("Brighton"))->Cost());
+    EXPECT_EQ(2, test_db.GetLocation(test_db.GetLocationId("Leeds"))->Cost());
+}
@@ -3,6 +3,8 @@
 #include <log4cxx/logger.h>
 #include <log4cxx/propertyconfigurator.h>
 #include <log4cxx/helpers/exception.h>
+#include <cstdio>
+#include <fstream>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -19,11 +21,11 @@ public:
     MockFileRouteDatabase(const std::string route_file) : FileRouteDatabase(route_file) {}
 
     // MOCK_METHOD(std::vector<const Location* const>, GetLocationsOnDisk, (), (override));
-    MOCK_METHOD((std::unordered_map<std::string, std::vector<std::string>>), GetRoutesOnDisk, (), (const, override));
+    MOCK_METHOD((std::unordered_map<std::string, std::vector<std::string>>), GetRoutesOnDisk, (const FileContents&), (const, override));
 
     /// @brief Adapter method to call FileRouteDatabase::GetRoutesOnDisk from the mock
-    std::unordered_map<std::string, std::vector<std::string>> RealGetRoutesOnDisk() {
-        return FileRouteDatabase::GetRoutesOnDisk();
+    std::unordered_map<std::string, std::vector<std::string>> RealGetRoutesOnDisk(const FileContents& file) {
+        return FileRouteDatabase::GetRoutesOnDisk(file);
     }
 
     /// @brief Utility method to return a Route by name, useful for simplifying the test code
@@ -95,7 +97,7 @@ TEST_F(FileRouteDatabaseTest, TestRoutesOnDiskSuccess)
     const std::string test_data_file = MockFileRouteDatabase::GetDataPath("test_load_success.csv");
     MockFileRouteDatabase test_db(test_data_file);
 
-    auto routes = test_db.RealGetRoutesOnDisk();
+    auto routes = test_db.RealGetRoutesOnDisk(FileContents(test_data_file));
     
     EXPECT_EQ(3, routes.size());
 
@@ -126,7 +128,7 @@ TEST_F(FileRouteDatabaseTest, TestRoutesOnDiskErrorFileMissing)
     const std::string test_data_file = MockFileRouteDatabase::GetDataPath("test_non_existant_file.csv");
     MockFileRouteDatabase test_db(test_data_file);
 
-    auto routes = test_db.RealGetRoutesOnDisk();
+    auto routes = test_db.RealGetRoutesOnDisk(FileContents(test_data_file));
 
     EXPECT_EQ(0, routes.size());
 }
@@ -147,7 +149,7 @@ TEST_F(FileRouteDatabaseTest, TestRoutesLoadSuccess)
     std::vector<std::string> johnogroates_routes = {"Glasgow", "Endinburgh"};
     routes.insert(std::make_pair("John O' Groats", johnogroates_routes));
 
-    EXPECT_CALL(test_db, GetRoutesOnDisk()).WillOnce([routes](){
+    EXPECT_CALL(test_db, GetRoutesOnDisk(testing::_)).WillOnce([routes](const FileContents&){
         return routes;
     }); 
 
@@ -180,10 +182,59 @@ TEST_F(FileRouteDatabaseTest, TestRoutesLoadFailed)
 {
     MockFileRouteDatabase test_db;
 
-    EXPECT_CALL(test_db, GetRoutesOnDisk()).WillOnce([](){
+    EXPECT_CALL(test_db, GetRoutesOnDisk(testing::_)).WillOnce([](const FileContents&){
         return std::unordered_map<std::string, std::vector<std::string>>();
     }); 
 
     bool result = test_db.Load();
     EXPECT_FALSE(result);
-}
\ No newline at end of file
+}
+/// @brief Test case for FileRouteDatabase::Load() and FileRouteDatabase::HasChanged(), the file is only parsed again once its contents
+/// have changed
+TEST_F(FileRouteDatabaseTest, TestRoutesLoadOnlyWhenChanged)
+{
+    const std::string route_file("test_routes_load_only_when_changed.csv");
+    std::ofstream(route_file, std::ios::trunc) << "London,Brighton,Oxford\nGlasgow,London\n";
+    MockFileRouteDatabase test_db(route_file);
+
+    EXPECT_CALL(test_db, GetRoutesOnDisk(testing::_))
+    .Times(2)
+    .WillRepeatedly([&test_db](const FileContents& file) {
+        return test_db.RealGetRoutesOnDisk(file);
+    });
+
+    EXPECT_TRUE(test_db.Load());
+    EXPECT_FALSE(test_db.HasChanged());
+    EXPECT_FALSE(test_db.Load());
+
+    // Rewritten with the same contents, it is checksummed but not parsed again
+    std::ofstream(route_file, std::ios::trunc) << "London,Brighton,Oxford\nGlasgow,London\n";
+    EXPECT_TRUE(test_db.HasChanged());
+    EXPECT_FALSE(test_db.Load());
+
+    // A changed route is a change, even with the same number of start locations
+    std::ofstream(route_file, std::ios::trunc) << "London,Brighton,Bath\nGlasgow,London\n";
+    EXPECT_TRUE(test_db.HasChanged());
+    EXPECT_TRUE(test_db.Load());
+    const std::vector<std::string>& london_routes = test_db.GetRoutes("London");
+    ASSERT_EQ(2, london_routes.size());
+    EXPECT_EQ("Bath", london_routes[1]);
+
+    std::remove(route_file.c_str());
+}
+
+/// @brief Test case for FileRouteDatabase::ParseRoutes() in chunks across several workers, the routes are the same as parsing the rows
+/// in one go, including for a start location on rows in different chunks
+TEST_F(FileRouteDatabaseTest, TestParseRoutesInChunks)
+{
+    const std::string contents("London, Brighton, Oxford\nGlasgow, London\n\nLondon, Bath\nBath, London\nGlasgow, Edinburgh, Bath\nLondon, Glasgow");
+    const auto expected_routes = FileRouteDatabase::ParseRoutes(contents, contents.size(), 1);
+    ASSERT_EQ(3, expected_routes.size());
+    EXPECT_EQ(std::vector<std::string>({"Brighton", "Oxford", "Bath", "Glasgow"}), expected_routes.at("London"));
+    EXPECT_EQ(std::vector<std::string>({"London", "Edinburgh", "Bath"}), expected_routes.at("Glasgow"));
+
+    for (size_t chunk_size = 0; chunk_size <= contents.size(); ++chunk_size) {
+        EXPECT_EQ(expected_routes, FileRouteDatabase::ParseRoutes(contents, chunk_size, 4)) << "chunk_size=" << chunk_size;
+    }
+    EXPECT_TRUE(FileRouteDatabase::ParseRoutes("", 16, 4).empty());
+}
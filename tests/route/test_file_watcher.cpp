@@ -0,0 +1,92 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "route/FileWatcher.h"
+
+using namespace route;
+
+const std::string TEST_WATCHED_FILE("test_file_watcher.csv");
+
+class FileWatcherTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+        WriteFile(TEST_WATCHED_FILE, "London,5\n");
+    }
+
+    void TearDown() override {
+        std::remove(TEST_WATCHED_FILE.c_str());
+        std::remove((TEST_WATCHED_FILE + ".tmp").c_str());
+    }
+
+    /// @brief Utility method to replace the contents of a file
+    static void WriteFile(const std::string& path, const std::string& contents) {
+        std::ofstream(path, std::ios::trunc) << contents;
+    }
+};
+
+/// @brief Test case for FileWatcher::Changed() for the ways a file can change, both with inotify and comparing the file stamp
+TEST_F(FileWatcherTest, TestChanged)
+{
+    for (bool use_inotify : {true, false}) {
+        SCOPED_TRACE(use_inotify ? "inotify" : "file stamp");
+        WriteFile(TEST_WATCHED_FILE, "London,5\n");
+        FileWatcher watcher(TEST_WATCHED_FILE, use_inotify);
+        EXPECT_EQ(use_inotify, watcher.UsesInotify());
+
+        // The file counts as changed until it is first read
+        EXPECT_TRUE(watcher.Changed());
+        watcher.Reset();
+        EXPECT_FALSE(watcher.Changed());
+        EXPECT_FALSE(watcher.Changed());
+
+        // Rewritten in place
+        WriteFile(TEST_WATCHED_FILE, "London,5\nGlasgow,3\n");
+        EXPECT_TRUE(watcher.Changed());
+        EXPECT_TRUE(watcher.Changed());
+        watcher.Reset();
+        EXPECT_FALSE(watcher.Changed());
+
+        // Replaced by a rename
+        WriteFile(TEST_WATCHED_FILE + ".tmp", "London,5\nGlasgow,3\nBrighton,1\n");
+        ASSERT_EQ(0, std::rename((TEST_WATCHED_FILE + ".tmp").c_str(), TEST_WATCHED_FILE.c_str()));
+        EXPECT_TRUE(watcher.Changed());
+        watcher.Reset();
+        EXPECT_FALSE(watcher.Changed());
+
+        // Deleted and made again
+        std::remove(TEST_WATCHED_FILE.c_str());
+        EXPECT_TRUE(watcher.Changed());
+        watcher.Reset();
+        EXPECT_FALSE(watcher.Changed());
+        WriteFile(TEST_WATCHED_FILE, "London,5\n");
+        EXPECT_TRUE(watcher.Changed());
+    }
+}
+
+/// @brief Test case for FileWatcher::Changed() for changes to other files in the same directory
+TEST_F(FileWatcherTest, TestOtherFileChanged)
+{
+    FileWatcher watcher(TEST_WATCHED_FILE);
+    watcher.Reset();
+
+    WriteFile(TEST_WATCHED_FILE + ".tmp", "Glasgow,3\n");
+    std::remove((TEST_WATCHED_FILE + ".tmp").c_str());
+    EXPECT_FALSE(watcher.Changed());
+}
+
+/// @brief Test case for FileWatcher for a file in a directory that doesn't exist, there is nothing for inotify to watch so the file
+/// stamp is compared instead
+TEST_F(FileWatcherTest, TestMissingDirectory)
+{
+    FileWatcher watcher("no_such_directory/locations.csv");
+    EXPECT_FALSE(watcher.UsesInotify());
+
+    EXPECT_TRUE(watcher.Changed());
+    watcher.Reset();
+    EXPECT_FALSE(watcher.Changed());
+}
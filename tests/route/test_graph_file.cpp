@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include "route/AtomicFile.h"
+#include "route/FileLocationDatabase.h"
+#include "route/FileRouteDatabase.h"
+#include "route/GraphFile.h"
+#include "route/GraphFileDatabase.h"
+#include "route/RoutePlanner.h"
+
+using namespace route;
+
+const std::string TEST_GRAPH_FILE_DATA_DIR("test_data/route/test_graph_file");
+const std::string TEST_GRAPH_FILE("test_graph_file.graph");
+
+class GraphFileTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+        ASSERT_TRUE(GraphFile::Convert(TEST_GRAPH_FILE_DATA_DIR + "/locations.csv", TEST_GRAPH_FILE_DATA_DIR + "/routes.csv", TEST_GRAPH_FILE));
+    }
+
+    void TearDown() override {
+        std::remove(TEST_GRAPH_FILE.c_str());
+    }
+
+    /// @brief Utility method to read the whole graph file
+    static std::string ReadGraphFile() {
+        std::ifstream file(TEST_GRAPH_FILE, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    /// @brief Utility method to replace the whole graph file
+    static void WriteGraphFile(const std::string& contents) {
+        std::ofstream(TEST_GRAPH_FILE, std::ios::binary | std::ios::trunc) << contents;
+    }
+};
+
+/// @brief Test case for GraphFile::Convert() and GraphFile::Load(), the graph file has the locations in file order and the routes the
+/// route planner works out from the two files, leaving out the unknown location
+TEST_F(GraphFileTest, TestConvert)
+{
+    EXPECT_TRUE(GraphFile::IsGraphFile(TEST_GRAPH_FILE));
+    EXPECT_FALSE(GraphFile::IsGraphFile(TEST_GRAPH_FILE_DATA_DIR + "/locations.csv"));
+
+    std::shared_ptr<const GraphFile> graph_file = GraphFile::Load(TEST_GRAPH_FILE);
+    ASSERT_NE(nullptr, graph_file);
+    const PerfectNameIndex& names = *graph_file->Names();
+    const RouteGraph& graph = *graph_file->Graph();
+
+    ASSERT_EQ(4, names.Size());
+    EXPECT_EQ("London", names.Name(0));
+    EXPECT_EQ("Oxford", names.Name(3));
+    EXPECT_EQ(2, names.Find("Brighton"));
+    EXPECT_EQ(INVALID_LOCATION_ID, names.Find("Atlantis"));
+
+    ASSERT_EQ(4, graph.LocationCount());
+    EXPECT_EQ(5, graph.LocationCost(0));
+    EXPECT_EQ(3, graph.LocationCost(1));
+    EXPECT_EQ(5, graph.RouteCount());
+    EXPECT_TRUE(graph.HasRoute(0, 2));
+    EXPECT_TRUE(graph.HasRoute(0, 3));
+    EXPECT_TRUE(graph.HasRoute(2, 3));
+    EXPECT_TRUE(graph.HasRoute(2, 0));
+    EXPECT_TRUE(graph.HasRoute(3, 1));
+    EXPECT_FALSE(graph.HasRoute(1, 0));
+    EXPECT_EQ(1, graph.ReverseRoutesEnd(1) - graph.ReverseRoutesBegin(1));
+}
+
+/// @brief Test case for GraphFile::Load() refusing a file that is missing, damaged, cut short or of another format version
+TEST_F(GraphFileTest, TestLoadMalformed)
+{
+    const std::string contents = ReadGraphFile();
+    EXPECT_EQ(nullptr, GraphFile::Load("test_non_existant_file.graph"));
+
+    std::string damaged = contents;
+    damaged[damaged.size() - 2] ^= 1;
+    WriteGraphFile(damaged);
+    EXPECT_EQ(nullptr, GraphFile::Load(TEST_GRAPH_FILE));
+
+    WriteGraphFile(contents.substr(0, contents.size() - 4));
+    EXPECT_EQ(nullptr, GraphFile::Load(TEST_GRAPH_FILE));
+
+    WriteGraphFile(contents.substr(0, 10));
+    EXPECT_EQ(nullptr, GraphFile::Load(TEST_GRAPH_FILE));
+
+    std::string other_version = contents;
+    other_version[7] = '0';
+    WriteGraphFile(other_version);
+    EXPECT_FALSE(GraphFile::IsGraphFile(TEST_GRAPH_FILE));
+    EXPECT_EQ(nullptr, GraphFile::Load(TEST_GRAPH_FILE));
+
+    WriteGraphFile(contents);
+    EXPECT_NE(nullptr, GraphFile::Load(TEST_GRAPH_FILE));
+}
+
+/// @brief Test case for AtomicFile::Save(), which the graph files are saved through. A save that fails part way leaves the file as it
+///        was and nothing written to the side
+TEST_F(GraphFileTest, TestAtomicFileSave)
+{
+    const std::string graph_file = ReadGraphFile();
+    const std::string temp_file = TEST_GRAPH_FILE + ".tmp";
+
+    EXPECT_FALSE(AtomicFile::Save(TEST_GRAPH_FILE, "graph file", [](std::ostream& file) -> void {
+        file << "half a graph file";
+        file.setstate(std::ios::badbit);
+    }));
+    EXPECT_EQ(ReadGraphFile(), graph_file);
+    EXPECT_FALSE(std::ifstream(temp_file).is_open());
+
+    EXPECT_FALSE(AtomicFile::Save("no_such_directory/" + TEST_GRAPH_FILE, "graph file", [](std::ostream& file) -> void {
+        file << "a graph file";
+    }));
+
+    EXPECT_TRUE(AtomicFile::Save(TEST_GRAPH_FILE, "graph file", [](std::ostream& file) -> void {
+        file << "a graph file";
+    }));
+    EXPECT_EQ(ReadGraphFile(), "a graph file");
+    EXPECT_FALSE(std::ifstream(temp_file).is_open());
+}
+
+/// @brief Test case for GraphFileDatabase as both the location and the route database
+TEST_F(GraphFileTest, TestDatabase)
+{
+    GraphFileDatabase graph_db(TEST_GRAPH_FILE);
+    EXPECT_EQ(nullptr, graph_db.GetRouteGraph());
+    EXPECT_EQ(INVALID_LOCATION_ID, graph_db.GetLocationId("London"));
+
+    EXPECT_TRUE(graph_db.Load());
+    EXPECT_FALSE(graph_db.Load());
+    ASSERT_NE(nullptr, graph_db.GetRouteGraph());
+    EXPECT_EQ(4, graph_db.GetRouteGraph()->LocationCount());
+    EXPECT_EQ(4, graph_db.GetLocationNameIndex()->Size());
+
+    const std::vector<Location*>& locations = graph_db.GetLocations();
+    ASSERT_EQ(4, locations.size());
+    for (LocationId id = 0; id < locations.size(); ++id) {
+        EXPECT_EQ(id, locations[id]->Id());
+        EXPECT_EQ(locations[id], graph_db.GetLocation(id));
+        EXPECT_EQ(id, graph_db.GetLocationId(std::string(locations[id]->Name())));
+    }
+    EXPECT_EQ("Glasgow", locations[1]->Name());
+    EXPECT_EQ(3, locations[1]->Cost());
+    EXPECT_EQ(nullptr, graph_db.GetLocation(4));
+
+    std::vector<std::string> london_routes = graph_db.GetRoutes("London");
+    std::sort(london_routes.begin(), london_routes.end());
+    EXPECT_EQ(std::vector<std::string>({"Brighton", "Oxford"}), london_routes);
+    EXPECT_EQ(std::vector<std::string>({"Glasgow"}), graph_db.GetRoutes("Oxford"));
+    EXPECT_TRUE(graph_db.GetRoutes("Glasgow").empty());
+    EXPECT_TRUE(graph_db.GetRoutes("Atlantis").empty());
+
+    // A damaged file keeps the graph already loaded
+    WriteGraphFile("not a graph file");
+    EXPECT_FALSE(graph_db.Load());
+    EXPECT_EQ(4, graph_db.GetRouteGraph()->LocationCount());
+}
+
+/// @brief Test case for the route planner answering the same over the graph file as over the location and route files it was made from
+TEST_F(GraphFileTest, TestRoutePlanner)
+{
+    auto graph_db = std::make_shared<GraphFileDatabase>(TEST_GRAPH_FILE);
+    RoutePlanner graph_planner(graph_db, graph_db);
+    RoutePlanner file_planner(std::make_shared<FileLocationDatabase>(TEST_GRAPH_FILE_DATA_DIR + "/locations.csv"),
+        std::make_shared<FileRouteDatabase>(TEST_GRAPH_FILE_DATA_DIR + "/routes.csv"));
+
+    EXPECT_EQ(file_planner.GetLocationNames(), graph_planner.GetLocationNames());
+    ASSERT_EQ(4, graph_planner.GetLocationCount());
+    for (LocationId start_id = 0; start_id < 4; ++start_id) {
+        for (LocationId end_id = 0; end_id < 4; ++end_id) {
+            EXPECT_EQ(file_planner.GetRouteCost(start_id, end_id), graph_planner.GetRouteCost(start_id, end_id));
+        }
+    }
+    EXPECT_EQ(10, graph_planner.GetRouteCost("London", "Glasgow"));
+    EXPECT_EQ(ROUTE_COST_UNREACHABLE, graph_planner.GetRouteCost("Glasgow", "London"));
+}
@@ -2,7 +2,10 @@
 #include <log4cxx/logger.h>
 #include <log4cxx/propertyconfigurator.h>
 #include <log4cxx/helpers/exception.h>
+#include <string>
+#include <vector>
 #include "route/Location.h"
+#include "route/LocationArena.h"
 
 using namespace route;
 
@@ -15,20 +18,28 @@ protected:
 
 TEST_F(LocationTest, LocationConstructor)
 {
-    Location* const location = new Location("test location", 10);
+    Location* const location = new Location("test location", 10, 4);
     
     EXPECT_EQ(location->Name(), "test location");
     EXPECT_EQ(location->Cost(), 10);
+    EXPECT_EQ(location->Id(), 4);
     EXPECT_EQ(location->Destinations().size(), 0);
 
     delete location;
 }
 
+TEST_F(LocationTest, LocationDefaultId)
+{
+    Location location("test location", 10);
+
+    EXPECT_EQ(location.Id(), INVALID_LOCATION_ID);
+}
+
 TEST_F(LocationTest, AddDesination)
 {
-    Location* const location_src = new Location("test location 1", 10);
-    Location* const location_valid_dst = new Location("test location 2", 20);
-    Location* const location_invalid_dst = new Location("test location 3", 30);
+    Location* const location_src = new Location("test location 1", 10, 0);
+    Location* const location_valid_dst = new Location("test location 2", 20, 1);
+    Location* const location_invalid_dst = new Location("test location 3", 30, 2);
 
     location_src->AddDestination(location_valid_dst); 
 
@@ -36,9 +47,44 @@ TEST_F(LocationTest, AddDesination)
     EXPECT_FALSE(location_src->DestinationIsValid(location_invalid_dst));
 
     auto valid_destinations = location_src->Destinations();
-    EXPECT_EQ(location_valid_dst, (valid_destinations.find(location_valid_dst->Name()))->second);
+    EXPECT_EQ(location_valid_dst, (valid_destinations.find(location_valid_dst->Id()))->second);
 
     delete location_src;
     delete location_valid_dst;
     delete location_invalid_dst;
-}
\ No newline at end of file
+}
+
+/// @brief Test case for locations made in an arena, with their names allocated from it, and destinations that are set again
+TEST_F(LocationTest, LocationArena)
+{
+    LocationArena arena(256);
+    std::vector<Location*> locations;
+    for (LocationId id = 0; id < 100; ++id) {
+        locations.push_back(arena.NewLocation("test location " + std::to_string(id), id, id));
+    }
+    for (LocationId id = 0; id < 100; ++id) {
+        locations[id]->AddDestination(locations[(id + 1) % 100]);
+        locations[id]->AddDestination(locations[(id + 7) % 100]);
+    }
+    EXPECT_EQ(arena.LocationCount(), 100);
+
+    for (LocationId id = 0; id < 100; ++id) {
+        EXPECT_EQ(locations[id]->Name(), "test location " + std::to_string(id));
+        EXPECT_EQ(locations[id]->Cost(), id);
+        EXPECT_EQ(locations[id]->Id(), id);
+        EXPECT_EQ(locations[id]->Destinations().size(), 2);
+        EXPECT_TRUE(locations[id]->DestinationIsValid(locations[(id + 7) % 100]));
+        EXPECT_FALSE(locations[id]->DestinationIsValid(locations[(id + 2) % 100]));
+    }
+
+    // As they are when the routes change
+    for (LocationId id = 0; id < 100; ++id) {
+        locations[id]->ClearDestinations();
+        locations[id]->AddDestination(locations[(id + 2) % 100]);
+    }
+    for (LocationId id = 0; id < 100; ++id) {
+        EXPECT_EQ(locations[id]->Destinations().size(), 1);
+        EXPECT_FALSE(locations[id]->DestinationIsValid(locations[(id + 7) % 100]));
+        EXPECT_TRUE(locations[id]->DestinationIsValid(locations[(id + 2) % 100]));
+    }
+}
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "route/DijkstraSearch.h"
+#include "route/LocationOrder.h"
+#include "route/RouteGraph.h"
+
+using namespace route;
+
+class LocationOrderTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    /// @brief Utility method to build a grid of locations with routes both ways between neighbours, numbered in a random order the way
+    ///        a location file might have them, with a second grid that isn't connected to the first
+    static RouteGraph MakeShuffledGrids(size_t width, unsigned seed) {
+        const size_t grid_size = width * width;
+        std::vector<size_t> ids(grid_size * 2);
+        std::iota(ids.begin(), ids.end(), 0);
+        std::mt19937 random(seed);
+        std::shuffle(ids.begin(), ids.end(), random);
+
+        std::vector<std::pair<size_t, size_t>> routes;
+        for (size_t grid_offset : {size_t(0), grid_size}) {
+            for (size_t y = 0; y < width; ++y) {
+                for (size_t x = 0; x < width; ++x) {
+                    const size_t i = grid_offset + y * width + x;
+                    if (x + 1 < width) {
+                        routes.push_back(std::make_pair(ids[i], ids[i + 1]));
+                        routes.push_back(std::make_pair(ids[i + 1], ids[i]));
+                    }
+                    if (y + 1 < width) {
+                        routes.push_back(std::make_pair(ids[i], ids[i + width]));
+                        routes.push_back(std::make_pair(ids[i + width], ids[i]));
+                    }
+                }
+            }
+        }
+        std::vector<unsigned int> location_costs(grid_size * 2);
+        std::uniform_int_distribution<unsigned int> cost(0, 9);
+        for (unsigned int& location_cost : location_costs) {
+            location_cost = cost(random);
+        }
+        return RouteGraph(location_costs, routes);
+    }
+};
+
+/// @brief Test case for the order being a permutation with the mapping working both ways, and unknown ids mapping to
+///        INVALID_LOCATION_ID
+TEST_F(LocationOrderTest, TestMapping)
+{
+    const RouteGraph graph = MakeShuffledGrids(10, 1);
+    const LocationOrder order = LocationOrder::ReverseCuthillMcKee(graph);
+    ASSERT_EQ(order.LocationCount(), graph.LocationCount());
+
+    std::vector<bool> seen(graph.LocationCount(), false);
+    for (LocationId external_id = 0; external_id < graph.LocationCount(); ++external_id) {
+        const LocationId internal_id = order.InternalId(external_id);
+        ASSERT_LT(internal_id, graph.LocationCount());
+        EXPECT_FALSE(seen[internal_id]);
+        seen[internal_id] = true;
+        EXPECT_EQ(order.ExternalId(internal_id), external_id);
+    }
+    EXPECT_EQ(order.InternalId(static_cast<LocationId>(graph.LocationCount())), INVALID_LOCATION_ID);
+    EXPECT_EQ(order.ExternalId(INVALID_LOCATION_ID), INVALID_LOCATION_ID);
+
+    const LocationOrder identity = LocationOrder::Identity(5);
+    for (LocationId location_id = 0; location_id < 5; ++location_id) {
+        EXPECT_EQ(identity.InternalId(location_id), location_id);
+    }
+}
+
+/// @brief Test case for the reordered graph having the same location costs and route costs as the original under the mapping, and its
+///        routes spanning far less
+TEST_F(LocationOrderTest, TestApply)
+{
+    const RouteGraph graph = MakeShuffledGrids(12, 2);
+    const LocationOrder order = LocationOrder::ReverseCuthillMcKee(graph);
+    const RouteGraph ordered = order.Apply(graph);
+    ASSERT_EQ(ordered.LocationCount(), graph.LocationCount());
+    ASSERT_EQ(ordered.RouteCount(), graph.RouteCount());
+
+    // A width w grid in reverse Cuthill-McKee order has no route spanning more than about 2w
+    EXPECT_LT(LocationOrder::AverageRouteSpan(ordered), 24.0);
+    EXPECT_LT(LocationOrder::AverageRouteSpan(ordered) * 4, LocationOrder::AverageRouteSpan(graph));
+
+    DijkstraSearch<BinaryHeapQueue> search;
+    for (LocationId start_id = 0; start_id < graph.LocationCount(); start_id += 7) {
+        EXPECT_EQ(ordered.LocationCost(order.InternalId(start_id)), graph.LocationCost(start_id));
+        for (LocationId end_id = 0; end_id < graph.LocationCount(); ++end_id) {
+            EXPECT_TRUE(ordered.HasRoute(order.InternalId(start_id), order.InternalId(end_id)) == graph.HasRoute(start_id, end_id));
+            ASSERT_EQ(search.RouteCost(ordered, order.InternalId(start_id), order.InternalId(end_id)), search.RouteCost(graph, start_id, end_id));
+        }
+    }
+}
@@ -0,0 +1,391 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "route/BufferPool.h"
+#include "route/DijkstraSearch.h"
+#include "route/FileLocationDatabase.h"
+#include "route/FileRouteDatabase.h"
+#include "route/GraphFile.h"
+#include "route/PagedGraph.h"
+#include "route/PagedGraphDatabase.h"
+#include "route/PagedRouteEngine.h"
+#include "route/RoutePlanner.h"
+#include "route/SearchEngine.h"
+
+using namespace route;
+
+const std::string TEST_PAGED_GRAPH_DATA_DIR("test_data/route/test_graph_file");
+const std::string TEST_PAGED_GRAPH_FILE("test_paged_graph.paged");
+const std::string TEST_PAGED_GRAPH_GRAPH_FILE("test_paged_graph.graph");
+const std::string TEST_BUFFER_POOL_FILE("test_buffer_pool.pages");
+const size_t TEST_PAGE_SIZE = 256;
+
+class PagedGraphTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    void TearDown() override {
+        std::remove(TEST_PAGED_GRAPH_FILE.c_str());
+        std::remove(TEST_PAGED_GRAPH_GRAPH_FILE.c_str());
+        std::remove(TEST_BUFFER_POOL_FILE.c_str());
+    }
+
+    /// @brief Utility method to build a random sparse graph, with a few locations left unreachable and the first location with
+    /// more routes than fit in a test page
+    static RouteGraph MakeRandomGraph(size_t location_count, unsigned seed) {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<unsigned int> cost(0, 9);
+        std::uniform_int_distribution<size_t> location(0, location_count - 1);
+
+        std::vector<unsigned int> location_costs(location_count);
+        for (unsigned int& location_cost : location_costs) {
+            location_cost = cost(random);
+        }
+        std::vector<std::pair<size_t, size_t>> routes;
+        for (size_t i = 0; i < location_count * 3; ++i) {
+            routes.push_back(std::make_pair(location(random), location(random)));
+        }
+        for (size_t end_id = 1; end_id <= 50; ++end_id) {
+            routes.push_back(std::make_pair(0, end_id));
+        }
+        return RouteGraph(location_costs, routes);
+    }
+
+    /// @brief Utility method to name the locations of a graph
+    static PerfectNameIndex MakeNames(size_t location_count, std::vector<std::string>& names) {
+        std::vector<std::string_view> name_views;
+        for (size_t location_id = 0; location_id < location_count; ++location_id) {
+            names.push_back("Location" + std::to_string(location_id));
+        }
+        for (const std::string& name : names) {
+            name_views.push_back(name);
+        }
+        return PerfectNameIndex(name_views);
+    }
+
+    /// @brief Utility method to read a whole file
+    static std::string ReadFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    /// @brief Utility method to replace a whole file
+    static void WriteFile(const std::string& path, const std::string& contents) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << contents;
+    }
+};
+
+/// @brief Test case for BufferPool reading pages into its frames, the clock passing over a page fetched since it last came round, and
+/// a pinned page never being evicted
+TEST_F(PagedGraphTest, TestBufferPool)
+{
+    // Each page is filled with its page id
+    const size_t page_words = TEST_PAGE_SIZE / sizeof(uint32_t);
+    std::string contents;
+    for (uint32_t page_id = 0; page_id < 6; ++page_id) {
+        const std::vector<uint32_t> page(page_words, page_id);
+        contents.append(reinterpret_cast<const char*>(page.data()), TEST_PAGE_SIZE);
+    }
+    WriteFile(TEST_BUFFER_POOL_FILE, contents);
+
+    BufferPool pool(TEST_BUFFER_POOL_FILE, 0, TEST_PAGE_SIZE, 6, 3, [](uint32_t page_id, const uint32_t*) -> bool {
+        return page_id != 5;
+    });
+    ASSERT_TRUE(pool.IsOpen());
+    EXPECT_EQ(3, pool.FrameCount());
+    for (uint32_t page_id = 0; page_id < 3; ++page_id) {
+        EXPECT_EQ(page_id, pool.Fetch(page_id).Words()[page_words - 1]);
+    }
+    EXPECT_EQ(2, pool.Fetch(2).Words()[0]);
+    EXPECT_EQ(1, pool.Counters().hits);
+    EXPECT_EQ(3, pool.Counters().misses);
+    EXPECT_EQ(0, pool.Counters().evictions);
+
+    // Every page has been fetched since the clock last came round, so the clock clears them all and takes the first
+    EXPECT_EQ(3, pool.Fetch(3).Words()[0]);
+    EXPECT_FALSE(pool.Resident(0));
+    // Page 1 is fetched again, so it gets a second chance and page 2 goes instead
+    pool.Fetch(1);
+    EXPECT_EQ(4, pool.Fetch(4).Words()[0]);
+    EXPECT_TRUE(pool.Resident(1));
+    EXPECT_FALSE(pool.Resident(2));
+    EXPECT_TRUE(pool.Resident(3));
+    EXPECT_EQ(2, pool.Counters().evictions);
+
+    // A pinned page stays whatever else is fetched
+    {
+        const BufferPool::PageHandle pinned = pool.Fetch(0);
+        for (uint32_t page_id = 1; page_id < 5; ++page_id) {
+            EXPECT_EQ(page_id, pool.Fetch(page_id).Words()[0]);
+            EXPECT_TRUE(pool.Resident(0));
+        }
+        EXPECT_EQ(0, pinned.Words()[0]);
+    }
+
+    // A page that fails its check isn't handed out or kept, so it is read again the next time
+    EXPECT_EQ(nullptr, pool.Fetch(5).Words());
+    EXPECT_EQ(1, pool.Counters().read_errors);
+    EXPECT_FALSE(pool.Resident(5));
+    EXPECT_EQ(nullptr, pool.Fetch(5).Words());
+    EXPECT_EQ(2, pool.Counters().read_errors);
+    EXPECT_EQ(pool.Counters().misses * TEST_PAGE_SIZE, pool.Counters().bytes_read);
+
+
+    EXPECT_EQ(4, pool.Fetch(4).Words()[0]);
+    pool.Prefetch(5);
+    pool.Prefetch(4);
+    EXPECT_EQ(1, pool.Counters().prefetches);
+}
+
+/// @brief Test case for PagedGraph::Save() and PagedGraph::Open(), every location is paged with its cost, name and routes, and the
+/// page is made bigger for the location with the most routes
+TEST_F(PagedGraphTest, TestSaveOpen)
+{
+    const RouteGraph graph = MakeRandomGraph(200, 1);
+    std::vector<std::string> names;
+    const PerfectNameIndex name_index = MakeNames(graph.LocationCount(), names);
+    ASSERT_TRUE(PagedGraph::Save(TEST_PAGED_GRAPH_FILE, name_index, graph, LocationOrder::ReverseCuthillMcKee(graph), TEST_PAGE_SIZE));
+    EXPECT_TRUE(PagedGraph::IsPagedGraphFile(TEST_PAGED_GRAPH_FILE));
+
+    std::shared_ptr<const PagedGraph> paged_graph = PagedGraph::Open(TEST_PAGED_GRAPH_FILE, 2 * 512);
+    ASSERT_NE(nullptr, paged_graph);
+    EXPECT_EQ(graph.LocationCount(), paged_graph->LocationCount());
+    EXPECT_EQ(graph.RouteCount(), paged_graph->RouteCount());
+    EXPECT_EQ(512, paged_graph->PageSize());
+    EXPECT_LT(5, paged_graph->PageCount());
+    EXPECT_EQ(2, paged_graph->FrameCount());
+
+    // The paged graph numbers the locations its own way, they are matched up by name
+    std::vector<bool> paged(graph.LocationCount(), false);
+    for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+        const LocationId external_id = name_index.Find(paged_graph->Names()->Name(location_id));
+        ASSERT_NE(INVALID_LOCATION_ID, external_id);
+        EXPECT_FALSE(paged[external_id]);
+        paged[external_id] = true;
+        EXPECT_EQ(graph.LocationCost(external_id), paged_graph->LocationCost(location_id));
+
+        std::vector<LocationId> destinations;
+        paged_graph->ForEachRoute(location_id, [&](LocationId destination, unsigned int route_cost) -> void {
+            destinations.push_back(name_index.Find(paged_graph->Names()->Name(destination)));
+            EXPECT_EQ(graph.LocationCost(destinations.back()), route_cost);
+        });
+        std::vector<LocationId> expected_destinations;
+        for (uint32_t route_i = graph.RoutesBegin(external_id); route_i < graph.RoutesEnd(external_id); ++route_i) {
+            expected_destinations.push_back(graph.Destination(route_i));
+        }
+        std::sort(destinations.begin(), destinations.end());
+        std::sort(expected_destinations.begin(), expected_destinations.end());
+        EXPECT_EQ(expected_destinations, destinations) << "location_id=" << location_id;
+    }
+    EXPECT_EQ(0, paged_graph->Counters().read_errors);
+    EXPECT_LT(0, paged_graph->Counters().evictions);
+}
+
+/// @brief Test case for PagedRouteEngine agreeing with a plain Dijkstra search over the graph held in memory, with a buffer pool of
+/// two pages for the whole graph
+TEST_F(PagedGraphTest, TestMatchesDijkstra)
+{
+    for (unsigned seed = 1; seed <= 3; ++seed) {
+        const RouteGraph graph = MakeRandomGraph(100, seed);
+        std::vector<std::string> names;
+        const PerfectNameIndex name_index = MakeNames(graph.LocationCount(), names);
+        ASSERT_TRUE(PagedGraph::Save(TEST_PAGED_GRAPH_FILE, name_index, graph, LocationOrder::ReverseCuthillMcKee(graph), TEST_PAGE_SIZE));
+        std::shared_ptr<const PagedGraph> paged_graph = PagedGraph::Open(TEST_PAGED_GRAPH_FILE, 1);
+        ASSERT_NE(nullptr, paged_graph);
+        std::vector<LocationId> external_ids;
+        for (LocationId location_id = 0; location_id < graph.LocationCount(); ++location_id) {
+            external_ids.push_back(name_index.Find(paged_graph->Names()->Name(location_id)));
+        }
+        EXPECT_EQ(1, paged_graph->FrameCount());
+        PagedRouteEngine engine(paged_graph);
+        DijkstraSearch<BinaryHeapQueue> search;
+
+        std::vector<LocationId> location_ids;
+        for (LocationId start_id = 0; start_id < graph.LocationCount(); ++start_id) {
+            location_ids.push_back(start_id);
+            for (LocationId end_id = 0; end_id < graph.LocationCount(); ++end_id) {
+                ASSERT_EQ(search.RouteCost(graph, external_ids[start_id], external_ids[end_id]), engine.GetRouteCost(start_id, end_id))
+                    << "seed=" << seed << " " << start_id << " -> " << end_id;
+            }
+        }
+        const std::vector<unsigned int> route_costs = engine.GetRouteCosts(location_ids, location_ids);
+        for (LocationId start_id = 0; start_id < graph.LocationCount(); ++start_id) {
+            for (LocationId end_id = 0; end_id < graph.LocationCount(); ++end_id) {
+                ASSERT_EQ(engine.GetRouteCost(start_id, end_id), route_costs[start_id * location_ids.size() + end_id]);
+            }
+        }
+
+        const BufferPoolCounters counters = paged_graph->Counters();
+        EXPECT_EQ(0, counters.read_errors);
+        EXPECT_LT(0, counters.hits);
+        EXPECT_LT(0, counters.evictions);
+        EXPECT_LT(0, counters.prefetches);
+    }
+}
+
+/// @brief Test case for PagedGraph::Open() refusing a file that is missing, cut short, of another format version or has a damaged
+/// index, and for a damaged page being read as empty
+TEST_F(PagedGraphTest, TestOpenMalformed)
+{
+    const RouteGraph graph = MakeRandomGraph(100, 1);
+    std::vector<std::string> names;
+    ASSERT_TRUE(PagedGraph::Save(TEST_PAGED_GRAPH_FILE, MakeNames(graph.LocationCount(), names), graph, LocationOrder::Identity(graph.LocationCount()),
+        TEST_PAGE_SIZE));
+    const std::string contents = ReadFile(TEST_PAGED_GRAPH_FILE);
+    const size_t page_size = PagedGraph::Open(TEST_PAGED_GRAPH_FILE)->PageSize();
+    EXPECT_EQ(nullptr, PagedGraph::Open("test_non_existant_file.paged"));
+
+    WriteFile(TEST_PAGED_GRAPH_FILE, contents.substr(0, contents.size() - 4));
+    EXPECT_EQ(nullptr, PagedGraph::Open(TEST_PAGED_GRAPH_FILE));
+
+    WriteFile(TEST_PAGED_GRAPH_FILE, contents.substr(0, 10));
+    EXPECT_EQ(nullptr, PagedGraph::Open(TEST_PAGED_GRAPH_FILE));
+
+    std::string other_version = contents;
+    other_version[7] = '0';
+    WriteFile(TEST_PAGED_GRAPH_FILE, other_version);
+    EXPECT_FALSE(PagedGraph::IsPagedGraphFile(TEST_PAGED_GRAPH_FILE));
+    EXPECT_EQ(nullptr, PagedGraph::Open(TEST_PAGED_GRAPH_FILE));
+
+    std::string damaged_index = contents;
+    damaged_index[damaged_index.size() - 2] ^= 1;
+    WriteFile(TEST_PAGED_GRAPH_FILE, damaged_index);
+    EXPECT_EQ(nullptr, PagedGraph::Open(TEST_PAGED_GRAPH_FILE));
+
+    // The pages aren't read until they are needed, so a damaged page is only found then
+    std::string damaged_page = contents;
+    damaged_page[page_size + 8] ^= 1;
+    WriteFile(TEST_PAGED_GRAPH_FILE, damaged_page);
+    std::shared_ptr<const PagedGraph> paged_graph = PagedGraph::Open(TEST_PAGED_GRAPH_FILE);
+    ASSERT_NE(nullptr, paged_graph);
+    size_t route_count = 0;
+    EXPECT_FALSE(paged_graph->ForEachRoute(0, [&route_count](LocationId, unsigned int) -> void {
+        ++route_count;
+    }));
+    EXPECT_EQ(0, route_count);
+    EXPECT_EQ(1, paged_graph->Counters().read_errors);
+    EXPECT_EQ(ROUTE_COST_ERROR, paged_graph->LocationCost(0));
+    EXPECT_EQ(2, paged_graph->Counters().read_errors);
+
+    // A query that needs the damaged page fails rather than giving a route cost
+    const PagedRouteEngine engine(paged_graph);
+    EXPECT_EQ(ROUTE_COST_ERROR, engine.GetRouteCost(0, 1));
+    EXPECT_EQ(std::vector<unsigned int>(2, ROUTE_COST_ERROR), engine.GetRouteCosts({0}, {0, 1}));
+}
+
+/// @brief Test case for PagedGraphDatabase as both the location and the route database, over a paged graph converted from a graph file
+TEST_F(PagedGraphTest, TestDatabase)
+{
+    ASSERT_TRUE(GraphFile::Convert(TEST_PAGED_GRAPH_DATA_DIR + "/locations.csv", TEST_PAGED_GRAPH_DATA_DIR + "/routes.csv", TEST_PAGED_GRAPH_GRAPH_FILE));
+    ASSERT_TRUE(PagedGraph::Convert(TEST_PAGED_GRAPH_GRAPH_FILE, TEST_PAGED_GRAPH_FILE));
+    EXPECT_FALSE(PagedGraph::Convert("test_non_existant_file.graph", TEST_PAGED_GRAPH_FILE));
+
+    PagedGraphDatabase paged_db(TEST_PAGED_GRAPH_FILE);
+    EXPECT_EQ(nullptr, paged_db.GetPagedGraph());
+    EXPECT_EQ(INVALID_LOCATION_ID, paged_db.GetLocationId("London"));
+    EXPECT_EQ(nullptr, paged_db.GetRouteGraph());
+
+    EXPECT_TRUE(paged_db.Load());
+    EXPECT_FALSE(paged_db.HasChanged());
+    EXPECT_FALSE(paged_db.Load());
+    ASSERT_NE(nullptr, paged_db.GetPagedGraph());
+    EXPECT_EQ(4, paged_db.GetPagedGraph()->LocationCount());
+    EXPECT_EQ(4, paged_db.GetLocationNameIndex()->Size());
+
+    const std::vector<Location*>& locations = paged_db.GetLocations();
+    ASSERT_EQ(4, locations.size());
+    for (LocationId id = 0; id < locations.size(); ++id) {
+        EXPECT_EQ(id, locations[id]->Id());
+        EXPECT_EQ(locations[id], paged_db.GetLocation(id));
+        EXPECT_EQ(id, paged_db.GetLocationId(std::string(locations[id]->Name())));
+    }
+    EXPECT_EQ(3, paged_db.GetLocation(paged_db.GetLocationId("Glasgow"))->Cost());
+    EXPECT_EQ(nullptr, paged_db.GetLocation(4));
+
+    std::vector<std::string> london_routes = paged_db.GetRoutes("London");
+    std::sort(london_routes.begin(), london_routes.end());
+    EXPECT_EQ(std::vector<std::string>({"Brighton", "Oxford"}), london_routes);
+    EXPECT_EQ(std::vector<std::string>({"Glasgow"}), paged_db.GetRoutes("Oxford"));
+    EXPECT_TRUE(paged_db.GetRoutes("Glasgow").empty());
+    EXPECT_TRUE(paged_db.GetRoutes("Atlantis").empty());
+
+    // A damaged file keeps the paged graph already opened
+    WriteFile(TEST_PAGED_GRAPH_FILE, "not a paged graph file");
+    EXPECT_TRUE(paged_db.HasChanged());
+    EXPECT_FALSE(paged_db.Load());
+    EXPECT_EQ(4, paged_db.GetPagedGraph()->LocationCount());
+}
+
+/// @brief Test case for the route planner answering the same over the paged graph as over the location and route files it was made
+/// from, the paged graph numbers the locations its own way so they are compared by name
+TEST_F(PagedGraphTest, TestRoutePlanner)
+{
+    ASSERT_TRUE(GraphFile::Convert(TEST_PAGED_GRAPH_DATA_DIR + "/locations.csv", TEST_PAGED_GRAPH_DATA_DIR + "/routes.csv", TEST_PAGED_GRAPH_GRAPH_FILE));
+    ASSERT_TRUE(PagedGraph::Convert(TEST_PAGED_GRAPH_GRAPH_FILE, TEST_PAGED_GRAPH_FILE));
+    auto paged_db = std::make_shared<PagedGraphDatabase>(TEST_PAGED_GRAPH_FILE);
+    RoutePlanner paged_planner(paged_db, paged_db);
+    RoutePlanner file_planner(std::make_shared<FileLocationDatabase>(TEST_PAGED_GRAPH_DATA_DIR + "/locations.csv"),
+        std::make_shared<FileRouteDatabase>(TEST_PAGED_GRAPH_DATA_DIR + "/routes.csv"));
+
+    std::vector<std::string> names = file_planner.GetLocationNames();
+    std::vector<std::string> paged_names = paged_planner.GetLocationNames();
+    std::sort(paged_names.begin(), paged_names.end());
+    std::sort(names.begin(), names.end());
+    EXPECT_EQ(names, paged_names);
+    ASSERT_EQ(4, paged_planner.GetLocationCount());
+    for (const std::string& start_name : names) {
+        for (const std::string& end_name : names) {
+            EXPECT_EQ(file_planner.GetRouteCost(start_name, end_name), paged_planner.GetRouteCost(start_name, end_name)) << start_name << " -> " << end_name;
+        }
+    }
+    EXPECT_EQ(10, paged_planner.GetRouteCost("London", "Glasgow"));
+    EXPECT_EQ(ROUTE_COST_UNREACHABLE, paged_planner.GetRouteCost("Glasgow", "London"));
+
+    const LocationId london_id = paged_planner.GetLocationId("London");
+    const LocationId glasgow_id = paged_planner.GetLocationId("Glasgow");
+    EXPECT_TRUE(paged_planner.MayHaveRoute(london_id, glasgow_id));
+    EXPECT_EQ(std::vector<unsigned int>({10}), paged_planner.GetRouteCosts({london_id}, {glasgow_id}));
+
+    // The routes can only be changed by writing the paged graph again, and the route engine stays the paged one
+    EXPECT_FALSE(paged_planner.UpdateLocationCost(london_id, 1));
+    EXPECT_FALSE(paged_planner.RemoveRoute(london_id, paged_planner.GetLocationId("Oxford")));
+    paged_planner.SetRouteEngine(DijkstraEngine::Factory());
+    EXPECT_EQ(10, paged_planner.GetRouteCost("London", "Glasgow"));
+}
+
+/// @brief Test case for the route planner over a paged graph with a damaged page, the queries that need the page fail rather than
+/// giving a route cost, and the failure isn't cached
+TEST_F(PagedGraphTest, TestRoutePlannerDamagedPage)
+{
+    ASSERT_TRUE(GraphFile::Convert(TEST_PAGED_GRAPH_DATA_DIR + "/locations.csv", TEST_PAGED_GRAPH_DATA_DIR + "/routes.csv", TEST_PAGED_GRAPH_GRAPH_FILE));
+    ASSERT_TRUE(PagedGraph::Convert(TEST_PAGED_GRAPH_GRAPH_FILE, TEST_PAGED_GRAPH_FILE));
+    std::string damaged_page = ReadFile(TEST_PAGED_GRAPH_FILE);
+    damaged_page[PagedGraph::Open(TEST_PAGED_GRAPH_FILE)->PageSize() + 8] ^= 1;
+    WriteFile(TEST_PAGED_GRAPH_FILE, damaged_page);
+
+    auto paged_db = std::make_shared<PagedGraphDatabase>(TEST_PAGED_GRAPH_FILE);
+    RoutePlanner paged_planner(paged_db, paged_db);
+    ASSERT_EQ(4, paged_planner.GetLocationCount());
+    const LocationId london_id = paged_planner.GetLocationId("London");
+    const LocationId glasgow_id = paged_planner.GetLocationId("Glasgow");
+
+    EXPECT_EQ(0, paged_planner.GetRouteCost("London", "Glasgow"));
+    EXPECT_EQ(0, paged_planner.GetRouteCost(london_id, glasgow_id));
+    EXPECT_TRUE(paged_planner.GetRouteCosts({london_id}, {glasgow_id}).empty());
+    EXPECT_EQ(ROUTE_COST_ERROR, paged_planner.AnswerRouteRequest(london_id, glasgow_id));
+    EXPECT_TRUE(paged_planner.AnswerRouteMatrixRequest({london_id}, {glasgow_id}).empty());
+    EXPECT_TRUE(paged_db->GetLocations().empty());
+    EXPECT_TRUE(paged_db->GetRoutes("London").empty());
+    EXPECT_EQ(0, paged_planner.GetRouteCostCache().Size());
+}
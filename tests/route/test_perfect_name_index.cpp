@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "route/PerfectNameIndex.h"
+
+using namespace route;
+
+class PerfectNameIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+};
+
+/// @brief Test case for each name getting its position as its id, and a repeated name the id of its first position
+TEST_F(PerfectNameIndexTest, TestIds)
+{
+    const std::vector<std::string_view> names = {"London", "Glasgow", "London", "Brighton"};
+    PerfectNameIndex index(names);
+
+    EXPECT_EQ(4, index.Size());
+    EXPECT_EQ(0, index.Find("London"));
+    EXPECT_EQ(1, index.Find("Glasgow"));
+    EXPECT_EQ(3, index.Find(std::string("Brighton")));
+    EXPECT_EQ("London", index.Name(0));
+    EXPECT_EQ("Glasgow", index.Name(1));
+    EXPECT_EQ("London", index.Name(2));
+    EXPECT_EQ("Brighton", index.Name(3));
+}
+
+/// @brief Test case for PerfectNameIndex::Find() for names in and not in the index, over enough names to fill many buckets
+TEST_F(PerfectNameIndexTest, TestFind)
+{
+    std::vector<std::string> names;
+    for (int i = 0; i < 100000; ++i) {
+        names.push_back("Location " + std::to_string(i));
+    }
+    PerfectNameIndex index(std::vector<std::string_view>(names.begin(), names.end()));
+
+    for (LocationId id = 0; id < names.size(); ++id) {
+        ASSERT_EQ(id, index.Find(names[id]));
+    }
+    EXPECT_EQ(INVALID_LOCATION_ID, index.Find("Location 100000"));
+    EXPECT_EQ(INVALID_LOCATION_ID, index.Find("Location 1 "));
+    EXPECT_EQ(INVALID_LOCATION_ID, index.Find(""));
+
+    // The names are around 14 characters, the slots, seeds and offsets take a few bytes per name on top
+    EXPECT_LT(index.MemoryBytes(), names.size() * 32);
+}
+
+/// @brief Test case for an index with no names, and the empty name
+TEST_F(PerfectNameIndexTest, TestEmpty)
+{
+    PerfectNameIndex empty;
+    EXPECT_EQ(0, empty.Size());
+    EXPECT_EQ(INVALID_LOCATION_ID, empty.Find("London"));
+    EXPECT_EQ(INVALID_LOCATION_ID, empty.Find(""));
+
+    PerfectNameIndex index(std::vector<std::string_view>({"", "London"}));
+    EXPECT_EQ(0, index.Find(""));
+    EXPECT_EQ(1, index.Find("London"));
+    EXPECT_EQ(INVALID_LOCATION_ID, index.Find("Glasgow"));
+}
+
+/// @brief Test case for PerfectNameIndex::Write() and PerfectNameIndex::Read(), the index read back finds the same ids and a malformed
+/// index is refused
+TEST_F(PerfectNameIndexTest, TestWriteRead)
+{
+    const std::vector<std::string_view> names = {"London", "Glasgow", "London", "Brighton"};
+    std::ostringstream file;
+    PerfectNameIndex(names).Write(file);
+    file << "trailing";
+    const std::string contents = file.str();
+
+    PerfectNameIndex index;
+    std::string_view data = contents;
+    ASSERT_TRUE(index.Read(data));
+    EXPECT_EQ("trailing", data);
+    EXPECT_EQ(4, index.Size());
+    EXPECT_EQ(0, index.Find("London"));
+    EXPECT_EQ(3, index.Find("Brighton"));
+    EXPECT_EQ("London", index.Name(2));
+    EXPECT_EQ(INVALID_LOCATION_ID, index.Find("Oxford"));
+
+    // Cut short, and with the last name no longer ending in a '\0'
+    data = std::string_view(contents).substr(0, contents.size() - 12);
+    EXPECT_FALSE(index.Read(data));
+    EXPECT_EQ(0, index.Size());
+    std::string damaged = contents;
+    damaged[damaged.find("Brighton") + 8] = 'X';
+    data = damaged;
+    EXPECT_FALSE(index.Read(data));
+}
@@ -0,0 +1,126 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "route/DijkstraSearch.h"
+#include "route/PriorityQueue.h"
+
+using namespace route;
+
+template <typename QueueType>
+class PriorityQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    QueueType queue;
+};
+
+typedef ::testing::Types<BinaryHeapQueue, QuaternaryHeapQueue, PairingHeapQueue, RadixHeapQueue> QueueTypes;
+TYPED_TEST_SUITE(PriorityQueueTest, QueueTypes);
+
+/// @brief Test case for popping entries in cost order
+TYPED_TEST(PriorityQueueTest, TestPopInCostOrder)
+{
+    this->queue.Reset(5);
+    EXPECT_TRUE(this->queue.Empty());
+
+    this->queue.Push(0, 7);
+    this->queue.Push(1, 3);
+    this->queue.Push(2, 9);
+    this->queue.Push(3, 3);
+    this->queue.Push(4, 5);
+    EXPECT_FALSE(this->queue.Empty());
+
+    std::vector<unsigned int> costs;
+    while (!this->queue.Empty()) {
+        costs.push_back(this->queue.Pop().cost);
+    }
+
+    EXPECT_EQ(costs, std::vector<unsigned int>({3, 3, 5, 7, 9}));
+}
+
+/// @brief Test case for interleaving push and pop the way a search does, never pushing below the last popped cost
+TYPED_TEST(PriorityQueueTest, TestMonotoneInterleaved)
+{
+    const size_t count = 1000;
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned int> step(0, 20);
+
+    this->queue.Reset(count);
+    unsigned int last = 0;
+    size_t pushed = 0;
+    size_t popped = 0;
+
+    this->queue.Push(pushed++, 0);
+    while (!this->queue.Empty()) {
+        QueueEntry entry = this->queue.Pop();
+        EXPECT_GE(entry.cost, last);
+        last = entry.cost;
+        ++popped;
+
+        for (int i = 0; i < 2 && pushed < count; ++i) {
+            this->queue.Push(pushed++, last + step(rng));
+        }
+    }
+
+    EXPECT_EQ(count, popped);
+}
+
+/// @brief Test case for the search giving the same result whichever queue policy is used
+TYPED_TEST(PriorityQueueTest, TestDijkstraSearch)
+{
+    // Each route costs the cost of the location it enters, so 0 -> 2 -> 3 is cheaper than 0 -> 1 -> 3
+    RouteGraph graph({2, 3, 1, 1, 1}, {{0, 1}, {0, 2}, {1, 3}, {2, 3}, {2, 1}, {3, 0}});
+
+    DijkstraSearch<TypeParam> search;
+    EXPECT_EQ(search.RouteCost(graph, 0, 3), 2);
+    EXPECT_EQ(search.RouteCost(graph, 0, 1), 3);
+    EXPECT_EQ(search.RouteCost(graph, 1, 0), 3);
+    EXPECT_EQ(search.RouteCost(graph, 3, 3), 0);
+    EXPECT_EQ(search.RouteCost(graph, 0, 4), ROUTE_COST_UNREACHABLE);
+
+    // The full trees, forwards from location 0 and backwards to it
+    const unsigned int unreachable = ROUTE_COST_UNREACHABLE;
+    EXPECT_EQ(search.RouteCostsFrom(graph, 0), std::vector<unsigned int>({0, 3, 1, 2, unreachable}));
+    EXPECT_EQ(search.SettledCount(), 4);
+    EXPECT_EQ(search.RouteCostsTo(graph, 0), std::vector<unsigned int>({0, 3, 3, 2, unreachable}));
+}
+
+class PairingHeapQueueTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+};
+
+/// @brief Test case for a repeated push lowering the cost of an entry already in the queue rather than adding a second one
+TEST_F(PairingHeapQueueTest, TestDecreaseKey)
+{
+    PairingHeapQueue queue;
+    queue.Reset(4);
+
+    queue.Push(0, 10);
+    queue.Push(1, 20);
+    queue.Push(2, 30);
+    queue.Push(3, 40);
+
+    queue.Push(3, 5);
+    queue.Push(2, 15);
+    queue.Push(1, 50); // A higher cost is ignored
+
+    std::vector<size_t> order;
+    std::vector<unsigned int> costs;
+    while (!queue.Empty()) {
+        QueueEntry entry = queue.Pop();
+        order.push_back(entry.index);
+        costs.push_back(entry.cost);
+    }
+
+    EXPECT_EQ(order, std::vector<size_t>({3, 0, 2, 1}));
+    EXPECT_EQ(costs, std::vector<unsigned int>({5, 10, 15, 20}));
+}
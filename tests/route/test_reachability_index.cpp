@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <memory>
+#include <random>
+#include <vector>
+#include "route/DijkstraSearch.h"
+#include "route/ReachabilityIndex.h"
+#include "route/RouteGraph.h"
+
+using namespace route;
+
+class ReachabilityIndexTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    /// @brief Utility method to build a random graph made of small cycles with a few routes between them, so there are plenty of
+    ///        components and pairs of locations with no route between them
+    static RouteGraph MakeRandomGraph(size_t location_count, unsigned seed) {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<size_t> location(0, location_count - 1);
+
+        std::vector<std::pair<size_t, size_t>> routes;
+        for (size_t location_i = 0; location_i + 1 < location_count; ++location_i) {
+            if (location_i % 4 != 3) {
+                routes.push_back(std::make_pair(location_i, location_i + 1));
+                routes.push_back(std::make_pair(location_i + 1, location_i));
+            }
+        }
+        for (size_t i = 0; i < location_count / 3; ++i) {
+            routes.push_back(std::make_pair(location(random), location(random)));
+        }
+        return RouteGraph(std::vector<unsigned int>(location_count, 1), routes);
+    }
+};
+
+/// @brief Test case for the components of a small graph and the pairs of locations ruled out
+TEST_F(ReachabilityIndexTest, TestComponents)
+{
+    //  0 <-> 1 -> 2 -> 3 -> 2, 4 isolated
+    RouteGraph graph({1, 1, 1, 1, 1}, {{0, 1}, {1, 0}, {1, 2}, {2, 3}, {3, 2}});
+    ReachabilityIndex index(graph);
+
+    EXPECT_EQ(index.ComponentCount(), 3);
+    EXPECT_EQ(index.Component(0), index.Component(1));
+    EXPECT_EQ(index.Component(2), index.Component(3));
+    EXPECT_NE(index.Component(0), index.Component(2));
+    // Components are numbered sinks first
+    EXPECT_LT(index.Component(2), index.Component(0));
+
+    EXPECT_TRUE(index.MayReach(0, 3));
+    EXPECT_TRUE(index.MayReach(3, 2));
+    EXPECT_TRUE(index.MayReach(4, 4));
+    EXPECT_FALSE(index.MayReach(3, 0));
+    EXPECT_FALSE(index.MayReach(0, 4));
+    EXPECT_FALSE(index.MayReach(4, 0));
+}
+
+/// @brief Test case for a long chain, the components are found without running out of stack
+TEST_F(ReachabilityIndexTest, TestLongChain)
+{
+    const size_t location_count = 200000;
+    std::vector<std::pair<size_t, size_t>> routes;
+    for (size_t location_i = 0; location_i + 1 < location_count; ++location_i) {
+        routes.push_back(std::make_pair(location_i, location_i + 1));
+    }
+    RouteGraph graph(std::vector<unsigned int>(location_count, 1), routes);
+    ReachabilityIndex index(graph);
+
+    EXPECT_EQ(index.ComponentCount(), location_count);
+    EXPECT_TRUE(index.MayReach(0, location_count - 1));
+    EXPECT_FALSE(index.MayReach(location_count - 1, 0));
+}
+
+/// @brief Test case for the index never ruling out a pair with a route, and ruling out most of the pairs without one, in random graphs
+TEST_F(ReachabilityIndexTest, TestMatchesDijkstra)
+{
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        RouteGraph graph = MakeRandomGraph(60, seed);
+        ReachabilityIndex index(graph);
+        DijkstraSearch<BinaryHeapQueue> search;
+        size_t no_route_count = 0;
+        size_t ruled_out_count = 0;
+
+        for (LocationId start_id = 0; start_id < graph.LocationCount(); ++start_id) {
+            const std::vector<unsigned int>& route_costs = search.RouteCostsFrom(graph, start_id);
+            for (LocationId end_id = 0; end_id < graph.LocationCount(); ++end_id) {
+                const bool has_route = route_costs[end_id] != ROUTE_COST_UNREACHABLE;
+                ASSERT_TRUE(!has_route || index.MayReach(start_id, end_id)) << "seed=" << seed << " " << start_id << " -> " << end_id;
+                no_route_count += has_route ? 0 : 1;
+                ruled_out_count += index.MayReach(start_id, end_id) ? 0 : 1;
+            }
+        }
+        EXPECT_GT(no_route_count, 0) << "seed=" << seed;
+        EXPECT_GE(ruled_out_count * 10, no_route_count * 9) << "seed=" << seed;
+    }
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <thread>
+#include <vector>
+#include "route/RouteCostCache.h"
+
+using namespace route;
+
+class RouteCostCacheTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    void TearDown() override {
+    }
+};
+
+/// @brief Test case for RouteCostCache::Lookup() and RouteCostCache::Insert()
+TEST_F(RouteCostCacheTest, TestLookup)
+{
+    RouteCostCache cache(4);
+    unsigned int route_cost = 0;
+
+    EXPECT_FALSE(cache.Lookup(1, 0, 1, route_cost));
+    cache.Insert(1, 0, 1, 7);
+    EXPECT_TRUE(cache.Lookup(1, 0, 1, route_cost));
+    EXPECT_EQ(route_cost, 7);
+
+    // The route is directed
+    EXPECT_FALSE(cache.Lookup(1, 1, 0, route_cost));
+
+    EXPECT_EQ(cache.HitCount(), 1);
+    EXPECT_EQ(cache.MissCount(), 2);
+    EXPECT_EQ(cache.Size(), 1);
+}
+
+/// @brief Test case for the least recently used route cost being evicted when the cache is full
+TEST_F(RouteCostCacheTest, TestEviction)
+{
+    RouteCostCache cache(2);
+    unsigned int route_cost = 0;
+
+    cache.Insert(1, 0, 1, 1);
+    cache.Insert(1, 0, 2, 2);
+    EXPECT_TRUE(cache.Lookup(1, 0, 1, route_cost));     // 0 -> 2 is now the least recently used
+    cache.Insert(1, 0, 3, 3);
+
+    EXPECT_EQ(cache.EvictionCount(), 1);
+    EXPECT_EQ(cache.Size(), 2);
+    EXPECT_TRUE(cache.Lookup(1, 0, 1, route_cost));
+    EXPECT_FALSE(cache.Lookup(1, 0, 2, route_cost));
+    EXPECT_TRUE(cache.Lookup(1, 0, 3, route_cost));
+    EXPECT_EQ(route_cost, 3);
+}
+
+/// @brief Test case for the cache being flushed when the route graph version moves on, and left alone by an older version
+TEST_F(RouteCostCacheTest, TestVersion)
+{
+    RouteCostCache cache(4);
+    unsigned int route_cost = 0;
+
+    cache.Insert(1, 0, 1, 7);
+    cache.Insert(1, 0, 2, 8);
+    EXPECT_FALSE(cache.Lookup(2, 0, 1, route_cost));
+    EXPECT_EQ(cache.Size(), 0);
+    EXPECT_EQ(cache.EvictionCount(), 0);
+
+    cache.Insert(2, 0, 1, 5);
+    EXPECT_TRUE(cache.Lookup(2, 0, 1, route_cost));
+    EXPECT_EQ(route_cost, 5);
+
+    // A caller still on the older version misses, and neither flushes nor adds to the newer route costs
+    EXPECT_FALSE(cache.Lookup(1, 0, 1, route_cost));
+    cache.Insert(1, 0, 1, 7);
+    cache.Insert(1, 0, 2, 8);
+    EXPECT_EQ(cache.Size(), 1);
+    EXPECT_TRUE(cache.Lookup(2, 0, 1, route_cost));
+    EXPECT_EQ(route_cost, 5);
+    EXPECT_FALSE(cache.Lookup(2, 0, 2, route_cost));
+}
+
+/// @brief Test case for RouteCostCache::Advance(), the route costs picked are carried over to the new version
+TEST_F(RouteCostCacheTest, TestAdvance)
+{
+    RouteCostCache cache(4);
+    unsigned int route_cost = 0;
+
+    cache.Insert(1, 0, 1, 7);
+    cache.Insert(1, 2, 3, 8);
+    cache.Advance(1, 2, [](LocationId start_id, LocationId end_id, unsigned int route_cost) -> bool {
+        return start_id == 2 && end_id == 3 && route_cost == 8;
+    });
+    EXPECT_EQ(cache.Size(), 1);
+    EXPECT_FALSE(cache.Lookup(2, 0, 1, route_cost));
+    EXPECT_TRUE(cache.Lookup(2, 2, 3, route_cost));
+    EXPECT_EQ(route_cost, 8);
+    EXPECT_FALSE(cache.Lookup(1, 2, 3, route_cost));
+
+    // The cache isn't on the version the change was made to, so nothing can be carried over
+    cache.Advance(3, 4, [](LocationId, LocationId, unsigned int) -> bool {
+        return true;
+    });
+    EXPECT_EQ(cache.Size(), 0);
+}
+
+/// @brief Test case for a cache with no capacity, nothing is kept
+TEST_F(RouteCostCacheTest, TestDisabled)
+{
+    RouteCostCache cache(0);
+    unsigned int route_cost = 0;
+
+    cache.Insert(1, 0, 1, 7);
+    EXPECT_FALSE(cache.Lookup(1, 0, 1, route_cost));
+    EXPECT_EQ(cache.Size(), 0);
+}
+
+/// @brief Test case for looking up and inserting route costs from several threads at once
+TEST_F(RouteCostCacheTest, TestConcurrentLookup)
+{
+    RouteCostCache cache(16);
+    std::vector<std::thread> threads;
+    for (unsigned int thread_i = 0; thread_i < 4; ++thread_i) {
+        threads.emplace_back([&cache]() {
+            for (unsigned int i = 0; i < 1000; ++i) {
+                unsigned int route_cost = 0;
+                const LocationId end_id = i % 32;
+                if (cache.Lookup(1, 0, end_id, route_cost)) {
+                    EXPECT_EQ(route_cost, end_id * 2);
+                }
+                else {
+                    cache.Insert(1, 0, end_id, end_id * 2);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(cache.HitCount() + cache.MissCount(), 4000);
+    EXPECT_LE(cache.Size(), 16);
+}
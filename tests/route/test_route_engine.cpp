@@ -0,0 +1,654 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+#include "route/AllPairsEngine.h"
+#include "route/AltEngine.h"
+#include "route/ContractionHierarchyEngine.h"
+#include "route/DeltaSteppingEngine.h"
+#include "route/HubLabelEngine.h"
+#include "route/DijkstraSearch.h"
+#include "route/OverlayEngine.h"
+#include "route/RouteGraph.h"
+#include "route/SearchEngine.h"
+
+using namespace route;
+
+template <typename EngineType>
+class RouteEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    /// @brief Utility method to build the engine under test over a graph
+    static RouteEnginePtr MakeEngine(std::shared_ptr<const RouteGraph> graph) {
+        return EngineType::Factory()(graph);
+    }
+
+    /// @brief Utility method to build a random sparse graph, with a few locations left unreachable
+    static std::shared_ptr<const RouteGraph> MakeRandomGraph(size_t location_count, unsigned seed) {
+        std::mt19937 random(seed);
+        std::uniform_int_distribution<unsigned int> cost(0, 9);
+        std::uniform_int_distribution<size_t> location(0, location_count - 1);
+
+        std::vector<unsigned int> location_costs(location_count);
+        for (unsigned int& location_cost : location_costs) {
+            location_cost = cost(random);
+        }
+        std::vector<std::pair<size_t, size_t>> routes;
+        for (size_t i = 0; i < location_count * 3; ++i) {
+            routes.push_back(std::make_pair(location(random), location(random)));
+        }
+        return std::make_shared<const RouteGraph>(location_costs, routes);
+    }
+};
+
+/// @brief The delta-stepping engine with no size threshold, a narrow bucket width so there are heavy routes, and a few threads, so the
+///        small test graphs go through all of it
+struct TestDeltaSteppingEngine {
+    static RouteEngineFactory Factory() {
+        static ThreadPool thread_pool(4);
+        return DeltaSteppingEngine::Factory(0, 3, thread_pool);
+    }
+};
+
+/// @brief The overlay engine with cells small enough that the test graphs get two levels
+struct TestOverlayEngine {
+    static RouteEngineFactory Factory() {
+        return OverlayEngine::Factory({4, 16});
+    }
+};
+
+typedef ::testing::Types<DijkstraEngine, BidirectionalDijkstraEngine, ContractionHierarchyEngine, AltEngine, AllPairsEngine, TestDeltaSteppingEngine, HubLabelEngine,
+    TestOverlayEngine> EngineTypes;
+TYPED_TEST_SUITE(RouteEngineTest, EngineTypes);
+
+/// @brief Test case for the route costs on a small graph, the cheapest route isn't the one with the fewest locations
+TYPED_TEST(RouteEngineTest, TestRouteCost)
+{
+    //  0 -> 1 (3)
+    //  0 -> 2 (1) -> 1
+    //  1 -> 3, 2 -> 3 (1) -> 0 (2)
+    //  4 isolated
+    auto graph = std::make_shared<const RouteGraph>(std::vector<unsigned int>({2, 3, 1, 1, 1}),
+        std::vector<std::pair<size_t, size_t>>({{0, 1}, {0, 2}, {1, 3}, {2, 3}, {2, 1}, {3, 0}}));
+    RouteEnginePtr engine = this->MakeEngine(graph);
+
+    EXPECT_EQ(engine->GetRouteCost(0, 3), 2);
+    EXPECT_EQ(engine->GetRouteCost(0, 1), 3);
+    EXPECT_EQ(engine->GetRouteCost(1, 0), 3);
+    EXPECT_EQ(engine->GetRouteCost(2, 0), 3);
+    EXPECT_EQ(engine->GetRouteCost(3, 3), 0);
+    EXPECT_EQ(engine->GetRouteCost(0, 4), ROUTE_COST_UNREACHABLE);
+    EXPECT_EQ(engine->GetRouteCost(4, 0), ROUTE_COST_UNREACHABLE);
+}
+
+/// @brief Test case for the engine agreeing with a plain Dijkstra search over every pair of locations in random graphs
+TYPED_TEST(RouteEngineTest, TestMatchesDijkstra)
+{
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        auto graph = this->MakeRandomGraph(40, seed);
+        RouteEnginePtr engine = this->MakeEngine(graph);
+        DijkstraSearch<BinaryHeapQueue> search;
+
+        for (LocationId start_id = 0; start_id < graph->LocationCount(); ++start_id) {
+            for (LocationId end_id = 0; end_id < graph->LocationCount(); ++end_id) {
+                ASSERT_EQ(engine->GetRouteCost(start_id, end_id), search.RouteCost(*graph, start_id, end_id)) << "seed=" << seed << " " << start_id << " -> " << end_id;
+            }
+        }
+    }
+}
+
+class ContractionHierarchyEngineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+};
+
+/// @brief Test case for the contraction only adding shortcuts where there is no witness route
+TEST_F(ContractionHierarchyEngineTest, TestShortcuts)
+{
+    // 0 -> 1 -> 2 and 0 -> 2 directly at the same cost as going via 1 (whose cost is 0), so 1 never needs a shortcut
+    auto witnessed = std::make_shared<const RouteGraph>(std::vector<unsigned int>({1, 0, 1}),
+        std::vector<std::pair<size_t, size_t>>({{0, 1}, {1, 2}, {0, 2}}));
+    ContractionHierarchyEngine witnessed_engine(witnessed);
+    EXPECT_EQ(witnessed_engine.ShortcutCount(), 0);
+    EXPECT_EQ(witnessed_engine.GetRouteCost(0, 2), 1);
+
+    // A star, every route between the leaves goes through the centre. The leaves are contracted first, so no shortcuts are needed
+    // and every query meets at the centre
+    auto star = std::make_shared<const RouteGraph>(std::vector<unsigned int>({5, 1, 2, 3}),
+        std::vector<std::pair<size_t, size_t>>({{0, 1}, {1, 0}, {0, 2}, {2, 0}, {0, 3}, {3, 0}}));
+    ContractionHierarchyEngine star_engine(star);
+    EXPECT_EQ(star_engine.ShortcutCount(), 0);
+    EXPECT_GT(star_engine.Rank(0), star_engine.Rank(1));
+    EXPECT_GT(star_engine.Rank(0), star_engine.Rank(2));
+    EXPECT_GT(star_engine.Rank(0), star_engine.Rank(3));
+    EXPECT_EQ(star_engine.GetRouteCost(1, 3), 8);
+    EXPECT_EQ(star_engine.GetRouteCost(3, 2), 7);
+}
+
+class AltEngineTest : public RouteEngineTest<AltEngine> {
+};
+
+/// @brief Test case for the landmark lower bounds never being more than the real route cost, and only ruling out routes that don't exist
+TEST_F(AltEngineTest, TestLowerBounds)
+{
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        auto graph = MakeRandomGraph(40, seed);
+        Landmarks landmarks(*graph, 4);
+        DijkstraSearch<BinaryHeapQueue> search;
+
+        EXPECT_EQ(landmarks.Count(), 4);
+        for (LocationId start_id = 0; start_id < graph->LocationCount(); ++start_id) {
+            const std::vector<unsigned int> route_costs = search.RouteCostsFrom(*graph, start_id);
+            for (LocationId end_id = 0; end_id < graph->LocationCount(); ++end_id) {
+                const unsigned int lower_bound = landmarks.LowerBound(start_id, end_id);
+                if (lower_bound == ROUTE_COST_UNREACHABLE) {
+                    ASSERT_EQ(route_costs[end_id], ROUTE_COST_UNREACHABLE) << "seed=" << seed << " " << start_id << " -> " << end_id;
+                }
+                else {
+                    ASSERT_LE(lower_bound, route_costs[end_id]) << "seed=" << seed << " " << start_id << " -> " << end_id;
+                }
+            }
+        }
+    }
+}
+
+/// @brief Test case for the ALT search settling fewer locations than Dijkstra on a long route
+TEST_F(AltEngineTest, TestSettlesFewerLocations)
+{
+    // A 20 x 20 grid with routes both ways between neighbours
+    const size_t width = 20;
+    std::vector<std::pair<size_t, size_t>> routes;
+    for (size_t y = 0; y < width; ++y) {
+        for (size_t x = 0; x < width; ++x) {
+            if (x + 1 < width) {
+                routes.push_back(std::make_pair(y * width + x, y * width + x + 1));
+                routes.push_back(std::make_pair(y * width + x + 1, y * width + x));
+            }
+            if (y + 1 < width) {
+                routes.push_back(std::make_pair(y * width + x, (y + 1) * width + x));
+                routes.push_back(std::make_pair((y + 1) * width + x, y * width + x));
+            }
+        }
+    }
+    RouteGraph graph(std::vector<unsigned int>(width * width, 1), routes);
+    Landmarks landmarks(graph, 4);
+
+    DijkstraSearch<BinaryHeapQueue> dijkstra;
+    AltSearch<BinaryHeapQueue> alt;
+    EXPECT_EQ(alt.RouteCost(graph, landmarks, 0, width * width - 1), 2 * (width - 1));
+    EXPECT_EQ(dijkstra.RouteCost(graph, 0, width * width - 1), 2 * (width - 1));
+    EXPECT_LT(alt.SettledCount() * 4, dijkstra.SettledCount());
+}
+
+class DijkstraEngineTest : public RouteEngineTest<DijkstraEngine> {
+};
+
+/// @brief Test case for a Dijkstra search carrying on from its shortest path tree, matching a fresh search for each end location in
+///        any order, and reading end locations that are already settled without settling anything more
+TEST_F(DijkstraEngineTest, TestResumeRouteCost)
+{
+    auto graph = MakeRandomGraph(200, 3);
+    std::mt19937 random(3);
+    std::uniform_int_distribution<LocationId> location(0, graph->LocationCount() - 1);
+    DijkstraSearch<BinaryHeapQueue> fresh;
+    DijkstraSearch<BinaryHeapQueue> resumed;
+
+    for (LocationId start_id : {0u, 7u, 0u}) {
+        for (int i = 0; i < 50; ++i) {
+            const LocationId end_id = location(random);
+            ASSERT_EQ(resumed.ResumeRouteCost(*graph, start_id, end_id), fresh.RouteCost(*graph, start_id, end_id));
+            EXPECT_EQ(resumed.Root(), start_id);
+        }
+    }
+
+    const LocationId end_id = location(random);
+    resumed.ResumeRouteCost(*graph, 0, end_id);
+    resumed.ResumeRouteCost(*graph, 0, end_id);
+    EXPECT_EQ(resumed.SettledCount(), 0);
+
+    // A backward search doesn't leave a tree to resume
+    resumed.RouteCostsTo(*graph, 0);
+    EXPECT_EQ(resumed.Root(), INVALID_LOCATION_ID);
+}
+
+/// @brief Test case for the engine's shortest path tree cache handing back the tree for a start location, and reusing the least
+///        recently used search once it is full
+TEST_F(DijkstraEngineTest, TestSearchTreeCache)
+{
+    SearchTreeCache<DijkstraSearch<BinaryHeapQueue>> cache(2);
+    auto graph = MakeRandomGraph(40, 4);
+
+    for (LocationId start_id : {0u, 1u}) {
+        std::unique_ptr<DijkstraSearch<BinaryHeapQueue>> search = cache.Acquire(start_id);
+        search->ResumeRouteCost(*graph, start_id, 5);
+        cache.Release(std::move(search));
+    }
+
+    std::unique_ptr<DijkstraSearch<BinaryHeapQueue>> search = cache.Acquire(0);
+    EXPECT_EQ(search->Root(), 0);
+    cache.Release(std::move(search));
+
+    // The cache is full so the least recently used search, start location 1, is handed out for a new start location
+    search = cache.Acquire(2);
+    EXPECT_EQ(search->Root(), 1);
+    search->ResumeRouteCost(*graph, 2, 5);
+    cache.Release(std::move(search));
+    EXPECT_EQ(cache.Acquire(1)->Root(), 0);
+    EXPECT_EQ(cache.Acquire(2)->Root(), 2);
+}
+
+class DeltaSteppingEngineTest : public RouteEngineTest<DeltaSteppingEngine> {
+};
+
+/// @brief Test case for the delta-stepping factory using plain Dijkstra for graphs under its size threshold
+TEST_F(DeltaSteppingEngineTest, TestSizeThreshold)
+{
+    auto graph = MakeRandomGraph(40, 5);
+
+    EXPECT_NE(std::dynamic_pointer_cast<const DijkstraEngine>(DeltaSteppingEngine::Factory(41)(graph)), nullptr);
+    EXPECT_NE(std::dynamic_pointer_cast<const DeltaSteppingEngine>(DeltaSteppingEngine::Factory(40)(graph)), nullptr);
+}
+
+/// @brief Test case for every bucket width and thread count giving the same route costs as plain Dijkstra
+TEST_F(DeltaSteppingEngineTest, TestBucketWidths)
+{
+    auto graph = MakeRandomGraph(300, 6);
+    DijkstraSearch<BinaryHeapQueue> dijkstra;
+
+    for (unsigned int delta : {0u, 1u, 2u, 5u, 20u}) {
+        for (size_t worker_count : {1u, 3u}) {
+            ThreadPool thread_pool(worker_count);
+            DeltaSteppingEngine engine(graph, delta, thread_pool);
+            EXPECT_GE(engine.Delta(), 1);
+            for (LocationId start_id = 0; start_id < graph->LocationCount(); start_id += 37) {
+                const std::vector<unsigned int>& route_costs = dijkstra.RouteCostsFrom(*graph, start_id);
+                for (LocationId end_id = 0; end_id < graph->LocationCount(); end_id += 11) {
+                    ASSERT_EQ(engine.GetRouteCost(start_id, end_id), route_costs[end_id]) << "delta=" << delta << " workers=" << worker_count;
+                }
+            }
+        }
+    }
+}
+
+/// @brief Test case for concurrent queries on one engine, each with a workspace of its own, giving the same route costs as plain Dijkstra
+TEST_F(DeltaSteppingEngineTest, TestConcurrentQueries)
+{
+    auto graph = MakeRandomGraph(300, 7);
+    ThreadPool thread_pool(3);
+    DeltaSteppingEngine engine(graph, 2, thread_pool);
+    std::vector<std::vector<unsigned int>> route_costs;
+    DijkstraSearch<BinaryHeapQueue> dijkstra;
+    for (LocationId start_id = 0; start_id < 4; ++start_id) {
+        route_costs.push_back(dijkstra.RouteCostsFrom(*graph, start_id));
+    }
+
+    std::vector<std::thread> threads;
+    std::vector<size_t> mismatches(route_costs.size(), 0);
+    for (LocationId start_id = 0; start_id < route_costs.size(); ++start_id) {
+        threads.emplace_back([&engine, &graph, &route_costs, &mismatches, start_id]() {
+            for (LocationId end_id = 0; end_id < graph->LocationCount(); ++end_id) {
+                if (engine.GetRouteCost(start_id, end_id) != route_costs[start_id][end_id]) {
+                    ++mismatches[start_id];
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (size_t mismatch_count : mismatches) {
+        EXPECT_EQ(mismatch_count, 0);
+    }
+}
+
+class AllPairsEngineTest : public RouteEngineTest<AllPairsEngine> {
+};
+
+/// @brief Test case for the all pairs factory refusing graphs over its size limit
+TEST_F(AllPairsEngineTest, TestRefuseLargeGraph)
+{
+    auto graph = MakeRandomGraph(40, 1);
+
+    EXPECT_EQ(AllPairsEngine::Factory(39)(graph), nullptr);
+
+    RouteEnginePtr engine = AllPairsEngine::Factory(40)(graph);
+    ASSERT_NE(engine, nullptr);
+    EXPECT_EQ(std::dynamic_pointer_cast<const AllPairsEngine>(engine)->MemoryBytes(), 40 * 40 * sizeof(unsigned int));
+}
+
+/// @brief Test case for the table being the same however many threads build it
+TEST_F(AllPairsEngineTest, TestWorkerCount)
+{
+    auto graph = MakeRandomGraph(40, 2);
+    ThreadPool single_pool(1);
+    ThreadPool parallel_pool(4);
+    AllPairsEngine single(graph, single_pool);
+    AllPairsEngine parallel(graph, parallel_pool);
+
+    for (LocationId start_id = 0; start_id < graph->LocationCount(); ++start_id) {
+        for (LocationId end_id = 0; end_id < graph->LocationCount(); ++end_id) {
+            ASSERT_EQ(single.GetRouteCost(start_id, end_id), parallel.GetRouteCost(start_id, end_id));
+        }
+    }
+}
+
+/// @brief Test case for the route cost matrix matching one query per pair, including repeated and unreachable end locations
+TYPED_TEST(RouteEngineTest, TestRouteCosts)
+{
+    auto graph = this->MakeRandomGraph(40, 3);
+    RouteEnginePtr engine = this->MakeEngine(graph);
+
+    const std::vector<LocationId> start_ids = {0, 5, 39, 5};
+    const std::vector<LocationId> end_ids = {1, 2, 3, 2, 20, 0};
+    const std::vector<unsigned int> route_costs = engine->GetRouteCosts(start_ids, end_ids);
+
+    ASSERT_EQ(route_costs.size(), start_ids.size() * end_ids.size());
+    for (size_t start_i = 0; start_i < start_ids.size(); ++start_i) {
+        for (size_t end_i = 0; end_i < end_ids.size(); ++end_i) {
+            EXPECT_EQ(route_costs[start_i * end_ids.size() + end_i], engine->GetRouteCost(start_ids[start_i], end_ids[end_i]));
+        }
+    }
+
+    EXPECT_TRUE(engine->GetRouteCosts({}, end_ids).empty());
+    EXPECT_TRUE(engine->GetRouteCosts(start_ids, {}).empty());
+}
+
+/// @brief Test case for the engine after a run of random changes agreeing with a plain Dijkstra search over the changed graph, whether
+///        the engine repaired itself or had to be built again
+TYPED_TEST(RouteEngineTest, TestApplyChange)
+{
+    const size_t location_count = 40;
+    std::mt19937 random(7);
+    std::uniform_int_distribution<unsigned int> cost(0, 9);
+    std::uniform_int_distribution<LocationId> location(0, location_count - 1);
+    std::uniform_int_distribution<int> change_type(0, 2);
+
+    auto graph = this->MakeRandomGraph(location_count, 7);
+    RouteEnginePtr engine = this->MakeEngine(graph);
+    DijkstraSearch<BinaryHeapQueue> search;
+
+    for (int change_i = 0; change_i < 30; ++change_i) {
+        // Some queries first, so the engine has partial work to carry over
+        for (int query_i = 0; query_i < 5; ++query_i) {
+            engine->GetRouteCost(location(random), location(random));
+        }
+
+        const LocationId start_id = location(random);
+        const LocationId end_id = location(random);
+        const int type = change_type(random);
+        RouteChange change = RouteChange::LocationCost(start_id, cost(random));
+        if (type == 1) {
+            change = graph->HasRoute(start_id, end_id) ? RouteChange::RemoveRoute(start_id, end_id) : RouteChange::AddRoute(start_id, end_id);
+        }
+        else if (type == 2 && graph->RoutesEnd(start_id) > graph->RoutesBegin(start_id)) {
+            change = RouteChange::RemoveRoute(start_id, graph->Destination(graph->RoutesBegin(start_id)));
+        }
+
+        graph = std::make_shared<const RouteGraph>(*graph, change);
+        RouteEnginePtr changed_engine = engine->ApplyChange(graph, change);
+        engine = changed_engine ? changed_engine : this->MakeEngine(graph);
+
+        for (LocationId start_id = 0; start_id < location_count; ++start_id) {
+            for (LocationId end_id = 0; end_id < location_count; ++end_id) {
+                ASSERT_EQ(engine->GetRouteCost(start_id, end_id), search.RouteCost(*graph, start_id, end_id)) << "change=" << change_i << " "
+                    << start_id << " -> " << end_id;
+            }
+        }
+    }
+}
+
+/// @brief Test case for the table being repaired for each kind of change rather than built again
+TEST_F(AllPairsEngineTest, TestApplyChange)
+{
+    auto graph = std::make_shared<const RouteGraph>(std::vector<unsigned int>({1, 2, 3}), std::vector<std::pair<size_t, size_t>>({{0, 1}, {1, 2}}));
+    RouteEnginePtr engine = MakeEngine(graph);
+
+    const std::vector<RouteChange> changes = {RouteChange::LocationCost(1, 5), RouteChange::LocationCost(1, 0), RouteChange::AddRoute(0, 2),
+        RouteChange::RemoveRoute(0, 2), RouteChange::RemoveRoute(1, 2)};
+    const std::vector<unsigned int> route_costs = {8, 3, 3, 3, ROUTE_COST_UNREACHABLE};
+    for (size_t change_i = 0; change_i < changes.size(); ++change_i) {
+        graph = std::make_shared<const RouteGraph>(*graph, changes[change_i]);
+        engine = engine->ApplyChange(graph, changes[change_i]);
+        ASSERT_TRUE(engine);
+        EXPECT_EQ(engine->GetRouteCost(0, 2), route_costs[change_i]) << "change=" << change_i;
+    }
+}
+
+/// @brief Test case for the cached shortest path trees being carried over when the change can't affect them
+TEST_F(DijkstraEngineTest, TestApplyChange)
+{
+    //  0 -> 1 -> 2, 3 -> 2
+    auto graph = std::make_shared<const RouteGraph>(std::vector<unsigned int>({1, 1, 1, 1}), std::vector<std::pair<size_t, size_t>>({{0, 1}, {1, 2}, {3, 2}}));
+    RouteEnginePtr engine = MakeEngine(graph);
+    EXPECT_EQ(engine->GetRouteCost(0, 2), 2);
+    EXPECT_EQ(engine->GetRouteCost(3, 2), 1);
+
+    // Location 1 isn't reached from 3, and its route change is after everything 0 has settled
+    RouteChange change = RouteChange::LocationCost(1, 4);
+    graph = std::make_shared<const RouteGraph>(*graph, change);
+    engine = engine->ApplyChange(graph, change);
+    ASSERT_TRUE(engine);
+    EXPECT_EQ(engine->GetRouteCost(3, 2), 1);
+    EXPECT_EQ(engine->GetRouteCost(0, 2), 5);
+
+    change = RouteChange::AddRoute(0, 2);
+    graph = std::make_shared<const RouteGraph>(*graph, change);
+    engine = engine->ApplyChange(graph, change);
+    ASSERT_TRUE(engine);
+    EXPECT_EQ(engine->GetRouteCost(0, 2), 1);
+    EXPECT_EQ(engine->GetRouteCost(3, 2), 1);
+}
+
+/// @brief Test case for DijkstraSearch::Repair(), a repaired partial tree carries on to the same route costs as a search over the changed
+///        graph, and the locations settled before the change are kept
+TEST_F(DijkstraEngineTest, TestRepair)
+{
+    const size_t location_count = 60;
+    std::mt19937 random(13);
+    std::uniform_int_distribution<unsigned int> cost(0, 9);
+    std::uniform_int_distribution<LocationId> location(0, location_count - 1);
+    std::uniform_int_distribution<int> change_type(0, 2);
+    DijkstraSearch<BinaryHeapQueue> search;
+    DijkstraSearch<BinaryHeapQueue> fresh_search;
+
+    for (int change_i = 0; change_i < 200; ++change_i) {
+        auto graph = MakeRandomGraph(location_count, change_i);
+        const LocationId root_id = location(random);
+        search.RouteCost(*graph, root_id, location(random));
+
+        const LocationId start_id = location(random);
+        const LocationId end_id = location(random);
+        const int type = change_type(random);
+        RouteChange change = RouteChange::LocationCost(start_id, cost(random));
+        if (type == 1 && start_id != end_id) {
+            change = graph->HasRoute(start_id, end_id) ? RouteChange::RemoveRoute(start_id, end_id) : RouteChange::AddRoute(start_id, end_id);
+        }
+        else if (type == 2 && graph->RoutesEnd(start_id) > graph->RoutesBegin(start_id)) {
+            change = RouteChange::RemoveRoute(start_id, graph->Destination(graph->RoutesBegin(start_id)));
+        }
+        auto changed_graph = std::make_shared<const RouteGraph>(*graph, change);
+        search.Repair(*graph, *changed_graph, change);
+
+        for (LocationId location_id = 0; location_id < location_count; ++location_id) {
+            ASSERT_EQ(search.ResumeRouteCost(*changed_graph, root_id, location_id), fresh_search.RouteCost(*changed_graph, root_id, location_id))
+                << "change=" << change_i << " " << root_id << " -> " << location_id;
+        }
+    }
+
+    //  0 -> 1 -> 2 -> 3, raising the cost of 3 leaves 0, 1 and 2 settled
+    auto graph = std::make_shared<const RouteGraph>(std::vector<unsigned int>({1, 1, 1, 1}), std::vector<std::pair<size_t, size_t>>({{0, 1}, {1, 2}, {2, 3}}));
+    EXPECT_EQ(search.ResumeRouteCost(*graph, 0, 3), 3);
+    const RouteChange change = RouteChange::LocationCost(3, 5);
+    auto changed_graph = std::make_shared<const RouteGraph>(*graph, change);
+    search.Repair(*graph, *changed_graph, change);
+    EXPECT_TRUE(search.Settled(2));
+    EXPECT_FALSE(search.Settled(3));
+    EXPECT_EQ(search.ResumeRouteCost(*changed_graph, 0, 3), 7);
+    EXPECT_EQ(search.SettledCount(), 1);
+}
+
+class HubLabelEngineTest : public RouteEngineTest<HubLabelEngine> {
+protected:
+    const std::string m_label_file = "test_hub_labels.hub";
+
+    void TearDown() override {
+        std::remove(m_label_file.c_str());
+    }
+};
+
+/// @brief Test case for labels saved to a file and loaded back giving the same route costs, and not being loaded for a different graph
+TEST_F(HubLabelEngineTest, TestSaveLoad)
+{
+    auto graph = MakeRandomGraph(60, 8);
+    HubLabelEngine engine(graph);
+    EXPECT_GT(engine.AverageLabelSize(), 0.0);
+    ASSERT_TRUE(engine.Save(m_label_file));
+
+    auto loaded = HubLabelEngine::Load(graph, m_label_file);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->MemoryBytes(), engine.MemoryBytes());
+    for (LocationId start_id = 0; start_id < graph->LocationCount(); ++start_id) {
+        for (LocationId end_id = 0; end_id < graph->LocationCount(); ++end_id) {
+            ASSERT_EQ(loaded->GetRouteCost(start_id, end_id), engine.GetRouteCost(start_id, end_id));
+        }
+    }
+
+    auto changed_graph = std::make_shared<const RouteGraph>(*graph, RouteChange::LocationCost(0, graph->LocationCost(0) + 1));
+    EXPECT_EQ(HubLabelEngine::Load(changed_graph, m_label_file), nullptr);
+    EXPECT_EQ(HubLabelEngine::Load(graph, "no_such_file.hub"), nullptr);
+
+    // A file cut short is refused rather than read past
+    std::ifstream file(m_label_file, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+    std::ofstream(m_label_file, std::ios::binary | std::ios::trunc).write(contents.data(), contents.size() - 8);
+    EXPECT_EQ(HubLabelEngine::Load(graph, m_label_file), nullptr);
+}
+
+/// @brief Test case for the factory building and saving the labels the first time and loading them after, and a change leaving them
+TEST_F(HubLabelEngineTest, TestFactoryLabelFile)
+{
+    auto graph = MakeRandomGraph(40, 9);
+
+    EXPECT_EQ(HubLabelEngine::Factory(39, m_label_file)(graph), nullptr);
+    EXPECT_FALSE(std::ifstream(m_label_file).is_open());
+
+    RouteEnginePtr built = HubLabelEngine::Factory(40, m_label_file)(graph);
+    ASSERT_NE(built, nullptr);
+    EXPECT_TRUE(std::ifstream(m_label_file).is_open());
+
+    RouteEnginePtr loaded = HubLabelEngine::Factory(40, m_label_file)(graph);
+    ASSERT_NE(loaded, nullptr);
+    EXPECT_EQ(loaded->GetRouteCost(0, 39), built->GetRouteCost(0, 39));
+
+    // The labels for a changed graph aren't saved over the ones for the graph on disk
+    const RouteChange change = RouteChange::LocationCost(0, graph->LocationCost(0) + 1);
+    auto changed_graph = std::make_shared<const RouteGraph>(*graph, change);
+    ASSERT_NE(loaded->ApplyChange(changed_graph, change), nullptr);
+    EXPECT_NE(HubLabelEngine::Load(graph, m_label_file), nullptr);
+    EXPECT_EQ(HubLabelEngine::Load(changed_graph, m_label_file), nullptr);
+}
+
+class OverlayEngineTest : public RouteEngineTest<TestOverlayEngine> {
+};
+
+/// @brief Test case for the partition's cells covering every location, fitting in their cell size and nesting inside the cells of the
+///        level above, with the boundaries being the locations with routes across them
+TEST_F(OverlayEngineTest, TestPartition)
+{
+    auto graph = MakeRandomGraph(100, 10);
+    OverlayPartition partition(*graph, {8, 32, 100});
+    ASSERT_EQ(partition.LevelCount(), 2);
+
+    for (size_t level_i = 0; level_i < partition.LevelCount(); ++level_i) {
+        const OverlayPartition::Level& level = partition.levels[level_i];
+        uint32_t next_begin = 0;
+        for (const OverlayPartition::Cell& cell : level.cells) {
+            EXPECT_EQ(cell.begin, next_begin);
+            EXPECT_LE(cell.end - cell.begin, level_i == 0 ? 8u : 32u);
+            next_begin = cell.end;
+        }
+        EXPECT_EQ(next_begin, graph->LocationCount());
+
+        for (LocationId location_id = 0; location_id < graph->LocationCount(); ++location_id) {
+            if (level_i > 0) {
+                // Every location of a cell at the level below is in the same cell at this level
+                const OverlayPartition::Level& lower = partition.levels[level_i - 1];
+                const OverlayPartition::Cell& lower_cell = lower.cells[lower.location_cells[location_id]];
+                EXPECT_EQ(level.location_cells[partition.order[lower_cell.begin]], level.location_cells[location_id]);
+            }
+            bool exit = false;
+            for (uint32_t route_i = graph->RoutesBegin(location_id); route_i < graph->RoutesEnd(location_id); ++route_i) {
+                exit = exit || level.location_cells[graph->Destination(route_i)] != level.location_cells[location_id];
+            }
+            EXPECT_EQ(level.exit_indexes[location_id] != OverlayPartition::INVALID_BOUNDARY_INDEX, exit) << location_id;
+        }
+    }
+}
+
+/// @brief Test case for the factory keeping the partition for a graph with the same routes and different location costs, and
+///        partitioning again when the routes change
+TEST_F(OverlayEngineTest, TestFactoryReusesPartition)
+{
+    auto graph = MakeRandomGraph(60, 11);
+    RouteEngineFactory factory = TestOverlayEngine::Factory();
+    auto engine = std::dynamic_pointer_cast<const OverlayEngine>(factory(graph));
+    ASSERT_NE(engine, nullptr);
+
+    auto cost_graph = std::make_shared<const RouteGraph>(*graph, RouteChange::LocationCost(5, graph->LocationCost(5) + 7));
+    auto cost_engine = std::dynamic_pointer_cast<const OverlayEngine>(factory(cost_graph));
+    ASSERT_NE(cost_engine, nullptr);
+    EXPECT_EQ(cost_engine->GetPartition(), engine->GetPartition());
+
+    auto route_graph = std::make_shared<const RouteGraph>(*graph, RouteChange::AddRoute(0, 59));
+    auto route_engine = std::dynamic_pointer_cast<const OverlayEngine>(factory(route_graph));
+    ASSERT_NE(route_engine, nullptr);
+    EXPECT_NE(route_engine->GetPartition(), engine->GetPartition());
+
+    DijkstraSearch<BinaryHeapQueue> search;
+    for (LocationId start_id = 0; start_id < graph->LocationCount(); ++start_id) {
+        for (LocationId end_id = 0; end_id < graph->LocationCount(); ++end_id) {
+            ASSERT_EQ(cost_engine->GetRouteCost(start_id, end_id), search.RouteCost(*cost_graph, start_id, end_id));
+            ASSERT_EQ(route_engine->GetRouteCost(start_id, end_id), search.RouteCost(*route_graph, start_id, end_id));
+        }
+    }
+}
+
+/// @brief Test case for a location cost change keeping the partition and matching the cliques of a full customisation
+TEST_F(OverlayEngineTest, TestApplyChange)
+{
+    auto graph = MakeRandomGraph(60, 12);
+    auto engine = std::dynamic_pointer_cast<const OverlayEngine>(MakeEngine(graph));
+    ASSERT_NE(engine, nullptr);
+
+    const RouteChange change = RouteChange::LocationCost(7, 9);
+    auto changed_graph = std::make_shared<const RouteGraph>(*graph, change);
+    auto changed = std::dynamic_pointer_cast<const OverlayEngine>(engine->ApplyChange(changed_graph, change));
+    ASSERT_NE(changed, nullptr);
+    EXPECT_EQ(changed->GetPartition(), engine->GetPartition());
+
+    OverlayEngine customised(changed_graph, engine->GetPartition());
+    for (LocationId start_id = 0; start_id < graph->LocationCount(); ++start_id) {
+        for (LocationId end_id = 0; end_id < graph->LocationCount(); ++end_id) {
+            ASSERT_EQ(changed->GetRouteCost(start_id, end_id), customised.GetRouteCost(start_id, end_id));
+        }
+    }
+
+    LocationId origin_id = 0;
+    while (graph->RoutesBegin(origin_id) == graph->RoutesEnd(origin_id)) {
+        ++origin_id;
+    }
+    const RouteChange route_change = RouteChange::RemoveRoute(origin_id, graph->Destination(graph->RoutesBegin(origin_id)));
+    EXPECT_EQ(engine->ApplyChange(std::make_shared<const RouteGraph>(*graph, route_change), route_change), nullptr);
+}
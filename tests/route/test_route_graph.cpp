@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <log4cxx/logger.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <log4cxx/helpers/exception.h>
+#include <set>
+#include "route/Location.h"
+#include "route/RouteGraph.h"
+
+using namespace route;
+
+class RouteGraphTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    /// @brief Utility method to collect the (destination, cost) routes leaving a location
+    static std::set<std::pair<uint32_t, unsigned int>> GetRoutes(const RouteGraph& graph, size_t location_i) {
+        std::set<std::pair<uint32_t, unsigned int>> routes;
+        for (uint32_t route_i = graph.RoutesBegin(location_i); route_i < graph.RoutesEnd(location_i); ++route_i) {
+            routes.insert(std::make_pair(graph.Destination(route_i), graph.RouteCost(route_i)));
+        }
+        return routes;
+    }
+};
+
+/// @brief Test case for building the graph from the destinations set on a list of locations
+TEST_F(RouteGraphTest, TestBuildFromLocations)
+{
+    Location london("London", 5, 0);
+    Location glasgow("Glasgow", 3, 1);
+    Location brighton("Brighton", 1, 2);
+    Location unknown("Unknown", 7, 3);
+
+    london.AddDestination(&glasgow);
+    london.AddDestination(&brighton);
+    glasgow.AddDestination(&london);
+    brighton.AddDestination(&london);
+    brighton.AddDestination(&unknown);  // Not in the graph, so should be dropped
+
+    RouteGraph graph({&london, &glasgow, &brighton});
+
+    EXPECT_EQ(graph.LocationCount(), 3);
+    EXPECT_EQ(graph.RouteCount(), 4);
+
+    EXPECT_EQ(graph.LocationCost(0), 5);
+    EXPECT_EQ(graph.LocationCost(1), 3);
+    EXPECT_EQ(graph.LocationCost(2), 1);
+
+    // The cost of each route is the cost of the location it enters
+    EXPECT_EQ(GetRoutes(graph, 0), (std::set<std::pair<uint32_t, unsigned int>>({{1, 3}, {2, 1}})));
+    EXPECT_EQ(GetRoutes(graph, 1), (std::set<std::pair<uint32_t, unsigned int>>({{0, 5}})));
+    EXPECT_EQ(GetRoutes(graph, 2), (std::set<std::pair<uint32_t, unsigned int>>({{0, 5}})));
+}
+
+/// @brief Test case for building the graph from a route list, locations with no routes get an empty range
+TEST_F(RouteGraphTest, TestBuildFromRoutes)
+{
+    RouteGraph graph({1, 2, 3, 4}, {{3, 0}, {0, 1}, {3, 1}, {0, 3}});
+
+    EXPECT_EQ(graph.LocationCount(), 4);
+    EXPECT_EQ(graph.RouteCount(), 4);
+
+    EXPECT_EQ(graph.RoutesEnd(0) - graph.RoutesBegin(0), 2);
+    EXPECT_EQ(graph.RoutesEnd(1) - graph.RoutesBegin(1), 0);
+    EXPECT_EQ(graph.RoutesEnd(2) - graph.RoutesBegin(2), 0);
+    EXPECT_EQ(graph.RoutesEnd(3) - graph.RoutesBegin(3), 2);
+
+    // Routes keep the order they were given in
+    EXPECT_EQ(graph.Destination(graph.RoutesBegin(0)), 1);
+    EXPECT_EQ(graph.Destination(graph.RoutesBegin(0) + 1), 3);
+    EXPECT_EQ(graph.Destination(graph.RoutesBegin(3)), 0);
+    EXPECT_EQ(graph.Destination(graph.RoutesBegin(3) + 1), 1);
+    EXPECT_EQ(graph.RouteCost(graph.RoutesBegin(3) + 1), 2);
+}
+
+/// @brief Test case for the reverse routes, each one mirrors a forward route and keeps its cost
+TEST_F(RouteGraphTest, TestReverseRoutes)
+{
+    RouteGraph graph({1, 2, 3, 4}, {{3, 0}, {0, 1}, {3, 1}, {0, 3}});
+
+    EXPECT_EQ(graph.ReverseRoutesEnd(0) - graph.ReverseRoutesBegin(0), 1);
+    EXPECT_EQ(graph.ReverseRoutesEnd(1) - graph.ReverseRoutesBegin(1), 2);
+    EXPECT_EQ(graph.ReverseRoutesEnd(2) - graph.ReverseRoutesBegin(2), 0);
+    EXPECT_EQ(graph.ReverseRoutesEnd(3) - graph.ReverseRoutesBegin(3), 1);
+
+    EXPECT_EQ(graph.Origin(graph.ReverseRoutesBegin(0)), 3);
+    EXPECT_EQ(graph.ReverseRouteCost(graph.ReverseRoutesBegin(0)), 1);
+    EXPECT_EQ(graph.Origin(graph.ReverseRoutesBegin(1)), 0);
+    EXPECT_EQ(graph.Origin(graph.ReverseRoutesBegin(1) + 1), 3);
+    EXPECT_EQ(graph.ReverseRouteCost(graph.ReverseRoutesBegin(1) + 1), 2);
+    EXPECT_EQ(graph.Origin(graph.ReverseRoutesBegin(3)), 0);
+    EXPECT_EQ(graph.ReverseRouteCost(graph.ReverseRoutesBegin(3)), 4);
+}
+
+/// @brief Test case for a copy of the graph with one change made to it, the original is left alone
+TEST_F(RouteGraphTest, TestRouteChange)
+{
+    RouteGraph graph({1, 2, 3}, {{0, 1}, {1, 2}});
+
+    RouteGraph location_changed(graph, RouteChange::LocationCost(1, 7));
+    EXPECT_EQ(location_changed.LocationCost(1), 7);
+    EXPECT_EQ(location_changed.RouteCost(location_changed.RoutesBegin(0)), 7);
+    EXPECT_EQ(graph.LocationCost(1), 2);
+
+    RouteGraph route_added(graph, RouteChange::AddRoute(2, 0));
+    EXPECT_EQ(route_added.RouteCount(), 3);
+    EXPECT_TRUE(route_added.HasRoute(2, 0));
+    EXPECT_EQ(GetRoutes(route_added, 2), (std::set<std::pair<uint32_t, unsigned int>>({{0, 1}})));
+    EXPECT_FALSE(graph.HasRoute(2, 0));
+
+    RouteGraph route_removed(graph, RouteChange::RemoveRoute(0, 1));
+    EXPECT_EQ(route_removed.RouteCount(), 1);
+    EXPECT_FALSE(route_removed.HasRoute(0, 1));
+    EXPECT_TRUE(route_removed.HasRoute(1, 2));
+    EXPECT_EQ(route_removed.ReverseRoutesEnd(1) - route_removed.ReverseRoutesBegin(1), 0);
+    EXPECT_TRUE(graph.HasRoute(0, 1));
+}
@@ -3,9 +3,18 @@
 #include <log4cxx/logger.h>
 #include <log4cxx/propertyconfigurator.h>
 #include <log4cxx/helpers/exception.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include "route/FileLocationDatabase.h"
+#include "route/FileRouteDatabase.h"
 #include "route/ILocationDatabase.h"
 #include "route/IRouteDatabase.h"
 #include "route/RoutePlanner.h"
+#include "route/AllPairsEngine.h"
+#include "route/SearchEngine.h"
 
 using namespace route;
 
@@ -26,15 +35,28 @@ public:
 class MockLocationDatabase : public ILocationDatabase {
 public:
     MOCK_METHOD(bool, Load,(), (override));
-    MOCK_METHOD(const std::vector<Location*>, GetLocations,(), (override, const));
-    MOCK_METHOD(Location* const, GetLocation,(std::string location_name), (override, const)); 
+    MOCK_METHOD(const std::vector<Location*>&, GetLocations,(), (override, const));
+    MOCK_METHOD(Location* const, GetLocation,(LocationId location_id), (override, const)); 
+    MOCK_METHOD(LocationId, GetLocationId,(const std::string& location_name), (override, const)); 
 };
 
 /// @brief this is the Mock Location Database class, its used to mock and control the locations during testing
 class MockRouteDatabase : public IRouteDatabase {
 public: 
     MOCK_METHOD(bool, Load,(), (override));
-    MOCK_METHOD(std::vector<std::string>, GetRoutes, (const std::string start_location_name), (override, const)); 
+    MOCK_METHOD(const std::vector<std::string>&, GetRoutes, (const std::string& start_location_name), (override, const)); 
+};
+
+/// @brief this is the Mock Location Database class for a database that says when it has changed
+class MockWatchedLocationDatabase : public MockLocationDatabase {
+public:
+    MOCK_METHOD(bool, HasChanged, (), (override, const));
+};
+
+/// @brief this is the Mock Route Database class for a database that says when it has changed
+class MockWatchedRouteDatabase : public MockRouteDatabase {
+public:
+    MOCK_METHOD(bool, HasChanged, (), (override, const));
 };
 
 class RoutePlannerTest : public ::testing::Test {
@@ -50,6 +72,24 @@ protected:
     void TearDown() override {
     }
 
+    /// @brief Utility method to have the mock location database look up locations by id and name from a list of locations
+    /// @param locations The list of locations, the id of each must be its index
+    void MockLocationLookups(const std::vector<Location*>& locations) {
+        EXPECT_CALL(*mock_location_db, GetLocation(testing::_)).WillRepeatedly([&locations](LocationId location_id) -> Location* {
+            return location_id < locations.size() ? locations[location_id] : nullptr;
+        }); 
+
+        EXPECT_CALL(*mock_location_db, GetLocationId(testing::_)).WillRepeatedly([&locations](const std::string& location_name) {
+            LocationId location_match = INVALID_LOCATION_ID;
+            std::for_each(locations.begin(), locations.end(), [&location_match, location_name](Location* const location) -> void {
+                if (location->Name() == location_name) {
+                    location_match = location->Id();
+                }
+            });
+            return location_match;
+        }); 
+    }
+
     std::unique_ptr<MockRoutePlanner> route_planner;
     std::shared_ptr<MockRouteDatabase> mock_route_db;
     std::shared_ptr<MockLocationDatabase> mock_location_db;
@@ -71,15 +111,13 @@ TEST_F(RoutePlannerTest, GetRoutesSuccess)
     });
 
     //Setup the locations
-    Location london("London", 5);
-    Location glasgow("Glasgow", 3);
-    Location brighton("Brighton", 1);
+    Location london("London", 5, 0);
+    Location glasgow("Glasgow", 3, 1);
+    Location brighton("Brighton", 1, 2);
 
     const std::vector<Location*> locations = {&london, &glasgow, &brighton};
 
-    EXPECT_CALL(*mock_location_db, GetLocations()).WillOnce([locations]() {
-        return locations;
-    }); 
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillOnce(testing::ReturnRef(locations)); 
 
     //Setup the routes
     std::unordered_map<std::string, std::vector<std::string>> routes;
@@ -93,29 +131,21 @@ TEST_F(RoutePlannerTest, GetRoutesSuccess)
     std::vector<std::string> brighton_routes = {"London"};
     routes.insert(std::make_pair("Brighton", brighton_routes));
 
-    EXPECT_CALL(*mock_route_db, GetRoutes(testing::_)).WillRepeatedly([routes](const std::string start_location) {
+    EXPECT_CALL(*mock_route_db, GetRoutes(testing::_)).WillRepeatedly([&routes](const std::string& start_location) -> const std::vector<std::string>& {
         return (routes.find(start_location))->second;
     }); 
 
     //Setup the individual location fetch
-    EXPECT_CALL(*mock_location_db, GetLocation(testing::_)).WillRepeatedly([locations](const std::string location_name) {
-        Location* location_match = nullptr;
-        std::for_each(locations.begin(), locations.end(), [&location_match, location_name](Location* const location) -> void {
-            if (location->Name() == location_name) {
-                location_match = location;
-            }
-        });
-        return location_match;
-    }); 
+    MockLocationLookups(locations);
 
     auto calculated_routes = route_planner->RealSetupRoutes();
 
     EXPECT_EQ(calculated_routes.size(), 3);
 
-    EXPECT_EQ(london.Destinations()["Glasgow"], &glasgow);
-    EXPECT_EQ(london.Destinations()["Brighton"], &brighton);
-    EXPECT_EQ(glasgow.Destinations()["London"], &london);
-    EXPECT_EQ(brighton.Destinations()["London"], &london);
+    EXPECT_EQ(london.Destinations().at(glasgow.Id()), &glasgow);
+    EXPECT_EQ(london.Destinations().at(brighton.Id()), &brighton);
+    EXPECT_EQ(glasgow.Destinations().at(london.Id()), &london);
+    EXPECT_EQ(brighton.Destinations().at(london.Id()), &london);
 }
 
 /// @brief Test case for RoutePlanner::GetRoutes() in the success case for when the location database changes
@@ -132,22 +162,19 @@ TEST_F(RoutePlannerTest, TestGetRoutesRereshOnLocationDbChange)
         return false;
     });
 
-    Location london("London", 5);
+    Location london("London", 5, 0);
     const std::vector<Location*> locations = {&london};
 
     //Just assert that the locations are fetched
     EXPECT_CALL(*mock_location_db, GetLocations())
     .Times(1)
-    .WillOnce([locations]() {
-        return locations;
-    }); 
+    .WillOnce(testing::ReturnRef(locations)); 
 
     //Only interested in checking the route calculation gets called
+    const std::vector<std::string> no_routes;
     EXPECT_CALL(*mock_route_db, GetRoutes(testing::_))
     .Times(1)
-    .WillOnce([](const std::string start_location) {
-        return std::vector<std::string>();
-    }); 
+    .WillOnce(testing::ReturnRef(no_routes)); 
 
     auto calculated_routes = route_planner->RealSetupRoutes();
     EXPECT_EQ(calculated_routes.size(), 1);
@@ -167,22 +194,19 @@ TEST_F(RoutePlannerTest, TestGetRoutesRereshOnRouteDbChange)
         return true;
     });
 
-    Location london("London", 5);
+    Location london("London", 5, 0);
     const std::vector<Location*> locations = {&london};
 
     //Just assert that the locations are fetched
     EXPECT_CALL(*mock_location_db, GetLocations())
     .Times(1)
-    .WillOnce([locations]() {
-        return locations;
-    }); 
+    .WillOnce(testing::ReturnRef(locations)); 
 
     //Only interested in checking the route calculation gets called
+    const std::vector<std::string> no_routes;
     EXPECT_CALL(*mock_route_db, GetRoutes(testing::_))
     .Times(1)
-    .WillOnce([](const std::string start_location) {
-        return std::vector<std::string>();
-    }); 
+    .WillOnce(testing::ReturnRef(no_routes)); 
 
     auto calculated_routes = route_planner->RealSetupRoutes();
     EXPECT_EQ(calculated_routes.size(), 1);
@@ -202,15 +226,13 @@ TEST_F(RoutePlannerTest, TestGetRoutesNoDbChange)
         return false;
     });
 
-    Location london("London", 5);
+    Location london("London", 5, 0);
     const std::vector<Location*> locations = {&london};
 
     //Just assert that the locations are fetched
     EXPECT_CALL(*mock_location_db, GetLocations())
     .Times(1)
-    .WillOnce([locations]() {
-        return locations;
-    }); 
+    .WillOnce(testing::ReturnRef(locations)); 
 
     //Only interested in checking the route has not been recalculated
     EXPECT_CALL(*mock_route_db, GetRoutes(testing::_))
@@ -224,16 +246,21 @@ TEST_F(RoutePlannerTest, TestGetRoutesNoDbChange)
 TEST_F(RoutePlannerTest, TestGetLocationNames)
 {   
     //Setup the locations
-    Location london("London", 5);
-    Location glasgow("Glasgow", 3);
-    Location brighton("Brighton", 1);
+    Location london("London", 5, 0);
+    Location glasgow("Glasgow", 3, 1);
+    Location brighton("Brighton", 1, 2);
 
     const std::vector<Location*> locations = {&london, &glasgow, &brighton};
 
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations)); 
+    EXPECT_CALL(*mock_location_db, Load()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*mock_route_db, Load()).WillRepeatedly(testing::Return(false));
+
+    // The names are listed from the route snapshot SetupRoutes() publishes
     EXPECT_CALL(*route_planner, SetupRoutes())
     .Times(1)
-    .WillOnce([locations]() {
-        return locations;
+    .WillOnce([this]() {
+        return route_planner->RealSetupRoutes();
     }); 
 
     auto location_names = route_planner->GetLocationNames();
@@ -248,22 +275,22 @@ TEST_F(RoutePlannerTest, TestGetLocationNames)
 TEST_F(RoutePlannerTest, TestCalculateRouteCost)
 {   
     //Setup the locations (use the locations from the assignment breif)
-    Location location_1("London", 5);
-    Location location_2("Birmingham", 5);
-    Location location_3("Manchester", 5);
-    Location location_4("Liverpool", 5);
-    Location location_5("Glasgow", 3);
-    Location location_6("Leeds", 3);
-    Location location_7("Edinburgh", 3);
-    Location location_8("Peterborough", 3);
-    Location location_9("Newcastle", 3);
-    Location location_10("Bath", 3);
-    Location location_11("Brighton", 1);
-    Location location_12("Leicester", 1);
-    Location location_13("Oxford", 1);
-    Location location_14("Cambridge", 1);
-    Location location_15("Sheffield", 1);
-    Location location_16("John O’Groats", 1);
+    Location location_1("London", 5, 0);
+    Location location_2("Birmingham", 5, 1);
+    Location location_3("Manchester", 5, 2);
+    Location location_4("Liverpool", 5, 3);
+    Location location_5("Glasgow", 3, 4);
+    Location location_6("Leeds", 3, 5);
+    Location location_7("Edinburgh", 3, 6);
+    Location location_8("Peterborough", 3, 7);
+    Location location_9("Newcastle", 3, 8);
+    Location location_10("Bath", 3, 9);
+    Location location_11("Brighton", 1, 10);
+    Location location_12("Leicester", 1, 11);
+    Location location_13("Oxford", 1, 12);
+    Location location_14("Cambridge", 1, 13);
+    Location location_15("Sheffield", 1, 14);
+    Location location_16("John O’Groats", 1, 15);
 
     const std::vector<Location*> locations = {
         &location_1, 
@@ -284,19 +311,9 @@ TEST_F(RoutePlannerTest, TestCalculateRouteCost)
         &location_16, 
     };
 
-    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly([locations]() {
-        return locations;
-    }); 
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations)); 
 
-    EXPECT_CALL(*mock_location_db, GetLocation(testing::_)).WillRepeatedly([locations](const std::string location_name) {
-        Location* location_match = nullptr;
-        std::for_each(locations.begin(), locations.end(), [&location_match, location_name](Location* const location) -> void {
-            if (location->Name() == location_name) {
-                location_match = location;
-            }
-        });
-        return location_match;
-    }); 
+    MockLocationLookups(locations);
 
 
     std::unordered_map<std::string, std::vector<std::string>> routes;
@@ -318,7 +335,7 @@ TEST_F(RoutePlannerTest, TestCalculateRouteCost)
     routes.insert(std::make_pair("Sheffield", std::vector<std::string>({"Manchester", "Leeds", "Peterborough", "Leicester"})));
     routes.insert(std::make_pair("John O’Groats", std::vector<std::string>({"Edinburgh", "Glasgow"})));
 
-    EXPECT_CALL(*mock_route_db, GetRoutes(testing::_)).WillRepeatedly([routes](const std::string start_location) {
+    EXPECT_CALL(*mock_route_db, GetRoutes(testing::_)).WillRepeatedly([&routes](const std::string& start_location) -> const std::vector<std::string>& {
         return (routes.find(start_location))->second;
     }); 
 
@@ -338,4 +355,397 @@ TEST_F(RoutePlannerTest, TestCalculateRouteCost)
     EXPECT_EQ(route_planner->GetRouteCost("Brighton", "Oxford"), 5);
     EXPECT_EQ(route_planner->GetRouteCost("Leeds", "Cambridge"), 6);
     EXPECT_EQ(route_planner->GetRouteCost("Manchester", "Brighton"), 13);
-}
\ No newline at end of file
+
+    // The same routes by id
+    EXPECT_EQ(route_planner->GetRouteCost(location_16.Id(), location_4.Id()), 9);
+    EXPECT_EQ(route_planner->GetRouteCost(location_11.Id(), location_13.Id()), 5);
+    EXPECT_EQ(route_planner->GetRouteCost(location_6.Id(), location_14.Id()), 6);
+    EXPECT_EQ(route_planner->GetRouteCost(location_3.Id(), location_11.Id()), 13);
+
+    // The same routes as a matrix
+    EXPECT_EQ(route_planner->GetRouteCosts({location_16.Id(), location_6.Id()}, {location_4.Id(), location_14.Id()}),
+        std::vector<unsigned int>({9, route_planner->GetRouteCost(location_16.Id(), location_14.Id()), route_planner->GetRouteCost(location_6.Id(), location_4.Id()), 6}));
+}
+
+/// @brief Test case for RoutePlanner::GetRouteCost() for when the start or end location is unknown
+TEST_F(RoutePlannerTest, TestCalculateRouteCostUnknownLocation)
+{   
+    Location london("London", 5, 0);
+    Location brighton("Brighton", 1, 1);
+    london.AddDestination(&brighton);
+    brighton.AddDestination(&london);
+
+    const std::vector<Location*> locations = {&london, &brighton};
+
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations)); 
+    MockLocationLookups(locations);
+
+    EXPECT_CALL(*mock_location_db, Load()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*mock_route_db, Load()).WillRepeatedly(testing::Return(false));
+
+    route_planner->RealSetupRoutes();
+
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Brighton"), 6);
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Glasgow"), 0);
+    EXPECT_EQ(route_planner->GetRouteCost("Glasgow", "Brighton"), 0);
+    EXPECT_EQ(route_planner->GetRouteCost(0, 2), 0);
+    EXPECT_TRUE(route_planner->GetRouteCosts({0, 1}, {0, 2}).empty());
+    EXPECT_EQ(route_planner->GetRouteCosts({0, 1}, {1}), std::vector<unsigned int>({6, 1}));
+}
+
+/// @brief Test case for RoutePlanner::AnswerRouteRequest() and RoutePlanner::AnswerRouteMatrixRequest(), an index past the end of
+/// the locations is refused even where narrowing it to a location id would wrap round to a known location
+TEST_F(RoutePlannerTest, TestAnswerRouteRequest)
+{
+    Location london("London", 5, 0);
+    Location brighton("Brighton", 1, 1);
+    Location bath("Bath", 3, 2);
+    london.AddDestination(&brighton);
+    brighton.AddDestination(&london);
+
+    const std::vector<Location*> locations = {&london, &brighton, &bath};
+
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations));
+    MockLocationLookups(locations);
+
+    EXPECT_CALL(*mock_location_db, Load()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*mock_route_db, Load()).WillRepeatedly(testing::Return(false));
+
+    route_planner->RealSetupRoutes();
+
+    const size_t wrapped_brighton = (static_cast<size_t>(1) << 32) + 1;
+    EXPECT_EQ(route_planner->AnswerRouteRequest(0, 1), 6);
+    EXPECT_EQ(route_planner->AnswerRouteRequest(0, 2), ROUTE_COST_UNREACHABLE);
+    EXPECT_EQ(route_planner->AnswerRouteRequest(0, 3), ROUTE_COST_ERROR);
+    EXPECT_EQ(route_planner->AnswerRouteRequest(0, wrapped_brighton), ROUTE_COST_ERROR);
+    EXPECT_EQ(route_planner->AnswerRouteMatrixRequest({0, 2}, {1, 2}), std::vector<unsigned int>({6, ROUTE_COST_UNREACHABLE, ROUTE_COST_UNREACHABLE, 3}));
+    EXPECT_TRUE(route_planner->AnswerRouteMatrixRequest({0}, {1, wrapped_brighton}).empty());
+    EXPECT_TRUE(route_planner->AnswerRouteMatrixRequest({3}, {1}).empty());
+}
+/// @brief Test case for RoutePlanner::SetRouteEngine(), the new engine is used straight away and survives the route graph being rebuilt
+TEST_F(RoutePlannerTest, TestSetRouteEngine)
+{   
+    Location london("London", 5, 0);
+    Location brighton("Brighton", 1, 1);
+    Location bath("Bath", 3, 2);
+    london.AddDestination(&brighton);
+    brighton.AddDestination(&bath);
+    bath.AddDestination(&london);
+
+    const std::vector<Location*> locations = {&london, &brighton, &bath};
+
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations)); 
+    MockLocationLookups(locations);
+
+    EXPECT_CALL(*mock_location_db, Load()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*mock_route_db, Load()).WillRepeatedly(testing::Return(false));
+
+    // No route graph yet, so there is nothing to search
+    route_planner->SetRouteEngine(BidirectionalDijkstraEngine::Factory());
+    EXPECT_EQ(route_planner->GetRouteCost(0, 2), 0);
+
+    route_planner->RealSetupRoutes();
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+    EXPECT_EQ(route_planner->GetRouteCost("Bath", "Brighton"), 9);
+
+    route_planner->SetRouteEngine(DijkstraEngine::Factory());
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+    EXPECT_EQ(route_planner->GetRouteCost("Bath", "Brighton"), 9);
+
+    // An engine that refuses the graph falls back to plain Dijkstra
+    route_planner->SetRouteEngine(AllPairsEngine::Factory(2));
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+    EXPECT_EQ(route_planner->GetRouteCost("Bath", "Brighton"), 9);
+}
+
+/// @brief Test case for the route cost cache in front of RoutePlanner::GetRouteCost(), repeated routes are served from the cache until
+///        the route graph is rebuilt
+TEST_F(RoutePlannerTest, TestRouteCostCache)
+{   
+    Location london("London", 5, 0);
+    Location brighton("Brighton", 1, 1);
+    Location bath("Bath", 3, 2);
+
+    const std::vector<Location*> locations = {&london, &brighton, &bath};
+
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations)); 
+    MockLocationLookups(locations);
+
+    std::unordered_map<std::string, std::vector<std::string>> routes;
+    routes.insert(std::make_pair("London", std::vector<std::string>({"Brighton"})));
+    routes.insert(std::make_pair("Brighton", std::vector<std::string>({"Bath"})));
+    routes.insert(std::make_pair("Bath", std::vector<std::string>({"London"})));
+
+    EXPECT_CALL(*mock_route_db, GetRoutes(testing::_)).WillRepeatedly([&routes](const std::string& start_location) -> const std::vector<std::string>& {
+        return (routes.find(start_location))->second;
+    }); 
+    EXPECT_CALL(*mock_location_db, Load()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*mock_route_db, Load()).WillRepeatedly(testing::Return(true));
+
+    route_planner->RealSetupRoutes();
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+    EXPECT_EQ(route_planner->GetRouteCost("Bath", "Brighton"), 9);
+
+    const RouteCostCache& cache = route_planner->GetRouteCostCache();
+    EXPECT_EQ(cache.HitCount(), 1);
+    EXPECT_EQ(cache.MissCount(), 2);
+    EXPECT_EQ(cache.Size(), 2);
+
+    // A direct route from London to Bath, the cached route cost must not be served for the rebuilt route graph
+    routes["London"].push_back("Bath");
+    route_planner->RealSetupRoutes();
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 8);
+    EXPECT_EQ(cache.HitCount(), 1);
+    EXPECT_EQ(cache.MissCount(), 3);
+    EXPECT_EQ(cache.Size(), 1);
+}
+
+/// @brief Test case for queries running while the routes are reloaded, every query is answered from a whole route snapshot
+TEST_F(RoutePlannerTest, TestQueriesDuringReload)
+{   
+    Location london("London", 5, 0);
+    Location brighton("Brighton", 1, 1);
+    Location bath("Bath", 3, 2);
+
+    const std::vector<Location*> locations = {&london, &brighton, &bath};
+
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations)); 
+    MockLocationLookups(locations);
+
+    std::unordered_map<std::string, std::vector<std::string>> routes;
+    routes.insert(std::make_pair("London", std::vector<std::string>({"Brighton"})));
+    routes.insert(std::make_pair("Brighton", std::vector<std::string>({"Bath"})));
+    routes.insert(std::make_pair("Bath", std::vector<std::string>({"London"})));
+
+    EXPECT_CALL(*mock_route_db, GetRoutes(testing::_)).WillRepeatedly([&routes](const std::string& start_location) -> const std::vector<std::string>& {
+        return (routes.find(start_location))->second;
+    }); 
+    EXPECT_CALL(*mock_location_db, Load()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*mock_route_db, Load()).WillRepeatedly(testing::Return(true));
+
+    route_planner->RealSetupRoutes();
+
+    std::atomic<bool> reloading(true);
+    std::vector<std::thread> queries;
+    for (int thread_i = 0; thread_i < 2; ++thread_i) {
+        queries.emplace_back([this, &reloading]() {
+            do {
+                ASSERT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+                ASSERT_EQ(route_planner->GetRouteCost(2, 1), 9);
+            } while (reloading);
+        });
+    }
+    for (int reload_i = 0; reload_i < 50; ++reload_i) {
+        route_planner->RealSetupRoutes();
+    }
+    reloading = false;
+    for (auto& query : queries) {
+        query.join();
+    }
+}
+
+/// @brief Test case for RoutePlanner::UpdateLocationCost(), RoutePlanner::AddRoute() and RoutePlanner::RemoveRoute(), each change is
+///        seen by the next query and changes that don't fit the routes are refused
+TEST_F(RoutePlannerTest, TestRouteChanges)
+{   
+    Location london("London", 5, 0);
+    Location brighton("Brighton", 1, 1);
+    Location bath("Bath", 3, 2);
+    london.AddDestination(&brighton);
+    brighton.AddDestination(&bath);
+    bath.AddDestination(&london);
+
+    const std::vector<Location*> locations = {&london, &brighton, &bath};
+
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations)); 
+    MockLocationLookups(locations);
+
+    EXPECT_CALL(*mock_location_db, Load()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*mock_route_db, Load()).WillRepeatedly(testing::Return(false));
+
+    // No route graph yet, so there is nothing to change
+    EXPECT_FALSE(route_planner->UpdateLocationCost(0, 1));
+
+    route_planner->SetRouteEngine(AllPairsEngine::Factory());
+    route_planner->RealSetupRoutes();
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+
+    EXPECT_TRUE(route_planner->UpdateLocationCost(1, 4));
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 12);
+
+    EXPECT_TRUE(route_planner->AddRoute(0, 2));
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 8);
+
+    EXPECT_TRUE(route_planner->RemoveRoute(0, 2));
+    EXPECT_TRUE(route_planner->RemoveRoute(1, 2));
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), ROUTE_COST_UNREACHABLE);
+    EXPECT_FALSE(route_planner->MayHaveRoute(0, 2));
+
+    EXPECT_FALSE(route_planner->UpdateLocationCost(3, 1));
+    EXPECT_FALSE(route_planner->AddRoute(0, 1));
+    EXPECT_FALSE(route_planner->AddRoute(0, 3));
+    EXPECT_FALSE(route_planner->RemoveRoute(1, 2));
+
+    // The changes are kept while the databases are unchanged
+    EXPECT_EQ(route_planner->GetLocationCount(), 3);
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Brighton"), 9);
+}
+
+/// @brief Test case for the route cost cache across route changes, the cached route costs a change can't have touched are kept and the
+///        rest are worked out again
+TEST_F(RoutePlannerTest, TestRouteCostCacheRouteChanges)
+{   
+    Location london("London", 5, 0);
+    Location brighton("Brighton", 1, 1);
+    Location bath("Bath", 3, 2);
+    Location york("York", 2, 3);
+    london.AddDestination(&brighton);
+    brighton.AddDestination(&bath);
+    bath.AddDestination(&london);
+    london.AddDestination(&york);
+
+    const std::vector<Location*> locations = {&london, &brighton, &bath, &york};
+
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations)); 
+    MockLocationLookups(locations);
+
+    EXPECT_CALL(*mock_location_db, Load()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*mock_route_db, Load()).WillRepeatedly(testing::Return(false));
+
+    route_planner->RealSetupRoutes();
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+    EXPECT_EQ(route_planner->GetRouteCost("Brighton", "Bath"), 4);
+    EXPECT_EQ(route_planner->GetRouteCost("Bath", "York"), 10);
+
+    const RouteCostCache& cache = route_planner->GetRouteCostCache();
+    EXPECT_EQ(cache.Size(), 3);
+
+    // York is only on the route from Bath
+    EXPECT_TRUE(route_planner->UpdateLocationCost(3, 7));
+    EXPECT_EQ(cache.Size(), 2);
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+    EXPECT_EQ(route_planner->GetRouteCost("Brighton", "Bath"), 4);
+    EXPECT_EQ(cache.HitCount(), 2);
+    EXPECT_EQ(route_planner->GetRouteCost("Bath", "York"), 15);
+
+    // A route from London to Bath is cheaper than going through Brighton, but doesn't change the route from Brighton
+    EXPECT_TRUE(route_planner->AddRoute(0, 2));
+    EXPECT_EQ(cache.Size(), 2);
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 8);
+    EXPECT_EQ(route_planner->GetRouteCost("Brighton", "Bath"), 4);
+    EXPECT_EQ(route_planner->GetRouteCost("Bath", "York"), 15);
+    EXPECT_EQ(cache.HitCount(), 4);
+
+    // Brighton starts one of the routes, and is no longer on the other
+    EXPECT_TRUE(route_planner->UpdateLocationCost(1, 4));
+    EXPECT_EQ(cache.Size(), 2);
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 8);
+    EXPECT_EQ(route_planner->GetRouteCost("Brighton", "Bath"), 7);
+    EXPECT_EQ(cache.HitCount(), 5);
+}
+
+/// @brief Test case for locations with no route between them, they get ROUTE_COST_UNREACHABLE rather than a route cost
+TEST_F(RoutePlannerTest, TestNoRoute)
+{   
+    Location london("London", 5, 0);
+    Location brighton("Brighton", 1, 1);
+    Location bath("Bath", 3, 2);
+    london.AddDestination(&brighton);
+    brighton.AddDestination(&london);
+
+    const std::vector<Location*> locations = {&london, &brighton, &bath};
+
+    EXPECT_CALL(*mock_location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations)); 
+    MockLocationLookups(locations);
+
+    EXPECT_CALL(*mock_location_db, Load()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*mock_route_db, Load()).WillRepeatedly(testing::Return(false));
+
+    // No route graph yet
+    EXPECT_FALSE(route_planner->MayHaveRoute(0, 1));
+
+    route_planner->RealSetupRoutes();
+    EXPECT_TRUE(route_planner->MayHaveRoute(0, 1));
+    EXPECT_FALSE(route_planner->MayHaveRoute(0, 2));
+    EXPECT_FALSE(route_planner->MayHaveRoute(2, 0));
+    EXPECT_FALSE(route_planner->MayHaveRoute(0, 3));
+
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Brighton"), 6);
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), ROUTE_COST_UNREACHABLE);
+    EXPECT_EQ(route_planner->GetRouteCost("Bath", "Brighton"), ROUTE_COST_UNREACHABLE);
+    EXPECT_EQ(route_planner->GetRouteCosts({0, 2}, {1, 2}), std::vector<unsigned int>({6, ROUTE_COST_UNREACHABLE, ROUTE_COST_UNREACHABLE, 3}));
+
+    // Adding a route is seen by the index straight away
+    EXPECT_TRUE(route_planner->AddRoute(1, 2));
+    EXPECT_TRUE(route_planner->MayHaveRoute(0, 2));
+    EXPECT_EQ(route_planner->GetRouteCost("London", "Bath"), 9);
+}
+
+/// @brief Test case for the databases only being reloaded by queries when they say they have changed
+TEST_F(RoutePlannerTest, TestRefreshOnlyWhenChanged)
+{
+    Location london("London", 5, 0);
+    Location brighton("Brighton", 1, 1);
+    Location bath("Bath", 3, 2);
+
+    const std::vector<Location*> locations = {&london, &brighton, &bath};
+    const std::vector<std::string> no_routes;
+
+    auto location_db = std::make_shared<MockWatchedLocationDatabase>();
+    auto route_db = std::make_shared<MockWatchedRouteDatabase>();
+    RoutePlanner test_route_planner(location_db, route_db);
+
+    bool locations_changed = false;
+    EXPECT_CALL(*location_db, GetLocations()).WillRepeatedly(testing::ReturnRef(locations));
+    EXPECT_CALL(*route_db, GetRoutes(testing::_)).WillRepeatedly(testing::ReturnRef(no_routes));
+    EXPECT_CALL(*location_db, HasChanged()).WillRepeatedly([&locations_changed]() {
+        return locations_changed;
+    });
+    EXPECT_CALL(*route_db, HasChanged()).WillRepeatedly(testing::Return(false));
+    EXPECT_CALL(*location_db, Load()).Times(2).WillRepeatedly(testing::Return(true));
+    EXPECT_CALL(*route_db, Load()).Times(2).WillRepeatedly(testing::Return(false));
+
+    // The first query sets the routes up, the next ones only read them while nothing has changed
+    EXPECT_EQ(test_route_planner.GetLocationCount(), 3);
+    EXPECT_EQ(test_route_planner.GetLocationCount(), 3);
+    EXPECT_EQ(test_route_planner.GetLocationNames().size(), 3);
+
+    locations_changed = true;
+    EXPECT_EQ(test_route_planner.GetLocationCount(), 3);
+}
+
+/// @brief Test case for RoutePlanner::StartReloading(), changes to the database files are picked up in the background
+TEST_F(RoutePlannerTest, TestBackgroundReload)
+{
+    const std::string location_file("test_background_reload_locations.csv");
+    const std::string route_file("test_background_reload_routes.csv");
+    std::ofstream(location_file, std::ios::trunc) << "London,5\nBrighton,1\nBath,3\n";
+    std::ofstream(route_file, std::ios::trunc) << "London,Brighton\nBrighton,Bath\n";
+
+    RoutePlanner test_route_planner(std::make_shared<FileLocationDatabase>(location_file), std::make_shared<FileRouteDatabase>(route_file));
+    test_route_planner.StartReloading(std::chrono::milliseconds(5));
+
+    // The queries only read the current routes, so they are polled until the reload thread has caught up
+    auto wait_for_route_cost = [&test_route_planner](const std::string& start, const std::string& end, unsigned int cost) -> bool {
+        for (int poll_i = 0; poll_i < 1000 && test_route_planner.GetRouteCost(start, end) != cost; ++poll_i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return test_route_planner.GetRouteCost(start, end) == cost;
+    };
+
+    EXPECT_TRUE(wait_for_route_cost("London", "Bath", 9));
+
+    // A location cost changed
+    std::ofstream(location_file, std::ios::trunc) << "London,5\nBrighton,2\nBath,3\n";
+    EXPECT_TRUE(wait_for_route_cost("London", "Bath", 10));
+
+    // A route replaced, the old one doesn't stay behind
+    std::ofstream(route_file, std::ios::trunc) << "London,Bath\nBrighton,Bath\n";
+    EXPECT_TRUE(wait_for_route_cost("London", "Bath", 8));
+    EXPECT_EQ(test_route_planner.GetRouteCost("London", "Brighton"), ROUTE_COST_UNREACHABLE);
+
+    test_route_planner.StopReloading();
+    std::remove(location_file.c_str());
+    std::remove(route_file.c_str());
+}
@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <log4cxx/propertyconfigurator.h>
+#include "route/SearchWorkspace.h"
+
+using namespace route;
+
+class SearchWorkspaceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    void TearDown() override {
+    }
+};
+
+/// @brief Test case for the route costs and settled locations of one search not being seen by the next
+TEST_F(SearchWorkspaceTest, TestReset)
+{
+    SearchWorkspace workspace;
+    workspace.Reset(4);
+
+    EXPECT_EQ(workspace.RouteCost(0), ROUTE_COST_UNREACHABLE);
+    workspace.SetRouteCost(0, 0);
+    workspace.SetRouteCost(2, 5);
+    workspace.SetRouteCost(2, 3);
+    workspace.Settle(0);
+
+    EXPECT_EQ(workspace.RouteCost(0), 0);
+    EXPECT_EQ(workspace.RouteCost(2), 3);
+    EXPECT_TRUE(workspace.Settled(0));
+    EXPECT_FALSE(workspace.Settled(2));
+
+    workspace.Reset(4);
+    EXPECT_EQ(workspace.RouteCost(0), ROUTE_COST_UNREACHABLE);
+    EXPECT_EQ(workspace.RouteCost(2), ROUTE_COST_UNREACHABLE);
+    EXPECT_FALSE(workspace.Settled(0));
+
+    // Settling a location again in the new search still gives it the new route cost
+    workspace.SetRouteCost(0, 7);
+    workspace.Settle(0);
+    EXPECT_EQ(workspace.RouteCost(0), 7);
+    EXPECT_TRUE(workspace.Settled(0));
+}
+
+/// @brief Test case for the workspace growing for a bigger graph
+TEST_F(SearchWorkspaceTest, TestGrow)
+{
+    SearchWorkspace workspace;
+    workspace.Reset(2);
+    workspace.SetRouteCost(1, 1);
+
+    workspace.Reset(10);
+    EXPECT_EQ(workspace.RouteCost(1), ROUTE_COST_UNREACHABLE);
+    EXPECT_EQ(workspace.RouteCost(9), ROUTE_COST_UNREACHABLE);
+    workspace.SetRouteCost(9, 4);
+    EXPECT_EQ(workspace.RouteCost(9), 4);
+}
@@ -0,0 +1,86 @@
+#include <gtest/gtest.h>
+#include <log4cxx/propertyconfigurator.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "route/ThreadPool.h"
+
+using namespace route;
+
+class ThreadPoolTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        log4cxx::PropertyConfigurator::configure("log4cxx.properties");
+    }
+
+    void TearDown() override {
+    }
+};
+
+/// @brief Test case for ThreadPool::ParallelFor() running every index exactly once, over many loops on the same pool
+TEST_F(ThreadPoolTest, TestParallelFor)
+{
+    ThreadPool thread_pool(4);
+    EXPECT_EQ(thread_pool.WorkerCount(), 4);
+
+    for (size_t count : {0u, 1u, 7u, 1000u, 12345u}) {
+        std::vector<std::atomic<int>> runs(count);
+        std::atomic<bool> bad_worker(false);
+        thread_pool.ParallelFor(count, 16, [&runs, &bad_worker, &thread_pool](size_t first, size_t end, size_t worker_i) -> void {
+            if (worker_i >= thread_pool.WorkerCount()) {
+                bad_worker = true;
+            }
+            for (size_t index = first; index < end; ++index) {
+                ++runs[index];
+            }
+        });
+        EXPECT_FALSE(bad_worker);
+        for (size_t index = 0; index < count; ++index) {
+            ASSERT_EQ(runs[index], 1) << "count=" << count << " index=" << index;
+        }
+    }
+}
+
+/// @brief Test case for a pool of one worker running loops on the calling thread
+TEST_F(ThreadPoolTest, TestSingleWorker)
+{
+    ThreadPool thread_pool(1);
+    size_t total = 0;
+    thread_pool.ParallelFor(100, 8, [&total](size_t first, size_t end, size_t worker_i) -> void {
+        EXPECT_EQ(worker_i, 0);
+        total += end - first;
+    });
+    EXPECT_EQ(total, 100);
+}
+
+/// @brief Test case for ThreadPool::ParallelFor() asked for from several threads at once, a loop that finds the workers busy is run on
+/// its own thread and every loop still runs every index exactly once
+TEST_F(ThreadPoolTest, TestConcurrentLoops)
+{
+    ThreadPool& thread_pool = ThreadPool::Shared();
+    EXPECT_EQ(&thread_pool, &ThreadPool::Shared());
+
+    const size_t count = 5000;
+    std::vector<std::vector<std::atomic<int>>> runs(4);
+    std::vector<std::thread> threads;
+    for (size_t thread_i = 0; thread_i < runs.size(); ++thread_i) {
+        runs[thread_i] = std::vector<std::atomic<int>>(count);
+        threads.emplace_back([&thread_pool, &runs, thread_i, count]() -> void {
+            for (int loop_i = 0; loop_i < 20; ++loop_i) {
+                thread_pool.ParallelFor(count, 8, [&runs, thread_i](size_t first, size_t end, size_t) -> void {
+                    for (size_t index = first; index < end; ++index) {
+                        ++runs[thread_i][index];
+                    }
+                });
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    for (size_t thread_i = 0; thread_i < runs.size(); ++thread_i) {
+        for (size_t index = 0; index < count; ++index) {
+            ASSERT_EQ(runs[thread_i][index], 20) << "thread_i=" << thread_i << " index=" << index;
+        }
+    }
+}